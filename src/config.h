@@ -137,11 +137,21 @@
 // Show OpenGL extensions and capabilities detailed logs on init
 //#define RLGL_SHOW_GL_DETAILS_INFO              1
 
+// Use a compact interleaved vertex layout for the render batch (24 bytes per vertex, full range float texcoords)
+//#define RLGL_RENDER_BATCH_INTERLEAVED          1
+// Keep normals on the interleaved render batch vertex layout (only for custom shaders using them)
+//#define RLGL_RENDER_BATCH_NORMALS              1
+// Support render batch contexts filled from worker threads (rlgl state accessed through a thread-local pointer)
+//#define RLGL_RENDER_BATCH_THREADS              1
+// Stream render batch data through a ring of vertex buffers, persistently mapped (if supported) or orphaned
+//#define RLGL_RENDER_BATCH_STREAMING            1
+
 #define RL_SUPPORT_MESH_GPU_SKINNING           1      // GPU skinning, comment if your GPU does not support more than 8 VBOs
 #endif
 
 //#define RL_DEFAULT_BATCH_BUFFER_ELEMENTS    4096    // Default internal render batch elements limits
 #define RL_DEFAULT_BATCH_BUFFERS               1      // Default number of batch buffers (multi-buffering)
+//#define RL_DEFAULT_BATCH_STREAM_BUFFERS      3      // Default number of batch buffers on streaming mode (ring buffering)
 #define RL_DEFAULT_BATCH_DRAWCALLS           256      // Default number of batch draw calls (by state changes: mode, texture)
 #define RL_DEFAULT_BATCH_MAX_TEXTURE_UNITS     4      // Maximum number of textures units that can be activated on batch drawing (SetShaderValueTexture())
 
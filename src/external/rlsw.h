@@ -9,7 +9,7 @@
 *       devices when required
 *
 *   FEATURES:
-*       - Rendering to custom internal framebuffer with multiple color modes supported:
+*       - Rendering to custom internal framebuffer (separate color and depth planes) with multiple color modes supported:
 *           - Color buffer: RGB - 8-bit (3:3:2) | RGB - 16-bit (5:6:5) | RGB - 24-bit (8:8:8)
 *           - Depth buffer: D - 8-bit (unorm) | D - 16-bit (unorm) | D - 24-bit (unorm)
 *       - Rendering modes supported: POINT, LINES, TRIANGLE, QUADS
@@ -17,19 +17,34 @@
 *       - Clipping support for all rendering modes
 *       - Texture features supported:
 *           - All uncompressed texture formats supported by raylib
+*           - Native storage for grayscale, gray-alpha, R5G6B5 and RGBA32 textures
+*           - Large textures stored by 4x4 texel tiles, cache friendly in any direction (SW_TEXTURE_TILE_MIN_SIZE)
 *           - Texture Minification/Magnification checks
-*           - Point and Bilinear filtering
+*           - Point and Bilinear filtering, fixed-point bilinear sampling by spans of pixels (SW_FIXED_POINT_TEXTURE)
+*           - Mipmaps generation, nearest-mip and trilinear filtering
 *           - Texture Wrap Modes with separate checks for S/T coordinates
-*       - Vertex Arrays support with direct primitive drawing mode
+*       - Vertex Arrays support with batched vertex processing and post-transform cache
+*           - Instanced drawing, per instance matrices and vertices fetched once (swDrawElementsInstanced())
 *       - Matrix Stack support (Matrix Push/Pop)
 *       - Other GL misc features:
 *           - GL-style getter functions
 *           - Framebuffer resizing
+*           - Rendering directly into user memory, with its own row stride and RGBA/BGRA order
+*           - Framebuffer objects, rendering to textures (color and depth attachments)
 *           - Perspective correction
 *           - Scissor clipping
-*           - Depth testing
-*           - Blend modes
+*           - Depth testing, with hierarchical depth tiles for early rejection
+*           - Deferred clears resolved per tile, and changed region tracking (swGetDirtyRect())
+*           - Blend modes, with fixed-point kernels for the standard ones (SW_FIXED_POINT_BLEND)
 *           - Face culling
+*           - Quads fast paths, screen aligned and affine ones (rotated or scaled sprites, constant w)
+*           - Coverage-based 4x multisampling of the main framebuffer polygons, shaded once per pixel (SW_MULTISAMPLE)
+*           - CPU vertex and fragment programs with uniforms, replacing the fixed function stages (swUseProgram())
+*       - Multithreaded tile-binned rasterization (SW_MAX_THREADS > 1)
+*       - Multiple independent contexts, current context per thread (swCreateContext())
+*       - Optional half-space block triangle rasterizer (SW_HALF_SPACE_RASTER)
+*       - Guard-band clipping, only near/far clipping for the polygons close to the viewport (SW_GUARD_BAND)
+*       - Optional rendering statistics, counters and timings of each stage (SW_ENABLE_STATS, swGetStats())
 *
 *   ADDITIONAL NOTES:
 *       Check PR for more info: https://github.com/raysan5/raylib/pull/4832
@@ -59,6 +74,19 @@
 *           #define SW_MAX_MODELVIEW_STACK_SIZE     8
 *           #define SW_MAX_TEXTURE_STACK_SIZE       2
 *           #define SW_MAX_TEXTURES                 128
+*           #define SW_TEXTURE_TILE_MIN_SIZE        64
+*           #define SW_MAX_FRAMEBUFFERS             16
+*           #define SW_MAX_THREADS                  1
+*           #define SW_BIN_TILE_SIZE                64
+*           #define SW_BIN_MAX_VERTICES             65536
+*           #define SW_VERTEX_CACHE_SIZE            256
+*           #define SW_HALF_SPACE_RASTER            false
+*           #define SW_GUARD_BAND                   4096
+*           #define SW_DEPTH_TILE_SIZE              8
+*           #define SW_FIXED_POINT_BLEND            false (true with RLSW_USE_SIMD_INTRINSICS)
+*           #define SW_FIXED_POINT_TEXTURE          false (true with RLSW_USE_SIMD_INTRINSICS)
+*           #define SW_MAX_PROGRAM_UNIFORMS         256
+*           #define SW_ENABLE_STATS                 false
 *
 *
 *   LICENSE: MIT
@@ -145,6 +173,107 @@
     #define SW_MAX_TEXTURES                 128
 #endif
 
+// Minimum width and height of the texture levels stored by tiles of 4x4 texels instead of rows,
+// neighbor texels in both directions stay close in memory for rotated and vertical walks
+// NOTE: 0 stores all the levels by rows
+#ifndef SW_TEXTURE_TILE_MIN_SIZE
+    #define SW_TEXTURE_TILE_MIN_SIZE        64
+#endif
+
+#ifndef SW_MAX_FRAMEBUFFERS
+    #define SW_MAX_FRAMEBUFFERS             16
+#endif
+
+// Maximum number of threads used for rasterization (including the calling thread)
+// When greater than 1, primitives are binned into screen tiles and rasterized
+// in parallel by a worker pool, tiles keep the submission order of their primitives
+#ifndef SW_MAX_THREADS
+    #define SW_MAX_THREADS                  1
+#endif
+
+// Size in pixels of the screen tiles used for primitives binning
+#ifndef SW_BIN_TILE_SIZE
+    #define SW_BIN_TILE_SIZE                64
+#endif
+
+// Maximum number of binned vertices before rasterization is forced
+#ifndef SW_BIN_MAX_VERTICES
+    #define SW_BIN_MAX_VERTICES             65536
+#endif
+
+// Number of vertices transformed at once by glDrawArrays(), also used as
+// post-transform cache by glDrawElements(), indexed by vertex index
+// NOTE: Must be a power of two of at least 4, to hold a whole quad
+#ifndef SW_VERTEX_CACHE_SIZE
+    #define SW_VERTEX_CACHE_SIZE            256
+#endif
+
+// The cache slot of a vertex index is masked with the cache size, and the arrays are transformed
+// by whole primitives, a smaller cache would never advance
+#if (SW_VERTEX_CACHE_SIZE < 4) || (SW_VERTEX_CACHE_SIZE & (SW_VERTEX_CACHE_SIZE - 1))
+    #error "SW_VERTEX_CACHE_SIZE must be a power of two of at least 4"
+#endif
+
+// Rasterize triangles with edge functions evaluated by blocks of 4x4 pixels (SIMD when available)
+// instead of scanlines, vertices are snapped to 1/16 pixel and follow the top-left fill rule
+#ifndef SW_HALF_SPACE_RASTER
+    #define SW_HALF_SPACE_RASTER            false
+#endif
+
+// Size in pixels of the guard band around the viewport, triangles and quads inside it are only
+// clipped against the near and far planes, the rasterizers limit them to the viewport and scissor rectangle
+// NOTE: Bounds the screen coordinates given to the rasterizers, half-space edge functions stay
+// in 32-bit range up to about one million pixels, 0 clips all the polygons against the frustum
+#ifndef SW_GUARD_BAND
+    #define SW_GUARD_BAND                   4096
+#endif
+
+// Size in pixels of the framebuffer tiles keeping the minimum and maximum depth values,
+// used to reject the primitives behind the depth buffer before interpolation and texturing
+// NOTE: Must be a multiple of 4 and a divisor of SW_BIN_TILE_SIZE
+#ifndef SW_DEPTH_TILE_SIZE
+    #define SW_DEPTH_TILE_SIZE              8
+#endif
+
+// A depth tile straddling two bin tiles would be updated by two rasterization threads at once
+#if (SW_BIN_TILE_SIZE % SW_DEPTH_TILE_SIZE) || (SW_DEPTH_TILE_SIZE % 4)
+    #error "SW_DEPTH_TILE_SIZE must be a multiple of 4 and a divisor of SW_BIN_TILE_SIZE"
+#endif
+
+// Blend 8-bit per channel color buffers in fixed point for the standard blend functions
+// (alpha, additive, multiplied, add colors and premultiplied alpha), bypassing the float conversions
+// NOTE: Faster than the float path with SIMD, or on targets without hardware floating point
+#ifndef SW_FIXED_POINT_BLEND
+    #if defined(RLSW_USE_SIMD_INTRINSICS)
+        #define SW_FIXED_POINT_BLEND        true
+    #else
+        #define SW_FIXED_POINT_BLEND        false
+    #endif
+#endif
+
+// Bilinear filtering of RGBA32 textures in fixed point by spans of 4 pixels in the scanline rasterizer,
+// texel coordinates and weights are computed for the whole span and texels blended in 16-bit lanes
+// NOTE: Applies to textures filtered linearly at all scales, weights have 8 bits of sub-texel precision
+#ifndef SW_FIXED_POINT_TEXTURE
+    #if defined(RLSW_USE_SIMD_INTRINSICS)
+        #define SW_FIXED_POINT_TEXTURE      true
+    #else
+        #define SW_FIXED_POINT_TEXTURE      false
+    #endif
+#endif
+
+// Size in bytes of the uniforms block shared by the vertex and fragment programs
+#ifndef SW_MAX_PROGRAM_UNIFORMS
+    #define SW_MAX_PROGRAM_UNIFORMS         256
+#endif
+
+// Count the processed vertices, primitives, fragments and texels, and time the clears,
+// the rasterization and the framebuffer copies, results are queried with swGetStats()
+// NOTE: Counters and timers are updated per fragment and per primitive, disabled by default
+#ifndef SW_ENABLE_STATS
+    #define SW_ENABLE_STATS                 false
+#endif
+
 // Under normal circumstances, clipping a polygon can add at most one vertex per clipping plane
 // Considering the largest polygon involved is a quadrilateral (4 vertices),
 // and that clipping occurs against both the frustum (6 planes) and the scissors (4 planes),
@@ -189,6 +318,7 @@ typedef double              GLclampd;
 #define GL_DEPTH_TEST                       0x0B71
 #define GL_CULL_FACE                        0x0B44
 #define GL_BLEND                            0x0BE2
+#define GL_MULTISAMPLE                      0x809D
 
 #define GL_VENDOR                           0x1F00
 #define GL_RENDERER                         0x1F01
@@ -271,6 +401,10 @@ typedef double              GLclampd;
 
 #define GL_NEAREST                          0x2600
 #define GL_LINEAR                           0x2601
+#define GL_NEAREST_MIPMAP_NEAREST           0x2700
+#define GL_LINEAR_MIPMAP_NEAREST            0x2701
+#define GL_NEAREST_MIPMAP_LINEAR            0x2702
+#define GL_LINEAR_MIPMAP_LINEAR             0x2703
 
 #define GL_REPEAT                           0x2901
 #define GL_CLAMP                            0x2900
@@ -280,6 +414,18 @@ typedef double              GLclampd;
 
 #define GL_TEXTURE_WRAP_S                   0x2802
 #define GL_TEXTURE_WRAP_T                   0x2803
+#define GL_TEXTURE_MAX_LEVEL                0x813D
+
+#define GL_NONE                             0
+#define GL_FRAMEBUFFER                      0x8D40
+#define GL_COLOR_ATTACHMENT0                0x8CE0
+#define GL_DEPTH_ATTACHMENT                 0x8D00
+#define GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE 0x8CD0
+#define GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME 0x8CD1
+#define GL_FRAMEBUFFER_COMPLETE             0x8CD5
+#define GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT 0x8CD6
+#define GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT 0x8CD7
+#define GL_FRAMEBUFFER_UNSUPPORTED          0x8CDD
 
 #define GL_NO_ERROR                         0
 #define GL_INVALID_ENUM                     0x0500
@@ -294,6 +440,7 @@ typedef double              GLclampd;
 #define GL_LUMINANCE_ALPHA                  0x190A
 #define GL_RGB                              0x1907
 #define GL_RGBA                             0x1908
+#define GL_BGRA                             0x80E1
 
 #define GL_BYTE                             0x1400
 #define GL_UNSIGNED_BYTE                    0x1401
@@ -302,6 +449,9 @@ typedef double              GLclampd;
 #define GL_INT                              0x1404
 #define GL_UNSIGNED_INT                     0x1405
 #define GL_FLOAT                            0x1406
+#define GL_UNSIGNED_SHORT_5_6_5             0x8363
+#define GL_UNSIGNED_SHORT_5_5_5_1           0x8034
+#define GL_UNSIGNED_SHORT_4_4_4_4           0x8033
 
 // OpenGL Definitions NOT USED
 #define GL_PERSPECTIVE_CORRECTION_HINT      0x0C50
@@ -330,6 +480,7 @@ typedef double              GLclampd;
 #define glGetFloatv(pname, params)                  swGetFloatv((pname), (params))
 #define glGetString(pname)                          swGetString((pname))
 #define glGetError()                                swGetError()
+#define glFinish()                                  swFinish()
 #define glViewport(x, y, w, h)                      swViewport((x), (y), (w), (h))
 #define glScissor(x, y, w, h)                       swScissor((x), (y), (w), (h))
 #define glClearColor(r, g, b, a)                    swClearColor((r), (g), (b), (a))
@@ -381,9 +532,18 @@ typedef double              GLclampd;
 #define glDrawElements(m,c,t,i)                     swDrawElements((m),(c),(t),(i))
 #define glGenTextures(c, v)                         swGenTextures((c), (v))
 #define glDeleteTextures(c, v)                      swDeleteTextures((c), (v))
-#define glTexImage2D(tr, l, if, w, h, b, f, t, p)   swTexImage2D((w), (h), (f), (t), (p))
+#define glTexImage2D(tr, l, if, w, h, b, f, t, p)   swTexImage2D((l), (w), (h), (f), (t), (p))
 #define glTexParameteri(tr, pname, param)           swTexParameteri((pname), (param))
+#define glGetTexParameteriv(tr, pname, params)      swGetTexParameteriv((pname), (params))
 #define glBindTexture(tr, id)                       swBindTexture((id))
+#define glGenerateMipmap(tr)                        swGenerateMipmap()
+#define glGetTexImage(tr, l, f, t, p)               swGetTexImage((l), (f), (t), (p))
+#define glGenFramebuffers(c, v)                     swGenFramebuffers((c), (v))
+#define glDeleteFramebuffers(c, v)                  swDeleteFramebuffers((c), (v))
+#define glBindFramebuffer(tr, id)                   swBindFramebuffer((id))
+#define glFramebufferTexture2D(tr, a, tt, t, l)     swFramebufferTexture2D((a), (t))
+#define glCheckFramebufferStatus(tr)                swCheckFramebufferStatus()
+#define glGetFramebufferAttachmentParameteriv(tr, a, p, v) swGetFramebufferAttachmentParameteriv((a), (p), (v))
 
 // OpenGL functions NOT IMPLEMENTED by rlsw
 #define glDepthMask(X)                          ((void)(X))
@@ -394,7 +554,6 @@ typedef double              GLclampd;
 #define glFrontFace(X)                          ((void)(X))
 #define glDepthFunc(X)                          ((void)(X))
 #define glTexSubImage2D(X,Y,Z,W,A,B,C,D,E)      ((void)(X),(void)(Y),(void)(Z),(void)(W),(void)(A),(void)(B),(void)(C),(void)(D),(void)(E))
-#define glGetTexImage(X,Y,Z,W,A)                ((void)(X),(void)(Y),(void)(Z),(void)(W),(void)(A))
 #define glNormal3f(X,Y,Z)                       ((void)(X),(void)(Y),(void)(Z))
 #define glNormal3fv(X)                          ((void)(X))
 #define glNormalPointer(X,Y,Z)                  ((void)(X),(void)(Y),(void)(Z))
@@ -407,7 +566,8 @@ typedef enum {
     SW_TEXTURE_2D = GL_TEXTURE_2D,
     SW_DEPTH_TEST = GL_DEPTH_TEST,
     SW_CULL_FACE = GL_CULL_FACE,
-    SW_BLEND = GL_BLEND
+    SW_BLEND = GL_BLEND,
+    SW_MULTISAMPLE = GL_MULTISAMPLE
 } SWstate;
 
 typedef enum {
@@ -484,6 +644,7 @@ typedef enum {
     SW_LUMINANCE_ALPHA = GL_LUMINANCE_ALPHA,
     SW_RGB = GL_RGB,
     SW_RGBA = GL_RGBA,
+    SW_BGRA = GL_BGRA,
 } SWformat;
 
 typedef enum {
@@ -493,12 +654,19 @@ typedef enum {
     SW_SHORT = GL_SHORT,
     SW_UNSIGNED_INT = GL_UNSIGNED_INT,
     SW_INT = GL_INT,
-    SW_FLOAT = GL_FLOAT
+    SW_FLOAT = GL_FLOAT,
+    SW_UNSIGNED_SHORT_5_6_5 = GL_UNSIGNED_SHORT_5_6_5,
+    SW_UNSIGNED_SHORT_5_5_5_1 = GL_UNSIGNED_SHORT_5_5_5_1,
+    SW_UNSIGNED_SHORT_4_4_4_4 = GL_UNSIGNED_SHORT_4_4_4_4
 } SWtype;
 
 typedef enum {
     SW_NEAREST = GL_NEAREST,
-    SW_LINEAR = GL_LINEAR
+    SW_LINEAR = GL_LINEAR,
+    SW_NEAREST_MIPMAP_NEAREST = GL_NEAREST_MIPMAP_NEAREST,
+    SW_LINEAR_MIPMAP_NEAREST = GL_LINEAR_MIPMAP_NEAREST,
+    SW_NEAREST_MIPMAP_LINEAR = GL_NEAREST_MIPMAP_LINEAR,
+    SW_LINEAR_MIPMAP_LINEAR = GL_LINEAR_MIPMAP_LINEAR
 } SWfilter;
 
 typedef enum {
@@ -510,9 +678,27 @@ typedef enum {
     SW_TEXTURE_MIN_FILTER = GL_TEXTURE_MIN_FILTER,
     SW_TEXTURE_MAG_FILTER = GL_TEXTURE_MAG_FILTER,
     SW_TEXTURE_WRAP_S = GL_TEXTURE_WRAP_S,
-    SW_TEXTURE_WRAP_T = GL_TEXTURE_WRAP_T
+    SW_TEXTURE_WRAP_T = GL_TEXTURE_WRAP_T,
+    SW_TEXTURE_MAX_LEVEL = GL_TEXTURE_MAX_LEVEL     // Query only, last level of the generated chain
 } SWtexparam;
 
+typedef enum {
+    SW_COLOR_ATTACHMENT0 = GL_COLOR_ATTACHMENT0,
+    SW_DEPTH_ATTACHMENT = GL_DEPTH_ATTACHMENT
+} SWattachment;
+
+typedef enum {
+    SW_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE = GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE,
+    SW_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME = GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME
+} SWattachget;
+
+typedef enum {
+    SW_FRAMEBUFFER_COMPLETE = GL_FRAMEBUFFER_COMPLETE,
+    SW_FRAMEBUFFER_INCOMPLETE_ATTACHMENT = GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT,
+    SW_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT = GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT,
+    SW_FRAMEBUFFER_UNSUPPORTED = GL_FRAMEBUFFER_UNSUPPORTED
+} SWfbstatus;
+
 typedef enum {
     SW_NO_ERROR = GL_NO_ERROR,
     SW_INVALID_ENUM = GL_INVALID_ENUM,
@@ -522,13 +708,51 @@ typedef enum {
     SW_INVALID_OPERATION = GL_INVALID_OPERATION,
 } SWerrcode;
 
+typedef struct sw_context SWcontext;    // Renderer context, opaque type
+
+// Vertex program, called for each vertex before the fixed function transformations
+// NOTE: Position is in object space (xyzw), it can be modified along with the texcoord and the color (RGBA)
+typedef void (*SWvertexproc)(float *position, float *texcoord, float *color, const void *uniforms);
+
+// Fragment program, called for each fragment in place of the texture modulation
+// NOTE: Color is the interpolated vertex color, to be replaced by the fragment color, texColor is
+// the texel sampled at texcoord (white if texturing is disabled), x and y the fragment coordinates
+typedef void (*SWfragmentproc)(float *color, const float *texColor, const float *texcoord, int x, int y, const void *uniforms);
+
+// Rendering statistics, accumulated since the last reset (SW_ENABLE_STATS)
+// NOTE: With SW_MAX_THREADS > 1, the times are summed over the rasterization threads
+typedef struct {
+    uint64_t drawCalls;             // Array draws and immediate mode primitives batches (swBegin())
+    uint64_t vertices;              // Vertices transformed
+    uint64_t primitives;            // Primitives assembled, after the polygon mode conversion
+    uint64_t primitivesCulled;      // Primitives discarded by face culling
+    uint64_t primitivesClipped;     // Primitives discarded by clipping, entirely outside
+    uint64_t primitivesAffine;      // Triangles and quads rasterized without perspective division (constant w)
+    uint64_t pixelsShaded;          // Fragments written to the color buffer
+    uint64_t pixelsDepthRejected;   // Fragments failing the depth test (hierarchical rejections not included)
+    uint64_t texelsFetched;         // Texels read by texture sampling
+    double clearTime;               // Time spent clearing, in milliseconds
+    double rasterTime;              // Time spent rasterizing primitives, in milliseconds
+    double copyTime;                // Time spent copying the framebuffer, in milliseconds
+} SWstats;
+
 //------------------------------------------------------------------------------------
 // Functions Declaration - Public API
 //------------------------------------------------------------------------------------
 SWAPI bool swInit(int w, int h);
 SWAPI void swClose(void);
 
+SWAPI SWcontext *swCreateContext(int w, int h);
+SWAPI void swDestroyContext(SWcontext *ctx);
+SWAPI void swMakeContextCurrent(SWcontext *ctx);
+SWAPI SWcontext *swGetCurrentContext(void);
+
 SWAPI bool swResizeFramebuffer(int w, int h);
+SWAPI bool swSetFramebufferMemory(void *pixels, int w, int h, int stride, SWformat format, SWtype type);
+SWAPI void *swGetFramebufferMemory(void);
+SWAPI bool swGetDirtyRect(int *x, int *y, int *w, int *h, bool reset);
+SWAPI bool swGetStats(SWstats *stats, bool reset);
+SWAPI void swFinish(void);
 SWAPI void swCopyFramebuffer(int x, int y, int w, int h, SWformat format, SWtype type, void *pixels);
 SWAPI void swBlitFramebuffer(int xDst, int yDst, int wDst, int hDst, int xSrc, int ySrc, int wSrc, int hSrc, SWformat format, SWtype type, void *pixels);
 
@@ -553,6 +777,9 @@ SWAPI void swCullFace(SWface face);
 SWAPI void swPointSize(float size);
 SWAPI void swLineWidth(float width);
 
+SWAPI void swUseProgram(SWvertexproc vertexProc, SWfragmentproc fragmentProc);
+SWAPI void swProgramUniforms(const void *data, int size);
+
 SWAPI void swMatrixMode(SWmatrix mode);
 SWAPI void swPushMatrix(void);
 SWAPI void swPopMatrix(void);
@@ -592,13 +819,25 @@ SWAPI void swTexCoord2fv(const float *v);
 SWAPI void swBindArray(SWarray type, void *buffer);
 SWAPI void swDrawArrays(SWdraw mode, int offset, int count);
 SWAPI void swDrawElements(SWdraw mode, int count, int type, const void *indices);
+SWAPI void swDrawArraysInstanced(SWdraw mode, int offset, int count, int instances, const float *matrices);
+SWAPI void swDrawElementsInstanced(SWdraw mode, int count, int type, const void *indices, int instances, const float *matrices);
 
 SWAPI void swGenTextures(int count, uint32_t *textures);
 SWAPI void swDeleteTextures(int count, uint32_t *textures);
 
-SWAPI void swTexImage2D(int width, int height, SWformat format, SWtype type, const void *data);
+SWAPI void swTexImage2D(int level, int width, int height, SWformat format, SWtype type, const void *data);
 SWAPI void swTexParameteri(int param, int value);
+SWAPI void swGetTexParameteriv(int param, int *value);
 SWAPI void swBindTexture(uint32_t id);
+SWAPI void swGenerateMipmap(void);
+SWAPI void swGetTexImage(int level, SWformat format, SWtype type, void *pixels);
+
+SWAPI void swGenFramebuffers(int count, uint32_t *framebuffers);
+SWAPI void swDeleteFramebuffers(int count, uint32_t *framebuffers);
+SWAPI void swBindFramebuffer(uint32_t id);
+SWAPI void swFramebufferTexture2D(SWattachment attachment, uint32_t texture);
+SWAPI SWfbstatus swCheckFramebufferStatus(void);
+SWAPI void swGetFramebufferAttachmentParameteriv(SWattachment attachment, SWattachget pname, int *v);
 
 #endif // RLSW_H
 
@@ -612,7 +851,9 @@ SWAPI void swBindTexture(uint32_t id);
 
 #include <stdlib.h>         // Required for: malloc(), free()
 #include <stddef.h>         // Required for: NULL, size_t, uint8_t, uint16_t, uint32_t...
+#include <string.h>         // Required for: memset(), memcmp()
 #include <math.h>           // Required for: sinf(), cosf(), floorf(), fabsf(), sqrtf(), roundf()
+#include <float.h>          // Required for: FLT_MAX
 
 // Simple log system to avoid printf() calls if required
 // NOTE: Avoiding those calls, also avoids const strings memory usage
@@ -624,6 +865,19 @@ SWAPI void swBindTexture(uint32_t id);
     #define SW_LOG(...)
 #endif
 
+// NOTE: Default TLS model, the library can be loaded with dlopen() by bindings
+#if defined(_MSC_VER)
+    #define SW_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__)
+    #define SW_THREAD_LOCAL __thread
+#elif defined(__cplusplus) && (__cplusplus >= 201103L)
+    #define SW_THREAD_LOCAL thread_local
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+    #define SW_THREAD_LOCAL _Thread_local
+#else
+    #define SW_THREAD_LOCAL // Current context shared by all threads if not available
+#endif
+
 #if defined(_MSC_VER)
     #define SW_ALIGN(x) __declspec(align(x))
 #elif defined(__GNUC__) || defined(__clang__)
@@ -703,6 +957,34 @@ SWAPI void swBindTexture(uint32_t id);
     #define SW_CURLY_INIT(name) (name)
 #endif
 
+#if (SW_MAX_THREADS > 1)
+    // Threads management for the rasterization worker pool
+    // NOTE: On Windows, MSVC provides C11 threads, MinGW-w64 provides pthreads (winpthreads)
+    #if defined(_MSC_VER)
+        #include <threads.h>    // Required for: thrd_create(), mtx_lock(), cnd_wait()...
+    #else
+        #include <pthread.h>    // Required for: pthread_create(), pthread_mutex_lock(), pthread_cond_wait()...
+    #endif
+#endif
+
+#if SW_ENABLE_STATS
+    #include <time.h>           // Required for: clock_gettime(), timespec_get(), clock()
+
+    #if defined(_WIN32)
+        // Functions required to query a monotonic time on Windows, windows.h is not included
+        // NOTE: LARGE_INTEGER is an union of 64-bit values, left incomplete here
+        #if defined(__cplusplus)
+        extern "C" {
+        #endif
+        union _LARGE_INTEGER;
+        __declspec(dllimport) int __stdcall QueryPerformanceCounter(union _LARGE_INTEGER *lpPerformanceCount);
+        __declspec(dllimport) int __stdcall QueryPerformanceFrequency(union _LARGE_INTEGER *lpFrequency);
+        #if defined(__cplusplus)
+        }
+        #endif
+    #endif
+#endif
+
 //----------------------------------------------------------------------------------
 // Defines and Macros
 //----------------------------------------------------------------------------------
@@ -713,18 +995,12 @@ SWAPI void swBindTexture(uint32_t id);
 
 #define SW_COLOR_PIXEL_SIZE     (SW_COLOR_BUFFER_BITS >> 3)
 #define SW_DEPTH_PIXEL_SIZE     (SW_DEPTH_BUFFER_BITS >> 3)
-#define SW_PIXEL_SIZE           (SW_COLOR_PIXEL_SIZE + SW_DEPTH_PIXEL_SIZE)
-
-#if (SW_PIXEL_SIZE <= 4)
-    #define SW_PIXEL_ALIGNMENT 4
-#else // if (SW_PIXEL_SIZE <= 8)
-    #define SW_PIXEL_ALIGNMENT 8
-#endif
 
 #if (SW_COLOR_BUFFER_BITS == 8)
     #define SW_COLOR_TYPE       uint8_t
     #define SW_COLOR_IS_PACKED  1
     #define SW_COLOR_PACK_COMP  1
+    #define SW_COLOR_ALIGN      1
     #define SW_PACK_COLOR(r,g,b) ((((uint8_t)((r)*7+0.5f))&0x07)<<5 | (((uint8_t)((g)*7+0.5f))&0x07)<<2 | ((uint8_t)((b)*3+0.5f))&0x03)
     #define SW_UNPACK_R(p)      (((p)>>5)&0x07)
     #define SW_UNPACK_G(p)      (((p)>>2)&0x07)
@@ -739,6 +1015,7 @@ SWAPI void swBindTexture(uint32_t id);
     #define SW_COLOR_TYPE       uint16_t
     #define SW_COLOR_IS_PACKED  1
     #define SW_COLOR_PACK_COMP  1
+    #define SW_COLOR_ALIGN      2
     #define SW_PACK_COLOR(r,g,b) ((((uint16_t)((r)*31+0.5f))&0x1F)<<11 | (((uint16_t)((g)*63+0.5f))&0x3F)<<5 | ((uint16_t)((b)*31+0.5f))&0x1F)
     #define SW_UNPACK_R(p)      (((p)>>11)&0x1F)
     #define SW_UNPACK_G(p)      (((p)>>5)&0x3F)
@@ -753,6 +1030,7 @@ SWAPI void swBindTexture(uint32_t id);
     #define SW_COLOR_TYPE       uint8_t
     #define SW_COLOR_IS_PACKED  0
     #define SW_COLOR_PACK_COMP  4
+    #define SW_COLOR_ALIGN      4   // Also with 24 bits, stored as 4 components
 #endif
 
 #if (SW_DEPTH_BUFFER_BITS == 16)
@@ -783,6 +1061,12 @@ SWAPI void swBindTexture(uint32_t id);
     #define SW_UNPACK_DEPTH(p)  (p)
 #endif
 
+#define SW_TILE_COLOR_PENDING   (1 << 0)    // Color clear deferred, the pixels are not written yet
+#define SW_TILE_DEPTH_PENDING   (1 << 1)    // Depth clear deferred, the pixels are not written yet
+#define SW_TILE_COLOR_CLEAN     (1 << 2)    // Color holds the tile clear color, not drawn since cleared
+#define SW_TILE_DEPTH_CLEAN     (1 << 3)    // Depth holds the tile clear depth, not drawn since cleared
+#define SW_TILE_DIRTY           (1 << 4)    // Tile changed since the last dirty rectangle reset
+
 #define SW_STATE_CHECK(flags)   (SW_STATE_CHECK_EX(RLSW.stateFlags, (flags)))
 #define SW_STATE_CHECK_EX(state, flags) (((state) & (flags)) == (flags))
 
@@ -791,6 +1075,20 @@ SWAPI void swBindTexture(uint32_t id);
 #define SW_STATE_DEPTH_TEST     (1 << 2)
 #define SW_STATE_CULL_FACE      (1 << 3)
 #define SW_STATE_BLEND          (1 << 4)
+#define SW_STATE_MULTISAMPLE    (1 << 5)
+
+#define SW_MAX_TEXTURE_LEVELS   16          // Mipmap levels, base level up to 32768x32768
+
+#define SW_MSAA_SAMPLES         4           // Samples per pixel of the multisampled framebuffer
+#define SW_MSAA_SAMPLE_MASK     0xF         // Coverage mask of all the samples of a pixel
+
+#if SW_ENABLE_STATS
+    #define SW_STATS_ADD(field, n)              (RLSW.stats.field += (n))
+    #define SW_RASTER_STATS_ADD(r, field, n)    ((r)->stats->field += (n))
+#else
+    #define SW_STATS_ADD(field, n)              ((void)(n))
+    #define SW_RASTER_STATS_ADD(r, field, n)    ((void)(n))
+#endif
 
 //----------------------------------------------------------------------------------
 // Module Types and Structures Definition
@@ -820,6 +1118,16 @@ typedef void (*sw_factor_f)(
     const float *SW_RESTRICT dst
 );
 
+// Blend functions with a fixed-point implementation for 8-bit color buffers
+typedef enum {
+    SW_BLEND_GENERIC = 0,               // Any other factors, blended in floating point
+    SW_BLEND_ALPHA,                     // SW_SRC_ALPHA, SW_ONE_MINUS_SRC_ALPHA
+    SW_BLEND_ADDITIVE,                  // SW_SRC_ALPHA, SW_ONE
+    SW_BLEND_MULTIPLIED,                // SW_DST_COLOR, SW_ONE_MINUS_SRC_ALPHA
+    SW_BLEND_ADD_COLORS,                // SW_ONE, SW_ONE
+    SW_BLEND_ALPHA_PREMULTIPLY,         // SW_ONE, SW_ONE_MINUS_SRC_ALPHA
+} sw_blend_mode_t;
+
 typedef float sw_matrix_t[4*4];
 typedef uint16_t sw_half_t;
 
@@ -833,10 +1141,28 @@ typedef struct {
 } sw_vertex_t;
 
 typedef struct {
-    uint8_t *pixels;            // Texture pixels (RGBA32)
+    uint8_t *pixels;            // Level pixels (texture storage format)
 
-    int width, height;          // Dimensions of the texture
+    int width, height;          // Dimensions of the level
     int wMinus1, hMinus1;       // Dimensions minus one
+    int tilesX;                 // Number of 4x4 texel tiles per row (0 if stored by rows)
+
+    float tx;                   // Texel width
+    float ty;                   // Texel height
+} sw_texture_level_t;
+
+typedef void (*sw_texture_fetch_f)(
+    float *SW_RESTRICT color,
+    const sw_texture_level_t *SW_RESTRICT level,
+    int x, int y
+);
+
+typedef struct {
+    sw_texture_level_t levels[SW_MAX_TEXTURE_LEVELS]; // Mipmap chain, level 0 is the base level
+    int levelCount;             // Number of complete levels in the chain
+
+    sw_pixelformat_t format;    // Storage format of the levels pixels
+    sw_texture_fetch_f fetch;   // Texel fetch function for the storage format
 
     SWfilter minFilter;         // Minification filter
     SWfilter magFilter;         // Magnification filter
@@ -844,28 +1170,176 @@ typedef struct {
     SWwrap sWrap;               // texcoord.x wrap mode
     SWwrap tWrap;               // texcoord.y wrap mode
 
-    float tx;                   // Texel width
-    float ty;                   // Texel height
+    uint32_t resolveFramebuffer; // Framebuffer object to copy from before sampling (0 if up to date)
 } sw_texture_t;
 
-// Pixel data type
-typedef SW_ALIGN(SW_PIXEL_ALIGNMENT) struct {
+// Color buffer pixel data type
+typedef SW_ALIGN(SW_COLOR_ALIGN) struct {
     SW_COLOR_TYPE color[SW_COLOR_PACK_COMP];
+} sw_color_t;
+
+// Depth buffer pixel data type
+typedef struct {
     SW_DEPTH_TYPE depth[SW_DEPTH_PACK_COMP];
-#if (SW_PIXEL_SIZE % SW_PIXEL_ALIGNMENT != 0)
-    uint8_t padding[SW_PIXEL_ALIGNMENT - SW_PIXEL_SIZE % SW_PIXEL_ALIGNMENT];
-#endif
+} sw_depth_t;
+
+// Pixel value, color and depth (clear values)
+typedef struct {
+    sw_color_t color;
+    sw_depth_t depth;
 } sw_pixel_t;
 
+// Depth bounds and deferred clear state of a framebuffer tile
+// NOTE: Bounds are conservative, all the depth values of the tile are between them
+typedef struct {
+    float zMin;
+    float zMax;
+    sw_color_t clearColor;          // Clear color the tile holds, written or pending
+    sw_depth_t clearDepth;          // Clear depth the tile holds, written or pending
+    uint8_t clearState;             // Tile clear state flags, SW_TILE_*
+} sw_depth_tile_t;
+
+// Framebuffer, color and depth are stored in separate planes
+// NOTE: The color plane can be user memory (see swSetFramebufferMemory()), with its own
+// row stride and channel order, the depth plane is always owned and tightly packed
 typedef struct {
-    sw_pixel_t *pixels;
+    sw_color_t *colors;             // Color plane
+    sw_depth_t *depths;             // Depth plane
     int width;
     int height;
-    int allocSz;
+    int colorStride;                // Color plane row stride, in pixels
+    int colorAllocSz;               // Owned color plane allocated pixels (0 if user memory)
+    int allocSz;                    // Depth plane allocated pixels
+    bool userColors;                // Color plane is user memory, not owned
+    bool bgra;                      // Color plane channel order is BGRA (32 bit color buffers only)
+
+    sw_depth_tile_t *depthTiles;    // Depth bounds of the framebuffer tiles
+    int depthTilesX;                // Number of depth tiles per row
+    int depthTilesY;                // Number of depth tiles per column
+    int depthTilesAllocSz;
+
+    sw_color_t *sampleColors;       // Multisample color plane, SW_MSAA_SAMPLES - 1 colors per pixel (NULL if not multisampled)
+    sw_depth_t *sampleDepths;       // Multisample depth plane, SW_MSAA_SAMPLES - 1 depths per pixel
+    int sampleAllocSz;              // Multisample planes allocated pixels
 } sw_framebuffer_t;
 
+// Framebuffer object
+// NOTE: Rendering happens in its own storage, in the framebuffer pixel format,
+// attached textures receive a copy of it when they are next bound (resolve)
+typedef struct {
+    sw_framebuffer_t storage;   // Color and depth pixels, swapped with the current framebuffer while bound
+    uint32_t colorTexture;      // Color attachment texture id (0 if none)
+    uint32_t depthTexture;      // Depth attachment texture id (0 if none)
+    bool used;                  // Framebuffer object id is generated
+} sw_fbo_t;
+
+// Raster state, everything the raster functions need apart from the vertices
+// NOTE: It is captured when a primitive is submitted, so its rasterization can be deferred
+typedef struct {
+    const sw_texture_t *texture;    // Texture sampled by textured primitives
+    sw_factor_f srcFactorFunc;      // Blend source factor function
+    sw_factor_f dstFactorFunc;      // Blend destination factor function
+    sw_blend_mode_t blendMode;      // Blend fixed-point kernel, generic if none
+    float lineWidth;                // Rasterized line width
+    float pointRadius;              // Rasterized point radius
+    int clipMin[2];                 // Clip rectangle minimum point, limits polygons, points and clears (inclusive)
+    int clipMax[2];                 // Clip rectangle maximum point, limits polygons, points and clears (exclusive)
+    sw_pixel_t clearValue;          // Clear value, clears only
+    uint32_t flags;                 // Resolved state flags, checked by the fragment program raster functions
+    SWfragmentproc fragmentProc;    // Fragment program, NULL for the fixed function
+    const void *uniforms;           // Programs uniforms block
+} sw_raster_state_t;
+
+// Raster target, destination pixels and the region that can be written
+typedef struct {
+    sw_color_t *colors;             // Framebuffer color plane
+    sw_depth_t *depths;             // Framebuffer depth plane
+    int colorStride;                // Color plane row stride, in pixels
+    int width;                      // Framebuffer width (depth plane row stride)
+    bool bgra;                      // Color plane channel order is BGRA
+    int xMin, yMin;                 // Writable region minimum point (inclusive)
+    int xMax, yMax;                 // Writable region maximum point (exclusive)
+    sw_depth_tile_t *depthTiles;    // Framebuffer depth tiles
+    int depthTilesX;                // Number of depth tiles per row
+    sw_color_t *sampleColors;       // Framebuffer multisample color plane (NULL if not multisampled)
+    sw_depth_t *sampleDepths;       // Framebuffer multisample depth plane
+    const sw_raster_state_t *state; // Raster state of the primitive being rasterized
+#if SW_ENABLE_STATS
+    SWstats *stats;                 // Statistics updated by the rasterization (per thread)
+#endif
+} sw_raster_t;
+
+// Raster command types
+typedef enum {
+    SW_RASTER_POLYGON = 0,          // Convex polygon, rasterized as a triangle fan
+    SW_RASTER_QUAD_AXIS_ALIGNED,    // Screen aligned quad, sorted at rasterization
+    SW_RASTER_QUAD_AFFINE,          // Parallelogram quad with constant w, attributes linear in screen space
+    SW_RASTER_LINE,                 // Line, 2 vertices
+    SW_RASTER_POINT,                // Point, 1 vertex
+    SW_RASTER_CLEAR                 // Clear of the state clip rectangle, no vertices
+} sw_raster_type_t;
+
+#if (SW_MAX_THREADS > 1)
+#if defined(_MSC_VER)
+    typedef thrd_t sw_thread_t;
+    typedef mtx_t sw_mutex_t;
+    typedef cnd_t sw_cond_t;
+#else
+    typedef pthread_t sw_thread_t;
+    typedef pthread_mutex_t sw_mutex_t;
+    typedef pthread_cond_t sw_cond_t;
+#endif
+
+// Binned raster command
 typedef struct {
-    sw_framebuffer_t framebuffer;   // Main framebuffer
+    uint8_t type;                   // Raster command type (sw_raster_type_t)
+    uint16_t flags;                 // Resolved state flags (primitives) or buffer bits (clears)
+    uint16_t vertexCount;           // Number of vertices of the command
+    uint32_t vertexOffset;          // First vertex in the vertices pool
+    uint32_t stateIndex;            // Raster state in the states pool
+} sw_command_t;
+
+// Screen tile bin, commands overlapping the tile in submission order
+typedef struct {
+    uint32_t *commands;
+    int count;
+    int capacity;
+} sw_bin_t;
+
+// Sort-middle binner and rasterization worker pool
+typedef struct {
+    sw_command_t *commands;         // Commands pool
+    int commandCount;
+    int commandCapacity;
+
+    sw_vertex_t *vertices;          // Vertices pool (screen space)
+    int vertexCount;
+    int vertexCapacity;
+
+    sw_raster_state_t *states;      // Raster states pool
+    int stateCount;
+    int stateCapacity;
+
+    sw_bin_t *bins;                 // Screen tiles bins
+    int binCapacity;
+    int tilesX, tilesY;
+
+    sw_thread_t threads[SW_MAX_THREADS - 1]; // Worker threads, the calling thread also rasterizes
+    int threadCount;
+
+    sw_mutex_t mutex;
+    sw_cond_t wakeCond;             // Signaled when a flush starts, or on shutdown
+    sw_cond_t doneCond;             // Signaled when the last worker finishes its tiles
+    uint32_t generation;            // Flush counter, workers wait for it to change
+    int nextTile;                   // Next tile to rasterize in the current flush
+    int pendingWorkers;             // Workers still rasterizing in the current flush
+    bool shutdown;                  // Workers must exit
+    bool initialized;               // Synchronization objects are initialized
+} sw_binner_t;
+#endif
+
+typedef struct sw_context {
+    sw_framebuffer_t framebuffer;   // Current framebuffer, the main one or the bound framebuffer object storage
     sw_pixel_t clearValue;          // Clear value of the framebuffer
 
     float vpCenter[2];              // Viewport center
@@ -895,6 +1369,14 @@ typedef struct {
     sw_vertex_t vertexBuffer[SW_MAX_CLIPPED_POLYGON_VERTICES];  // Buffer used for storing primitive vertices, used for processing and rendering
     int vertexCounter;                                          // Number of vertices in 'ctx.vertexBuffer'
 
+    sw_vertex_t vertexCache[SW_VERTEX_CACHE_SIZE];              // Vertices transformed from the arrays, before primitive assembly
+    uint32_t vertexCacheIndex[SW_VERTEX_CACHE_SIZE];            // Vertex index stored in each cache entry (elements drawing)
+    uint32_t vertexCacheDraw[SW_VERTEX_CACHE_SIZE];             // Draw call that stored each cache entry (elements drawing)
+    uint32_t vertexCacheDrawCounter;                            // Current elements draw call, invalidates the cache when incremented
+
+    sw_vertex_t *instanceVertices;                              // Vertices fetched once for all the instances of a draw (object space)
+    int instanceVertexCapacity;
+
     SWdraw drawMode;                                            // Current primitive mode (e.g., lines, triangles)
     SWpoly polyMode;                                            // Current polygon filling mode (e.g., lines, triangles)
     int reqVertices;                                            // Number of vertices required for the primitive being drawn
@@ -917,8 +1399,14 @@ typedef struct {
 
     sw_factor_f srcFactorFunc;
     sw_factor_f dstFactorFunc;
+    sw_blend_mode_t blendMode;
 
     SWface cullFace;                                            // Faces to cull
+
+    SWvertexproc vertexProc;                                    // Vertex program, NULL for the fixed function
+    SWfragmentproc fragmentProc;                                // Fragment program, NULL for the fixed function
+    SW_ALIGN(16) uint8_t programUniforms[SW_MAX_PROGRAM_UNIFORMS]; // Uniforms block shared by the programs
+
     SWerrcode errCode;                                          // Last error code
 
     sw_texture_t *loadedTextures;
@@ -927,13 +1415,34 @@ typedef struct {
     uint32_t *freeTextureIds;
     int freeTextureIdCount;
 
+    sw_framebuffer_t mainFramebuffer;                           // Main framebuffer, stored while a framebuffer object is bound
+    uint32_t currentFramebuffer;                                // Bound framebuffer object, 0 for the main framebuffer
+
+    sw_fbo_t *loadedFramebuffers;
+    int loadedFramebufferCount;
+
+    uint32_t *freeFramebufferIds;
+    int freeFramebufferIdCount;
+
     uint32_t stateFlags;
+
+#if SW_ENABLE_STATS
+    SWstats stats;                                              // Rendering statistics since the last reset
+#endif
+
+#if (SW_MAX_THREADS > 1)
+    sw_binner_t binner;                                         // Primitives binner and rasterization threads
+#endif
 } sw_context_t;
 
 //----------------------------------------------------------------------------------
 // Global Variables Definition
 //----------------------------------------------------------------------------------
-static sw_context_t RLSW = { 0 };
+static sw_context_t swDefaultContext = { 0 };                              // Context used by swInit()/swClose()
+static SW_THREAD_LOCAL sw_context_t *swCurrentContext = &swDefaultContext;  // Current context of the calling thread
+
+// NOTE: All the functions work on the calling thread current context
+#define RLSW (*swCurrentContext)
 
 //----------------------------------------------------------------------------------
 // Module Functions Declaration
@@ -1005,6 +1514,18 @@ static inline float sw_fract(float x)
     return (x - floorf(x));
 }
 
+static inline float sw_log2(float x)
+{
+    // Fast approximation, exponent plus a quadratic fit of the mantissa
+    union { float f; uint32_t u; } fb;
+    fb.f = x;
+
+    float e = (float)((int)((fb.u >> 23) & 0xFF) - 128);
+    fb.u = (fb.u & 0x007FFFFF) | 0x3F800000; // Mantissa in [1.0f, 2.0f)
+
+    return e + (-0.34484843f*fb.f + 2.02466578f)*fb.f - 0.67487759f;
+}
+
 static inline int sw_clampi(int v, int min, int max)
 {
     if (v < min) return min;
@@ -1012,6 +1533,16 @@ static inline int sw_clampi(int v, int min, int max)
     return v;
 }
 
+static inline int sw_mini(int a, int b)
+{
+    return (a < b)? a : b;
+}
+
+static inline int sw_maxi(int a, int b)
+{
+    return (a > b)? a : b;
+}
+
 static inline void sw_lerp_vertex_PTCH(sw_vertex_t *SW_RESTRICT out, const sw_vertex_t *SW_RESTRICT a, const sw_vertex_t *SW_RESTRICT b, float t)
 {
     const float tInv = 1.0f - t;
@@ -1117,6 +1648,50 @@ static inline void sw_add_vertex_grad_scaled_PTCH(
     out->homogeneous[3] += gradients->homogeneous[3]*scale;
 }
 
+// Checks if two projected vertices share the same w, stored as its reciprocal
+static inline bool sw_vertex_same_w(const sw_vertex_t *a, const sw_vertex_t *b)
+{
+    return (fabsf(b->homogeneous[3] - a->homogeneous[3]) <= 1e-6f*fabsf(a->homogeneous[3]));
+}
+
+// Checks if the w of projected vertices is constant, their attributes are then linear in screen space
+static inline bool sw_vertices_are_affine(const sw_vertex_t *vertices, int count)
+{
+    for (int i = 1; i < count; i++)
+    {
+        if (!sw_vertex_same_w(&vertices[0], &vertices[i])) return false;
+    }
+
+    return true;
+}
+
+// Gets the vertices of a triangle with a constant w as affine ones, attributes no longer divided by w
+// and a unit w, interpolated without perspective division; copies are made only when w is not one
+static inline bool sw_triangle_get_affine(sw_vertex_t copies[3], const sw_vertex_t *v[3])
+{
+    if (!sw_vertex_same_w(v[0], v[1]) || !sw_vertex_same_w(v[0], v[2])) return false;
+
+    if ((v[0]->homogeneous[3] == 1.0f) && (v[1]->homogeneous[3] == 1.0f) && (v[2]->homogeneous[3] == 1.0f)) return true;
+
+    for (int i = 0; i < 3; i++)
+    {
+        float w = 1.0f/v[i]->homogeneous[3];
+
+        copies[i] = *v[i];
+        copies[i].homogeneous[3] = 1.0f;
+        copies[i].texcoord[0] *= w;
+        copies[i].texcoord[1] *= w;
+        copies[i].color[0] *= w;
+        copies[i].color[1] *= w;
+        copies[i].color[2] *= w;
+        copies[i].color[3] *= w;
+
+        v[i] = &copies[i];
+    }
+
+    return true;
+}
+
 static inline void sw_float_to_unorm8_simd(uint8_t dst[4], const float src[4])
 {
 #if defined(SW_HAS_NEON)
@@ -1212,6 +1787,38 @@ static inline void sw_float_from_unorm8_simd(float dst[4], const uint8_t src[4])
 #endif
 }
 
+// Transforms a point (w = 1) by a column-major matrix
+static inline void sw_vec4_transform_point_simd(float dst[4], const sw_matrix_t m, const float src[3])
+{
+#if defined(SW_HAS_NEON)
+    float32x4_t result = vmulq_n_f32(vld1q_f32(&m[0]), src[0]);
+    result = vaddq_f32(result, vmulq_n_f32(vld1q_f32(&m[4]), src[1]));
+    result = vaddq_f32(result, vmulq_n_f32(vld1q_f32(&m[8]), src[2]));
+    result = vaddq_f32(result, vld1q_f32(&m[12]));
+    vst1q_f32(dst, result);
+#elif defined(SW_HAS_SSE) || defined(SW_HAS_SSE2) || defined(SW_HAS_SSE3) || defined(SW_HAS_SSSE3) || defined(SW_HAS_SSE41) || defined(SW_HAS_SSE42)
+    __m128 result = _mm_mul_ps(_mm_loadu_ps(&m[0]), _mm_set1_ps(src[0]));
+    result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(&m[4]), _mm_set1_ps(src[1])));
+    result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(&m[8]), _mm_set1_ps(src[2])));
+    result = _mm_add_ps(result, _mm_loadu_ps(&m[12]));
+    _mm_storeu_ps(dst, result);
+#else
+    dst[0] = m[0]*src[0] + m[4]*src[1] + m[8]*src[2] + m[12];
+    dst[1] = m[1]*src[0] + m[5]*src[1] + m[9]*src[2] + m[13];
+    dst[2] = m[2]*src[0] + m[6]*src[1] + m[10]*src[2] + m[14];
+    dst[3] = m[3]*src[0] + m[7]*src[1] + m[11]*src[2] + m[15];
+#endif
+}
+
+// Transforms a vector by a column-major matrix
+static inline void sw_vec4_transform(float dst[4], const sw_matrix_t m, const float v[4])
+{
+    dst[0] = m[0]*v[0] + m[4]*v[1] + m[8]*v[2] + m[12]*v[3];
+    dst[1] = m[1]*v[0] + m[5]*v[1] + m[9]*v[2] + m[13]*v[3];
+    dst[2] = m[2]*v[0] + m[6]*v[1] + m[10]*v[2] + m[14]*v[3];
+    dst[3] = m[3]*v[0] + m[7]*v[1] + m[11]*v[2] + m[15]*v[3];
+}
+
 // Half conversion functions
 static inline uint32_t sw_half_to_float_ui(uint16_t h)
 {
@@ -1267,203 +1874,469 @@ static inline sw_half_t sw_half_from_float(float i)
 
 // Framebuffer management functions
 //-------------------------------------------------------------------------------------------
-static inline bool sw_framebuffer_load(int w, int h)
+static inline void sw_framebuffer_set_depth_tiles(sw_framebuffer_t *fb, float zMin, float zMax)
 {
-    int size = w*h;
+    int count = fb->depthTilesX*fb->depthTilesY;
 
-    RLSW.framebuffer.pixels = SW_MALLOC(sizeof(sw_pixel_t)*size);
-    if (RLSW.framebuffer.pixels == NULL) return false;
-
-    RLSW.framebuffer.width = w;
-    RLSW.framebuffer.height = h;
-    RLSW.framebuffer.allocSz = size;
-
-    return true;
+    for (int i = 0; i < count; i++)
+    {
+        fb->depthTiles[i].zMin = zMin;
+        fb->depthTiles[i].zMax = zMax;
+    }
 }
 
-static inline bool sw_framebuffer_resize(int w, int h)
+static inline void sw_framebuffer_fill_color(const sw_raster_t *r, sw_color_t color)
 {
-    int newSize = w*h;
-
-    if (newSize <= RLSW.framebuffer.allocSz)
+#if !SW_COLOR_IS_PACKED
+    // Color plane in BGRA order
+    if (r->bgra)
     {
-        RLSW.framebuffer.width = w;
-        RLSW.framebuffer.height = h;
-        return true;
+        SW_COLOR_TYPE tmp = color.color[0];
+        color.color[0] = color.color[2];
+        color.color[2] = tmp;
     }
+#endif
 
-    void *newPixels = SW_REALLOC(RLSW.framebuffer.pixels, sizeof(sw_pixel_t)*newSize);
-    if (newPixels == NULL) return false;
-
-    RLSW.framebuffer.pixels = newPixels;
+    for (int y = r->yMin; y < r->yMax; y++)
+    {
+        sw_color_t *row = r->colors + y*r->colorStride + r->xMin;
+        for (int x = r->xMin; x < r->xMax; x++, row++) *row = color;
+    }
 
-    RLSW.framebuffer.width = w;
-    RLSW.framebuffer.height = h;
-    RLSW.framebuffer.allocSz = newSize;
+    // NOTE: Multisampled color planes are never user memory, their order is always RGBA
+    if (r->sampleColors == NULL) return;
 
-    return true;
+    const int count = (r->xMax - r->xMin)*(SW_MSAA_SAMPLES - 1);
+    for (int y = r->yMin; y < r->yMax; y++)
+    {
+        sw_color_t *row = r->sampleColors + (y*r->width + r->xMin)*(SW_MSAA_SAMPLES - 1);
+        for (int i = 0; i < count; i++) row[i] = color;
+    }
 }
 
-static inline void sw_framebuffer_read_color(float dst[4], const sw_pixel_t *src)
+static inline void sw_framebuffer_fill_depth(const sw_raster_t *r, sw_depth_t depth)
 {
-#if SW_COLOR_IS_PACKED
-    SW_COLOR_TYPE pixel = src->color[0];
-    dst[0] = SW_TO_FLOAT_R(SW_UNPACK_R(pixel));
-    dst[1] = SW_TO_FLOAT_G(SW_UNPACK_G(pixel));
-    dst[2] = SW_TO_FLOAT_B(SW_UNPACK_B(pixel));
-    dst[3] = 1.0f;
-#else
-    sw_float_from_unorm8_simd(dst, src->color);
-#endif
+    for (int y = r->yMin; y < r->yMax; y++)
+    {
+        sw_depth_t *row = r->depths + y*r->width + r->xMin;
+        for (int x = r->xMin; x < r->xMax; x++, row++) *row = depth;
+    }
+
+    if (r->sampleDepths == NULL) return;
+
+    const int count = (r->xMax - r->xMin)*(SW_MSAA_SAMPLES - 1);
+    for (int y = r->yMin; y < r->yMax; y++)
+    {
+        sw_depth_t *row = r->sampleDepths + (y*r->width + r->xMin)*(SW_MSAA_SAMPLES - 1);
+        for (int i = 0; i < count; i++) row[i] = depth;
+    }
 }
 
-static inline void sw_framebuffer_read_color8(uint8_t dst[4], const sw_pixel_t *src)
+static inline void sw_framebuffer_get_raster(const sw_framebuffer_t *fb, sw_raster_t *r)
 {
-#if SW_COLOR_IS_PACKED
-    SW_COLOR_TYPE pixel = src->color[0];
-    dst[0] = SW_SCALE_R(SW_UNPACK_R(pixel));
-    dst[1] = SW_SCALE_G(SW_UNPACK_G(pixel));
-    dst[2] = SW_SCALE_B(SW_UNPACK_B(pixel));
-    dst[3] = 255;
-#else
-    const SW_COLOR_TYPE *p = src->color;
-    dst[0] = p[0];
-    dst[1] = p[1];
-    dst[2] = p[2];
-    dst[3] = p[3];
-#endif
+    *r = SW_CURLY_INIT(sw_raster_t) { 0 };
+    r->colors = fb->colors;
+    r->depths = fb->depths;
+    r->colorStride = fb->colorStride;
+    r->width = fb->width;
+    r->bgra = fb->bgra;
+    r->depthTiles = fb->depthTiles;
+    r->depthTilesX = fb->depthTilesX;
+    r->sampleColors = fb->sampleColors;
+    r->sampleDepths = fb->sampleDepths;
+    r->xMax = fb->width;
+    r->yMax = fb->height;
 }
 
-static inline float sw_framebuffer_read_depth(const sw_pixel_t *src)
+// Writes the deferred clears of a tile, limited to the raster region
+// NOTE: Clears covering whole tiles only record the clear values in them, the pixels are written
+// when a primitive first touches the tile or when the framebuffer is read, and the tiles already
+// holding the clear values are neither written again nor marked as dirty
+static inline void sw_depth_tile_resolve(const sw_raster_t *r, sw_depth_tile_t *tile, int tx, int ty)
 {
-#if SW_DEPTH_IS_PACKED
-    return src->depth[0]*SW_DEPTH_SCALE;
-#else
-    return SW_UNPACK_DEPTH(src->depth)*SW_DEPTH_SCALE;
-#endif
+    if (!(tile->clearState & (SW_TILE_COLOR_PENDING | SW_TILE_DEPTH_PENDING))) return;
+
+    sw_raster_t rect = *r;
+    rect.xMin = sw_maxi(tx*SW_DEPTH_TILE_SIZE, r->xMin);
+    rect.yMin = sw_maxi(ty*SW_DEPTH_TILE_SIZE, r->yMin);
+    rect.xMax = sw_mini((tx + 1)*SW_DEPTH_TILE_SIZE, r->xMax);
+    rect.yMax = sw_mini((ty + 1)*SW_DEPTH_TILE_SIZE, r->yMax);
+
+    if (tile->clearState & SW_TILE_COLOR_PENDING) sw_framebuffer_fill_color(&rect, tile->clearColor);
+    if (tile->clearState & SW_TILE_DEPTH_PENDING) sw_framebuffer_fill_depth(&rect, tile->clearDepth);
+
+    tile->clearState &= ~(SW_TILE_COLOR_PENDING | SW_TILE_DEPTH_PENDING);
 }
 
-static inline void sw_framebuffer_write_color(sw_pixel_t *dst, const float src[4])
+// Writes the deferred clears of the whole framebuffer, required before reading its pixels
+static inline void sw_framebuffer_resolve_clears(sw_framebuffer_t *fb)
 {
-#if SW_COLOR_IS_PACKED
-    dst->color[0] = SW_PACK_COLOR(src[0], src[1], src[2]);
-#else
-    sw_float_to_unorm8_simd(dst->color, src);
-#endif
+    if (fb->depthTiles == NULL) return;
+
+    sw_raster_t r;
+    sw_framebuffer_get_raster(fb, &r);
+
+    for (int ty = 0; ty < fb->depthTilesY; ty++)
+    {
+        sw_depth_tile_t *tile = &fb->depthTiles[ty*fb->depthTilesX];
+        for (int tx = 0; tx < fb->depthTilesX; tx++, tile++) sw_depth_tile_resolve(&r, tile, tx, ty);
+    }
 }
 
-static inline void sw_framebuffer_write_depth(sw_pixel_t *dst, float depth)
+// Writes the deferred clears of the whole framebuffer and marks all the tiles as drawn
+static inline void sw_framebuffer_touch_tiles(sw_framebuffer_t *fb)
 {
-    depth = sw_saturate(depth); // REVIEW: An overflow can occur in certain circumstances with clipping, and needs to be reviewed...
+    sw_framebuffer_resolve_clears(fb);
 
-#if SW_DEPTH_IS_PACKED
-    dst->depth[0] = SW_PACK_DEPTH(depth);
-#else
-    dst->depth[0] = SW_PACK_DEPTH_0(depth);
-    dst->depth[1] = SW_PACK_DEPTH_1(depth);
-    dst->depth[2] = SW_PACK_DEPTH_2(depth);
-#endif
+    int count = fb->depthTilesX*fb->depthTilesY;
+    for (int i = 0; i < count; i++) fb->depthTiles[i].clearState = SW_TILE_DIRTY;
 }
 
-static inline void sw_framebuffer_fill_color(sw_pixel_t *ptr, int size, const SW_COLOR_TYPE color[SW_COLOR_PACK_COMP])
+static inline bool sw_framebuffer_load_depth_tiles(sw_framebuffer_t *fb)
 {
-    if (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)
+    int tilesX = (fb->width + SW_DEPTH_TILE_SIZE - 1)/SW_DEPTH_TILE_SIZE;
+    int tilesY = (fb->height + SW_DEPTH_TILE_SIZE - 1)/SW_DEPTH_TILE_SIZE;
+
+    if (tilesX*tilesY > fb->depthTilesAllocSz)
     {
-        int w = RLSW.scMax[0] - RLSW.scMin[0] + 1;
-        for (int y = RLSW.scMin[1]; y <= RLSW.scMax[1]; y++)
-        {
-            sw_pixel_t *row = ptr + y*RLSW.framebuffer.width + RLSW.scMin[0];
-            for (int x = 0; x < w; x++, row++)
-            {
-                for (int i = 0; i < SW_COLOR_PACK_COMP; i++) row->color[i] = color[i];
-            }
-        }
+        void *newTiles = SW_REALLOC(fb->depthTiles, sizeof(sw_depth_tile_t)*tilesX*tilesY);
+        if (newTiles == NULL) return false;
+
+        fb->depthTiles = newTiles;
+        fb->depthTilesAllocSz = tilesX*tilesY;
     }
-    else
+
+    fb->depthTilesX = tilesX;
+    fb->depthTilesY = tilesY;
+
+    // NOTE: Depth values are unknown, the bounds cover the whole depth range
+    sw_framebuffer_set_depth_tiles(fb, 0.0f, 1.0f);
+
+    for (int i = 0; i < tilesX*tilesY; i++) fb->depthTiles[i].clearState = SW_TILE_DIRTY;
+
+    return true;
+}
+
+static inline bool sw_framebuffer_load(sw_framebuffer_t *fb, int w, int h)
+{
+    int size = w*h;
+
+    fb->colors = SW_MALLOC(sizeof(sw_color_t)*size);
+    fb->depths = SW_MALLOC(sizeof(sw_depth_t)*size);
+
+    fb->width = w;
+    fb->height = h;
+    fb->colorStride = w;
+    fb->colorAllocSz = size;
+    fb->allocSz = size;
+    fb->userColors = false;
+    fb->bgra = false;
+
+    fb->depthTiles = NULL;
+    fb->depthTilesAllocSz = 0;
+
+    fb->sampleColors = NULL;
+    fb->sampleDepths = NULL;
+    fb->sampleAllocSz = 0;
+
+    if ((fb->colors == NULL) || (fb->depths == NULL) || !sw_framebuffer_load_depth_tiles(fb))
     {
-        for (int i = 0; i < size; i++, ptr++)
-        {
-            for (int j = 0; j < SW_COLOR_PACK_COMP; j++) ptr->color[j] = color[j];
-        }
+        SW_FREE(fb->colors);
+        SW_FREE(fb->depths);
+        fb->colors = NULL;
+        fb->depths = NULL;
+        return false;
     }
+
+    return true;
 }
 
-static inline void sw_framebuffer_fill_depth(sw_pixel_t *ptr, int size, const SW_DEPTH_TYPE depth[SW_DEPTH_PACK_COMP])
+static inline void sw_framebuffer_unload(sw_framebuffer_t *fb)
 {
-    if (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)
+    if (!fb->userColors) SW_FREE(fb->colors);
+    SW_FREE(fb->depths);
+    SW_FREE(fb->depthTiles);
+    SW_FREE(fb->sampleColors);
+    SW_FREE(fb->sampleDepths);
+}
+
+// Setups the multisample planes of a framebuffer, all the samples of a pixel start with its values
+// NOTE: The planes are kept once allocated, they are resized with the framebuffer
+static inline bool sw_framebuffer_load_samples(sw_framebuffer_t *fb)
+{
+    sw_framebuffer_resolve_clears(fb);
+
+    int size = fb->width*fb->height;
+
+    if (size > fb->sampleAllocSz)
     {
-        int w = RLSW.scMax[0] - RLSW.scMin[0] + 1;
-        for (int y = RLSW.scMin[1]; y <= RLSW.scMax[1]; y++)
+        SW_FREE(fb->sampleColors);
+        SW_FREE(fb->sampleDepths);
+
+        fb->sampleColors = SW_MALLOC(sizeof(sw_color_t)*size*(SW_MSAA_SAMPLES - 1));
+        fb->sampleDepths = SW_MALLOC(sizeof(sw_depth_t)*size*(SW_MSAA_SAMPLES - 1));
+        fb->sampleAllocSz = size;
+
+        // NOTE: The framebuffer is no longer multisampled on failure
+        if ((fb->sampleColors == NULL) || (fb->sampleDepths == NULL))
         {
-            sw_pixel_t *row = ptr + y*RLSW.framebuffer.width + RLSW.scMin[0];
-            for (int x = 0; x < w; x++, row++)
-            {
-                for (int i = 0; i < SW_DEPTH_PACK_COMP; i++) row->depth[i] = depth[i];
-            }
+            SW_FREE(fb->sampleColors);
+            SW_FREE(fb->sampleDepths);
+            fb->sampleColors = NULL;
+            fb->sampleDepths = NULL;
+            fb->sampleAllocSz = 0;
+            return false;
         }
     }
-    else
+
+    for (int y = 0; y < fb->height; y++)
     {
-        for (int i = 0; i < size; i++, ptr++)
+        const sw_color_t *colors = fb->colors + y*fb->colorStride;
+        const sw_depth_t *depths = fb->depths + y*fb->width;
+        sw_color_t *sampleColors = fb->sampleColors + y*fb->width*(SW_MSAA_SAMPLES - 1);
+        sw_depth_t *sampleDepths = fb->sampleDepths + y*fb->width*(SW_MSAA_SAMPLES - 1);
+
+        for (int x = 0; x < fb->width; x++)
         {
-            for (int j = 0; j < SW_DEPTH_PACK_COMP; j++) ptr->depth[j] = depth[j];
+            for (int s = 0; s < SW_MSAA_SAMPLES - 1; s++)
+            {
+                *sampleColors++ = colors[x];
+                *sampleDepths++ = depths[x];
+            }
         }
     }
+
+    return true;
 }
 
-static inline void sw_framebuffer_fill(sw_pixel_t *ptr, int size, sw_pixel_t value)
+static inline bool sw_framebuffer_resize_depth(sw_framebuffer_t *fb, int w, int h)
 {
-    if (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)
+    sw_framebuffer_resolve_clears(fb);
+
+    int newSize = w*h;
+
+    if (newSize > fb->allocSz)
     {
-        int w = RLSW.scMax[0] - RLSW.scMin[0] + 1;
-        for (int y = RLSW.scMin[1]; y <= RLSW.scMax[1]; y++)
-        {
-            sw_pixel_t *row = ptr + y*RLSW.framebuffer.width + RLSW.scMin[0];
-            for (int x = 0; x < w; x++, row++) *row = value;
-        }
+        void *newDepths = SW_REALLOC(fb->depths, sizeof(sw_depth_t)*newSize);
+        if (newDepths == NULL) return false;
+
+        fb->depths = newDepths;
+        fb->allocSz = newSize;
     }
-    else
+
+    fb->width = w;
+    fb->height = h;
+
+    return sw_framebuffer_load_depth_tiles(fb);
+}
+
+static inline bool sw_framebuffer_resize(sw_framebuffer_t *fb, int w, int h)
+{
+    // NOTE: User memory can not be resized, it must be set again with the new dimensions
+    if (fb->userColors) return ((w == fb->width) && (h == fb->height));
+
+    sw_framebuffer_resolve_clears(fb);
+
+    int newSize = w*h;
+
+    if (newSize > fb->colorAllocSz)
+    {
+        void *newColors = SW_REALLOC(fb->colors, sizeof(sw_color_t)*newSize);
+        if (newColors == NULL) return false;
+
+        fb->colors = newColors;
+        fb->colorAllocSz = newSize;
+    }
+
+    fb->colorStride = w;
+
+    if (!sw_framebuffer_resize_depth(fb, w, h)) return false;
+
+    return (fb->sampleColors == NULL) || sw_framebuffer_load_samples(fb);
+}
+
+// Sets user memory as the framebuffer color plane, or restores an owned one if NULL
+// NOTE: Previous color contents are not kept
+static inline bool sw_framebuffer_set_colors(sw_framebuffer_t *fb, void *pixels, int w, int h, int stride, bool bgra)
+{
+    sw_framebuffer_resolve_clears(fb);
+
+    if (pixels == NULL)
+    {
+        if (!fb->userColors) return true;
+
+        sw_color_t *colors = SW_MALLOC(sizeof(sw_color_t)*fb->width*fb->height);
+        if (colors == NULL) return false;
+
+        fb->colors = colors;
+        fb->colorStride = fb->width;
+        fb->colorAllocSz = fb->width*fb->height;
+        fb->userColors = false;
+        fb->bgra = false;
+
+        sw_framebuffer_touch_tiles(fb);
+
+        return true;
+    }
+
+    if (!sw_framebuffer_resize_depth(fb, w, h)) return false;
+
+    if (!fb->userColors) SW_FREE(fb->colors);
+
+    fb->colors = (sw_color_t *)pixels;
+    fb->colorStride = stride;
+    fb->colorAllocSz = 0;
+    fb->userColors = true;
+    fb->bgra = bgra;
+
+    return true;
+}
+
+static inline void sw_framebuffer_read_color(float dst[4], const sw_color_t *src)
+{
+#if SW_COLOR_IS_PACKED
+    SW_COLOR_TYPE pixel = src->color[0];
+    dst[0] = SW_TO_FLOAT_R(SW_UNPACK_R(pixel));
+    dst[1] = SW_TO_FLOAT_G(SW_UNPACK_G(pixel));
+    dst[2] = SW_TO_FLOAT_B(SW_UNPACK_B(pixel));
+    dst[3] = 1.0f;
+#else
+    sw_float_from_unorm8_simd(dst, src->color);
+#endif
+}
+
+static inline void sw_framebuffer_read_color8(uint8_t dst[4], const sw_color_t *src)
+{
+#if SW_COLOR_IS_PACKED
+    SW_COLOR_TYPE pixel = src->color[0];
+    dst[0] = SW_SCALE_R(SW_UNPACK_R(pixel));
+    dst[1] = SW_SCALE_G(SW_UNPACK_G(pixel));
+    dst[2] = SW_SCALE_B(SW_UNPACK_B(pixel));
+    dst[3] = 255;
+#else
+    const SW_COLOR_TYPE *p = src->color;
+    dst[0] = p[0];
+    dst[1] = p[1];
+    dst[2] = p[2];
+    dst[3] = p[3];
+#endif
+}
+
+static inline float sw_framebuffer_read_depth(const sw_depth_t *src)
+{
+#if SW_DEPTH_IS_PACKED
+    return src->depth[0]*SW_DEPTH_SCALE;
+#else
+    return SW_UNPACK_DEPTH(src->depth)*SW_DEPTH_SCALE;
+#endif
+}
+
+static inline void sw_framebuffer_write_color(sw_color_t *dst, const float src[4])
+{
+#if SW_COLOR_IS_PACKED
+    dst->color[0] = SW_PACK_COLOR(src[0], src[1], src[2]);
+#else
+    sw_float_to_unorm8_simd(dst->color, src);
+#endif
+}
+
+static inline void sw_framebuffer_write_depth(sw_depth_t *dst, float depth)
+{
+    depth = sw_saturate(depth); // REVIEW: An overflow can occur in certain circumstances with clipping, and needs to be reviewed...
+
+#if SW_DEPTH_IS_PACKED
+    dst->depth[0] = SW_PACK_DEPTH(depth);
+#else
+    dst->depth[0] = SW_PACK_DEPTH_0(depth);
+    dst->depth[1] = SW_PACK_DEPTH_1(depth);
+    dst->depth[2] = SW_PACK_DEPTH_2(depth);
+#endif
+}
+
+// Reads a color of the current framebuffer in RGBA order, whatever its color plane order
+static inline void sw_framebuffer_read_color8_ordered(uint8_t dst[4], const sw_color_t *src)
+{
+    sw_framebuffer_read_color8(dst, src);
+
+#if !SW_COLOR_IS_PACKED
+    if (RLSW.framebuffer.bgra)
+    {
+        uint8_t tmp = dst[0];
+        dst[0] = dst[2];
+        dst[2] = tmp;
+    }
+#endif
+}
+
+// Reads a resolved color of the current framebuffer in RGBA order, the average of its samples if multisampled
+static inline void sw_framebuffer_read_color8_resolved(uint8_t dst[4], const sw_color_t *src)
+{
+    const sw_framebuffer_t *fb = &RLSW.framebuffer;
+
+    if (fb->sampleColors == NULL)
+    {
+        sw_framebuffer_read_color8_ordered(dst, src);
+        return;
+    }
+
+    // NOTE: Multisampled color planes are owned, the pixel index matches the depth plane one
+    const sw_color_t *samples = fb->sampleColors + (src - fb->colors)*(SW_MSAA_SAMPLES - 1);
+    uint32_t sum[4];
+    uint8_t color[4];
+
+    sw_framebuffer_read_color8(color, src);
+    for (int i = 0; i < 4; i++) sum[i] = color[i];
+
+    for (int s = 0; s < SW_MSAA_SAMPLES - 1; s++)
     {
-        for (int i = 0; i < size; i++, ptr++) *ptr = value;
+        sw_framebuffer_read_color8(color, &samples[s]);
+        for (int i = 0; i < 4; i++) sum[i] += color[i];
     }
+
+    for (int i = 0; i < 4; i++) dst[i] = (uint8_t)((sum[i] + SW_MSAA_SAMPLES/2)/SW_MSAA_SAMPLES);
 }
 
 static inline void sw_framebuffer_copy_fast(void* dst)
 {
-    int size = RLSW.framebuffer.width*RLSW.framebuffer.height;
-    const sw_pixel_t *pixels = RLSW.framebuffer.pixels;
+    int width = RLSW.framebuffer.width;
+    int height = RLSW.framebuffer.height;
+    int stride = RLSW.framebuffer.colorStride;
+    const sw_color_t *pixels = RLSW.framebuffer.colors;
 
+    for (int y = 0; y < height; y++, pixels += stride)
+    {
 #if SW_COLOR_BUFFER_BITS == 8
-    uint8_t *dst8 = (uint8_t*)dst;
-    for (int i = 0; i < size; i++) dst8[i] = pixels[i].color[0];
+        uint8_t *dst8 = (uint8_t*)dst + y*width;
+        for (int i = 0; i < width; i++) dst8[i] = pixels[i].color[0];
 #elif SW_COLOR_BUFFER_BITS == 16
-    uint16_t *dst16 = (uint16_t*)dst;
-    for (int i = 0; i < size; i++) dst16[i] = *(uint16_t*)pixels[i].color;
+        uint16_t *dst16 = (uint16_t*)dst + y*width;
+        for (int i = 0; i < width; i++) dst16[i] = *(uint16_t*)pixels[i].color;
 #else // 32 bits
-    uint32_t *dst32 = (uint32_t*)dst;
-    #if SW_GL_FRAMEBUFFER_COPY_BGRA
-        for (int i = 0; i < size; i++)
+        uint32_t *dst32 = (uint32_t*)dst + y*width;
+        if (RLSW.framebuffer.bgra != SW_GL_FRAMEBUFFER_COPY_BGRA)
         {
-            const uint8_t *c = pixels[i].color;
-            dst32[i] = (uint32_t)c[2] | ((uint32_t)c[1] << 8) | ((uint32_t)c[0] << 16) | ((uint32_t)c[3] << 24);
+            for (int i = 0; i < width; i++)
+            {
+                const uint8_t *c = pixels[i].color;
+                dst32[i] = (uint32_t)c[2] | ((uint32_t)c[1] << 8) | ((uint32_t)c[0] << 16) | ((uint32_t)c[3] << 24);
+            }
         }
-    #else // RGBA
-        for (int i = 0; i < size; i++) dst32[i] = *(uint32_t*)pixels[i].color;
-    #endif
+        else memcpy(dst32, pixels, sizeof(uint32_t)*width);
 #endif
+    }
 }
 
 #define DEFINE_FRAMEBUFFER_COPY_BEGIN(name, DST_PTR_T)                          \
 static inline void sw_framebuffer_copy_to_##name(int x, int y, int w, int h, DST_PTR_T *dst) \
 {                                                                               \
-    const int stride = RLSW.framebuffer.width;                                  \
-    const sw_pixel_t *src = RLSW.framebuffer.pixels + (y*stride + x);           \
+    const int stride = RLSW.framebuffer.colorStride;                            \
+    const sw_color_t *src = RLSW.framebuffer.colors + (y*stride + x);           \
                                                                                 \
     for (int iy = 0; iy < h; iy++) {                                            \
-        const sw_pixel_t *line = src;                                           \
+        const sw_color_t *line = src;                                           \
         for (int ix = 0; ix < w; ix++) {                                        \
             uint8_t color[4];                                                   \
-            sw_framebuffer_read_color8(color, line);                            \
+            sw_framebuffer_read_color8_resolved(color, line);                   \
 
 #define DEFINE_FRAMEBUFFER_COPY_END()                                           \
             ++line;                                                             \
@@ -1582,8 +2455,8 @@ static inline void sw_framebuffer_blit_to_##name(
     int xSrc, int ySrc, int wSrc, int hSrc,                                     \
     DST_PTR_T *dst)                                                             \
 {                                                                               \
-    const sw_pixel_t *srcBase = RLSW.framebuffer.pixels;                        \
-    const int fbWidth = RLSW.framebuffer.width;                                 \
+    const sw_color_t *srcBase = RLSW.framebuffer.colors;                        \
+    const int fbWidth = RLSW.framebuffer.colorStride;                           \
                                                                                 \
     const uint32_t xScale = ((uint32_t)wSrc << 16)/(uint32_t)wDst;              \
     const uint32_t yScale = ((uint32_t)hSrc << 16)/(uint32_t)hDst;              \
@@ -1591,15 +2464,15 @@ static inline void sw_framebuffer_blit_to_##name(
     for (int dy = 0; dy < hDst; dy++) {                                         \
         uint32_t yFix = ((uint32_t)ySrc << 16) + dy*yScale;                     \
         int sy = yFix >> 16;                                                    \
-        const sw_pixel_t *srcLine = srcBase + sy*fbWidth + xSrc;                \
+        const sw_color_t *srcLine = srcBase + sy*fbWidth + xSrc;                \
                                                                                 \
-        const sw_pixel_t *srcPtr = srcLine;                                     \
+        const sw_color_t *srcPtr = srcLine;                                     \
         for (int dx = 0; dx < wDst; dx++) {                                     \
             uint32_t xFix = dx*xScale;                                          \
             int sx = xFix >> 16;                                                \
-            const sw_pixel_t *pixel = srcPtr + sx;                              \
+            const sw_color_t *pixel = srcPtr + sx;                              \
             uint8_t color[4];                                                   \
-            sw_framebuffer_read_color8(color, pixel);
+            sw_framebuffer_read_color8_resolved(color, pixel);
 
 #define DEFINE_FRAMEBUFFER_BLIT_END()                                           \
         }                                                                       \
@@ -1715,6 +2588,15 @@ static inline int sw_get_pixel_format(SWformat format, SWtype type)
     int channels = 0;
     int bitsPerChannel = 8; // Default: 8 bits per channel
 
+    // Packed types define all the channels of the pixel
+    switch (type)
+    {
+        case SW_UNSIGNED_SHORT_5_6_5: return (format == SW_RGB)? SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5 : SW_PIXELFORMAT_UNKNOWN;
+        case SW_UNSIGNED_SHORT_5_5_5_1: return (format == SW_RGBA)? SW_PIXELFORMAT_UNCOMPRESSED_R5G5B5A1 : SW_PIXELFORMAT_UNKNOWN;
+        case SW_UNSIGNED_SHORT_4_4_4_4: return (format == SW_RGBA)? SW_PIXELFORMAT_UNCOMPRESSED_R4G4B4A4 : SW_PIXELFORMAT_UNKNOWN;
+        default: break;
+    }
+
     // Determine the number of channels (format)
     switch (format)
     {
@@ -1896,72 +2778,253 @@ static inline void sw_get_pixel(uint8_t *color, const void *pixels, uint32_t off
         }
     }
 }
+
+// Textures keep the formats that can be sampled directly, the others are converted to RGBA32
+static inline sw_pixelformat_t sw_get_texture_storage_format(sw_pixelformat_t format)
+{
+    switch (format)
+    {
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE:
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: return format;
+        default: return SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    }
+}
+
+static inline int sw_get_texture_pixel_size(sw_pixelformat_t format)
+{
+    switch (format)
+    {
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE: return 1;
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA: return 2;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5: return 2;
+        default: return 4;
+    }
+}
+
+// Writes an RGBA32 color to a texture storage format pixel, or to another 8-bit or packed format pixel
+static inline void sw_set_texture_pixel(void *pixels, uint32_t offset, const uint8_t *color, sw_pixelformat_t format)
+{
+    switch (format)
+    {
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE:
+        {
+            ((uint8_t*)pixels)[offset] = (uint8_t)((color[0]*77 + color[1]*150 + color[2]*29 + 128) >> 8);
+            break;
+        }
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA:
+        {
+            uint8_t *dst = &((uint8_t*)pixels)[offset*2];
+            dst[0] = (uint8_t)((color[0]*77 + color[1]*150 + color[2]*29 + 128) >> 8);
+            dst[1] = color[3];
+            break;
+        }
+        case SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5:
+        {
+            uint16_t r = (uint16_t)((color[0]*31 + 127)/255);
+            uint16_t g = (uint16_t)((color[1]*63 + 127)/255);
+            uint16_t b = (uint16_t)((color[2]*31 + 127)/255);
+            ((uint16_t*)pixels)[offset] = (r << 11) | (g << 5) | b;
+            break;
+        }
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8:
+        {
+            uint8_t *dst = &((uint8_t*)pixels)[offset*3];
+            dst[0] = color[0];
+            dst[1] = color[1];
+            dst[2] = color[2];
+            break;
+        }
+        case SW_PIXELFORMAT_UNCOMPRESSED_R5G5B5A1:
+        {
+            uint16_t r = (uint16_t)((color[0]*31 + 127)/255);
+            uint16_t g = (uint16_t)((color[1]*31 + 127)/255);
+            uint16_t b = (uint16_t)((color[2]*31 + 127)/255);
+            uint16_t a = (color[3] >= 128)? 1 : 0;
+            ((uint16_t*)pixels)[offset] = (r << 11) | (g << 6) | (b << 1) | a;
+            break;
+        }
+        case SW_PIXELFORMAT_UNCOMPRESSED_R4G4B4A4:
+        {
+            uint16_t r = (uint16_t)((color[0]*15 + 127)/255);
+            uint16_t g = (uint16_t)((color[1]*15 + 127)/255);
+            uint16_t b = (uint16_t)((color[2]*15 + 127)/255);
+            uint16_t a = (uint16_t)((color[3]*15 + 127)/255);
+            ((uint16_t*)pixels)[offset] = (r << 12) | (g << 8) | (b << 4) | a;
+            break;
+        }
+        default:
+        {
+            uint8_t *dst = &((uint8_t*)pixels)[offset*4];
+            dst[0] = color[0];
+            dst[1] = color[1];
+            dst[2] = color[2];
+            dst[3] = color[3];
+            break;
+        }
+    }
+}
 //-------------------------------------------------------------------------------------------
 
 // Texture sampling functionality
 //-------------------------------------------------------------------------------------------
-static inline void sw_texture_fetch(float* color, const sw_texture_t* tex, int x, int y)
+// Index of a texel in the level pixels, stored by rows or by tiles of 4x4 texels
+static inline int sw_texture_texel_index(const sw_texture_level_t *level, int x, int y)
+{
+    if (level->tilesX == 0) return y*level->width + x;
+
+    return (((y >> 2)*level->tilesX + (x >> 2)) << 4) | ((y & 3) << 2) | (x & 3);
+}
+
+// Number of texels stored by a level, tiled levels are padded to whole tiles
+static inline int sw_texture_level_size(const sw_texture_level_t *level)
 {
-    sw_float_from_unorm8_simd(color, &tex->pixels[4*(y*tex->width + x)]);
+    if (level->tilesX == 0) return level->width*level->height;
+
+    return level->tilesX*((level->height + 3) >> 2)*16;
+}
+
+// Allocates the pixels of a texture level, the level is tiled if large enough
+static inline bool sw_texture_level_alloc(sw_texture_level_t *level, int width, int height, sw_pixelformat_t format)
+{
+    bool tiled = (SW_TEXTURE_TILE_MIN_SIZE > 0) && (width >= SW_TEXTURE_TILE_MIN_SIZE) && (height >= SW_TEXTURE_TILE_MIN_SIZE);
+
+    level->width = width;
+    level->height = height;
+    level->wMinus1 = width - 1;
+    level->hMinus1 = height - 1;
+    level->tilesX = tiled? (width + 3) >> 2 : 0;
+    level->tx = 1.0f/width;
+    level->ty = 1.0f/height;
+
+    level->pixels = SW_MALLOC(sw_get_texture_pixel_size(format)*sw_texture_level_size(level));
+
+    return (level->pixels != NULL);
+}
+
+static void sw_texture_fetch_GRAYSCALE(float *SW_RESTRICT color, const sw_texture_level_t *SW_RESTRICT level, int x, int y)
+{
+    float gray = level->pixels[sw_texture_texel_index(level, x, y)]*SW_INV_255;
+
+    color[0] = gray;
+    color[1] = gray;
+    color[2] = gray;
+    color[3] = 1.0f;
+}
+
+static void sw_texture_fetch_GRAY_ALPHA(float *SW_RESTRICT color, const sw_texture_level_t *SW_RESTRICT level, int x, int y)
+{
+    const uint8_t *src = &level->pixels[2*sw_texture_texel_index(level, x, y)];
+    float gray = src[0]*SW_INV_255;
+
+    color[0] = gray;
+    color[1] = gray;
+    color[2] = gray;
+    color[3] = src[1]*SW_INV_255;
+}
+
+static void sw_texture_fetch_R5G6B5(float *SW_RESTRICT color, const sw_texture_level_t *SW_RESTRICT level, int x, int y)
+{
+    uint16_t pixel = ((const uint16_t*)level->pixels)[sw_texture_texel_index(level, x, y)];
+
+    color[0] = (float)((pixel >> 11) & 0x1F)*(1.0f/31.0f);
+    color[1] = (float)((pixel >> 5) & 0x3F)*(1.0f/63.0f);
+    color[2] = (float)(pixel & 0x1F)*(1.0f/31.0f);
+    color[3] = 1.0f;
+}
+
+static void sw_texture_fetch_R8G8B8A8(float *SW_RESTRICT color, const sw_texture_level_t *SW_RESTRICT level, int x, int y)
+{
+    sw_float_from_unorm8_simd(color, &level->pixels[4*sw_texture_texel_index(level, x, y)]);
+}
+
+static inline void sw_texture_set_format(sw_texture_t *tex, sw_pixelformat_t format)
+{
+    tex->format = format;
+
+    switch (format)
+    {
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE: tex->fetch = sw_texture_fetch_GRAYSCALE; break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA: tex->fetch = sw_texture_fetch_GRAY_ALPHA; break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5: tex->fetch = sw_texture_fetch_R5G6B5; break;
+        default: tex->fetch = sw_texture_fetch_R8G8B8A8; break;
+    }
 }
 
-static inline void sw_texture_sample_nearest(float *color, const sw_texture_t *tex, float u, float v)
+static inline void sw_texture_sample_nearest(float *color, const sw_texture_t *tex, const sw_texture_level_t *level, float u, float v)
 {
     u = (tex->sWrap == SW_REPEAT)? sw_fract(u) : sw_saturate(u);
     v = (tex->tWrap == SW_REPEAT)? sw_fract(v) : sw_saturate(v);
 
-    int x = u*tex->width;
-    int y = v*tex->height;
+    int x = u*level->width;
+    int y = v*level->height;
+
+    // NOTE: Coordinates can reach the texture size, clamped ones stay on the last texel,
+    // repeated ones wrap to the first (fract() of tiny negative values rounds to 1.0)
+    if (x > level->wMinus1) x = (tex->sWrap == SW_REPEAT)? 0 : level->wMinus1;
+    if (y > level->hMinus1) y = (tex->tWrap == SW_REPEAT)? 0 : level->hMinus1;
 
-    sw_texture_fetch(color, tex, x, y);
+    tex->fetch(color, level, x, y);
 }
 
-static inline void sw_texture_sample_linear(float *color, const sw_texture_t *tex, float u, float v)
+static inline void sw_texture_sample_linear(float *color, const sw_texture_t *tex, const sw_texture_level_t *level, float u, float v)
 {
     // TODO: With a bit more cleverness thee number of operations can
     // be clearly reduced, but for now it works fine
 
-    float xf = (u*tex->width) - 0.5f;
-    float yf = (v*tex->height) - 0.5f;
+    float xf = (u*level->width) - 0.5f;
+    float yf = (v*level->height) - 0.5f;
 
     float fx = sw_fract(xf);
     float fy = sw_fract(yf);
 
-    int x0 = (int)xf;
-    int y0 = (int)yf;
+    // NOTE: Rounded down like the fractions, truncation would pick the wrong texels below zero
+    int x0 = (int)floorf(xf);
+    int y0 = (int)floorf(yf);
 
     int x1 = x0 + 1;
     int y1 = y0 + 1;
 
-    // NOTE: If the textures are POT, avoid the division for SW_REPEAT
+    // NOTE: Power of two dimensions wrap with a mask, avoiding the divisions for SW_REPEAT
 
     if (tex->sWrap == SW_CLAMP)
     {
-        x0 = (x0 > tex->wMinus1)? tex->wMinus1 : x0;
-        x1 = (x1 > tex->wMinus1)? tex->wMinus1 : x1;
+        x0 = sw_clampi(x0, 0, level->wMinus1);
+        x1 = sw_clampi(x1, 0, level->wMinus1);
+    }
+    else if ((level->width & level->wMinus1) == 0)
+    {
+        x0 &= level->wMinus1;
+        x1 &= level->wMinus1;
     }
     else
     {
-        x0 = (x0%tex->width + tex->width)%tex->width;
-        x1 = (x1%tex->width + tex->width)%tex->width;
+        x0 = (x0%level->width + level->width)%level->width;
+        x1 = (x1%level->width + level->width)%level->width;
     }
 
     if (tex->tWrap == SW_CLAMP)
     {
-        y0 = (y0 > tex->hMinus1)? tex->hMinus1 : y0;
-        y1 = (y1 > tex->hMinus1)? tex->hMinus1 : y1;
+        y0 = sw_clampi(y0, 0, level->hMinus1);
+        y1 = sw_clampi(y1, 0, level->hMinus1);
+    }
+    else if ((level->height & level->hMinus1) == 0)
+    {
+        y0 &= level->hMinus1;
+        y1 &= level->hMinus1;
     }
     else
     {
-        y0 = (y0%tex->height + tex->height)%tex->height;
-        y1 = (y1%tex->height + tex->height)%tex->height;
+        y0 = (y0%level->height + level->height)%level->height;
+        y1 = (y1%level->height + level->height)%level->height;
     }
 
     float c00[4], c10[4], c01[4], c11[4];
-    sw_texture_fetch(c00, tex, x0, y0);
-    sw_texture_fetch(c10, tex, x1, y0);
-    sw_texture_fetch(c01, tex, x0, y1);
-    sw_texture_fetch(c11, tex, x1, y1);
+    tex->fetch(c00, level, x0, y0);
+    tex->fetch(c10, level, x1, y0);
+    tex->fetch(c01, level, x0, y1);
+    tex->fetch(c11, level, x1, y1);
 
     for (int i = 0; i < 4; i++)
     {
@@ -1971,7 +3034,52 @@ static inline void sw_texture_sample_linear(float *color, const sw_texture_t *te
     }
 }
 
-static inline void sw_texture_sample(float *color, const sw_texture_t *tex, float u, float v, float dUdx, float dUdy, float dVdx, float dVdy)
+static inline int sw_texture_sample_mipmap(float *color, const sw_texture_t *tex, float u, float v, float L2)
+{
+    // Level of detail from the squared footprint: log2(sqrt(L2))
+    float lod = 0.5f*sw_log2(L2);
+    float maxLod = (float)(tex->levelCount - 1);
+    lod = (lod < 0.0f)? 0.0f : ((lod > maxLod)? maxLod : lod);
+
+    bool linear = (tex->minFilter == SW_LINEAR_MIPMAP_NEAREST) || (tex->minFilter == SW_LINEAR_MIPMAP_LINEAR);
+
+    if ((tex->minFilter == SW_NEAREST_MIPMAP_NEAREST) || (tex->minFilter == SW_LINEAR_MIPMAP_NEAREST))
+    {
+        const sw_texture_level_t *level = &tex->levels[(int)(lod + 0.5f)];
+
+        if (linear) sw_texture_sample_linear(color, tex, level, u, v);
+        else sw_texture_sample_nearest(color, tex, level, u, v);
+
+        return linear? 4 : 1;
+    }
+    else
+    {
+        // Blend the two nearest levels (trilinear with linear filtering)
+        int l0 = (int)lod;
+        int l1 = (l0 < tex->levelCount - 1)? l0 + 1 : l0;
+        float f = lod - (float)l0;
+
+        float c0[4], c1[4];
+
+        if (linear)
+        {
+            sw_texture_sample_linear(c0, tex, &tex->levels[l0], u, v);
+            sw_texture_sample_linear(c1, tex, &tex->levels[l1], u, v);
+        }
+        else
+        {
+            sw_texture_sample_nearest(c0, tex, &tex->levels[l0], u, v);
+            sw_texture_sample_nearest(c1, tex, &tex->levels[l1], u, v);
+        }
+
+        for (int i = 0; i < 4; i++) color[i] = c0[i] + f*(c1[i] - c0[i]);
+
+        return linear? 8 : 2;
+    }
+}
+
+// Samples a texture with the filter selected by the derivatives, returns the number of texels read
+static inline int sw_texture_sample(float *color, const sw_texture_t *tex, float u, float v, float dUdx, float dUdy, float dVdx, float dVdy)
 {
     // Previous method: There is no need to compute the square root
     // because using the squared value, the comparison remains (L2 > 1.0f*1.0f)
@@ -1979,33 +3087,223 @@ static inline void sw_texture_sample(float *color, const sw_texture_t *tex, floa
     //float dv = sqrtf(dVdx*dVdx + dVdy*dVdy);
     //float L = (du > dv)? du : dv;
 
-    // Calculate the derivatives for each axis
-    float dU2 = dUdx*dUdx + dUdy*dUdy;
-    float dV2 = dVdx*dVdx + dVdy*dVdy;
+    // Calculate the derivatives for each axis, in base level texels
+    const sw_texture_level_t *base = &tex->levels[0];
+    float w = (float)base->width;
+    float h = (float)base->height;
+    float dU2 = (dUdx*dUdx + dUdy*dUdy)*w*w;
+    float dV2 = (dVdx*dVdx + dVdy*dVdy)*h*h;
     float L2 = (dU2 > dV2)? dU2 : dV2;
 
     SWfilter filter = (L2 > 1.0f)? tex->minFilter : tex->magFilter;
 
     switch (filter)
     {
-        case SW_NEAREST: sw_texture_sample_nearest(color, tex, u, v); break;
-        case SW_LINEAR: sw_texture_sample_linear(color, tex, u, v); break;
+        case SW_NEAREST: sw_texture_sample_nearest(color, tex, base, u, v); return 1;
+        case SW_LINEAR: sw_texture_sample_linear(color, tex, base, u, v); return 4;
+        case SW_NEAREST_MIPMAP_NEAREST:
+        case SW_LINEAR_MIPMAP_NEAREST:
+        case SW_NEAREST_MIPMAP_LINEAR:
+        case SW_LINEAR_MIPMAP_LINEAR: return sw_texture_sample_mipmap(color, tex, u, v, L2);
         default: break;
     }
+
+    return 0;
 }
-//-------------------------------------------------------------------------------------------
 
-// Color blending functionality
-//-------------------------------------------------------------------------------------------
-static inline void sw_factor_zero(float *SW_RESTRICT factor, const float *SW_RESTRICT src, const float *SW_RESTRICT dst)
+// Checks if the span sampling applies to a texture, RGBA32 and filtered linearly at all scales
+static inline bool sw_texture_is_span_linear(const sw_texture_t *tex)
 {
-    factor[0] = factor[1] = factor[2] = factor[3] = 0.0f;
+    return SW_FIXED_POINT_TEXTURE && (tex->format == SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) &&
+           (tex->minFilter == SW_LINEAR) && (tex->magFilter == SW_LINEAR);
 }
 
-static inline void sw_factor_one(float *SW_RESTRICT factor, const float *SW_RESTRICT src, const float *SW_RESTRICT dst)
+// Bilinear sampling of a span of 4 pixels in fixed point, the texture coordinates of the pixel i are
+// (u + i*dUdx)/(w + i*dWdx), (v + i*dVdx)/(w + i*dWdx), results are RGBA 8-bit texels
+// NOTE: Coordinates are converted to 24.8 fixed point, the texels are weighted in 16-bit lanes:
+// top = (c00*(256 - fx) + c10*fx) >> 8, bottom likewise and the result between them with fy
+static inline void sw_texture_sample_linear_span(uint8_t texels[4][4], const sw_texture_t *tex,
+                                                 float u, float v, float w, float dUdx, float dVdx, float dWdx)
 {
-    factor[0] = factor[1] = factor[2] = factor[3] = 1.0f;
-}
+    const sw_texture_level_t *level = &tex->levels[0];
+    const bool sRepeat = (tex->sWrap == SW_REPEAT);
+    const bool tRepeat = (tex->tWrap == SW_REPEAT);
+    const float sScale = (float)level->width*256.0f;
+    const float tScale = (float)level->height*256.0f;
+
+    int32_t xi[4], yi[4];
+
+    // Fixed point texel coordinates, wrapped or clamped to [0..1] first, so they are never negative
+#if defined(SW_HAS_NEON_FMA) || defined(SW_HAS_NEON)
+    const float32x4_t lanes = { 0.0f, 1.0f, 2.0f, 3.0f };
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    float32x4_t wl = vmlaq_n_f32(vdupq_n_f32(w), lanes, dWdx);
+    // NOTE: Reciprocal estimate refined by two Newton-Raphson steps, vdivq_f32() is AArch64 only
+    float32x4_t wRcp = vrecpeq_f32(wl);
+    wRcp = vmulq_f32(wRcp, vrecpsq_f32(wl, wRcp));
+    wRcp = vmulq_f32(wRcp, vrecpsq_f32(wl, wRcp));
+    float32x4_t st[2] = {
+        vmulq_f32(vmlaq_n_f32(vdupq_n_f32(u), lanes, dUdx), wRcp),
+        vmulq_f32(vmlaq_n_f32(vdupq_n_f32(v), lanes, dVdx), wRcp)
+    };
+    for (int k = 0; k < 2; k++)
+    {
+        if ((k == 0)? sRepeat : tRepeat)
+        {
+            // NOTE: floor() from the truncation, corrected for the negative values
+            float32x4_t f = vcvtq_f32_s32(vcvtq_s32_f32(st[k]));
+            f = vsubq_f32(f, vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(f, st[k]), vreinterpretq_u32_f32(one))));
+            st[k] = vsubq_f32(st[k], f);
+        }
+        else st[k] = vminq_f32(vmaxq_f32(st[k], vdupq_n_f32(0.0f)), one);
+    }
+    vst1q_s32(xi, vsubq_s32(vcvtq_s32_f32(vmulq_n_f32(st[0], sScale)), vdupq_n_s32(128)));
+    vst1q_s32(yi, vsubq_s32(vcvtq_s32_f32(vmulq_n_f32(st[1], tScale)), vdupq_n_s32(128)));
+#elif defined(SW_HAS_SSE2) || defined(SW_HAS_SSE3) || defined(SW_HAS_SSSE3) || defined(SW_HAS_SSE41) || defined(SW_HAS_SSE42)
+    const __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128 wRcp = _mm_div_ps(one, _mm_add_ps(_mm_set1_ps(w), _mm_mul_ps(lanes, _mm_set1_ps(dWdx))));
+    __m128 st[2] = {
+        _mm_mul_ps(_mm_add_ps(_mm_set1_ps(u), _mm_mul_ps(lanes, _mm_set1_ps(dUdx))), wRcp),
+        _mm_mul_ps(_mm_add_ps(_mm_set1_ps(v), _mm_mul_ps(lanes, _mm_set1_ps(dVdx))), wRcp)
+    };
+    for (int k = 0; k < 2; k++)
+    {
+        if ((k == 0)? sRepeat : tRepeat)
+        {
+            // NOTE: floor() from the truncation, corrected for the negative values
+            __m128 f = _mm_cvtepi32_ps(_mm_cvttps_epi32(st[k]));
+            f = _mm_sub_ps(f, _mm_and_ps(_mm_cmpgt_ps(f, st[k]), one));
+            st[k] = _mm_sub_ps(st[k], f);
+        }
+        else st[k] = _mm_min_ps(_mm_max_ps(st[k], _mm_setzero_ps()), one);
+    }
+    _mm_storeu_si128((__m128i *)xi, _mm_sub_epi32(_mm_cvttps_epi32(_mm_mul_ps(st[0], _mm_set1_ps(sScale))), _mm_set1_epi32(128)));
+    _mm_storeu_si128((__m128i *)yi, _mm_sub_epi32(_mm_cvttps_epi32(_mm_mul_ps(st[1], _mm_set1_ps(tScale))), _mm_set1_epi32(128)));
+#else
+    for (int i = 0; i < 4; i++)
+    {
+        float wRcp = 1.0f/(w + i*dWdx);
+        float s = (u + i*dUdx)*wRcp;
+        float t = (v + i*dVdx)*wRcp;
+        s = sw_saturate(sRepeat? sw_fract(s) : s);
+        t = sw_saturate(tRepeat? sw_fract(t) : t);
+        xi[i] = (int32_t)(s*sScale) - 128;
+        yi[i] = (int32_t)(t*tScale) - 128;
+    }
+#endif
+
+    // Texels addresses and weights, the neighbors wrap or stay on the edge
+    // NOTE: Coordinates are clamped to the level whatever the wrap mode, invalid ones can't read outside
+    uint32_t c00[4], c10[4], c01[4], c11[4];
+    int32_t fx[4], fy[4];
+    const uint32_t *pixels = (const uint32_t *)level->pixels;
+
+    for (int i = 0; i < 4; i++)
+    {
+        int x0 = xi[i] >> 8, y0 = yi[i] >> 8;
+        int x1 = x0 + 1, y1 = y0 + 1;
+        fx[i] = xi[i] & 0xFF;
+        fy[i] = yi[i] & 0xFF;
+
+        if (sRepeat)
+        {
+            x0 = (x0 < 0)? x0 + level->width : x0;
+            x1 = (x1 > level->wMinus1)? x1 - level->width : x1;
+        }
+        if (tRepeat)
+        {
+            y0 = (y0 < 0)? y0 + level->height : y0;
+            y1 = (y1 > level->hMinus1)? y1 - level->height : y1;
+        }
+
+        x0 = sw_clampi(x0, 0, level->wMinus1);
+        x1 = sw_clampi(x1, 0, level->wMinus1);
+        y0 = sw_clampi(y0, 0, level->hMinus1);
+        y1 = sw_clampi(y1, 0, level->hMinus1);
+
+        c00[i] = pixels[sw_texture_texel_index(level, x0, y0)];
+        c10[i] = pixels[sw_texture_texel_index(level, x1, y0)];
+        c01[i] = pixels[sw_texture_texel_index(level, x0, y1)];
+        c11[i] = pixels[sw_texture_texel_index(level, x1, y1)];
+    }
+
+    // Weighted texels, two pixels per 16-bit lanes register
+#if defined(SW_HAS_NEON_FMA) || defined(SW_HAS_NEON)
+    const uint16x8_t full = vdupq_n_u16(256);
+    for (int h = 0; h < 2; h++)
+    {
+        uint16x8_t wx = vcombine_u16(vdup_n_u16((uint16_t)fx[2*h]), vdup_n_u16((uint16_t)fx[2*h + 1]));
+        uint16x8_t wy = vcombine_u16(vdup_n_u16((uint16_t)fy[2*h]), vdup_n_u16((uint16_t)fy[2*h + 1]));
+        uint16x8_t p00 = vmovl_u8(vreinterpret_u8_u32(vld1_u32(&c00[2*h])));
+        uint16x8_t p10 = vmovl_u8(vreinterpret_u8_u32(vld1_u32(&c10[2*h])));
+        uint16x8_t p01 = vmovl_u8(vreinterpret_u8_u32(vld1_u32(&c01[2*h])));
+        uint16x8_t p11 = vmovl_u8(vreinterpret_u8_u32(vld1_u32(&c11[2*h])));
+        uint16x8_t ix = vsubq_u16(full, wx);
+        uint16x8_t top = vshrq_n_u16(vmlaq_u16(vmulq_u16(p00, ix), p10, wx), 8);
+        uint16x8_t bottom = vshrq_n_u16(vmlaq_u16(vmulq_u16(p01, ix), p11, wx), 8);
+        uint16x8_t result = vshrq_n_u16(vmlaq_u16(vmulq_u16(top, vsubq_u16(full, wy)), bottom, wy), 8);
+        vst1_u8(texels[2*h], vmovn_u16(result));
+    }
+#elif defined(SW_HAS_SSE2) || defined(SW_HAS_SSE3) || defined(SW_HAS_SSSE3) || defined(SW_HAS_SSE41) || defined(SW_HAS_SSE42)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(256);
+    __m128i wx = _mm_loadu_si128((const __m128i *)fx);
+    __m128i wy = _mm_loadu_si128((const __m128i *)fy);
+    wx = _mm_packs_epi32(wx, wx);
+    wy = _mm_packs_epi32(wy, wy);
+    wx = _mm_unpacklo_epi16(wx, wx);
+    wy = _mm_unpacklo_epi16(wy, wy);
+    const __m128i wxs[2] = { _mm_unpacklo_epi32(wx, wx), _mm_unpackhi_epi32(wx, wx) };
+    const __m128i wys[2] = { _mm_unpacklo_epi32(wy, wy), _mm_unpackhi_epi32(wy, wy) };
+    const __m128i q00 = _mm_loadu_si128((const __m128i *)c00);
+    const __m128i q10 = _mm_loadu_si128((const __m128i *)c10);
+    const __m128i q01 = _mm_loadu_si128((const __m128i *)c01);
+    const __m128i q11 = _mm_loadu_si128((const __m128i *)c11);
+    __m128i results[2];
+    for (int h = 0; h < 2; h++)
+    {
+        __m128i p00 = h? _mm_unpackhi_epi8(q00, zero) : _mm_unpacklo_epi8(q00, zero);
+        __m128i p10 = h? _mm_unpackhi_epi8(q10, zero) : _mm_unpacklo_epi8(q10, zero);
+        __m128i p01 = h? _mm_unpackhi_epi8(q01, zero) : _mm_unpacklo_epi8(q01, zero);
+        __m128i p11 = h? _mm_unpackhi_epi8(q11, zero) : _mm_unpacklo_epi8(q11, zero);
+        __m128i ix = _mm_sub_epi16(full, wxs[h]);
+        __m128i top = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(p00, ix), _mm_mullo_epi16(p10, wxs[h])), 8);
+        __m128i bottom = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(p01, ix), _mm_mullo_epi16(p11, wxs[h])), 8);
+        results[h] = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(top, _mm_sub_epi16(full, wys[h])), _mm_mullo_epi16(bottom, wys[h])), 8);
+    }
+    _mm_storeu_si128((__m128i *)texels, _mm_packus_epi16(results[0], results[1]));
+#else
+    for (int i = 0; i < 4; i++)
+    {
+        const uint8_t *p00 = (const uint8_t *)&c00[i];
+        const uint8_t *p10 = (const uint8_t *)&c10[i];
+        const uint8_t *p01 = (const uint8_t *)&c01[i];
+        const uint8_t *p11 = (const uint8_t *)&c11[i];
+        uint32_t ix = 256 - fx[i], iy = 256 - fy[i];
+
+        for (int c = 0; c < 4; c++)
+        {
+            uint32_t top = (p00[c]*ix + p10[c]*fx[i]) >> 8;
+            uint32_t bottom = (p01[c]*ix + p11[c]*fx[i]) >> 8;
+            texels[i][c] = (uint8_t)((top*iy + bottom*fy[i]) >> 8);
+        }
+    }
+#endif
+}
+//-------------------------------------------------------------------------------------------
+
+// Color blending functionality
+//-------------------------------------------------------------------------------------------
+static inline void sw_factor_zero(float *SW_RESTRICT factor, const float *SW_RESTRICT src, const float *SW_RESTRICT dst)
+{
+    factor[0] = factor[1] = factor[2] = factor[3] = 0.0f;
+}
+
+static inline void sw_factor_one(float *SW_RESTRICT factor, const float *SW_RESTRICT src, const float *SW_RESTRICT dst)
+{
+    factor[0] = factor[1] = factor[2] = factor[3] = 1.0f;
+}
 
 static inline void sw_factor_src_color(float *SW_RESTRICT factor, const float *SW_RESTRICT src, const float *SW_RESTRICT dst)
 {
@@ -2057,18 +3355,242 @@ static inline void sw_factor_src_alpha_saturate(float *SW_RESTRICT factor, const
     factor[3] = (src[3] < 1.0f)? src[3] : 1.0f;
 }
 
-static inline void sw_blend_colors(float *SW_RESTRICT dst/*[4]*/, const float *SW_RESTRICT src/*[4]*/)
+static inline void sw_blend_colors(const sw_raster_state_t *state, float *SW_RESTRICT dst/*[4]*/, const float *SW_RESTRICT src/*[4]*/)
 {
     float srcFactor[4], dstFactor[4];
 
-    RLSW.srcFactorFunc(srcFactor, src, dst);
-    RLSW.dstFactorFunc(dstFactor, src, dst);
+    state->srcFactorFunc(srcFactor, src, dst);
+    state->dstFactorFunc(dstFactor, src, dst);
 
     dst[0] = srcFactor[0]*src[0] + dstFactor[0]*dst[0];
     dst[1] = srcFactor[1]*src[1] + dstFactor[1]*dst[1];
     dst[2] = srcFactor[2]*src[2] + dstFactor[2]*dst[2];
     dst[3] = srcFactor[3]*src[3] + dstFactor[3]*dst[3];
 }
+
+// Blending of 8-bit unorm colors: dst = src*srcFactor + dst*dstFactor, saturated
+// NOTE: Products are divided by 255 with rounding, x/255 ~= (x + 128 + ((x + 128) >> 8)) >> 8
+#if defined(SW_HAS_NEON_FMA) || defined(SW_HAS_NEON)
+static inline uint16x4_t sw_div255_neon(uint16x4_t x)
+{
+    x = vadd_u16(x, vdup_n_u16(128));
+    return vshr_n_u16(vadd_u16(x, vshr_n_u16(x, 8)), 8);
+}
+#elif defined(SW_HAS_SSE2) || defined(SW_HAS_SSE3) || defined(SW_HAS_SSSE3) || defined(SW_HAS_SSE41) || defined(SW_HAS_SSE42)
+static inline __m128i sw_div255_sse2(__m128i x)
+{
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+#else
+static inline uint32_t sw_div255(uint32_t x)
+{
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+#endif
+
+static inline void sw_blend_colors8(uint8_t *SW_RESTRICT dst/*[4]*/, const float *SW_RESTRICT src/*[4]*/, sw_blend_mode_t mode)
+{
+#if defined(SW_HAS_NEON_FMA) || defined(SW_HAS_NEON)
+    // NOTE: The source color goes straight from float to 16-bit lanes, saturated to [0..255]
+    uint16x4_t s = vmin_u16(vqmovun_s32(vcvtq_s32_f32(vmulq_n_f32(vld1q_f32(src), 255.0f))), vdup_n_u16(255));
+    uint16x4_t d = vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(*(const uint32_t *)dst))));
+    uint16x4_t alpha = vdup_lane_u16(s, 3);
+    uint16x4_t invAlpha = vsub_u16(vdup_n_u16(255), alpha);
+    uint16x4_t result;
+
+    switch (mode)
+    {
+        case SW_BLEND_ALPHA: result = sw_div255_neon(vmla_u16(vmul_u16(s, alpha), d, invAlpha)); break;
+        case SW_BLEND_ADDITIVE: result = vadd_u16(sw_div255_neon(vmul_u16(s, alpha)), d); break;
+        case SW_BLEND_MULTIPLIED: result = vadd_u16(sw_div255_neon(vmul_u16(s, d)), sw_div255_neon(vmul_u16(d, invAlpha))); break;
+        case SW_BLEND_ADD_COLORS: result = vadd_u16(s, d); break;
+        case SW_BLEND_ALPHA_PREMULTIPLY: result = vadd_u16(s, sw_div255_neon(vmul_u16(d, invAlpha))); break;
+        default: return;
+    }
+
+    uint8x8_t packed = vqmovn_u16(vcombine_u16(result, result));
+    vst1_lane_u32((uint32_t *)dst, vreinterpret_u32_u8(packed), 0);
+#elif defined(SW_HAS_SSE2) || defined(SW_HAS_SSE3) || defined(SW_HAS_SSSE3) || defined(SW_HAS_SSE41) || defined(SW_HAS_SSE42)
+    __m128i zero = _mm_setzero_si128();
+    // NOTE: The source color goes straight from float to 16-bit lanes, saturated to [0..255]
+    __m128i s = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src), _mm_set1_ps(255.0f)));
+    s = _mm_packs_epi32(s, s);
+    s = _mm_min_epi16(_mm_max_epi16(s, zero), _mm_set1_epi16(255));
+    __m128i d = _mm_unpacklo_epi8(_mm_cvtsi32_si128(*(const int32_t *)dst), zero);
+    __m128i alpha = _mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i invAlpha = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+    __m128i result;
+
+    switch (mode)
+    {
+        case SW_BLEND_ALPHA: result = sw_div255_sse2(_mm_add_epi16(_mm_mullo_epi16(s, alpha), _mm_mullo_epi16(d, invAlpha))); break;
+        case SW_BLEND_ADDITIVE: result = _mm_add_epi16(sw_div255_sse2(_mm_mullo_epi16(s, alpha)), d); break;
+        case SW_BLEND_MULTIPLIED: result = _mm_add_epi16(sw_div255_sse2(_mm_mullo_epi16(s, d)), sw_div255_sse2(_mm_mullo_epi16(d, invAlpha))); break;
+        case SW_BLEND_ADD_COLORS: result = _mm_add_epi16(s, d); break;
+        case SW_BLEND_ALPHA_PREMULTIPLY: result = _mm_add_epi16(s, sw_div255_sse2(_mm_mullo_epi16(d, invAlpha))); break;
+        default: return;
+    }
+
+    *(int32_t *)dst = _mm_cvtsi128_si32(_mm_packus_epi16(result, zero));
+#else
+    uint32_t src8[4];
+    for (int i = 0; i < 4; i++)
+    {
+        float value = src[i]*255.0f;
+        value = (value > 255.0f)? 255.0f : value;
+        value = (value < 0.0f)? 0.0f : value;
+        src8[i] = (uint32_t)value;
+    }
+
+    uint32_t alpha = src8[3];
+    uint32_t invAlpha = 255 - alpha;
+    uint32_t result[4];
+
+    switch (mode)
+    {
+        case SW_BLEND_ALPHA: for (int i = 0; i < 4; i++) result[i] = sw_div255(src8[i]*alpha + dst[i]*invAlpha); break;
+        case SW_BLEND_ADDITIVE: for (int i = 0; i < 4; i++) result[i] = sw_div255(src8[i]*alpha) + dst[i]; break;
+        case SW_BLEND_MULTIPLIED: for (int i = 0; i < 4; i++) result[i] = sw_div255(src8[i]*dst[i]) + sw_div255(dst[i]*invAlpha); break;
+        case SW_BLEND_ADD_COLORS: for (int i = 0; i < 4; i++) result[i] = src8[i] + dst[i]; break;
+        case SW_BLEND_ALPHA_PREMULTIPLY: for (int i = 0; i < 4; i++) result[i] = src8[i] + sw_div255(dst[i]*invAlpha); break;
+        default: return;
+    }
+
+    for (int i = 0; i < 4; i++) dst[i] = (result[i] > 255)? 255 : (uint8_t)result[i];
+#endif
+}
+
+// Blends a color into a framebuffer pixel, using the fixed-point kernels when possible
+static inline void sw_framebuffer_blend_color(sw_color_t *dst, const float src[4], const sw_raster_state_t *state)
+{
+#if !SW_COLOR_IS_PACKED && SW_FIXED_POINT_BLEND
+    if (state->blendMode != SW_BLEND_GENERIC)
+    {
+        sw_blend_colors8(dst->color, src, state->blendMode);
+        return;
+    }
+#endif
+
+    float dstColor[4];
+    sw_framebuffer_read_color(dstColor, dst);
+    sw_blend_colors(state, dstColor, src);
+    sw_framebuffer_write_color(dst, dstColor);
+}
+
+// Outputs a fragment color to the covered samples of a multisampled raster target pixel
+// NOTE: Sample 0 is the color plane pixel, the other ones follow each other in the multisample plane
+static inline void sw_framebuffer_output_samples(const sw_raster_t *r, sw_color_t *dst, const float src[4], bool blend, uint32_t samples)
+{
+    SW_RASTER_STATS_ADD(r, pixelsShaded, 1);
+
+    sw_color_t *extra = r->sampleColors + (dst - r->colors)*(SW_MSAA_SAMPLES - 1);
+
+    if (blend)
+    {
+        if (samples & 1) sw_framebuffer_blend_color(dst, src, r->state);
+        for (int s = 1; s < SW_MSAA_SAMPLES; s++)
+        {
+            if (samples & (1u << s)) sw_framebuffer_blend_color(&extra[s - 1], src, r->state);
+        }
+        return;
+    }
+
+    // Without blending the color is the same for all the samples, it is converted once
+    sw_color_t color;
+    sw_framebuffer_write_color(&color, src);
+
+    if (samples & 1) *dst = color;
+    for (int s = 1; s < SW_MSAA_SAMPLES; s++)
+    {
+        if (samples & (1u << s)) extra[s - 1] = color;
+    }
+}
+
+// Outputs a fragment color to a raster target pixel, blended or not, in the color plane order
+// NOTE: Primitives without sample coverage (lines and points) write all the samples of a multisampled pixel
+static inline void sw_framebuffer_output_color(const sw_raster_t *r, sw_color_t *dst, const float src[4], bool blend)
+{
+    if (r->sampleColors != NULL)
+    {
+        sw_framebuffer_output_samples(r, dst, src, blend, SW_MSAA_SAMPLE_MASK);
+        return;
+    }
+
+    SW_RASTER_STATS_ADD(r, pixelsShaded, 1);
+
+#if !SW_COLOR_IS_PACKED
+    if (r->bgra)
+    {
+        const float color[4] = { src[2], src[1], src[0], src[3] };
+        if (blend) sw_framebuffer_blend_color(dst, color, r->state);
+        else sw_framebuffer_write_color(dst, color);
+        return;
+    }
+#endif
+
+    if (blend) sw_framebuffer_blend_color(dst, src, r->state);
+    else sw_framebuffer_write_color(dst, src);
+}
+
+// Writes a fragment depth to a raster target pixel, and to all its samples if multisampled
+static inline void sw_framebuffer_output_depth(const sw_raster_t *r, sw_depth_t *dst, float depth)
+{
+    sw_framebuffer_write_depth(dst, depth);
+
+    if (r->sampleDepths != NULL)
+    {
+        sw_depth_t *extra = r->sampleDepths + (dst - r->depths)*(SW_MSAA_SAMPLES - 1);
+        for (int s = 0; s < SW_MSAA_SAMPLES - 1; s++) extra[s] = *dst;
+    }
+}
+
+// Depth test of the covered samples of a multisampled pixel, returns the passing samples
+// NOTE: The depth of each sample is the pixel center depth plus its offset along the depth plane
+static inline uint32_t sw_framebuffer_test_samples(const sw_raster_t *r, const sw_depth_t *dst, float depth, const float offsets[SW_MSAA_SAMPLES], uint32_t samples)
+{
+    const sw_depth_t *extra = r->sampleDepths + (dst - r->depths)*(SW_MSAA_SAMPLES - 1);
+    uint32_t pass = 0;
+
+    if ((samples & 1) && (depth + offsets[0] <= sw_framebuffer_read_depth(dst))) pass |= 1;
+    for (int s = 1; s < SW_MSAA_SAMPLES; s++)
+    {
+        if ((samples & (1u << s)) && (depth + offsets[s] <= sw_framebuffer_read_depth(&extra[s - 1]))) pass |= (1u << s);
+    }
+
+    return pass;
+}
+
+// Writes the depths of the covered samples of a multisampled pixel
+static inline void sw_framebuffer_output_depth_samples(const sw_raster_t *r, sw_depth_t *dst, float depth, const float offsets[SW_MSAA_SAMPLES], uint32_t samples)
+{
+    sw_depth_t *extra = r->sampleDepths + (dst - r->depths)*(SW_MSAA_SAMPLES - 1);
+
+    if (samples & 1) sw_framebuffer_write_depth(dst, depth + offsets[0]);
+    for (int s = 1; s < SW_MSAA_SAMPLES; s++)
+    {
+        if (samples & (1u << s)) sw_framebuffer_write_depth(&extra[s - 1], depth + offsets[s]);
+    }
+}
+
+// Runs the fragment program of the raster state, the texel is white if none (lines and points)
+static inline void sw_fragment_program(const sw_raster_t *r, float color[4], const float texColor[4], float s, float t, int x, int y)
+{
+    static const float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    const float texcoord[2] = { s, t };
+
+    r->state->fragmentProc(color, (texColor != NULL)? texColor : white, texcoord, x, y, r->state->uniforms);
+
+    color[0] = sw_saturate(color[0]);
+    color[1] = sw_saturate(color[1]);
+    color[2] = sw_saturate(color[2]);
+    color[3] = sw_saturate(color[3]);
+}
+
+// Depth test and blending of the fragment program raster functions, checked at rasterization
+#define SW_PROGRAM_DEPTH_TEST   SW_STATE_CHECK_EX(r->state->flags, SW_STATE_DEPTH_TEST)
+#define SW_PROGRAM_BLEND        SW_STATE_CHECK_EX(r->state->flags, SW_STATE_BLEND)
 //-------------------------------------------------------------------------------------------
 
 // Projection helper functions
@@ -2080,6 +3602,89 @@ static inline void sw_project_ndc_to_screen(float screen[2], const float ndc[4])
 }
 //-------------------------------------------------------------------------------------------
 
+// Raster state management
+//-------------------------------------------------------------------------------------------
+static inline uint32_t sw_raster_get_flags(void)
+{
+    uint32_t state = RLSW.stateFlags;
+
+    if (RLSW.currentTexture == 0) state &= ~SW_STATE_TEXTURE_2D;
+    if ((RLSW.srcFactor == SW_ONE) && (RLSW.dstFactor == SW_ZERO)) state &= ~SW_STATE_BLEND;
+    if (RLSW.framebuffer.sampleColors == NULL) state &= ~SW_STATE_MULTISAMPLE; // Framebuffer objects are not multisampled
+
+    return state;
+}
+
+static inline void sw_raster_get_state(sw_raster_state_t *state, sw_raster_type_t type)
+{
+    uint32_t flags = sw_raster_get_flags();
+
+    // NOTE: Fragment programs sample the default white texture when texturing is disabled
+    state->texture = &RLSW.loadedTextures[(flags & SW_STATE_TEXTURE_2D)? RLSW.currentTexture : 0];
+    state->srcFactorFunc = RLSW.srcFactorFunc;
+    state->dstFactorFunc = RLSW.dstFactorFunc;
+    state->blendMode = RLSW.blendMode;
+    state->lineWidth = RLSW.lineWidth;
+    state->pointRadius = RLSW.pointRadius;
+    state->clearValue = RLSW.clearValue;
+    state->flags = flags;
+    state->fragmentProc = RLSW.fragmentProc;
+    state->uniforms = RLSW.programUniforms;
+
+    if (type == SW_RASTER_CLEAR)
+    {
+        // Clears affect the scissor rectangle (inclusive) or the whole framebuffer
+        if (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)
+        {
+            state->clipMin[0] = RLSW.scMin[0];
+            state->clipMin[1] = RLSW.scMin[1];
+            state->clipMax[0] = RLSW.scMax[0] + 1;
+            state->clipMax[1] = RLSW.scMax[1] + 1;
+        }
+        else
+        {
+            state->clipMin[0] = 0;
+            state->clipMin[1] = 0;
+            state->clipMax[0] = RLSW.framebuffer.width;
+            state->clipMax[1] = RLSW.framebuffer.height;
+        }
+    }
+    else if ((type == SW_RASTER_POLYGON) || (type == SW_RASTER_QUAD_AXIS_ALIGNED) || (type == SW_RASTER_QUAD_AFFINE))
+    {
+        // Polygons are limited to the pixels the frustum and scissor clipping would keep,
+        // required by the ones left unclipped inside the guard band
+        int vpX = (int)(RLSW.vpCenter[0] - RLSW.vpHalf[0]);
+        int vpY = (int)(RLSW.vpCenter[1] - RLSW.vpHalf[1]);
+
+        state->clipMin[0] = sw_maxi(vpX, 0);
+        state->clipMin[1] = sw_maxi(vpY, 0);
+        state->clipMax[0] = sw_mini(vpX + RLSW.vpSize[0], RLSW.framebuffer.width);
+        state->clipMax[1] = sw_mini(vpY + RLSW.vpSize[1], RLSW.framebuffer.height);
+
+        if (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)
+        {
+            state->clipMin[0] = sw_maxi(state->clipMin[0], RLSW.scMin[0]);
+            state->clipMin[1] = sw_maxi(state->clipMin[1], RLSW.scMin[1]);
+            state->clipMax[0] = sw_mini(state->clipMax[0], RLSW.scMax[0]);
+            state->clipMax[1] = sw_mini(state->clipMax[1], RLSW.scMax[1]);
+        }
+    }
+    else
+    {
+        const int *min = (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)? RLSW.scMin : RLSW.vpMin;
+        const int *max = (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)? RLSW.scMax : RLSW.vpMax;
+
+        state->clipMin[0] = min[0];
+        state->clipMin[1] = min[1];
+        state->clipMax[0] = max[0];
+        state->clipMax[1] = max[1];
+    }
+}
+
+// Rasterizes the primitive or bins it for deferred rasterization, defined after the raster functions
+static inline void sw_raster_submit(sw_raster_type_t type, uint32_t flags, const sw_vertex_t *vertices, int count);
+//-------------------------------------------------------------------------------------------
+
 // Polygon clipping management
 //-------------------------------------------------------------------------------------------
 #define DEFINE_CLIP_FUNC(name, FUNC_IS_INSIDE, FUNC_COMPUTE_T)                          \
@@ -2160,13 +3765,71 @@ DEFINE_CLIP_FUNC(scissor_y_min, IS_INSIDE_SCISSOR_Y_MIN, COMPUTE_T_SCISSOR_Y_MIN
 DEFINE_CLIP_FUNC(scissor_y_max, IS_INSIDE_SCISSOR_Y_MAX, COMPUTE_T_SCISSOR_Y_MAX)
 //-------------------------------------------------------------------------------------------
 
+// Clip planes outcodes
+//-------------------------------------------------------------------------------------------
+#define SW_CLIP_W           0x01
+#define SW_CLIP_X_POS       0x02
+#define SW_CLIP_X_NEG       0x04
+#define SW_CLIP_Y_POS       0x08
+#define SW_CLIP_Y_NEG       0x10
+#define SW_CLIP_Z_POS       0x20
+#define SW_CLIP_Z_NEG       0x40
+#define SW_CLIP_GUARD_BAND  0x80    // Outside of the guard band, not a clip plane
+
+// Gets the planes a vertex is outside of
+static inline uint32_t sw_clip_outcode(const float h[4], const float guardBand[2])
+{
+    uint32_t code = 0;
+
+    if (!IS_INSIDE_PLANE_W(h)) code |= SW_CLIP_W;
+    if (!IS_INSIDE_PLANE_X_POS(h)) code |= SW_CLIP_X_POS;
+    if (!IS_INSIDE_PLANE_X_NEG(h)) code |= SW_CLIP_X_NEG;
+    if (!IS_INSIDE_PLANE_Y_POS(h)) code |= SW_CLIP_Y_POS;
+    if (!IS_INSIDE_PLANE_Y_NEG(h)) code |= SW_CLIP_Y_NEG;
+    if (!IS_INSIDE_PLANE_Z_POS(h)) code |= SW_CLIP_Z_POS;
+    if (!IS_INSIDE_PLANE_Z_NEG(h)) code |= SW_CLIP_Z_NEG;
+
+    if ((fabsf(h[0]) > guardBand[0]*h[3]) || (fabsf(h[1]) > guardBand[1]*h[3])) code |= SW_CLIP_GUARD_BAND;
+
+    return code;
+}
+//-------------------------------------------------------------------------------------------
+
 // Main polygon clip function
+// NOTE: Only the planes crossed by the polygon are clipped, and with a guard band, the polygons inside it
+// are not clipped against the sides of the frustum and the scissor rectangle, the raster clip rectangle limits them
 static inline bool sw_polygon_clip(sw_vertex_t polygon[SW_MAX_CLIPPED_POLYGON_VERTICES], int *vertexCounter)
 {
-    static sw_vertex_t tmp[SW_MAX_CLIPPED_POLYGON_VERTICES];
+    sw_vertex_t tmp[SW_MAX_CLIPPED_POLYGON_VERTICES];
 
     int n = *vertexCounter;
 
+    // Guard band limits in clip space, relative to the viewport half dimensions
+    float guardBand[2] = { FLT_MAX, FLT_MAX };
+    if (SW_GUARD_BAND > 0)
+    {
+        guardBand[0] = 1.0f + (float)SW_GUARD_BAND/fmaxf(RLSW.vpHalf[0], 1.0f);
+        guardBand[1] = 1.0f + (float)SW_GUARD_BAND/fmaxf(RLSW.vpHalf[1], 1.0f);
+    }
+
+    // A polygon is outside if all its vertices are outside of the same plane, and it can only
+    // cross the planes some of its vertices are outside of
+    uint32_t codeAnd = 0xFF, codeOr = 0;
+    for (int i = 0; i < n; i++)
+    {
+        uint32_t code = sw_clip_outcode(polygon[i].homogeneous, guardBand);
+        codeAnd &= code;
+        codeOr |= code;
+    }
+
+    if (codeAnd & ~SW_CLIP_GUARD_BAND)
+    {
+        *vertexCounter = 0;
+        return false;
+    }
+
+    bool guardBandClip = (SW_GUARD_BAND > 0) && !(codeOr & (SW_CLIP_W | SW_CLIP_GUARD_BAND));
+
     #define CLIP_AGAINST_PLANE(FUNC_CLIP)                       \
     {                                                           \
         n = FUNC_CLIP(tmp, polygon, n);                         \
@@ -2178,15 +3841,20 @@ static inline bool sw_polygon_clip(sw_vertex_t polygon[SW_MAX_CLIPPED_POLYGON_VE
         for (int i = 0; i < n; i++) polygon[i] = tmp[i];        \
     }
 
-    CLIP_AGAINST_PLANE(sw_clip_w);
-    CLIP_AGAINST_PLANE(sw_clip_x_pos);
-    CLIP_AGAINST_PLANE(sw_clip_x_neg);
-    CLIP_AGAINST_PLANE(sw_clip_y_pos);
-    CLIP_AGAINST_PLANE(sw_clip_y_neg);
-    CLIP_AGAINST_PLANE(sw_clip_z_pos);
-    CLIP_AGAINST_PLANE(sw_clip_z_neg);
+    if (codeOr & SW_CLIP_W) CLIP_AGAINST_PLANE(sw_clip_w);
 
-    if (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)
+    if (!guardBandClip)
+    {
+        if (codeOr & SW_CLIP_X_POS) CLIP_AGAINST_PLANE(sw_clip_x_pos);
+        if (codeOr & SW_CLIP_X_NEG) CLIP_AGAINST_PLANE(sw_clip_x_neg);
+        if (codeOr & SW_CLIP_Y_POS) CLIP_AGAINST_PLANE(sw_clip_y_pos);
+        if (codeOr & SW_CLIP_Y_NEG) CLIP_AGAINST_PLANE(sw_clip_y_neg);
+    }
+
+    if (codeOr & SW_CLIP_Z_POS) CLIP_AGAINST_PLANE(sw_clip_z_pos);
+    if (codeOr & SW_CLIP_Z_NEG) CLIP_AGAINST_PLANE(sw_clip_z_neg);
+
+    if (!guardBandClip && (RLSW.stateFlags & SW_STATE_SCISSOR_TEST))
     {
         CLIP_AGAINST_PLANE(sw_clip_scissor_x_min);
         CLIP_AGAINST_PLANE(sw_clip_scissor_x_max);
@@ -2199,57 +3867,342 @@ static inline bool sw_polygon_clip(sw_vertex_t polygon[SW_MAX_CLIPPED_POLYGON_VE
     return (n >= 3);
 }
 
-// Triangle rendering logic
+// Depth tiles functionality
 //-------------------------------------------------------------------------------------------
-static inline bool sw_triangle_face_culling(void)
-{
-    // NOTE: Face culling is done before clipping to avoid unnecessary computations
-    // To handle triangles crossing the w=0 plane correctly,
-    // the winding order test is performeed in homogeneous coordinates directly,
-    // before the perspective division (division by w)
-    // This test determines the orientation of the triangle in the (x,y,w) plane,
-    // which corresponds to the projected 2D winding order sign,
-    // even with negative w values
-
-    // Preload homogeneous coordinates into local variables
-    const float *h0 = RLSW.vertexBuffer[0].homogeneous;
-    const float *h1 = RLSW.vertexBuffer[1].homogeneous;
-    const float *h2 = RLSW.vertexBuffer[2].homogeneous;
-
-    // Compute a value proportional to the signed area in the projected 2D plane,
-    // calculated directly using homogeneous coordinates BEFORE division by w
-    // This is the determinant of the matrix formed by the (x, y, w) components
-    // of the vertices, which correctly captures the winding order in homogeneous
-    // space and its relationship to the projected 2D winding order, even with
-    // negative w values
-    // The determinant formula used here is:
-    // h0.x*(h1.y*h2.w - h2.y*h1.w) +
-    // h1.x*(h2.y*h0.w - h0.y*h2.w) +
-    // h2.x*(h0.y*h1.w - h1.y*h0.w)
+// NOTE: The depth test passes for fragments less or equal than the stored depth, so primitives
+// behind the maximum depth of a tile can be rejected, and the ones in front of the minimum depth
+// of a tile can skip the depth reads, bounds are only lowered by depth tested primitives fully
+// covering a tile and widened by the other writes
 
-    const float hSgnArea =
-        h0[0]*(h1[1]*h2[3] - h2[1]*h1[3]) +
-        h1[0]*(h2[1]*h0[3] - h0[1]*h2[3]) +
-        h2[0]*(h0[1]*h1[3] - h1[1]*h0[3]);
+// Margin of the primitive depth ranges, covers the depth quantization and the interpolation errors
+#define SW_DEPTH_TILE_EPSILON   1e-4f
 
-    // Discard the triangle if its winding order (determined by the sign
-    // of the homogeneous area/determinant) matches the culled direction
-    // A positive hSgnArea typically corresponds to a counter-clockwise
-    // winding in the projected space when all w > 0
-    // This test is robust for points with w > 0 or w < 0, correctly
-    // capturing the change in orientation when crossing the w=0 plane
+// Depth plane of a triangle in screen space
+typedef struct {
+    float x0, y0, z0;           // Reference vertex
+    float dZdx, dZdy;           // Depth gradients
+    float zMin, zMax;           // Depth range of the triangle, extended by one pixel step
+    float xMin, yMin;           // Screen bounding box minimum point
+    float xMax, yMax;           // Screen bounding box maximum point
+    float area;                 // Twice the signed area, zero for degenerate triangles
+} sw_depth_plane_t;
 
-    // The culling logic remains the same based on the signed area/determinant
-    // A value of 0 for hSgnArea means the points are collinear in (x, y, w)
-    // space, which corresponds to a degenerate triangle projection
-    // Such triangles are typically not culled by this test (0 < 0 is false, 0 > 0 is false)
-    // and should be handled by the clipper if necessary
-    return (RLSW.cullFace == SW_FRONT)? (hSgnArea < 0) : (hSgnArea > 0); // Cull if winding is "clockwise" : "counter-clockwise"
+static inline sw_depth_tile_t *sw_depth_tile_at(const sw_raster_t *r, int x, int y)
+{
+    return &r->depthTiles[(y/SW_DEPTH_TILE_SIZE)*r->depthTilesX + x/SW_DEPTH_TILE_SIZE];
 }
 
-static inline void sw_triangle_clip_and_project(void)
+// Gets the depth tiles overlapped by a screen rectangle, limited to the raster region
+// NOTE: The rectangle is expanded by one pixel, rasterizers can cover pixels slightly outside of it
+static inline bool sw_depth_tiles_get_range(const sw_raster_t *r, float xMin, float yMin, float xMax, float yMax, int tMin[2], int tMax[2])
 {
-    sw_vertex_t *polygon = RLSW.vertexBuffer;
+    int x0 = sw_maxi((int)floorf(xMin) - 1, r->xMin);
+    int y0 = sw_maxi((int)floorf(yMin) - 1, r->yMin);
+    int x1 = sw_mini((int)xMax + 1, r->xMax - 1);
+    int y1 = sw_mini((int)yMax + 1, r->yMax - 1);
+
+    if ((x0 > x1) || (y0 > y1)) return false;
+
+    tMin[0] = x0/SW_DEPTH_TILE_SIZE;
+    tMin[1] = y0/SW_DEPTH_TILE_SIZE;
+    tMax[0] = x1/SW_DEPTH_TILE_SIZE;
+    tMax[1] = y1/SW_DEPTH_TILE_SIZE;
+
+    return true;
+}
+
+// Gets the screen rectangle of a depth tile, limited to the raster region and expanded by one pixel
+static inline void sw_depth_tile_get_rect(const sw_raster_t *r, int tx, int ty, float rect[4])
+{
+    rect[0] = (float)sw_maxi(tx*SW_DEPTH_TILE_SIZE, r->xMin) - 1.0f;
+    rect[1] = (float)sw_maxi(ty*SW_DEPTH_TILE_SIZE, r->yMin) - 1.0f;
+    rect[2] = (float)sw_mini((tx + 1)*SW_DEPTH_TILE_SIZE, r->xMax) + 1.0f;
+    rect[3] = (float)sw_mini((ty + 1)*SW_DEPTH_TILE_SIZE, r->yMax) + 1.0f;
+}
+
+// Widens the bounds of the depth tiles overlapped by a screen rectangle
+// NOTE: Depth tested writes can only lower the depth values
+static inline void sw_depth_tiles_widen(const sw_raster_t *r, float xMin, float yMin, float xMax, float yMax, float zLo, float zHi, bool depthTest)
+{
+    int tMin[2], tMax[2];
+    if (!sw_depth_tiles_get_range(r, xMin, yMin, xMax, yMax, tMin, tMax)) return;
+
+    zLo = sw_saturate(zLo - SW_DEPTH_TILE_EPSILON);
+    zHi = sw_saturate(zHi + SW_DEPTH_TILE_EPSILON);
+
+    for (int ty = tMin[1]; ty <= tMax[1]; ty++)
+    {
+        sw_depth_tile_t *tile = &r->depthTiles[ty*r->depthTilesX + tMin[0]];
+
+        for (int tx = tMin[0]; tx <= tMax[0]; tx++, tile++)
+        {
+            if (tile->zMin > zLo) tile->zMin = zLo;
+            if (!depthTest && (tile->zMax < zHi)) tile->zMax = zHi;
+        }
+    }
+}
+
+static inline void sw_depth_plane_init(sw_depth_plane_t *p, const sw_vertex_t *v0, const sw_vertex_t *v1, const sw_vertex_t *v2)
+{
+    float dx1 = v1->screen[0] - v0->screen[0], dy1 = v1->screen[1] - v0->screen[1];
+    float dx2 = v2->screen[0] - v0->screen[0], dy2 = v2->screen[1] - v0->screen[1];
+    float dz1 = v1->homogeneous[2] - v0->homogeneous[2];
+    float dz2 = v2->homogeneous[2] - v0->homogeneous[2];
+
+    p->x0 = v0->screen[0];
+    p->y0 = v0->screen[1];
+    p->z0 = v0->homogeneous[2];
+
+    p->xMin = fminf(p->x0, fminf(v1->screen[0], v2->screen[0]));
+    p->yMin = fminf(p->y0, fminf(v1->screen[1], v2->screen[1]));
+    p->xMax = fmaxf(p->x0, fmaxf(v1->screen[0], v2->screen[0]));
+    p->yMax = fmaxf(p->y0, fmaxf(v1->screen[1], v2->screen[1]));
+
+    p->area = dx1*dy2 - dx2*dy1;
+
+    if (fabsf(p->area) < 1e-6f)
+    {
+        // NOTE: Depth values of degenerate triangles are not predictable, any value is possible
+        p->area = 0.0f;
+        p->dZdx = p->dZdy = 0.0f;
+        p->zMin = -FLT_MAX;
+        p->zMax = FLT_MAX;
+        return;
+    }
+
+    float areaRcp = 1.0f/p->area;
+    p->dZdx = (dz1*dy2 - dz2*dy1)*areaRcp;
+    p->dZdy = (dz2*dx1 - dz1*dx2)*areaRcp;
+
+    float step = fabsf(p->dZdx) + fabsf(p->dZdy);
+    p->zMin = fminf(p->z0, fminf(v1->homogeneous[2], v2->homogeneous[2])) - step;
+    p->zMax = fmaxf(p->z0, fmaxf(v1->homogeneous[2], v2->homogeneous[2])) + step;
+}
+
+// Gets the depth range of a triangle over a screen rectangle
+static inline void sw_depth_plane_get_range(const sw_depth_plane_t *p, const float rect[4], float *zLo, float *zHi)
+{
+    float lo = p->zMin;
+    float hi = p->zMax;
+
+    if (p->area != 0.0f)
+    {
+        float zc = p->z0 + p->dZdx*(0.5f*(rect[0] + rect[2]) - p->x0) + p->dZdy*(0.5f*(rect[1] + rect[3]) - p->y0);
+        float zr = 0.5f*(fabsf(p->dZdx)*(rect[2] - rect[0]) + fabsf(p->dZdy)*(rect[3] - rect[1]));
+        lo = fmaxf(lo, zc - zr);
+        hi = fminf(hi, zc + zr);
+    }
+
+    *zLo = lo - SW_DEPTH_TILE_EPSILON;
+    *zHi = hi + SW_DEPTH_TILE_EPSILON;
+}
+
+static inline bool sw_triangle_covers_rect(const sw_depth_plane_t *p, const sw_vertex_t *v[3], const float rect[4])
+{
+    if (p->area == 0.0f) return false;
+
+    float sign = (p->area > 0.0f)? 1.0f : -1.0f;
+
+    for (int i = 0; i < 3; i++)
+    {
+        const float *a = v[i]->screen;
+        const float *b = v[(i + 1)%3]->screen;
+        float ex = (b[0] - a[0])*sign;
+        float ey = (b[1] - a[1])*sign;
+
+        // The edge function is linear, the rectangle is inside if its four corners are
+        if ((ex*(rect[1] - a[1]) - ey*(rect[0] - a[0]) < 0.0f) ||
+            (ex*(rect[1] - a[1]) - ey*(rect[2] - a[0]) < 0.0f) ||
+            (ex*(rect[3] - a[1]) - ey*(rect[0] - a[0]) < 0.0f) ||
+            (ex*(rect[3] - a[1]) - ey*(rect[2] - a[0]) < 0.0f)) return false;
+    }
+
+    return true;
+}
+
+// Checks if a triangle is behind all the depth tiles it overlaps
+static inline bool sw_depth_tiles_reject_triangle(const sw_raster_t *r, const sw_depth_plane_t *p)
+{
+    int tMin[2], tMax[2];
+    if (!sw_depth_tiles_get_range(r, p->xMin, p->yMin, p->xMax, p->yMax, tMin, tMax)) return true;
+
+    for (int ty = tMin[1]; ty <= tMax[1]; ty++)
+    {
+        for (int tx = tMin[0]; tx <= tMax[0]; tx++)
+        {
+            float rect[4], zLo, zHi;
+            sw_depth_tile_get_rect(r, tx, ty, rect);
+            sw_depth_plane_get_range(p, rect, &zLo, &zHi);
+
+            if (zLo <= r->depthTiles[ty*r->depthTilesX + tx].zMax) return false;
+        }
+    }
+
+    return true;
+}
+
+// Checks if the part of a depth tile inside the raster region is inside the state clip rectangle,
+// primitives can only fully cover the tiles they are not clipped in
+static inline bool sw_depth_tile_is_unclipped(const sw_raster_t *r, int tx, int ty)
+{
+    return (sw_maxi(tx*SW_DEPTH_TILE_SIZE, r->xMin) >= r->state->clipMin[0]) &&
+           (sw_maxi(ty*SW_DEPTH_TILE_SIZE, r->yMin) >= r->state->clipMin[1]) &&
+           (sw_mini((tx + 1)*SW_DEPTH_TILE_SIZE, r->xMax) <= r->state->clipMax[0]) &&
+           (sw_mini((ty + 1)*SW_DEPTH_TILE_SIZE, r->yMax) <= r->state->clipMax[1]);
+}
+
+// Updates the bounds of the depth tiles overlapped by a rasterized triangle
+static inline void sw_depth_tiles_update_triangle(const sw_raster_t *r, const sw_depth_plane_t *p, const sw_vertex_t *v[3], bool depthTest)
+{
+    int tMin[2], tMax[2];
+    if (!sw_depth_tiles_get_range(r, p->xMin, p->yMin, p->xMax, p->yMax, tMin, tMax)) return;
+
+    for (int ty = tMin[1]; ty <= tMax[1]; ty++)
+    {
+        for (int tx = tMin[0]; tx <= tMax[0]; tx++)
+        {
+            sw_depth_tile_t *tile = &r->depthTiles[ty*r->depthTilesX + tx];
+
+            float rect[4], zLo, zHi;
+            sw_depth_tile_get_rect(r, tx, ty, rect);
+            sw_depth_plane_get_range(p, rect, &zLo, &zHi);
+
+            zLo = sw_saturate(zLo);
+            zHi = sw_saturate(zHi);
+
+            if (tile->zMin > zLo) tile->zMin = zLo;
+
+            if (!depthTest)
+            {
+                if (tile->zMax < zHi) tile->zMax = zHi;
+            }
+            else if ((tile->zMax > zHi) && sw_depth_tile_is_unclipped(r, tx, ty) && sw_triangle_covers_rect(p, v, rect))
+            {
+                // Each pixel of the tile keeps the nearest of its depth and the triangle one
+                tile->zMax = zHi;
+            }
+        }
+    }
+}
+
+// Checks if a depth range is behind all the depth tiles overlapped by a pixel rectangle
+static inline bool sw_depth_tiles_reject_rect(const sw_raster_t *r, int xMin, int yMin, int xMax, int yMax, float zLo)
+{
+    xMin = sw_maxi(xMin, r->xMin);
+    yMin = sw_maxi(yMin, r->yMin);
+    xMax = sw_mini(xMax, r->xMax);
+    yMax = sw_mini(yMax, r->yMax);
+
+    if ((xMin >= xMax) || (yMin >= yMax)) return true;
+
+    for (int ty = yMin/SW_DEPTH_TILE_SIZE; ty <= (yMax - 1)/SW_DEPTH_TILE_SIZE; ty++)
+    {
+        for (int tx = xMin/SW_DEPTH_TILE_SIZE; tx <= (xMax - 1)/SW_DEPTH_TILE_SIZE; tx++)
+        {
+            if (zLo <= r->depthTiles[ty*r->depthTilesX + tx].zMax) return false;
+        }
+    }
+
+    return true;
+}
+
+// Updates the bounds of the depth tiles overlapped by a pixel rectangle written with a depth range
+// NOTE: Overwriting writes (clears, primitives without depth test) replace the bounds of the tiles they
+// fully cover, depth tested writes can only lower them
+static inline void sw_depth_tiles_update_rect(const sw_raster_t *r, int xMin, int yMin, int xMax, int yMax, float zLo, float zHi, bool overwrite)
+{
+    xMin = sw_maxi(xMin, r->xMin);
+    yMin = sw_maxi(yMin, r->yMin);
+    xMax = sw_mini(xMax, r->xMax);
+    yMax = sw_mini(yMax, r->yMax);
+
+    if ((xMin >= xMax) || (yMin >= yMax)) return;
+
+    zLo = sw_saturate(zLo);
+    zHi = sw_saturate(zHi);
+
+    for (int ty = yMin/SW_DEPTH_TILE_SIZE; ty <= (yMax - 1)/SW_DEPTH_TILE_SIZE; ty++)
+    {
+        bool coveredY = (sw_maxi(ty*SW_DEPTH_TILE_SIZE, r->yMin) >= yMin) &&
+                        (sw_mini((ty + 1)*SW_DEPTH_TILE_SIZE, r->yMax) <= yMax);
+
+        for (int tx = xMin/SW_DEPTH_TILE_SIZE; tx <= (xMax - 1)/SW_DEPTH_TILE_SIZE; tx++)
+        {
+            sw_depth_tile_t *tile = &r->depthTiles[ty*r->depthTilesX + tx];
+
+            bool covered = coveredY && (sw_maxi(tx*SW_DEPTH_TILE_SIZE, r->xMin) >= xMin) &&
+                           (sw_mini((tx + 1)*SW_DEPTH_TILE_SIZE, r->xMax) <= xMax);
+
+            if (covered && overwrite)
+            {
+                tile->zMin = zLo;
+                tile->zMax = zHi;
+                continue;
+            }
+
+            if (tile->zMin > zLo) tile->zMin = zLo;
+
+            if (overwrite)
+            {
+                if (tile->zMax < zHi) tile->zMax = zHi;
+            }
+            else if (covered && (tile->zMax > zHi)) tile->zMax = zHi;
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------
+
+// Triangle rendering logic
+//-------------------------------------------------------------------------------------------
+static inline bool sw_triangle_face_culling(void)
+{
+    // NOTE: Face culling is done before clipping to avoid unnecessary computations
+    // To handle triangles crossing the w=0 plane correctly,
+    // the winding order test is performeed in homogeneous coordinates directly,
+    // before the perspective division (division by w)
+    // This test determines the orientation of the triangle in the (x,y,w) plane,
+    // which corresponds to the projected 2D winding order sign,
+    // even with negative w values
+
+    // Preload homogeneous coordinates into local variables
+    const float *h0 = RLSW.vertexBuffer[0].homogeneous;
+    const float *h1 = RLSW.vertexBuffer[1].homogeneous;
+    const float *h2 = RLSW.vertexBuffer[2].homogeneous;
+
+    // Compute a value proportional to the signed area in the projected 2D plane,
+    // calculated directly using homogeneous coordinates BEFORE division by w
+    // This is the determinant of the matrix formed by the (x, y, w) components
+    // of the vertices, which correctly captures the winding order in homogeneous
+    // space and its relationship to the projected 2D winding order, even with
+    // negative w values
+    // The determinant formula used here is:
+    // h0.x*(h1.y*h2.w - h2.y*h1.w) +
+    // h1.x*(h2.y*h0.w - h0.y*h2.w) +
+    // h2.x*(h0.y*h1.w - h1.y*h0.w)
+
+    const float hSgnArea =
+        h0[0]*(h1[1]*h2[3] - h2[1]*h1[3]) +
+        h1[0]*(h2[1]*h0[3] - h0[1]*h2[3]) +
+        h2[0]*(h0[1]*h1[3] - h1[1]*h0[3]);
+
+    // Discard the triangle if its winding order (determined by the sign
+    // of the homogeneous area/determinant) matches the culled direction
+    // A positive hSgnArea typically corresponds to a counter-clockwise
+    // winding in the projected space when all w > 0
+    // This test is robust for points with w > 0 or w < 0, correctly
+    // capturing the change in orientation when crossing the w=0 plane
+
+    // The culling logic remains the same based on the signed area/determinant
+    // A value of 0 for hSgnArea means the points are collinear in (x, y, w)
+    // space, which corresponds to a degenerate triangle projection
+    // Such triangles are typically not culled by this test (0 < 0 is false, 0 > 0 is false)
+    // and should be handled by the clipper if necessary
+    return (RLSW.cullFace == SW_FRONT)? (hSgnArea < 0) : (hSgnArea > 0); // Cull if winding is "clockwise" : "counter-clockwise"
+}
+
+static inline void sw_triangle_clip_and_project(void)
+{
+    sw_vertex_t *polygon = RLSW.vertexBuffer;
     int *vertexCounter = &RLSW.vertexCounter;
 
     if (sw_polygon_clip(polygon, vertexCounter))
@@ -2285,19 +4238,25 @@ static inline void sw_triangle_clip_and_project(void)
     }
 }
 
-#define DEFINE_TRIANGLE_RASTER_SCANLINE(FUNC_NAME, ENABLE_TEXTURE, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND) \
-static inline void FUNC_NAME(const sw_texture_t *tex, const sw_vertex_t *start,     \
-                             const sw_vertex_t *end, float dUdy, float dVdy)        \
+#define DEFINE_TRIANGLE_RASTER_SCANLINE(FUNC_NAME, ENABLE_TEXTURE, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND, ENABLE_PROGRAM, ENABLE_PERSPECTIVE) \
+static inline void FUNC_NAME(const sw_raster_t *r, const sw_texture_t *tex,       \
+                             const sw_vertex_t *start, const sw_vertex_t *end,      \
+                             float dUdy, float dVdy)                                \
 {                                                                                   \
-    /* Gets the start and end coordinates */                                        \
-    int xStart = (int)start->screen[0];                                             \
-    int xEnd   = (int)end->screen[0];                                               \
+    /* Gets the start and end coordinates, limited to the raster region */          \
+    int xStart = (int)floorf(start->screen[0]);                                     \
+    int xEnd   = (int)floorf(end->screen[0]);                                       \
+    int xFirst = sw_maxi(xStart, r->xMin);                                          \
+    xEnd = sw_mini(xEnd, r->xMax);                                                  \
                                                                                     \
     /* Avoid empty lines */                                                         \
-    if (xStart == xEnd) return;                                                     \
+    if (xFirst >= xEnd) return;                                                     \
+                                                                                    \
+    /* First pixel of the line in the clip rectangle, the same one for all bin tiles */ \
+    int xBase = sw_maxi(xStart, r->state->clipMin[0]);                              \
                                                                                     \
     /* Compute the subpixel distance to traverse before the first pixel */          \
-    float xSubstep = 1.0f - sw_fract(start->screen[0]);                             \
+    float xSubstep = 1.0f - sw_fract(start->screen[0]) + (float)(xBase - xStart);   \
                                                                                     \
     /* Compute the inverse horizontal distance along the X axis */                  \
     float dxRcp = 1.0f/(end->screen[0] - start->screen[0]);                         \
@@ -2338,57 +4297,26 @@ static inline void FUNC_NAME(const sw_texture_t *tex, const sw_vertex_t *start,
         v = start->texcoord[1] + dVdx*xSubstep;                                     \
     }                                                                               \
                                                                                     \
-    /* Pre-calculate the starting pointers for the framebuffer row */               \
-    int y = (int)start->screen[1];                                                  \
-    sw_pixel_t *ptr = RLSW.framebuffer.pixels + y*RLSW.framebuffer.width + xStart;  \
+    /* Span of bilinear texels, sampled 4 pixels ahead when eligible */             \
+    const bool spanLinear = ENABLE_TEXTURE && sw_texture_is_span_linear(tex);       \
+    uint8_t spanTexels[4][4];                                                       \
+    int spanStart = xFirst;                                                         \
+    int spanEnd = xFirst;                                                           \
                                                                                     \
-    /* Scanline rasterization */                                                    \
-    for (int x = xStart; x < xEnd; x++)                                             \
+    /* Bin tiles step to their first pixel with the same increments as the */       \
+    /* whole line, and start with its texel span, so they get the same values */    \
+    /* NOTE: Except after a hidden depth tile segment left of the bin tile, */      \
+    /* that the whole line skips with one scaled add */                             \
+    int xSpan = xFirst - (xFirst - xBase)%4;                                        \
+    for (int x = xBase; x < xFirst; x++)                                            \
     {                                                                               \
-        float wRcp = 1.0f/w;                                                        \
-        float srcColor[4] = {                                                       \
-            color[0]*wRcp,                                                          \
-            color[1]*wRcp,                                                          \
-            color[2]*wRcp,                                                          \
-            color[3]*wRcp                                                           \
-        };                                                                          \
-                                                                                    \
-        if (ENABLE_DEPTH_TEST)                                                      \
-        {                                                                           \
-            /* TODO: Implement different depth funcs? */                            \
-            float depth =  sw_framebuffer_read_depth(ptr);                          \
-            if (z > depth) goto discard;                                            \
-        }                                                                           \
-                                                                                    \
-        /* TODO: Implement depth mask */                                            \
-        sw_framebuffer_write_depth(ptr, z);                                         \
-                                                                                    \
-        if (ENABLE_TEXTURE)                                                         \
-        {                                                                           \
-            float texColor[4];                                                      \
-            float s = u*wRcp;                                                       \
-            float t = v*wRcp;                                                       \
-            sw_texture_sample(texColor, tex, s, t, dUdx, dUdy, dVdx, dVdy);         \
-            srcColor[0] *= texColor[0];                                             \
-            srcColor[1] *= texColor[1];                                             \
-            srcColor[2] *= texColor[2];                                             \
-            srcColor[3] *= texColor[3];                                             \
-        }                                                                           \
-                                                                                    \
-        if (ENABLE_COLOR_BLEND)                                                     \
-        {                                                                           \
-            float dstColor[4];                                                      \
-            sw_framebuffer_read_color(dstColor, ptr);                               \
-            sw_blend_colors(dstColor, srcColor);                                    \
-            sw_framebuffer_write_color(ptr, dstColor);                              \
-        }                                                                           \
-        else                                                                        \
+        if (spanLinear && (x == xSpan))                                             \
         {                                                                           \
-            sw_framebuffer_write_color(ptr, srcColor);                              \
+            sw_texture_sample_linear_span(spanTexels, tex, u, v, w, dUdx, dVdx, dWdx); \
+            SW_RASTER_STATS_ADD(r, texelsFetched, 16);                              \
+            spanStart = x;                                                          \
+            spanEnd = x + 4;                                                        \
         }                                                                           \
-                                                                                    \
-        /* Increment the interpolation parameter, UVs, and pointers */              \
-    discard:                                                                        \
         z += dZdx;                                                                  \
         w += dWdx;                                                                  \
         color[0] += dCdx[0];                                                        \
@@ -2400,14 +4328,144 @@ static inline void FUNC_NAME(const sw_texture_t *tex, const sw_vertex_t *start,
             u += dUdx;                                                              \
             v += dVdx;                                                              \
         }                                                                           \
-        ++ptr;                                                                      \
+    }                                                                               \
+                                                                                    \
+    /* Pre-calculate the starting pointers for the framebuffer row */               \
+    int y = (int)start->screen[1];                                                  \
+    sw_color_t *cptr = r->colors + y*r->colorStride + xFirst;                       \
+    sw_depth_t *dptr = r->depths + y*r->width + xFirst;                             \
+                                                                                    \
+    /* Scanline rasterization, walked in depth tile segments */                     \
+    for (int x = xFirst; x < xEnd;)                                                 \
+    {                                                                               \
+        int xSegEnd = xEnd;                                                         \
+        bool depthPass = false;                                                     \
+                                                                                    \
+        if (ENABLE_DEPTH_TEST)                                                      \
+        {                                                                           \
+            /* Test the whole segment against the tile depth bounds */              \
+            const sw_depth_tile_t *tile = sw_depth_tile_at(r, x, y);                \
+            xSegEnd = sw_mini((x/SW_DEPTH_TILE_SIZE + 1)*SW_DEPTH_TILE_SIZE, xEnd); \
+            int count = xSegEnd - x;                                                \
+            float zLast = z + dZdx*(count - 1);                                     \
+            float zLo = ((z < zLast)? z : zLast) - SW_DEPTH_TILE_EPSILON;           \
+            float zHi = ((z > zLast)? z : zLast) + SW_DEPTH_TILE_EPSILON;           \
+                                                                                    \
+            if (zLo > tile->zMax)                                                   \
+            {                                                                       \
+                /* Segment entirely hidden, skip it */                              \
+                z += dZdx*count;                                                    \
+                w += dWdx*count;                                                    \
+                color[0] += dCdx[0]*count;                                          \
+                color[1] += dCdx[1]*count;                                          \
+                color[2] += dCdx[2]*count;                                          \
+                color[3] += dCdx[3]*count;                                          \
+                if (ENABLE_TEXTURE)                                                 \
+                {                                                                   \
+                    u += dUdx*count;                                                \
+                    v += dVdx*count;                                                \
+                }                                                                   \
+                cptr += count;                                                      \
+                dptr += count;                                                      \
+                x = xSegEnd;                                                        \
+                continue;                                                           \
+            }                                                                       \
+                                                                                    \
+            /* Segment entirely visible, no depth reads needed */                   \
+            depthPass = (zHi <= tile->zMin);                                        \
+        }                                                                           \
+                                                                                    \
+        for (; x < xSegEnd; x++)                                                    \
+        {                                                                           \
+            /* NOTE: Affine variants have a unit w, no perspective division */      \
+            float wRcp = ENABLE_PERSPECTIVE? 1.0f/w : 1.0f;                         \
+            float srcColor[4] = {                                                   \
+                color[0]*wRcp,                                                      \
+                color[1]*wRcp,                                                      \
+                color[2]*wRcp,                                                      \
+                color[3]*wRcp                                                       \
+            };                                                                      \
+                                                                                    \
+            if (ENABLE_DEPTH_TEST && !depthPass)                                    \
+            {                                                                       \
+                /* TODO: Implement different depth funcs? */                        \
+                float depth =  sw_framebuffer_read_depth(dptr);                     \
+                if (z > depth) { SW_RASTER_STATS_ADD(r, pixelsDepthRejected, 1); goto discard; } \
+            }                                                                       \
+                                                                                    \
+            /* TODO: Implement depth mask */                                        \
+            sw_framebuffer_output_depth(r, dptr, z);                                \
+                                                                                    \
+            if (ENABLE_TEXTURE)                                                     \
+            {                                                                       \
+                float texColor[4];                                                  \
+                float s = u*wRcp;                                                   \
+                float t = v*wRcp;                                                   \
+                if (spanLinear)                                                     \
+                {                                                                   \
+                    if (x >= spanEnd)                                               \
+                    {                                                               \
+                        sw_texture_sample_linear_span(spanTexels, tex, u, v, w, dUdx, dVdx, dWdx); \
+                        SW_RASTER_STATS_ADD(r, texelsFetched, 16);                  \
+                        spanStart = x;                                              \
+                        spanEnd = x + 4;                                            \
+                    }                                                               \
+                    sw_float_from_unorm8_simd(texColor, spanTexels[x - spanStart]); \
+                }                                                                   \
+                else                                                                \
+                {                                                                   \
+                    /* Derivatives scaled by 1/w, approximates the perspective LOD */ \
+                    int texels = sw_texture_sample(texColor, tex, s, t,             \
+                        dUdx*wRcp, dUdy*wRcp, dVdx*wRcp, dVdy*wRcp);                \
+                    SW_RASTER_STATS_ADD(r, texelsFetched, texels);                  \
+                }                                                                   \
+                if (ENABLE_PROGRAM) sw_fragment_program(r, srcColor, texColor, s, t, x, y); \
+                else                                                                \
+                {                                                                   \
+                    srcColor[0] *= texColor[0];                                     \
+                    srcColor[1] *= texColor[1];                                     \
+                    srcColor[2] *= texColor[2];                                     \
+                    srcColor[3] *= texColor[3];                                     \
+                }                                                                   \
+            }                                                                       \
+                                                                                    \
+            sw_framebuffer_output_color(r, cptr, srcColor, ENABLE_COLOR_BLEND);     \
+                                                                                    \
+            /* Increment the interpolation parameter, UVs, and pointers */          \
+        discard:                                                                    \
+            z += dZdx;                                                              \
+            w += dWdx;                                                              \
+            color[0] += dCdx[0];                                                    \
+            color[1] += dCdx[1];                                                    \
+            color[2] += dCdx[2];                                                    \
+            color[3] += dCdx[3];                                                    \
+            if (ENABLE_TEXTURE)                                                     \
+            {                                                                       \
+                u += dUdx;                                                          \
+                v += dVdx;                                                          \
+            }                                                                       \
+            ++cptr;                                                                 \
+            ++dptr;                                                                 \
+        }                                                                           \
     }                                                                               \
 }
 
-#define DEFINE_TRIANGLE_RASTER(FUNC_NAME, FUNC_SCANLINE, ENABLE_TEXTURE)            \
-static inline void FUNC_NAME(const sw_vertex_t *v0, const sw_vertex_t *v1,          \
-                             const sw_vertex_t *v2, const sw_texture_t *tex)        \
+#define DEFINE_TRIANGLE_RASTER(FUNC_NAME, FUNC_SCANLINE, FUNC_SCANLINE_AFFINE, ENABLE_TEXTURE) \
+static inline void FUNC_NAME(const sw_raster_t *r, const sw_vertex_t *v0,           \
+                             const sw_vertex_t *v1, const sw_vertex_t *v2,          \
+                             const sw_texture_t *tex)                               \
 {                                                                                   \
+    /* Triangles with a constant w use the affine scanlines */                      \
+    void (*scanline)(const sw_raster_t *, const sw_texture_t *, const sw_vertex_t *, \
+                     const sw_vertex_t *, float, float) = FUNC_SCANLINE;            \
+    sw_vertex_t affineVertices[3];                                                  \
+    const sw_vertex_t *vertices[3] = { v0, v1, v2 };                                \
+    if (sw_triangle_get_affine(affineVertices, vertices))                           \
+    {                                                                               \
+        v0 = vertices[0]; v1 = vertices[1]; v2 = vertices[2];                       \
+        scanline = FUNC_SCANLINE_AFFINE;                                            \
+    }                                                                               \
+                                                                                    \
     /* Swap vertices by increasing y */                                             \
     if (v0->screen[1] > v1->screen[1]) { const sw_vertex_t *tmp = v0; v0 = v1; v1 = tmp; } \
     if (v1->screen[1] > v2->screen[1]) { const sw_vertex_t *tmp = v1; v1 = v2; v2 = tmp; } \
@@ -2425,6 +4483,14 @@ static inline void FUNC_NAME(const sw_vertex_t *v0, const sw_vertex_t *v1,
                                                                                     \
     if (h02 < 1e-6f) return;                                                        \
                                                                                     \
+    /* Y bounds (vertical clipping) */                                              \
+    int yTop = (int)floorf(y0);                                                     \
+    int yMid = (int)floorf(y1);                                                     \
+    int yBot = (int)floorf(y2);                                                     \
+                                                                                    \
+    /* Reject triangles outside of the raster region rows */                        \
+    if ((yBot <= r->yMin) || (yTop >= r->yMax)) return;                             \
+                                                                                    \
     /* Precompute the inverse values without additional checks */                   \
     float h02Rcp = 1.0f/h02;                                                        \
     float h01Rcp = (h01 > 1e-6f)? 1.0f/h01 : 0.0f;                                  \
@@ -2439,11 +4505,6 @@ static inline void FUNC_NAME(const sw_vertex_t *v0, const sw_vertex_t *v1,
     float y0Substep = 1.0f - sw_fract(y0);                                          \
     float y1Substep = 1.0f - sw_fract(y1);                                          \
                                                                                     \
-    /* Y bounds (vertical clipping) */                                              \
-    int yTop = (int)y0;                                                             \
-    int yMid = (int)y1;                                                             \
-    int yBot = (int)y2;                                                             \
-                                                                                    \
     /* Compute gradients for each side of the triangle */                           \
     sw_vertex_t dVXdy02, dVXdy01, dVXdy12;                                          \
     sw_get_vertex_grad_PTCH(&dVXdy02, v0, v2, h02Rcp);                              \
@@ -2458,19 +4519,43 @@ static inline void FUNC_NAME(const sw_vertex_t *v0, const sw_vertex_t *v1,
     vLeft.screen[0] += dXdy02*y0Substep;                                            \
     vRight.screen[0] += dXdy01*y0Substep;                                           \
                                                                                     \
-    /* Scanline for the upper part of the triangle */                               \
-    for (int y = yTop; y < yMid; y++)                                               \
+    /* Row the left edge is currently interpolated at */                            \
+    int yLeft = yTop;                                                               \
+                                                                                    \
+    /* Scanline for the upper part of the triangle, limited to the raster region */ \
+    /* NOTE: Rows are walked from the first one in the clip rectangle, bin tiles */ \
+    /* step the rows above them with the same increments as the whole triangle */   \
+    int yStart = sw_maxi(yTop, r->state->clipMin[1]);                               \
+    int yEnd = sw_mini(yMid, r->yMax);                                              \
+    if (yStart < yEnd)                                                              \
     {                                                                               \
-        vLeft.screen[1] = vRight.screen[1] = y;                                     \
+        if (yStart > yTop)                                                          \
+        {                                                                           \
+            float skip = (float)(yStart - yTop);                                    \
+            sw_add_vertex_grad_scaled_PTCH(&vLeft, &dVXdy02, skip);                 \
+            sw_add_vertex_grad_scaled_PTCH(&vRight, &dVXdy01, skip);                \
+            vLeft.screen[0] += dXdy02*skip;                                         \
+            vRight.screen[0] += dXdy01*skip;                                        \
+        }                                                                           \
+                                                                                    \
+        for (int y = yStart; y < yEnd; y++)                                         \
+        {                                                                           \
+            if (y >= r->yMin)                                                       \
+            {                                                                       \
+                vLeft.screen[1] = vRight.screen[1] = y;                             \
+                                                                                    \
+                if (vLeft.screen[0] < vRight.screen[0]) scanline(r, tex, &vLeft, &vRight, dVXdy02.texcoord[0], dVXdy02.texcoord[1]); \
+                else scanline(r, tex, &vRight, &vLeft, dVXdy02.texcoord[0], dVXdy02.texcoord[1]); \
+            }                                                                       \
                                                                                     \
-        if (vLeft.screen[0] < vRight.screen[0]) FUNC_SCANLINE(tex, &vLeft, &vRight, dVXdy02.texcoord[0], dVXdy02.texcoord[1]); \
-        else FUNC_SCANLINE(tex, &vRight, &vLeft, dVXdy02.texcoord[0], dVXdy02.texcoord[1]); \
+            sw_add_vertex_grad_PTCH(&vLeft, &dVXdy02);                              \
+            vLeft.screen[0] += dXdy02;                                              \
                                                                                     \
-        sw_add_vertex_grad_PTCH(&vLeft, &dVXdy02);                                  \
-        vLeft.screen[0] += dXdy02;                                                  \
+            sw_add_vertex_grad_PTCH(&vRight, &dVXdy01);                             \
+            vRight.screen[0] += dXdy01;                                             \
+        }                                                                           \
                                                                                     \
-        sw_add_vertex_grad_PTCH(&vRight, &dVXdy01);                                 \
-        vRight.screen[0] += dXdy01;                                                 \
+        yLeft = yEnd;                                                               \
     }                                                                               \
                                                                                     \
     /* Get a copy of next right for interpolation and apply substep correction */   \
@@ -2478,91 +4563,533 @@ static inline void FUNC_NAME(const sw_vertex_t *v0, const sw_vertex_t *v1,
     sw_add_vertex_grad_scaled_PTCH(&vRight, &dVXdy12, y1Substep);                   \
     vRight.screen[0] += dXdy12*y1Substep;                                           \
                                                                                     \
-    /* Scanline for the lower part of the triangle */                               \
-    for (int y = yMid; y < yBot; y++)                                               \
+    /* Scanline for the lower part of the triangle, limited to the raster region */ \
+    yStart = sw_maxi(yMid, r->state->clipMin[1]);                                   \
+    yEnd = sw_mini(yBot, r->yMax);                                                  \
+    if (yStart < yEnd)                                                              \
     {                                                                               \
-        vLeft.screen[1] = vRight.screen[1] = y;                                     \
+        if (yStart > yLeft)                                                         \
+        {                                                                           \
+            float skip = (float)(yStart - yLeft);                                   \
+            sw_add_vertex_grad_scaled_PTCH(&vLeft, &dVXdy02, skip);                 \
+            vLeft.screen[0] += dXdy02*skip;                                         \
+        }                                                                           \
+                                                                                    \
+        if (yStart > yMid)                                                          \
+        {                                                                           \
+            float skip = (float)(yStart - yMid);                                    \
+            sw_add_vertex_grad_scaled_PTCH(&vRight, &dVXdy12, skip);                \
+            vRight.screen[0] += dXdy12*skip;                                        \
+        }                                                                           \
                                                                                     \
-        if (vLeft.screen[0] < vRight.screen[0]) FUNC_SCANLINE(tex, &vLeft, &vRight, dVXdy02.texcoord[0], dVXdy02.texcoord[1]); \
-        else FUNC_SCANLINE(tex, &vRight, &vLeft, dVXdy02.texcoord[0], dVXdy02.texcoord[1]); \
+        for (int y = yStart; y < yEnd; y++)                                         \
+        {                                                                           \
+            if (y >= r->yMin)                                                       \
+            {                                                                       \
+                vLeft.screen[1] = vRight.screen[1] = y;                             \
+                                                                                    \
+                if (vLeft.screen[0] < vRight.screen[0]) scanline(r, tex, &vLeft, &vRight, dVXdy02.texcoord[0], dVXdy02.texcoord[1]); \
+                else scanline(r, tex, &vRight, &vLeft, dVXdy02.texcoord[0], dVXdy02.texcoord[1]); \
+            }                                                                       \
                                                                                     \
-        sw_add_vertex_grad_PTCH(&vLeft, &dVXdy02);                                  \
-        vLeft.screen[0] += dXdy02;                                                  \
+            sw_add_vertex_grad_PTCH(&vLeft, &dVXdy02);                              \
+            vLeft.screen[0] += dXdy02;                                              \
                                                                                     \
-        sw_add_vertex_grad_PTCH(&vRight, &dVXdy12);                                 \
-        vRight.screen[0] += dXdy12;                                                 \
+            sw_add_vertex_grad_PTCH(&vRight, &dVXdy12);                             \
+            vRight.screen[0] += dXdy12;                                             \
+        }                                                                           \
     }                                                                               \
 }
 
-DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline, 0, 0, 0)
-DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX, 1, 0, 0)
-DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_DEPTH, 0, 1, 0)
-DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_BLEND, 0, 0, 1)
-DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX_DEPTH, 1, 1, 0)
-DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX_BLEND, 1, 0, 1)
-DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_DEPTH_BLEND, 0, 1, 1)
-DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX_DEPTH_BLEND, 1, 1, 1)
-
-DEFINE_TRIANGLE_RASTER(sw_triangle_raster, sw_triangle_raster_scanline, false)
-DEFINE_TRIANGLE_RASTER(sw_triangle_raster_TEX, sw_triangle_raster_scanline_TEX, true)
-DEFINE_TRIANGLE_RASTER(sw_triangle_raster_DEPTH, sw_triangle_raster_scanline_DEPTH, false)
-DEFINE_TRIANGLE_RASTER(sw_triangle_raster_BLEND, sw_triangle_raster_scanline_BLEND, false)
-DEFINE_TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH, sw_triangle_raster_scanline_TEX_DEPTH, true)
-DEFINE_TRIANGLE_RASTER(sw_triangle_raster_TEX_BLEND, sw_triangle_raster_scanline_TEX_BLEND, true)
-DEFINE_TRIANGLE_RASTER(sw_triangle_raster_DEPTH_BLEND, sw_triangle_raster_scanline_DEPTH_BLEND, false)
-DEFINE_TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH_BLEND, sw_triangle_raster_scanline_TEX_DEPTH_BLEND, true)
 
-static inline void sw_triangle_render(void)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline, 0, 0, 0, 0, 1)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX, 1, 0, 0, 0, 1)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_DEPTH, 0, 1, 0, 0, 1)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_BLEND, 0, 0, 1, 0, 1)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX_DEPTH, 1, 1, 0, 0, 1)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX_BLEND, 1, 0, 1, 0, 1)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_DEPTH_BLEND, 0, 1, 1, 0, 1)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX_DEPTH_BLEND, 1, 1, 1, 0, 1)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_PROGRAM, 1, SW_PROGRAM_DEPTH_TEST, SW_PROGRAM_BLEND, 1, 1)
+
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_AFFINE, 0, 0, 0, 0, 0)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX_AFFINE, 1, 0, 0, 0, 0)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_DEPTH_AFFINE, 0, 1, 0, 0, 0)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_BLEND_AFFINE, 0, 0, 1, 0, 0)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX_DEPTH_AFFINE, 1, 1, 0, 0, 0)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX_BLEND_AFFINE, 1, 0, 1, 0, 0)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_DEPTH_BLEND_AFFINE, 0, 1, 1, 0, 0)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX_DEPTH_BLEND_AFFINE, 1, 1, 1, 0, 0)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_PROGRAM_AFFINE, 1, SW_PROGRAM_DEPTH_TEST, SW_PROGRAM_BLEND, 1, 0)
+
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster, sw_triangle_raster_scanline, sw_triangle_raster_scanline_AFFINE, false)
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster_TEX, sw_triangle_raster_scanline_TEX, sw_triangle_raster_scanline_TEX_AFFINE, true)
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster_DEPTH, sw_triangle_raster_scanline_DEPTH, sw_triangle_raster_scanline_DEPTH_AFFINE, false)
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster_BLEND, sw_triangle_raster_scanline_BLEND, sw_triangle_raster_scanline_BLEND_AFFINE, false)
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH, sw_triangle_raster_scanline_TEX_DEPTH, sw_triangle_raster_scanline_TEX_DEPTH_AFFINE, true)
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster_TEX_BLEND, sw_triangle_raster_scanline_TEX_BLEND, sw_triangle_raster_scanline_TEX_BLEND_AFFINE, true)
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster_DEPTH_BLEND, sw_triangle_raster_scanline_DEPTH_BLEND, sw_triangle_raster_scanline_DEPTH_BLEND_AFFINE, false)
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH_BLEND, sw_triangle_raster_scanline_TEX_DEPTH_BLEND, sw_triangle_raster_scanline_TEX_DEPTH_BLEND_AFFINE, true)
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster_PROGRAM, sw_triangle_raster_scanline_PROGRAM, sw_triangle_raster_scanline_PROGRAM_AFFINE, true)
+
+// Half-space (edge functions) triangle rasterization
+// NOTE: Vertices are snapped to a 1/16 pixel grid and pixels are sampled at their center,
+// the coverage is evaluated by blocks of 4x4 pixels, blocks fully inside the triangle skip
+// the per-pixel tests, the top-left fill rule avoids gaps and overdraw on shared edges
+#define SW_SUBPIXEL_BITS    4
+#define SW_SUBPIXEL_SCALE   (1 << SW_SUBPIXEL_BITS)
+#define SW_BLOCK_SIZE       4
+
+typedef struct {
+    int64_t c;                  // Edge function at the center of the pixel (0, 0), fill rule bias included
+    int32_t stepX;              // Edge function increment per pixel along X
+    int32_t stepY;              // Edge function increment per pixel along Y
+} sw_edge_t;
+
+static inline int32_t sw_snap_subpixel(float x)
 {
-    if (RLSW.stateFlags & SW_STATE_CULL_FACE)
-    {
-        if (!sw_triangle_face_culling()) return;
-    }
+    // NOTE: Screen coordinates are offset by half a pixel by the projection
+    return (int32_t)floorf((x - 0.5f)*SW_SUBPIXEL_SCALE + 0.5f);
+}
 
-    sw_triangle_clip_and_project();
+// Setups the edge going from (x0, y0) to (x1, y1), with the triangle interior on its positive side
+static inline void sw_edge_setup(sw_edge_t *edge, int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+    int32_t dx = x1 - x0;
+    int32_t dy = y1 - y0;
 
-    if (RLSW.vertexCounter < 3) return;
+    // Top-left rule: pixels on left edges (interior at increasing x) or
+    // top edges (horizontal, interior at increasing y) are inside
+    bool isTopLeft = (dy < 0) || ((dy == 0) && (dx > 0));
 
-    #define TRIANGLE_RASTER(RASTER_FUNC)                        \
-    {                                                           \
-        for (int i = 0; i < RLSW.vertexCounter - 2; i++)        \
-        {                                                       \
-            RASTER_FUNC(                                        \
-                &RLSW.vertexBuffer[0],                          \
-                &RLSW.vertexBuffer[i + 1],                      \
-                &RLSW.vertexBuffer[i + 2],                      \
-                &RLSW.loadedTextures[RLSW.currentTexture]       \
-            );                                                  \
-        }                                                       \
-    }
+    const int64_t half = SW_SUBPIXEL_SCALE/2;
+    edge->c = (int64_t)dx*(half - y0) - (int64_t)dy*(half - x0) - (isTopLeft? 0 : 1);
+    edge->stepX = -dy*SW_SUBPIXEL_SCALE;
+    edge->stepY = dx*SW_SUBPIXEL_SCALE;
+}
 
-    uint32_t state = RLSW.stateFlags;
-    if (RLSW.currentTexture == 0) state &= ~SW_STATE_TEXTURE_2D;
-    if ((RLSW.srcFactor == SW_ONE) && (RLSW.dstFactor == SW_ZERO)) state &= ~SW_STATE_BLEND;
+// Multisampling samples positions, rotated grid offsets from the pixel center (in sub-pixels)
+#define SW_MSAA_SAMPLE_EXTENT   6   // Largest sample offset along an axis
 
-    if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH_BLEND)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_DEPTH_BLEND)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_TEX_BLEND)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST)) TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_BLEND)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) TRIANGLE_RASTER(sw_triangle_raster_DEPTH)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D)) TRIANGLE_RASTER(sw_triangle_raster_TEX)
-    else TRIANGLE_RASTER(sw_triangle_raster)
+static const int32_t sw_msaa_offsets[SW_MSAA_SAMPLES][2] = {
+    { -2, -6 }, { 6, -2 }, { -6, 2 }, { 2, 6 }
+};
 
-    #undef TRIANGLE_RASTER
+// Edge function increment from a pixel center to one of its samples
+// NOTE: The per pixel steps are multiples of the sub-pixel scale, the division is exact
+static inline int32_t sw_edge_sample_step(const sw_edge_t *edge, int sample)
+{
+    return (edge->stepX*sw_msaa_offsets[sample][0] + edge->stepY*sw_msaa_offsets[sample][1])/SW_SUBPIXEL_SCALE;
 }
-//-------------------------------------------------------------------------------------------
 
-// Quad rendering logic
-//-------------------------------------------------------------------------------------------
-static inline bool sw_quad_face_culling(void)
+// Coverage of a row of 4 pixels from the edge functions of its first pixel,
+// bit i is set when the pixel i is inside the three edges (all non negative)
+static inline uint32_t sw_edge_row_mask(const int32_t e[3], const int32_t laneSteps[3][4])
 {
-    // NOTE: Face culling is done before clipping to avoid unnecessary computations
-    // To handle quads crossing the w=0 plane correctly,
-    // the winding order test is performed in homogeneous coordinates directly,
-    // before the perspective division (division by w)
-    // For a convex quad with vertices P0, P1, P2, P3 in sequential order,
-    // the winding order of the quad is the same as the winding order
+#if defined(SW_HAS_NEON)
+    int32x4_t e0 = vaddq_s32(vdupq_n_s32(e[0]), vld1q_s32(laneSteps[0]));
+    int32x4_t e1 = vaddq_s32(vdupq_n_s32(e[1]), vld1q_s32(laneSteps[1]));
+    int32x4_t e2 = vaddq_s32(vdupq_n_s32(e[2]), vld1q_s32(laneSteps[2]));
+    uint32x4_t sign = vshrq_n_u32(vreinterpretq_u32_s32(vorrq_s32(vorrq_s32(e0, e1), e2)), 31);
+    uint32_t outside = vgetq_lane_u32(sign, 0) | (vgetq_lane_u32(sign, 1) << 1) |
+                       (vgetq_lane_u32(sign, 2) << 2) | (vgetq_lane_u32(sign, 3) << 3);
+    return ~outside & 0xF;
+#elif defined(SW_HAS_SSE2) || defined(SW_HAS_SSE3) || defined(SW_HAS_SSSE3) || defined(SW_HAS_SSE41) || defined(SW_HAS_SSE42)
+    __m128i e0 = _mm_add_epi32(_mm_set1_epi32(e[0]), _mm_loadu_si128((const __m128i *)laneSteps[0]));
+    __m128i e1 = _mm_add_epi32(_mm_set1_epi32(e[1]), _mm_loadu_si128((const __m128i *)laneSteps[1]));
+    __m128i e2 = _mm_add_epi32(_mm_set1_epi32(e[2]), _mm_loadu_si128((const __m128i *)laneSteps[2]));
+    __m128i any = _mm_or_si128(_mm_or_si128(e0, e1), e2);
+    return ~(uint32_t)_mm_movemask_ps(_mm_castsi128_ps(any)) & 0xF;
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        if (((e[0] + laneSteps[0][i]) | (e[1] + laneSteps[1][i]) | (e[2] + laneSteps[2][i])) >= 0) mask |= (1u << i);
+    }
+    return mask;
+#endif
+}
+
+// Attributes interpolated by the half-space rasterizer, all linear in screen space
+static inline void sw_get_vertex_attribs_ZWCT(float attribs[8], const sw_vertex_t *v)
+{
+    attribs[0] = v->homogeneous[2];
+    attribs[1] = v->homogeneous[3];
+    attribs[2] = v->color[0];
+    attribs[3] = v->color[1];
+    attribs[4] = v->color[2];
+    attribs[5] = v->color[3];
+    attribs[6] = v->texcoord[0];
+    attribs[7] = v->texcoord[1];
+}
+
+#define DEFINE_TRIANGLE_RASTER_HALF_SPACE(FUNC_NAME, ENABLE_TEXTURE, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND, ENABLE_PROGRAM, ENABLE_MSAA) \
+static inline void FUNC_NAME(const sw_raster_t *r, const sw_vertex_t *v0,           \
+                             const sw_vertex_t *v1, const sw_vertex_t *v2,          \
+                             const sw_texture_t *tex)                               \
+{                                                                                   \
+    /* Triangles with a constant w are interpolated without perspective division */ \
+    sw_vertex_t affineVertices[3];                                                  \
+    const sw_vertex_t *vertices[3] = { v0, v1, v2 };                                \
+    const bool affine = sw_triangle_get_affine(affineVertices, vertices);           \
+    v0 = vertices[0]; v1 = vertices[1]; v2 = vertices[2];                           \
+                                                                                    \
+    /* Snap the vertices to the sub-pixel grid */                                   \
+    int32_t x0 = sw_snap_subpixel(v0->screen[0]), y0 = sw_snap_subpixel(v0->screen[1]); \
+    int32_t x1 = sw_snap_subpixel(v1->screen[0]), y1 = sw_snap_subpixel(v1->screen[1]); \
+    int32_t x2 = sw_snap_subpixel(v2->screen[0]), y2 = sw_snap_subpixel(v2->screen[1]); \
+                                                                                    \
+    /* Twice the signed area, the vertices are reordered to make it positive */     \
+    int64_t area = (int64_t)(x1 - x0)*(y2 - y0) - (int64_t)(x2 - x0)*(y1 - y0);     \
+    if (area == 0) return;                                                          \
+    if (area < 0)                                                                   \
+    {                                                                               \
+        const sw_vertex_t *tmp = v1; v1 = v2; v2 = tmp;                             \
+        int32_t t = x1; x1 = x2; x2 = t;                                            \
+        t = y1; y1 = y2; y2 = t;                                                    \
+        area = -area;                                                               \
+    }                                                                               \
+                                                                                    \
+    /* Pixels bounding box, limited to the raster region */                         \
+    /* NOTE: With multisampling, pixels whose center is outside can have covered samples */ \
+    const int32_t half = SW_SUBPIXEL_SCALE/2;                                       \
+    const int32_t extent = ENABLE_MSAA? SW_MSAA_SAMPLE_EXTENT : 0;                  \
+    int xMin = (sw_mini(x0, sw_mini(x1, x2)) - half - extent + SW_SUBPIXEL_SCALE - 1) >> SW_SUBPIXEL_BITS; \
+    int yMin = (sw_mini(y0, sw_mini(y1, y2)) - half - extent + SW_SUBPIXEL_SCALE - 1) >> SW_SUBPIXEL_BITS; \
+    int xMax = ((sw_maxi(x0, sw_maxi(x1, x2)) - half + extent) >> SW_SUBPIXEL_BITS) + 1; \
+    int yMax = ((sw_maxi(y0, sw_maxi(y1, y2)) - half + extent) >> SW_SUBPIXEL_BITS) + 1; \
+    xMin = sw_maxi(xMin, r->xMin);                                                  \
+    yMin = sw_maxi(yMin, r->yMin);                                                  \
+    xMax = sw_mini(xMax, r->xMax);                                                  \
+    yMax = sw_mini(yMax, r->yMax);                                                  \
+    if ((xMin >= xMax) || (yMin >= yMax)) return;                                   \
+                                                                                    \
+    /* Edge functions, each one is positive on the side of its opposite vertex */   \
+    sw_edge_t edges[3];                                                             \
+    sw_edge_setup(&edges[0], x1, y1, x2, y2);                                       \
+    sw_edge_setup(&edges[1], x2, y2, x0, y0);                                       \
+    sw_edge_setup(&edges[2], x0, y0, x1, y1);                                       \
+                                                                                    \
+    /* Per-lane increments and extents of the edge functions over a block */        \
+    /* NOTE: With multisampling, the extents include the sample offsets */          \
+    int32_t laneSteps[3][4];                                                        \
+    int32_t sampleSteps[3][SW_MSAA_SAMPLES] = { { 0 } };                            \
+    int64_t blockMin[3], blockMax[3];                                               \
+    for (int k = 0; k < 3; k++)                                                     \
+    {                                                                               \
+        for (int i = 0; i < 4; i++) laneSteps[k][i] = i*edges[k].stepX;             \
+        int64_t sx = (int64_t)edges[k].stepX*(SW_BLOCK_SIZE - 1);                   \
+        int64_t sy = (int64_t)edges[k].stepY*(SW_BLOCK_SIZE - 1);                   \
+        blockMin[k] = ((sx < 0)? sx : 0) + ((sy < 0)? sy : 0);                      \
+        blockMax[k] = ((sx > 0)? sx : 0) + ((sy > 0)? sy : 0);                      \
+                                                                                    \
+        if (ENABLE_MSAA)                                                            \
+        {                                                                           \
+            int32_t sMin = 0, sMax = 0;                                             \
+            for (int s = 0; s < SW_MSAA_SAMPLES; s++)                               \
+            {                                                                       \
+                sampleSteps[k][s] = sw_edge_sample_step(&edges[k], s);              \
+                sMin = sw_mini(sMin, sampleSteps[k][s]);                            \
+                sMax = sw_maxi(sMax, sampleSteps[k][s]);                            \
+            }                                                                       \
+            blockMin[k] += sMin;                                                    \
+            blockMax[k] += sMax;                                                    \
+        }                                                                           \
+    }                                                                               \
+                                                                                    \
+    /* Attribute planes, evaluated relative to the first vertex */                  \
+    float a0[8], a1[8], a2[8], dAdx[8], dAdy[8];                                    \
+    sw_get_vertex_attribs_ZWCT(a0, v0);                                             \
+    sw_get_vertex_attribs_ZWCT(a1, v1);                                             \
+    sw_get_vertex_attribs_ZWCT(a2, v2);                                             \
+                                                                                    \
+    const float subpixelRcp = 1.0f/SW_SUBPIXEL_SCALE;                               \
+    float fx0 = x0*subpixelRcp, fy0 = y0*subpixelRcp;                               \
+    float dx1 = (x1 - x0)*subpixelRcp, dy1 = (y1 - y0)*subpixelRcp;                 \
+    float dx2 = (x2 - x0)*subpixelRcp, dy2 = (y2 - y0)*subpixelRcp;                 \
+    float areaRcp = 1.0f/(dx1*dy2 - dx2*dy1);                                       \
+                                                                                    \
+    const int attribCount = ENABLE_TEXTURE? 8 : 6;                                  \
+    for (int k = 0; k < attribCount; k++)                                           \
+    {                                                                               \
+        float da1 = a1[k] - a0[k];                                                  \
+        float da2 = a2[k] - a0[k];                                                  \
+        dAdx[k] = (da1*dy2 - da2*dy1)*areaRcp;                                      \
+        dAdy[k] = (da2*dx1 - da1*dx2)*areaRcp;                                      \
+    }                                                                               \
+                                                                                    \
+    /* Depth offsets of the samples from the pixel center */                        \
+    float zOffsets[SW_MSAA_SAMPLES] = { 0 };                                        \
+    if (ENABLE_MSAA)                                                                \
+    {                                                                               \
+        for (int s = 0; s < SW_MSAA_SAMPLES; s++)                                   \
+        {                                                                           \
+            zOffsets[s] = (dAdx[0]*sw_msaa_offsets[s][0] + dAdy[0]*sw_msaa_offsets[s][1])*subpixelRcp; \
+        }                                                                           \
+    }                                                                               \
+                                                                                    \
+    /* Traverse the blocks covering the bounding box */                             \
+    int bxStart = xMin & ~(SW_BLOCK_SIZE - 1);                                      \
+    int byStart = yMin & ~(SW_BLOCK_SIZE - 1);                                      \
+                                                                                    \
+    for (int by = byStart; by < yMax; by += SW_BLOCK_SIZE)                          \
+    {                                                                               \
+        for (int bx = bxStart; bx < xMax; bx += SW_BLOCK_SIZE)                      \
+        {                                                                           \
+            /* Classify the block against each edge */                              \
+            /* NOTE: Edges fully covering the block are left to zero */             \
+            int32_t e[3] = { 0 };                                                   \
+            int32_t rowSteps[3] = { 0 };                                            \
+            int32_t lanes[3][4] = { { 0 } };                                        \
+            int32_t sampleLanes[3][SW_MSAA_SAMPLES] = { { 0 } };                    \
+            bool partial = false;                                                   \
+            bool outside = false;                                                   \
+                                                                                    \
+            for (int k = 0; k < 3; k++)                                             \
+            {                                                                       \
+                int64_t eb = edges[k].c + (int64_t)edges[k].stepX*bx + (int64_t)edges[k].stepY*by; \
+                if (eb + blockMax[k] < 0) { outside = true; break; }                \
+                if (eb + blockMin[k] < 0)                                           \
+                {                                                                   \
+                    /* NOTE: The edge crosses the block, values stay in 32-bit range */ \
+                    e[k] = (int32_t)eb;                                             \
+                    rowSteps[k] = edges[k].stepY;                                   \
+                    for (int i = 0; i < 4; i++) lanes[k][i] = laneSteps[k][i];      \
+                    if (ENABLE_MSAA) for (int s = 0; s < SW_MSAA_SAMPLES; s++) sampleLanes[k][s] = sampleSteps[k][s]; \
+                    partial = true;                                                 \
+                }                                                                   \
+            }                                                                       \
+                                                                                    \
+            if (outside) continue;                                                  \
+                                                                                    \
+            /* Test the block depth range against the tile depth bounds */          \
+            /* NOTE: Blocks are aligned and never straddle a depth tile */          \
+            bool depthPass = false;                                                 \
+            if (ENABLE_DEPTH_TEST)                                                  \
+            {                                                                       \
+                const sw_depth_tile_t *tile = sw_depth_tile_at(r, bx, by);          \
+                float zc = a0[0] + dAdx[0]*((bx + 2.0f) - fx0) + dAdy[0]*((by + 2.0f) - fy0); \
+                float zr = (ENABLE_MSAA? 2.0f : 1.5f)*(fabsf(dAdx[0]) + fabsf(dAdy[0])) + SW_DEPTH_TILE_EPSILON; \
+                if (zc - zr > tile->zMax) continue;                                 \
+                depthPass = (zc + zr <= tile->zMin);                                \
+            }                                                                       \
+                                                                                    \
+            /* Pixels of the block inside the raster region */                      \
+            uint32_t regionMask = 0xF;                                              \
+            if (bx < xMin) regionMask &= (0xFu << (xMin - bx)) & 0xF;               \
+            if (bx + SW_BLOCK_SIZE > xMax) regionMask &= 0xFu >> (bx + SW_BLOCK_SIZE - xMax); \
+                                                                                    \
+            for (int j = 0; j < SW_BLOCK_SIZE; j++)                                 \
+            {                                                                       \
+                int y = by + j;                                                     \
+                uint32_t mask = regionMask;                                         \
+                uint32_t coverage[SW_BLOCK_SIZE] = { SW_MSAA_SAMPLE_MASK, SW_MSAA_SAMPLE_MASK, SW_MSAA_SAMPLE_MASK, SW_MSAA_SAMPLE_MASK }; \
+                                                                                    \
+                if (partial)                                                        \
+                {                                                                   \
+                    if (ENABLE_MSAA)                                                \
+                    {                                                               \
+                        /* Samples coverage of each pixel, pixels without covered samples are discarded */ \
+                        for (int i = 0; i < SW_BLOCK_SIZE; i++)                     \
+                        {                                                           \
+                            const int32_t ep[3] = { e[0] + lanes[0][i], e[1] + lanes[1][i], e[2] + lanes[2][i] }; \
+                            coverage[i] = sw_edge_row_mask(ep, (const int32_t (*)[4])sampleLanes); \
+                            if (coverage[i] == 0) mask &= ~(1u << i);               \
+                        }                                                           \
+                    }                                                               \
+                    else mask &= sw_edge_row_mask(e, (const int32_t (*)[4])lanes);  \
+                    e[0] += rowSteps[0];                                            \
+                    e[1] += rowSteps[1];                                            \
+                    e[2] += rowSteps[2];                                            \
+                }                                                                   \
+                                                                                    \
+                if ((mask == 0) || (y < yMin) || (y >= yMax)) continue;             \
+                                                                                    \
+                /* Attributes at the center of the first pixel of the block row */  \
+                float px = (bx + 0.5f) - fx0;                                       \
+                float py = (y + 0.5f) - fy0;                                        \
+                float a[8];                                                         \
+                for (int k = 0; k < attribCount; k++) a[k] = a0[k] + dAdx[k]*px + dAdy[k]*py; \
+                                                                                    \
+                sw_color_t *cptr = r->colors + y*r->colorStride + bx;               \
+                sw_depth_t *dptr = r->depths + y*r->width + bx;                     \
+                                                                                    \
+                for (int i = 0; i < SW_BLOCK_SIZE; i++, cptr++, dptr++)             \
+                {                                                                   \
+                    /* Covered samples passing the depth test, the pixel is shaded once for all of them */ \
+                    uint32_t samples = (mask & (1u << i))? coverage[i] : 0;         \
+                    if (ENABLE_DEPTH_TEST && !depthPass && (samples != 0))          \
+                    {                                                               \
+                        if (ENABLE_MSAA) samples = sw_framebuffer_test_samples(r, dptr, a[0], zOffsets, samples); \
+                        else if (!(a[0] <= sw_framebuffer_read_depth(dptr))) samples = 0; \
+                    }                                                               \
+                                                                                    \
+                    if (samples != 0)                                               \
+                    {                                                               \
+                        float wRcp = affine? 1.0f : 1.0f/a[1];                      \
+                        float srcColor[4] = {                                       \
+                            a[2]*wRcp,                                              \
+                            a[3]*wRcp,                                              \
+                            a[4]*wRcp,                                              \
+                            a[5]*wRcp                                               \
+                        };                                                          \
+                                                                                    \
+                        /* TODO: Implement depth mask */                            \
+                        if (ENABLE_MSAA) sw_framebuffer_output_depth_samples(r, dptr, a[0], zOffsets, samples); \
+                        else sw_framebuffer_output_depth(r, dptr, a[0]);            \
+                                                                                    \
+                        if (ENABLE_TEXTURE)                                         \
+                        {                                                           \
+                            float texColor[4];                                      \
+                            float s = a[6]*wRcp;                                    \
+                            float t = a[7]*wRcp;                                    \
+                            /* Derivatives scaled by 1/w, approximates the perspective LOD */ \
+                            int texels = sw_texture_sample(texColor, tex, s, t,     \
+                                dAdx[6]*wRcp, dAdy[6]*wRcp, dAdx[7]*wRcp, dAdy[7]*wRcp); \
+                            SW_RASTER_STATS_ADD(r, texelsFetched, texels);          \
+                            if (ENABLE_PROGRAM) sw_fragment_program(r, srcColor, texColor, s, t, bx + i, y); \
+                            else                                                    \
+                            {                                                       \
+                                srcColor[0] *= texColor[0];                         \
+                                srcColor[1] *= texColor[1];                         \
+                                srcColor[2] *= texColor[2];                         \
+                                srcColor[3] *= texColor[3];                         \
+                            }                                                       \
+                        }                                                           \
+                                                                                    \
+                        if (ENABLE_MSAA) sw_framebuffer_output_samples(r, cptr, srcColor, ENABLE_COLOR_BLEND, samples); \
+                        else sw_framebuffer_output_color(r, cptr, srcColor, ENABLE_COLOR_BLEND); \
+                    }                                                               \
+                    else if (mask & (1u << i)) SW_RASTER_STATS_ADD(r, pixelsDepthRejected, 1); \
+                                                                                    \
+                    for (int k = 0; k < attribCount; k++) a[k] += dAdx[k];          \
+                }                                                                   \
+            }                                                                       \
+        }                                                                           \
+    }                                                                               \
+}
+
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_half_space, 0, 0, 0, 0, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_half_space_TEX, 1, 0, 0, 0, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_half_space_DEPTH, 0, 1, 0, 0, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_half_space_BLEND, 0, 0, 1, 0, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_half_space_TEX_DEPTH, 1, 1, 0, 0, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_half_space_TEX_BLEND, 1, 0, 1, 0, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_half_space_DEPTH_BLEND, 0, 1, 1, 0, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_half_space_TEX_DEPTH_BLEND, 1, 1, 1, 0, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_half_space_PROGRAM, 1, SW_PROGRAM_DEPTH_TEST, SW_PROGRAM_BLEND, 1, 0)
+
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_multisample, 0, 0, 0, 0, 1)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_multisample_TEX, 1, 0, 0, 0, 1)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_multisample_DEPTH, 0, 1, 0, 0, 1)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_multisample_BLEND, 0, 0, 1, 0, 1)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_multisample_TEX_DEPTH, 1, 1, 0, 0, 1)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_multisample_TEX_BLEND, 1, 0, 1, 0, 1)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_multisample_DEPTH_BLEND, 0, 1, 1, 0, 1)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_multisample_TEX_DEPTH_BLEND, 1, 1, 1, 0, 1)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_multisample_PROGRAM, 1, SW_PROGRAM_DEPTH_TEST, SW_PROGRAM_BLEND, 1, 1)
+
+static inline void sw_raster_polygon(const sw_raster_t *r, uint32_t state, const sw_vertex_t *polygon, int n)
+{
+    bool depthTest = SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST);
+
+    // Triangles are limited to the clip rectangle captured in the state, the depth tiles
+    // updates need the whole region to know the tiles the clip rectangle cuts
+    sw_raster_t clipped = *r;
+    clipped.xMin = sw_maxi(r->xMin, r->state->clipMin[0]);
+    clipped.yMin = sw_maxi(r->yMin, r->state->clipMin[1]);
+    clipped.xMax = sw_mini(r->xMax, r->state->clipMax[0]);
+    clipped.yMax = sw_mini(r->yMax, r->state->clipMax[1]);
+
+    if ((clipped.xMin >= clipped.xMax) || (clipped.yMin >= clipped.yMax)) return;
+
+    // Triangles behind the depth tiles they overlap are rejected before rasterization
+    #define TRIANGLE_RASTER(RASTER_FUNC)                                    \
+    {                                                                       \
+        for (int i = 0; i < n - 2; i++)                                     \
+        {                                                                   \
+            const sw_vertex_t *v[3] = {                                     \
+                &polygon[0],                                                \
+                &polygon[i + 1],                                            \
+                &polygon[i + 2]                                             \
+            };                                                              \
+                                                                            \
+            sw_depth_plane_t plane;                                         \
+            sw_depth_plane_init(&plane, v[0], v[1], v[2]);                  \
+            if (depthTest && sw_depth_tiles_reject_triangle(&clipped, &plane)) \
+                continue;                                                   \
+                                                                            \
+            RASTER_FUNC(&clipped, v[0], v[1], v[2], r->state->texture);     \
+            sw_depth_tiles_update_triangle(r, &plane, v, depthTest);        \
+        }                                                                   \
+    }
+
+    // NOTE: Multisampling always uses the half-space rasterizer, it evaluates the coverage per sample
+    if (SW_STATE_CHECK_EX(state, SW_STATE_MULTISAMPLE))
+    {
+        if (r->state->fragmentProc != NULL) TRIANGLE_RASTER(sw_triangle_raster_multisample_PROGRAM)
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_multisample_TEX_DEPTH_BLEND)
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_multisample_DEPTH_BLEND)
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_multisample_TEX_BLEND)
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST)) TRIANGLE_RASTER(sw_triangle_raster_multisample_TEX_DEPTH)
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_multisample_BLEND)
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) TRIANGLE_RASTER(sw_triangle_raster_multisample_DEPTH)
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D)) TRIANGLE_RASTER(sw_triangle_raster_multisample_TEX)
+        else TRIANGLE_RASTER(sw_triangle_raster_multisample)
+    }
+#if SW_HALF_SPACE_RASTER
+    else if (r->state->fragmentProc != NULL) TRIANGLE_RASTER(sw_triangle_raster_half_space_PROGRAM)
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_half_space_TEX_DEPTH_BLEND)
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_half_space_DEPTH_BLEND)
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_half_space_TEX_BLEND)
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST)) TRIANGLE_RASTER(sw_triangle_raster_half_space_TEX_DEPTH)
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_half_space_BLEND)
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) TRIANGLE_RASTER(sw_triangle_raster_half_space_DEPTH)
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D)) TRIANGLE_RASTER(sw_triangle_raster_half_space_TEX)
+    else TRIANGLE_RASTER(sw_triangle_raster_half_space)
+#else
+    else if (r->state->fragmentProc != NULL) TRIANGLE_RASTER(sw_triangle_raster_PROGRAM)
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH_BLEND)
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_DEPTH_BLEND)
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_TEX_BLEND)
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST)) TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH)
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_BLEND)
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) TRIANGLE_RASTER(sw_triangle_raster_DEPTH)
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D)) TRIANGLE_RASTER(sw_triangle_raster_TEX)
+    else TRIANGLE_RASTER(sw_triangle_raster)
+#endif
+
+    #undef TRIANGLE_RASTER
+}
+
+static inline void sw_triangle_render(void)
+{
+    SW_STATS_ADD(primitives, 1);
+
+    if (RLSW.stateFlags & SW_STATE_CULL_FACE)
+    {
+        if (!sw_triangle_face_culling()) { SW_STATS_ADD(primitivesCulled, 1); return; }
+    }
+
+    sw_triangle_clip_and_project();
+
+    if (RLSW.vertexCounter < 3) { SW_STATS_ADD(primitivesClipped, 1); return; }
+    if (SW_ENABLE_STATS && sw_vertices_are_affine(RLSW.vertexBuffer, RLSW.vertexCounter)) SW_STATS_ADD(primitivesAffine, 1);
+
+    sw_raster_submit(SW_RASTER_POLYGON, sw_raster_get_flags(), RLSW.vertexBuffer, RLSW.vertexCounter);
+}
+//-------------------------------------------------------------------------------------------
+
+// Quad rendering logic
+//-------------------------------------------------------------------------------------------
+static inline bool sw_quad_face_culling(void)
+{
+    // NOTE: Face culling is done before clipping to avoid unnecessary computations
+    // To handle quads crossing the w=0 plane correctly,
+    // the winding order test is performed in homogeneous coordinates directly,
+    // before the perspective division (division by w)
+    // For a convex quad with vertices P0, P1, P2, P3 in sequential order,
+    // the winding order of the quad is the same as the winding order
     // of the triangle P0 P1 P2. The homogeneous triangle is used on
     // winding test on this first triangle
 
@@ -2681,10 +5208,32 @@ static inline bool sw_quad_is_axis_aligned(void)
     return true;
 }
 
-static inline void sw_quad_sort_cw(const sw_vertex_t* *output)
+// Checks if the projected quad is a parallelogram with a constant w, sprites drawn in 2D or facing the camera
+// NOTE: Its attributes must be planar too, the affine path interpolates them across the whole quad
+static inline bool sw_quad_is_affine(void)
 {
-    const sw_vertex_t *input = RLSW.vertexBuffer;
+    const sw_vertex_t *v = RLSW.vertexBuffer;
+
+    if (!sw_vertices_are_affine(v, 4)) return false;
+
+    // Opposite corners of a parallelogram have the same midpoint, in screen space and for the attributes
+    #define SW_QUAD_IS_PLANAR(FIELD, INDEX, EPSILON) \
+        (fabsf(v[0].FIELD[INDEX] + v[2].FIELD[INDEX] - v[1].FIELD[INDEX] - v[3].FIELD[INDEX]) <= (EPSILON))
 
+    const float wRcp = fabsf(v[0].homogeneous[3]);
+    bool planar = SW_QUAD_IS_PLANAR(screen, 0, 0.01f) && SW_QUAD_IS_PLANAR(screen, 1, 0.01f) &&
+                  SW_QUAD_IS_PLANAR(homogeneous, 2, 1e-5f) &&
+                  SW_QUAD_IS_PLANAR(texcoord, 0, 1e-5f*wRcp) && SW_QUAD_IS_PLANAR(texcoord, 1, 1e-5f*wRcp) &&
+                  SW_QUAD_IS_PLANAR(color, 0, 1e-3f*wRcp) && SW_QUAD_IS_PLANAR(color, 1, 1e-3f*wRcp) &&
+                  SW_QUAD_IS_PLANAR(color, 2, 1e-3f*wRcp) && SW_QUAD_IS_PLANAR(color, 3, 1e-3f*wRcp);
+
+    #undef SW_QUAD_IS_PLANAR
+
+    return planar;
+}
+
+static inline void sw_quad_sort_cw(const sw_vertex_t* *output, const sw_vertex_t *input)
+{
     // Calculate the centroid of the quad
     float cx = (input[0].screen[0] + input[1].screen[0] +
                 input[2].screen[0] + input[3].screen[0])*0.25f;
@@ -2722,11 +5271,11 @@ static inline void sw_quad_sort_cw(const sw_vertex_t* *output)
 // TODO: REVIEW: Could a perfectly aligned quad, where one of the four points has a different depth,
 // still appear perfectly aligned from a certain point of view?
 // Because in that case, it's still needed to perform perspective division for textures and colors...
-#define DEFINE_QUAD_RASTER_AXIS_ALIGNED(FUNC_NAME, ENABLE_TEXTURE, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND) \
-static inline void FUNC_NAME(void)                                              \
+#define DEFINE_QUAD_RASTER_AXIS_ALIGNED(FUNC_NAME, ENABLE_TEXTURE, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND, ENABLE_PROGRAM) \
+static inline void FUNC_NAME(const sw_raster_t *r, const sw_vertex_t *quad)   \
 {                                                                               \
     const sw_vertex_t *sortedVerts[4];                                          \
-    sw_quad_sort_cw(sortedVerts);                                               \
+    sw_quad_sort_cw(sortedVerts, quad);                                         \
                                                                                 \
     const sw_vertex_t *v0 = sortedVerts[0];                                     \
     const sw_vertex_t *v1 = sortedVerts[1];                                     \
@@ -2734,10 +5283,10 @@ static inline void FUNC_NAME(void)
     const sw_vertex_t *v3 = sortedVerts[3];                                     \
                                                                                 \
     /* Screen bounds (axis-aligned) */                                          \
-    int xMin = (int)v0->screen[0];                                              \
-    int yMin = (int)v0->screen[1];                                              \
-    int xMax = (int)v2->screen[0];                                              \
-    int yMax = (int)v2->screen[1];                                              \
+    int xMin = (int)floorf(v0->screen[0]);                                      \
+    int yMin = (int)floorf(v0->screen[1]);                                      \
+    int xMax = (int)floorf(v2->screen[0]);                                      \
+    int yMax = (int)floorf(v2->screen[1]);                                      \
                                                                                 \
     float w = v2->screen[0] - v0->screen[0];                                    \
     float h = v2->screen[1] - v0->screen[1];                                    \
@@ -2751,6 +5300,26 @@ static inline void FUNC_NAME(void)
     float xSubstep = 1.0f - sw_fract(v0->screen[0]);                            \
     float ySubstep = 1.0f - sw_fract(v0->screen[1]);                            \
                                                                                 \
+    /* Limit the bounds to the clip rectangle, then to the raster region */     \
+    /* NOTE: Bin tiles step the rows and pixels before their region with the */ \
+    /* same increments as the whole quad, so they get the same values */        \
+    int clipX = r->state->clipMin[0];                                           \
+    int clipY = r->state->clipMin[1];                                           \
+    if (xMin < clipX) {                                                         \
+        xSubstep += (float)(clipX - xMin);                                      \
+        xMin = clipX;                                                           \
+    }                                                                           \
+    if (yMin < clipY) {                                                         \
+        ySubstep += (float)(clipY - yMin);                                      \
+        yMin = clipY;                                                           \
+    }                                                                           \
+    int xFirst = sw_maxi(xMin, r->xMin);                                        \
+    int yFirst = sw_maxi(yMin, r->yMin);                                        \
+    if (xMax > r->xMax) xMax = r->xMax;                                         \
+    if (yMax > r->yMax) yMax = r->yMax;                                         \
+                                                                                \
+    if ((xFirst >= xMax) || (yFirst >= yMax)) return;                           \
+                                                                                \
     /* Calculation of vertex gradients in X and Y */                            \
     float dUdx = 0.0f, dVdx = 0.0f;                                             \
     float dUdy = 0.0f, dVdy = 0.0f;                                             \
@@ -2776,11 +5345,12 @@ static inline void FUNC_NAME(void)
     dZdy = (v3->homogeneous[2] - v0->homogeneous[2])*hRcp;                      \
                                                                                 \
     /* Start of quad rasterization */                                           \
-    const sw_texture_t *tex;                                                    \
-    if (ENABLE_TEXTURE) tex = &RLSW.loadedTextures[RLSW.currentTexture];        \
+    const sw_texture_t *tex = r->state->texture;                                \
                                                                                 \
-    sw_pixel_t *pixels = RLSW.framebuffer.pixels;                               \
-    int wDst = RLSW.framebuffer.width;                                          \
+    sw_color_t *colors = r->colors;                                             \
+    sw_depth_t *depths = r->depths;                                             \
+    int wColor = r->colorStride;                                                \
+    int wDst = r->width;                                                        \
                                                                                 \
     float zScanline = v0->homogeneous[2] + dZdx*xSubstep + dZdy*ySubstep;       \
     float uScanline = v0->texcoord[0] + dUdx*xSubstep + dUdy*ySubstep;          \
@@ -2793,9 +5363,26 @@ static inline void FUNC_NAME(void)
         v0->color[3] + dCdx[3]*xSubstep + dCdy[3]*ySubstep                      \
     };                                                                          \
                                                                                 \
-    for (int y = yMin; y < yMax; y++)                                           \
+    /* Step to the first row of the raster region */                            \
+    for (int y = yMin; y < yFirst; y++)                                         \
+    {                                                                           \
+        zScanline += dZdy;                                                      \
+        colorScanline[0] += dCdy[0];                                            \
+        colorScanline[1] += dCdy[1];                                            \
+        colorScanline[2] += dCdy[2];                                            \
+        colorScanline[3] += dCdy[3];                                            \
+                                                                                \
+        if (ENABLE_TEXTURE)                                                     \
+        {                                                                       \
+            uScanline += dUdy;                                                  \
+            vScanline += dVdy;                                                  \
+        }                                                                       \
+    }                                                                           \
+                                                                                \
+    for (int y = yFirst; y < yMax; y++)                                         \
     {                                                                           \
-        sw_pixel_t *ptr = pixels + y*wDst + xMin;                               \
+        sw_color_t *cptr = colors + y*wColor + xFirst;                          \
+        sw_depth_t *dptr = depths + y*wDst + xFirst;                            \
                                                                                 \
         float z = zScanline;                                                    \
         float u = uScanline;                                                    \
@@ -2808,8 +5395,23 @@ static inline void FUNC_NAME(void)
             colorScanline[3]                                                    \
         };                                                                      \
                                                                                 \
+        /* Step to the first pixel of the raster region */                      \
+        for (int x = xMin; x < xFirst; x++)                                     \
+        {                                                                       \
+            z += dZdx;                                                          \
+            color[0] += dCdx[0];                                                \
+            color[1] += dCdx[1];                                                \
+            color[2] += dCdx[2];                                                \
+            color[3] += dCdx[3];                                                \
+            if (ENABLE_TEXTURE)                                                 \
+            {                                                                   \
+                u += dUdx;                                                      \
+                v += dVdx;                                                      \
+            }                                                                   \
+        }                                                                       \
+                                                                                \
         /* Scanline rasterization */                                            \
-        for (int x = xMin; x < xMax; x++)                                       \
+        for (int x = xFirst; x < xMax; x++)                                     \
         {                                                                       \
             /* Pixel color computation */                                       \
             float srcColor[4] = {                                               \
@@ -2823,31 +5425,29 @@ static inline void FUNC_NAME(void)
             if (ENABLE_DEPTH_TEST)                                              \
             {                                                                   \
                 /* TODO: Implement different depth funcs? */                    \
-                float depth =  sw_framebuffer_read_depth(ptr);                  \
-                if (z > depth) goto discard;                                    \
+                float depth =  sw_framebuffer_read_depth(dptr);                 \
+                if (z > depth) { SW_RASTER_STATS_ADD(r, pixelsDepthRejected, 1); goto discard; } \
             }                                                                   \
                                                                                 \
             /* TODO: Implement depth mask */                                    \
-            sw_framebuffer_write_depth(ptr, z);                                 \
+            sw_framebuffer_output_depth(r, dptr, z);                            \
                                                                                 \
             if (ENABLE_TEXTURE)                                                 \
             {                                                                   \
                 float texColor[4];                                              \
-                sw_texture_sample(texColor, tex, u, v, dUdx, dUdy, dVdx, dVdy); \
-                srcColor[0] *= texColor[0];                                     \
-                srcColor[1] *= texColor[1];                                     \
-                srcColor[2] *= texColor[2];                                     \
-                srcColor[3] *= texColor[3];                                     \
+                int texels = sw_texture_sample(texColor, tex, u, v, dUdx, dUdy, dVdx, dVdy); \
+                SW_RASTER_STATS_ADD(r, texelsFetched, texels);                  \
+                if (ENABLE_PROGRAM) sw_fragment_program(r, srcColor, texColor, u, v, x, y); \
+                else                                                            \
+                {                                                               \
+                    srcColor[0] *= texColor[0];                                 \
+                    srcColor[1] *= texColor[1];                                 \
+                    srcColor[2] *= texColor[2];                                 \
+                    srcColor[3] *= texColor[3];                                 \
+                }                                                               \
             }                                                                   \
                                                                                 \
-            if (ENABLE_COLOR_BLEND)                                             \
-            {                                                                   \
-                float dstColor[4];                                              \
-                sw_framebuffer_read_color(dstColor, ptr);                       \
-                sw_blend_colors(dstColor, srcColor);                            \
-                sw_framebuffer_write_color(ptr, dstColor);                      \
-            }                                                                   \
-            else sw_framebuffer_write_color(ptr, srcColor);                     \
+            sw_framebuffer_output_color(r, cptr, srcColor, ENABLE_COLOR_BLEND); \
                                                                                 \
         discard:                                                                \
             z += dZdx;                                                          \
@@ -2860,7 +5460,8 @@ static inline void FUNC_NAME(void)
                 u += dUdx;                                                      \
                 v += dVdx;                                                      \
             }                                                                   \
-            ++ptr;                                                              \
+            ++cptr;                                                             \
+            ++dptr;                                                             \
         }                                                                       \
                                                                                 \
         zScanline += dZdy;                                                      \
@@ -2877,66 +5478,342 @@ static inline void FUNC_NAME(void)
     }                                                                           \
 }
 
-DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned, 0, 0, 0)
-DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_TEX, 1, 0, 0)
-DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_DEPTH, 0, 1, 0)
-DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_BLEND, 0, 0, 1)
-DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_TEX_DEPTH, 1, 1, 0)
-DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_TEX_BLEND, 1, 0, 1)
-DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_DEPTH_BLEND, 0, 1, 1)
-DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_TEX_DEPTH_BLEND, 1, 1, 1)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned, 0, 0, 0, 0)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_TEX, 1, 0, 0, 0)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_DEPTH, 0, 1, 0, 0)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_BLEND, 0, 0, 1, 0)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_TEX_DEPTH, 1, 1, 0, 0)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_TEX_BLEND, 1, 0, 1, 0)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_DEPTH_BLEND, 0, 1, 1, 0)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_TEX_DEPTH_BLEND, 1, 1, 1, 0)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_PROGRAM, 1, SW_PROGRAM_DEPTH_TEST, SW_PROGRAM_BLEND, 1)
+
+// Affine quads, sprites rotated or scaled in 2D: attributes are linear in screen space, without
+// perspective divide nor w interpolation, and the textures are sampled with constant derivatives
+#define DEFINE_QUAD_RASTER_AFFINE_SPAN(FUNC_NAME, ENABLE_TEXTURE, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND, ENABLE_PROGRAM) \
+static inline void FUNC_NAME(const sw_raster_t *r, const sw_texture_t *tex,     \
+                             int y, int xBase, int xStart, int xEnd,            \
+                             const float *a, const float *dAdx, const float *dAdy) \
+{                                                                               \
+    /* Attributes at the first pixel in the clip rectangle, in order depth, */  \
+    /* color and texcoords */                                                   \
+    float z = a[0];                                                             \
+    float color[4] = { a[1], a[2], a[3], a[4] };                                \
+    float u = a[5];                                                             \
+    float v = a[6];                                                             \
+                                                                                \
+    const bool spanLinear = ENABLE_TEXTURE && sw_texture_is_span_linear(tex);   \
+    uint8_t spanTexels[4][4];                                                   \
+    int spanStart = xStart;                                                     \
+    int spanEnd = xStart;                                                       \
+                                                                                \
+    /* Bin tiles step to their first pixel with the same increments as the */   \
+    /* whole span, and start with its texel span, so they get the same values */ \
+    int xSpan = xStart - (xStart - xBase)%4;                                    \
+    for (int x = xBase; x < xStart; x++)                                        \
+    {                                                                           \
+        if (spanLinear && (x == xSpan))                                         \
+        {                                                                       \
+            sw_texture_sample_linear_span(spanTexels, tex, u, v, 1.0f, dAdx[5], dAdx[6], 0.0f); \
+            SW_RASTER_STATS_ADD(r, texelsFetched, 16);                          \
+            spanStart = x;                                                      \
+            spanEnd = x + 4;                                                    \
+        }                                                                       \
+        z += dAdx[0];                                                           \
+        color[0] += dAdx[1];                                                    \
+        color[1] += dAdx[2];                                                    \
+        color[2] += dAdx[3];                                                    \
+        color[3] += dAdx[4];                                                    \
+        if (ENABLE_TEXTURE)                                                     \
+        {                                                                       \
+            u += dAdx[5];                                                       \
+            v += dAdx[6];                                                       \
+        }                                                                       \
+    }                                                                           \
+                                                                                \
+    sw_color_t *cptr = r->colors + y*r->colorStride + xStart;                   \
+    sw_depth_t *dptr = r->depths + y*r->width + xStart;                         \
+                                                                                \
+    for (int x = xStart; x < xEnd; x++)                                         \
+    {                                                                           \
+        float srcColor[4] = {                                                   \
+            color[0],                                                           \
+            color[1],                                                           \
+            color[2],                                                           \
+            color[3]                                                            \
+        };                                                                      \
+                                                                                \
+        if (ENABLE_DEPTH_TEST)                                                  \
+        {                                                                       \
+            /* TODO: Implement different depth funcs? */                        \
+            float depth =  sw_framebuffer_read_depth(dptr);                     \
+            if (z > depth) { SW_RASTER_STATS_ADD(r, pixelsDepthRejected, 1); goto discard; } \
+        }                                                                       \
+                                                                                \
+        /* TODO: Implement depth mask */                                        \
+        sw_framebuffer_output_depth(r, dptr, z);                                \
+                                                                                \
+        if (ENABLE_TEXTURE)                                                     \
+        {                                                                       \
+            float texColor[4];                                                  \
+            if (spanLinear)                                                     \
+            {                                                                   \
+                /* NOTE: No perspective, the span is sampled with a unit w */   \
+                if (x >= spanEnd)                                               \
+                {                                                               \
+                    sw_texture_sample_linear_span(spanTexels, tex, u, v, 1.0f, dAdx[5], dAdx[6], 0.0f); \
+                    SW_RASTER_STATS_ADD(r, texelsFetched, 16);                  \
+                    spanStart = x;                                              \
+                    spanEnd = x + 4;                                            \
+                }                                                               \
+                sw_float_from_unorm8_simd(texColor, spanTexels[x - spanStart]); \
+            }                                                                   \
+            else                                                                \
+            {                                                                   \
+                int texels = sw_texture_sample(texColor, tex, u, v, dAdx[5], dAdy[5], dAdx[6], dAdy[6]); \
+                SW_RASTER_STATS_ADD(r, texelsFetched, texels);                  \
+            }                                                                   \
+            if (ENABLE_PROGRAM) sw_fragment_program(r, srcColor, texColor, u, v, x, y); \
+            else                                                                \
+            {                                                                   \
+                srcColor[0] *= texColor[0];                                     \
+                srcColor[1] *= texColor[1];                                     \
+                srcColor[2] *= texColor[2];                                     \
+                srcColor[3] *= texColor[3];                                     \
+            }                                                                   \
+        }                                                                       \
+                                                                                \
+        sw_framebuffer_output_color(r, cptr, srcColor, ENABLE_COLOR_BLEND);     \
+                                                                                \
+    discard:                                                                    \
+        z += dAdx[0];                                                           \
+        color[0] += dAdx[1];                                                    \
+        color[1] += dAdx[2];                                                    \
+        color[2] += dAdx[3];                                                    \
+        color[3] += dAdx[4];                                                    \
+        if (ENABLE_TEXTURE)                                                     \
+        {                                                                       \
+            u += dAdx[5];                                                       \
+            v += dAdx[6];                                                       \
+        }                                                                       \
+        ++cptr;                                                                 \
+        ++dptr;                                                                 \
+    }                                                                           \
+}
+
+#define DEFINE_QUAD_RASTER_AFFINE(FUNC_NAME, FUNC_SPAN)                         \
+static inline void FUNC_NAME(const sw_raster_t *r, const sw_vertex_t *quad)     \
+{                                                                               \
+    const sw_vertex_t *v0 = &quad[0];                                           \
+    const sw_vertex_t *v1 = &quad[1];                                           \
+    const sw_vertex_t *v3 = &quad[3];                                           \
+                                                                                \
+    /* Attribute planes from the edges sharing the first corner */              \
+    float e1x = v1->screen[0] - v0->screen[0], e1y = v1->screen[1] - v0->screen[1]; \
+    float e3x = v3->screen[0] - v0->screen[0], e3y = v3->screen[1] - v0->screen[1]; \
+    float area = e1x*e3y - e3x*e1y;                                             \
+    if (fabsf(area) < 1e-6f) return;                                            \
+    float areaRcp = 1.0f/area;                                                  \
+                                                                                \
+    /* Attributes were divided by the constant w at projection, scaled back */  \
+    float wScale = 1.0f/v0->homogeneous[3];                                     \
+    float a0[7], dAdx[7], dAdy[7];                                              \
+    for (int k = 0; k < 7; k++)                                                 \
+    {                                                                           \
+        float c0 = (k == 0)? v0->homogeneous[2] : ((k < 5)? v0->color[k - 1] : v0->texcoord[k - 5]); \
+        float c1 = (k == 0)? v1->homogeneous[2] : ((k < 5)? v1->color[k - 1] : v1->texcoord[k - 5]); \
+        float c3 = (k == 0)? v3->homogeneous[2] : ((k < 5)? v3->color[k - 1] : v3->texcoord[k - 5]); \
+        float scale = (k == 0)? 1.0f : wScale;                                  \
+        float da1 = (c1 - c0)*scale;                                            \
+        float da3 = (c3 - c0)*scale;                                            \
+        a0[k] = c0*scale;                                                       \
+        dAdx[k] = (da1*e3y - da3*e1y)*areaRcp;                                  \
+        dAdy[k] = (da3*e1x - da1*e3x)*areaRcp;                                  \
+    }                                                                           \
+                                                                                \
+    /* Rows covered by the quad, limited to the raster region */                \
+    float qyMin = quad[0].screen[1], qyMax = qyMin;                             \
+    for (int i = 1; i < 4; i++)                                                 \
+    {                                                                           \
+        qyMin = fminf(qyMin, quad[i].screen[1]);                                \
+        qyMax = fmaxf(qyMax, quad[i].screen[1]);                                \
+    }                                                                           \
+    int yMin = sw_maxi((int)floorf(qyMin), r->yMin);                            \
+    int yMax = sw_mini((int)floorf(qyMax), r->yMax);                            \
+                                                                                \
+    /* Inverse slopes of the edges, horizontal ones never cross a row */        \
+    float edgeDxDy[4];                                                          \
+    for (int i = 0; i < 4; i++)                                                 \
+    {                                                                           \
+        const float *p = quad[i].screen;                                        \
+        const float *q = quad[(i + 1)%4].screen;                                \
+        edgeDxDy[i] = (p[1] != q[1])? (q[0] - p[0])/(q[1] - p[1]) : 0.0f;       \
+    }                                                                           \
+                                                                                \
+    for (int y = yMin; y < yMax; y++)                                           \
+    {                                                                           \
+        /* Span between the edges crossing the row, pixels are sampled at their \
+           bottom-right corner like the scanline triangles, the span is (xLeft, xRight] */ \
+        float yc = y + 1.0f;                                                    \
+        float xLeft = FLT_MAX, xRight = -FLT_MAX;                               \
+        for (int i = 0; i < 4; i++)                                             \
+        {                                                                       \
+            const float *p = quad[i].screen;                                    \
+            const float *q = quad[(i + 1)%4].screen;                            \
+            if ((yc <= fminf(p[1], q[1])) || (yc > fmaxf(p[1], q[1]))) continue; \
+            float xc = p[0] + (yc - p[1])*edgeDxDy[i];                          \
+            xLeft = fminf(xLeft, xc);                                           \
+            xRight = fmaxf(xRight, xc);                                         \
+        }                                                                       \
+        if (xLeft > xRight) continue;                                           \
+                                                                                \
+        int xBase = sw_maxi((int)floorf(xLeft), r->state->clipMin[0]);          \
+        int xStart = sw_maxi((int)floorf(xLeft), r->xMin);                      \
+        int xEnd = sw_mini((int)floorf(xRight), r->xMax);                       \
+        if (xStart >= xEnd) continue;                                           \
+                                                                                \
+        /* Attributes at the first pixel in the clip rectangle */               \
+        float px = (xBase + 1.0f) - v0->screen[0];                              \
+        float py = yc - v0->screen[1];                                          \
+        float a[7];                                                             \
+        for (int k = 0; k < 7; k++) a[k] = a0[k] + dAdx[k]*px + dAdy[k]*py;     \
+                                                                                \
+        FUNC_SPAN(r, r->state->texture, y, xBase, xStart, xEnd, a, dAdx, dAdy); \
+    }                                                                           \
+}
+
+DEFINE_QUAD_RASTER_AFFINE_SPAN(sw_quad_raster_affine_span, 0, 0, 0, 0)
+DEFINE_QUAD_RASTER_AFFINE_SPAN(sw_quad_raster_affine_span_TEX, 1, 0, 0, 0)
+DEFINE_QUAD_RASTER_AFFINE_SPAN(sw_quad_raster_affine_span_DEPTH, 0, 1, 0, 0)
+DEFINE_QUAD_RASTER_AFFINE_SPAN(sw_quad_raster_affine_span_BLEND, 0, 0, 1, 0)
+DEFINE_QUAD_RASTER_AFFINE_SPAN(sw_quad_raster_affine_span_TEX_DEPTH, 1, 1, 0, 0)
+DEFINE_QUAD_RASTER_AFFINE_SPAN(sw_quad_raster_affine_span_TEX_BLEND, 1, 0, 1, 0)
+DEFINE_QUAD_RASTER_AFFINE_SPAN(sw_quad_raster_affine_span_DEPTH_BLEND, 0, 1, 1, 0)
+DEFINE_QUAD_RASTER_AFFINE_SPAN(sw_quad_raster_affine_span_TEX_DEPTH_BLEND, 1, 1, 1, 0)
+DEFINE_QUAD_RASTER_AFFINE_SPAN(sw_quad_raster_affine_span_PROGRAM, 1, SW_PROGRAM_DEPTH_TEST, SW_PROGRAM_BLEND, 1)
+
+DEFINE_QUAD_RASTER_AFFINE(sw_quad_raster_affine, sw_quad_raster_affine_span)
+DEFINE_QUAD_RASTER_AFFINE(sw_quad_raster_affine_TEX, sw_quad_raster_affine_span_TEX)
+DEFINE_QUAD_RASTER_AFFINE(sw_quad_raster_affine_DEPTH, sw_quad_raster_affine_span_DEPTH)
+DEFINE_QUAD_RASTER_AFFINE(sw_quad_raster_affine_BLEND, sw_quad_raster_affine_span_BLEND)
+DEFINE_QUAD_RASTER_AFFINE(sw_quad_raster_affine_TEX_DEPTH, sw_quad_raster_affine_span_TEX_DEPTH)
+DEFINE_QUAD_RASTER_AFFINE(sw_quad_raster_affine_TEX_BLEND, sw_quad_raster_affine_span_TEX_BLEND)
+DEFINE_QUAD_RASTER_AFFINE(sw_quad_raster_affine_DEPTH_BLEND, sw_quad_raster_affine_span_DEPTH_BLEND)
+DEFINE_QUAD_RASTER_AFFINE(sw_quad_raster_affine_TEX_DEPTH_BLEND, sw_quad_raster_affine_span_TEX_DEPTH_BLEND)
+DEFINE_QUAD_RASTER_AFFINE(sw_quad_raster_affine_PROGRAM, sw_quad_raster_affine_span_PROGRAM)
+
+static inline void sw_raster_quad(const sw_raster_t *r, uint32_t state, const sw_vertex_t *quad)
+{
+    // Pixels and depth range covered by the quad, the depth plane is extrapolated up to one pixel
+    const sw_vertex_t *v[4];
+    sw_quad_sort_cw(v, quad);
+
+    float dZdx = v[1]->homogeneous[2] - v[0]->homogeneous[2];
+    float dZdy = v[3]->homogeneous[2] - v[0]->homogeneous[2];
+    float w = v[2]->screen[0] - v[0]->screen[0];
+    float h = v[2]->screen[1] - v[0]->screen[1];
+    float step = ((w > 0.0f)? fabsf(dZdx)/w : 0.0f) + ((h > 0.0f)? fabsf(dZdy)/h : 0.0f);
+    float zLo = v[0]->homogeneous[2] + fminf(dZdx, 0.0f) + fminf(dZdy, 0.0f) - step - SW_DEPTH_TILE_EPSILON;
+    float zHi = v[0]->homogeneous[2] + fmaxf(dZdx, 0.0f) + fmaxf(dZdy, 0.0f) + step + SW_DEPTH_TILE_EPSILON;
+
+    // Quads are limited to the clip rectangle captured in the state
+    sw_raster_t clipped = *r;
+    clipped.xMin = sw_maxi(r->xMin, r->state->clipMin[0]);
+    clipped.yMin = sw_maxi(r->yMin, r->state->clipMin[1]);
+    clipped.xMax = sw_mini(r->xMax, r->state->clipMax[0]);
+    clipped.yMax = sw_mini(r->yMax, r->state->clipMax[1]);
+
+    int xMin = sw_maxi((int)floorf(v[0]->screen[0]), clipped.xMin);
+    int yMin = sw_maxi((int)floorf(v[0]->screen[1]), clipped.yMin);
+    int xMax = sw_mini((int)floorf(v[2]->screen[0]), clipped.xMax);
+    int yMax = sw_mini((int)floorf(v[2]->screen[1]), clipped.yMax);
+
+    if ((xMin >= xMax) || (yMin >= yMax)) return;
+
+    bool depthTest = SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST);
+    if (depthTest && sw_depth_tiles_reject_rect(r, xMin, yMin, xMax, yMax, zLo)) return;
+
+    if (r->state->fragmentProc != NULL) sw_quad_raster_axis_aligned_PROGRAM(&clipped, quad);
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_quad_raster_axis_aligned_TEX_DEPTH_BLEND(&clipped, quad);
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_quad_raster_axis_aligned_DEPTH_BLEND(&clipped, quad);
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_BLEND)) sw_quad_raster_axis_aligned_TEX_BLEND(&clipped, quad);
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST)) sw_quad_raster_axis_aligned_TEX_DEPTH(&clipped, quad);
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) sw_quad_raster_axis_aligned_BLEND(&clipped, quad);
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) sw_quad_raster_axis_aligned_DEPTH(&clipped, quad);
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D)) sw_quad_raster_axis_aligned_TEX(&clipped, quad);
+    else sw_quad_raster_axis_aligned(&clipped, quad);
+
+    sw_depth_tiles_update_rect(r, xMin, yMin, xMax, yMax, zLo, zHi, !depthTest);
+}
+
+static inline void sw_raster_quad_affine(const sw_raster_t *r, uint32_t state, const sw_vertex_t *quad)
+{
+    bool depthTest = SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST);
+
+    // Quads are limited to the clip rectangle captured in the state
+    sw_raster_t clipped = *r;
+    clipped.xMin = sw_maxi(r->xMin, r->state->clipMin[0]);
+    clipped.yMin = sw_maxi(r->yMin, r->state->clipMin[1]);
+    clipped.xMax = sw_mini(r->xMax, r->state->clipMax[0]);
+    clipped.yMax = sw_mini(r->yMax, r->state->clipMax[1]);
+
+    if ((clipped.xMin >= clipped.xMax) || (clipped.yMin >= clipped.yMax)) return;
+
+    // Depth tiles are tested and updated with the two triangles of the quad
+    const sw_vertex_t *triangles[2][3] = {
+        { &quad[0], &quad[1], &quad[2] },
+        { &quad[0], &quad[2], &quad[3] }
+    };
+    sw_depth_plane_t planes[2];
+    sw_depth_plane_init(&planes[0], triangles[0][0], triangles[0][1], triangles[0][2]);
+    sw_depth_plane_init(&planes[1], triangles[1][0], triangles[1][1], triangles[1][2]);
+
+    if (depthTest && sw_depth_tiles_reject_triangle(&clipped, &planes[0]) &&
+        sw_depth_tiles_reject_triangle(&clipped, &planes[1])) return;
+
+    if (r->state->fragmentProc != NULL) sw_quad_raster_affine_PROGRAM(&clipped, quad);
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_quad_raster_affine_TEX_DEPTH_BLEND(&clipped, quad);
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_quad_raster_affine_DEPTH_BLEND(&clipped, quad);
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_BLEND)) sw_quad_raster_affine_TEX_BLEND(&clipped, quad);
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST)) sw_quad_raster_affine_TEX_DEPTH(&clipped, quad);
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) sw_quad_raster_affine_BLEND(&clipped, quad);
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) sw_quad_raster_affine_DEPTH(&clipped, quad);
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D)) sw_quad_raster_affine_TEX(&clipped, quad);
+    else sw_quad_raster_affine(&clipped, quad);
+
+    sw_depth_tiles_update_triangle(r, &planes[0], triangles[0], depthTest);
+    sw_depth_tiles_update_triangle(r, &planes[1], triangles[1], depthTest);
+}
 
 static inline void sw_quad_render(void)
 {
+    SW_STATS_ADD(primitives, 1);
+
     if (RLSW.stateFlags & SW_STATE_CULL_FACE)
     {
-        if (!sw_quad_face_culling()) return;
+        if (!sw_quad_face_culling()) { SW_STATS_ADD(primitivesCulled, 1); return; }
     }
 
     sw_quad_clip_and_project();
 
-    if (RLSW.vertexCounter < 3) return;
+    if (RLSW.vertexCounter < 3) { SW_STATS_ADD(primitivesClipped, 1); return; }
+    if (SW_ENABLE_STATS && sw_vertices_are_affine(RLSW.vertexBuffer, RLSW.vertexCounter)) SW_STATS_ADD(primitivesAffine, 1);
 
-    uint32_t state = RLSW.stateFlags;
-    if (RLSW.currentTexture == 0) state &= ~SW_STATE_TEXTURE_2D;
-    if ((RLSW.srcFactor == SW_ONE) && (RLSW.dstFactor == SW_ZERO)) state &= ~SW_STATE_BLEND;
+    uint32_t flags = sw_raster_get_flags();
 
-    if ((RLSW.vertexCounter == 4) && sw_quad_is_axis_aligned())
+    // NOTE: Multisampled quads are rasterized as polygons, their edges are antialiased too
+    if ((RLSW.vertexCounter == 4) && !(flags & SW_STATE_MULTISAMPLE) && sw_quad_is_axis_aligned())
     {
-        if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_quad_raster_axis_aligned_TEX_DEPTH_BLEND();
-        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_quad_raster_axis_aligned_DEPTH_BLEND();
-        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_BLEND)) sw_quad_raster_axis_aligned_TEX_BLEND();
-        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST)) sw_quad_raster_axis_aligned_TEX_DEPTH();
-        else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) sw_quad_raster_axis_aligned_BLEND();
-        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) sw_quad_raster_axis_aligned_DEPTH();
-        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D)) sw_quad_raster_axis_aligned_TEX();
-        else sw_quad_raster_axis_aligned();
-        return;
+        sw_raster_submit(SW_RASTER_QUAD_AXIS_ALIGNED, flags, RLSW.vertexBuffer, 4);
     }
-
-    #define TRIANGLE_RASTER(RASTER_FUNC)                        \
-    {                                                           \
-        for (int i = 0; i < RLSW.vertexCounter - 2; i++)        \
-        {                                                       \
-            RASTER_FUNC(                                        \
-                &RLSW.vertexBuffer[0],                          \
-                &RLSW.vertexBuffer[i + 1],                      \
-                &RLSW.vertexBuffer[i + 2],                      \
-                &RLSW.loadedTextures[RLSW.currentTexture]       \
-            );                                                  \
-        }                                                       \
+    else if ((RLSW.vertexCounter == 4) && !(flags & SW_STATE_MULTISAMPLE) && sw_quad_is_affine())
+    {
+        sw_raster_submit(SW_RASTER_QUAD_AFFINE, flags, RLSW.vertexBuffer, 4);
+    }
+    else
+    {
+        sw_raster_submit(SW_RASTER_POLYGON, flags, RLSW.vertexBuffer, RLSW.vertexCounter);
     }
-
-    if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH_BLEND)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_DEPTH_BLEND)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_TEX_BLEND)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST)) TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_BLEND)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) TRIANGLE_RASTER(sw_triangle_raster_DEPTH)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D)) TRIANGLE_RASTER(sw_triangle_raster_TEX)
-    else TRIANGLE_RASTER(sw_triangle_raster)
-
-    #undef TRIANGLE_RASTER
 }
 //-------------------------------------------------------------------------------------------
 
@@ -3037,8 +5914,8 @@ static inline bool sw_line_clip_and_project(sw_vertex_t *v0, sw_vertex_t *v1)
     return true;
 }
 
-#define DEFINE_LINE_RASTER(FUNC_NAME, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND) \
-static inline void FUNC_NAME(const sw_vertex_t *v0, const sw_vertex_t *v1) \
+#define DEFINE_LINE_RASTER(FUNC_NAME, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND, ENABLE_PROGRAM) \
+static inline void FUNC_NAME(const sw_raster_t *r, const sw_vertex_t *v0, const sw_vertex_t *v1) \
 {                                                                       \
     float x0 = v0->screen[0];                                           \
     float y0 = v0->screen[1];                                           \
@@ -3078,13 +5955,13 @@ static inline void FUNC_NAME(const sw_vertex_t *v0, const sw_vertex_t *v1) \
     float x = x0 + xInc*substep;                                        \
     float y = y0 + yInc*substep;                                        \
     float z = v0->homogeneous[2] + zInc*substep;                        \
-    float r = v0->color[0] + rInc*substep;                              \
-    float g = v0->color[1] + gInc*substep;                              \
-    float b = v0->color[2] + bInc*substep;                              \
-    float a = v0->color[3] + aInc*substep;                              \
+    float cr = v0->color[0] + rInc*substep;                             \
+    float cg = v0->color[1] + gInc*substep;                             \
+    float cb = v0->color[2] + bInc*substep;                             \
+    float ca = v0->color[3] + aInc*substep;                             \
                                                                         \
-    const int fbWidth = RLSW.framebuffer.width;                         \
-    sw_pixel_t *pixels = RLSW.framebuffer.pixels;                       \
+    const int fbWidth = r->width;                                       \
+    const int fbStride = r->colorStride;                                \
                                                                         \
     int numPixels = (int)(steps - substep) + 1;                         \
                                                                         \
@@ -3094,35 +5971,34 @@ static inline void FUNC_NAME(const sw_vertex_t *v0, const sw_vertex_t *v1) \
         int px = (int)(x - 0.5f);                                       \
         int py = (int)(y - 0.5f);                                       \
                                                                         \
-        sw_pixel_t *ptr = pixels + py*fbWidth + px;                     \
+        /* Skip the pixels outside of the raster region */              \
+        if ((px < r->xMin) || (px >= r->xMax)) goto discard;            \
+        if ((py < r->yMin) || (py >= r->yMax)) goto discard;            \
+                                                                        \
+        sw_color_t *cptr = r->colors + py*fbStride + px;                \
+        sw_depth_t *dptr = r->depths + py*fbWidth + px;                 \
                                                                         \
         if (ENABLE_DEPTH_TEST)                                          \
         {                                                               \
-            float depth = sw_framebuffer_read_depth(ptr);               \
-            if (z > depth) goto discard;                                \
+            float depth = sw_framebuffer_read_depth(dptr);              \
+            if (z > depth) { SW_RASTER_STATS_ADD(r, pixelsDepthRejected, 1); goto discard; } \
         }                                                               \
                                                                         \
-        sw_framebuffer_write_depth(ptr, z);                             \
+        sw_framebuffer_output_depth(r, dptr, z);                        \
                                                                         \
-        float color[4] = {r, g, b, a};                                  \
+        float color[4] = {cr, cg, cb, ca};                              \
+        if (ENABLE_PROGRAM) sw_fragment_program(r, color, NULL, 0.0f, 0.0f, px, py); \
                                                                         \
-        if (ENABLE_COLOR_BLEND)                                         \
-        {                                                               \
-            float dstColor[4];                                          \
-            sw_framebuffer_read_color(dstColor, ptr);                   \
-            sw_blend_colors(dstColor, color);                           \
-            sw_framebuffer_write_color(ptr, dstColor);                  \
-        }                                                               \
-        else sw_framebuffer_write_color(ptr, color);                    \
+        sw_framebuffer_output_color(r, cptr, color, ENABLE_COLOR_BLEND); \
                                                                         \
     discard:                                                            \
         x += xInc; y += yInc; z += zInc;                                \
-        r += rInc; g += gInc; b += bInc; a += aInc;                     \
+        cr += rInc; cg += gInc; cb += bInc; ca += aInc;                 \
     }                                                                   \
 }
 
 #define DEFINE_LINE_THICK_RASTER(FUNC_NAME, RASTER_FUNC)                \
-void FUNC_NAME(const sw_vertex_t *v1, const sw_vertex_t *v2)            \
+void FUNC_NAME(const sw_raster_t *r, const sw_vertex_t *v1, const sw_vertex_t *v2) \
 {                                                                       \
     sw_vertex_t tv1, tv2;                                               \
                                                                         \
@@ -3134,70 +6010,89 @@ void FUNC_NAME(const sw_vertex_t *v1, const sw_vertex_t *v2)            \
     int dx = x2 - x1;                                                   \
     int dy = y2 - y1;                                                   \
                                                                         \
-    RASTER_FUNC(v1, v2);                                                \
+    RASTER_FUNC(r, v1, v2);                                             \
                                                                         \
     if ((dx != 0) && (abs(dy/dx) < 1))                                  \
     {                                                                   \
-        int wy = (int)((RLSW.lineWidth - 1.0f)*abs(dx)/sqrtf(dx*dx + dy*dy)); \
+        int wy = (int)((r->state->lineWidth - 1.0f)*abs(dx)/sqrtf(dx*dx + dy*dy)); \
         wy >>= 1;                                                       \
         for (int i = 1; i <= wy; i++)                                   \
         {                                                               \
             tv1 = *v1, tv2 = *v2;                                       \
             tv1.screen[1] -= i;                                         \
             tv2.screen[1] -= i;                                         \
-            RASTER_FUNC(&tv1, &tv2);                                    \
+            RASTER_FUNC(r, &tv1, &tv2);                                 \
             tv1 = *v1, tv2 = *v2;                                       \
             tv1.screen[1] += i;                                         \
             tv2.screen[1] += i;                                         \
-            RASTER_FUNC(&tv1, &tv2);                                    \
+            RASTER_FUNC(r, &tv1, &tv2);                                 \
         }                                                               \
     }                                                                   \
     else if (dy != 0)                                                   \
     {                                                                   \
-        int wx = (int)((RLSW.lineWidth - 1.0f)*abs(dy)/sqrtf(dx*dx + dy*dy)); \
+        int wx = (int)((r->state->lineWidth - 1.0f)*abs(dy)/sqrtf(dx*dx + dy*dy)); \
         wx >>= 1;                                                       \
         for (int i = 1; i <= wx; i++)                                   \
         {                                                               \
             tv1 = *v1, tv2 = *v2;                                       \
             tv1.screen[0] -= i;                                         \
             tv2.screen[0] -= i;                                         \
-            RASTER_FUNC(&tv1, &tv2);                                    \
+            RASTER_FUNC(r, &tv1, &tv2);                                 \
             tv1 = *v1, tv2 = *v2;                                       \
             tv1.screen[0] += i;                                         \
             tv2.screen[0] += i;                                         \
-            RASTER_FUNC(&tv1, &tv2);                                    \
+            RASTER_FUNC(r, &tv1, &tv2);                                 \
         }                                                               \
     }                                                                   \
 }
 
-DEFINE_LINE_RASTER(sw_line_raster, 0, 0)
-DEFINE_LINE_RASTER(sw_line_raster_DEPTH, 1, 0)
-DEFINE_LINE_RASTER(sw_line_raster_BLEND, 0, 1)
-DEFINE_LINE_RASTER(sw_line_raster_DEPTH_BLEND, 1, 1)
+DEFINE_LINE_RASTER(sw_line_raster, 0, 0, 0)
+DEFINE_LINE_RASTER(sw_line_raster_DEPTH, 1, 0, 0)
+DEFINE_LINE_RASTER(sw_line_raster_BLEND, 0, 1, 0)
+DEFINE_LINE_RASTER(sw_line_raster_DEPTH_BLEND, 1, 1, 0)
+DEFINE_LINE_RASTER(sw_line_raster_PROGRAM, SW_PROGRAM_DEPTH_TEST, SW_PROGRAM_BLEND, 1)
 
 DEFINE_LINE_THICK_RASTER(sw_line_thick_raster, sw_line_raster)
 DEFINE_LINE_THICK_RASTER(sw_line_thick_raster_DEPTH, sw_line_raster_DEPTH)
 DEFINE_LINE_THICK_RASTER(sw_line_thick_raster_BLEND, sw_line_raster_BLEND)
 DEFINE_LINE_THICK_RASTER(sw_line_thick_raster_DEPTH_BLEND, sw_line_raster_DEPTH_BLEND)
+DEFINE_LINE_THICK_RASTER(sw_line_thick_raster_PROGRAM, sw_line_raster_PROGRAM)
 
-static inline void sw_line_render(sw_vertex_t *vertices)
+static inline void sw_raster_line(const sw_raster_t *r, uint32_t state, const sw_vertex_t *v0, const sw_vertex_t *v1)
 {
-    if (!sw_line_clip_and_project(&vertices[0], &vertices[1])) return;
-
-    if (RLSW.lineWidth >= 2.0f)
+    if (r->state->lineWidth >= 2.0f)
     {
-        if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_line_thick_raster_DEPTH_BLEND(&vertices[0], &vertices[1]);
-        else if (SW_STATE_CHECK(SW_STATE_BLEND)) sw_line_thick_raster_BLEND(&vertices[0], &vertices[1]);
-        else if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST)) sw_line_thick_raster_DEPTH(&vertices[0], &vertices[1]);
-        else sw_line_thick_raster(&vertices[0], &vertices[1]);
+        if (r->state->fragmentProc != NULL) sw_line_thick_raster_PROGRAM(r, v0, v1);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_line_thick_raster_DEPTH_BLEND(r, v0, v1);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) sw_line_thick_raster_BLEND(r, v0, v1);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) sw_line_thick_raster_DEPTH(r, v0, v1);
+        else sw_line_thick_raster(r, v0, v1);
     }
     else
     {
-        if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_line_raster_DEPTH_BLEND(&vertices[0], &vertices[1]);
-        else if (SW_STATE_CHECK(SW_STATE_BLEND)) sw_line_raster_BLEND(&vertices[0], &vertices[1]);
-        else if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST)) sw_line_raster_DEPTH(&vertices[0], &vertices[1]);
-        else sw_line_raster(&vertices[0], &vertices[1]);
+        if (r->state->fragmentProc != NULL) sw_line_raster_PROGRAM(r, v0, v1);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_line_raster_DEPTH_BLEND(r, v0, v1);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) sw_line_raster_BLEND(r, v0, v1);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) sw_line_raster_DEPTH(r, v0, v1);
+        else sw_line_raster(r, v0, v1);
     }
+
+    // Lines are widened by half their width, plus one pixel for the rounding
+    float margin = 0.5f*r->state->lineWidth + 1.0f;
+    float zLo = fminf(v0->homogeneous[2], v1->homogeneous[2]);
+    float zHi = fmaxf(v0->homogeneous[2], v1->homogeneous[2]);
+    sw_depth_tiles_widen(r, fminf(v0->screen[0], v1->screen[0]) - margin, fminf(v0->screen[1], v1->screen[1]) - margin,
+        fmaxf(v0->screen[0], v1->screen[0]) + margin, fmaxf(v0->screen[1], v1->screen[1]) + margin,
+        zLo, zHi, SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST));
+}
+
+static inline void sw_line_render(sw_vertex_t *vertices)
+{
+    SW_STATS_ADD(primitives, 1);
+
+    if (!sw_line_clip_and_project(&vertices[0], &vertices[1])) { SW_STATS_ADD(primitivesClipped, 1); return; }
+
+    sw_raster_submit(SW_RASTER_LINE, sw_raster_get_flags(), vertices, 2);
 }
 //-------------------------------------------------------------------------------------------
 
@@ -3239,48 +6134,39 @@ static inline bool sw_point_clip_and_project(sw_vertex_t *v)
     return (insideX && insideY);
 }
 
-#define DEFINE_POINT_RASTER(FUNC_NAME, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND, CHECK_BOUNDS) \
-static inline void FUNC_NAME(int x, int y, float z, const float color[4])   \
+#define DEFINE_POINT_RASTER(FUNC_NAME, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND, ENABLE_PROGRAM) \
+static inline void FUNC_NAME(const sw_raster_t *r, int x, int y, float z, const float color[4]) \
 {                                                                           \
-    if (CHECK_BOUNDS == 1)                                                  \
-    {                                                                       \
-        if ((x < RLSW.vpMin[0]) || (x >= RLSW.vpMax[0])) return;            \
-        if ((y < RLSW.vpMin[1]) || (y >= RLSW.vpMax[1])) return;            \
-    }                                                                       \
-    else if (CHECK_BOUNDS == SW_SCISSOR_TEST)                               \
-    {                                                                       \
-        if ((x < RLSW.scMin[0]) || (x >= RLSW.scMax[0])) return;            \
-        if ((y < RLSW.scMin[1]) || (y >= RLSW.scMax[1])) return;            \
-    }                                                                       \
+    if ((x < r->xMin) || (x >= r->xMax)) return;                            \
+    if ((y < r->yMin) || (y >= r->yMax)) return;                            \
                                                                             \
-    int offset = y*RLSW.framebuffer.width + x;                              \
-    sw_pixel_t *ptr = RLSW.framebuffer.pixels + offset;                     \
+    sw_color_t *cptr = r->colors + y*r->colorStride + x;                    \
+    sw_depth_t *dptr = r->depths + y*r->width + x;                          \
                                                                             \
     if (ENABLE_DEPTH_TEST)                                                  \
     {                                                                       \
-        float depth = sw_framebuffer_read_depth(ptr);                       \
-        if (z > depth) return;                                              \
+        float depth = sw_framebuffer_read_depth(dptr);                      \
+        if (z > depth) { SW_RASTER_STATS_ADD(r, pixelsDepthRejected, 1); return; } \
     }                                                                       \
                                                                             \
-    sw_framebuffer_write_depth(ptr, z);                                     \
+    sw_framebuffer_output_depth(r, dptr, z);                                \
                                                                             \
-    if (ENABLE_COLOR_BLEND)                                                 \
+    if (ENABLE_PROGRAM)                                                     \
     {                                                                       \
-        float dstColor[4];                                                  \
-        sw_framebuffer_read_color(dstColor, ptr);                           \
-        sw_blend_colors(dstColor, color);                                   \
-        sw_framebuffer_write_color(ptr, dstColor);                          \
+        float fragColor[4] = { color[0], color[1], color[2], color[3] };    \
+        sw_fragment_program(r, fragColor, NULL, 0.0f, 0.0f, x, y);          \
+        sw_framebuffer_output_color(r, cptr, fragColor, ENABLE_COLOR_BLEND); \
     }                                                                       \
-    else sw_framebuffer_write_color(ptr, color);                            \
+    else sw_framebuffer_output_color(r, cptr, color, ENABLE_COLOR_BLEND);   \
 }
 
 #define DEFINE_POINT_THICK_RASTER(FUNC_NAME, RASTER_FUNC)                   \
-static inline void FUNC_NAME(sw_vertex_t *v)                                \
+static inline void FUNC_NAME(const sw_raster_t *r, const sw_vertex_t *v)    \
 {                                                                           \
     int cx = v->screen[0];                                                  \
     int cy = v->screen[1];                                                  \
     float cz = v->homogeneous[2];                                           \
-    int radius = RLSW.pointRadius;                                          \
+    int radius = r->state->pointRadius;                                     \
     const float *color = v->color;                                          \
                                                                             \
     int x = 0;                                                              \
@@ -3291,13 +6177,13 @@ static inline void FUNC_NAME(sw_vertex_t *v)                                \
     {                                                                       \
         for (int i = -x; i <= x; i++)                                       \
         {                                                                   \
-            RASTER_FUNC(cx + i, cy + y, cz, color);                         \
-            RASTER_FUNC(cx + i, cy - y, cz, color);                         \
+            RASTER_FUNC(r, cx + i, cy + y, cz, color);                      \
+            RASTER_FUNC(r, cx + i, cy - y, cz, color);                      \
         }                                                                   \
         for (int i = -y; i <= y; i++)                                       \
         {                                                                   \
-            RASTER_FUNC(cx + i, cy + x, cz, color);                         \
-            RASTER_FUNC(cx + i, cy - x, cz, color);                         \
+            RASTER_FUNC(r, cx + i, cy + x, cz, color);                      \
+            RASTER_FUNC(r, cx + i, cy - x, cz, color);                      \
         }                                                                   \
         if (d > 0)                                                          \
         {                                                                   \
@@ -3309,92 +6195,829 @@ static inline void FUNC_NAME(sw_vertex_t *v)                                \
     }                                                                       \
 }
 
-DEFINE_POINT_RASTER(sw_point_raster, 0, 0, 0)
-DEFINE_POINT_RASTER(sw_point_raster_DEPTH, 1, 0, 0)
-DEFINE_POINT_RASTER(sw_point_raster_BLEND, 0, 1, 0)
-DEFINE_POINT_RASTER(sw_point_raster_DEPTH_BLEND, 1, 1, 0)
+DEFINE_POINT_RASTER(sw_point_raster, 0, 0, 0)
+DEFINE_POINT_RASTER(sw_point_raster_DEPTH, 1, 0, 0)
+DEFINE_POINT_RASTER(sw_point_raster_BLEND, 0, 1, 0)
+DEFINE_POINT_RASTER(sw_point_raster_DEPTH_BLEND, 1, 1, 0)
+DEFINE_POINT_RASTER(sw_point_raster_PROGRAM, SW_PROGRAM_DEPTH_TEST, SW_PROGRAM_BLEND, 1)
+
+DEFINE_POINT_THICK_RASTER(sw_point_thick_raster, sw_point_raster)
+DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_DEPTH, sw_point_raster_DEPTH)
+DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_BLEND, sw_point_raster_BLEND)
+DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_DEPTH_BLEND, sw_point_raster_DEPTH_BLEND)
+DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_PROGRAM, sw_point_raster_PROGRAM)
+
+static inline void sw_raster_point(const sw_raster_t *r, uint32_t state, const sw_vertex_t *v)
+{
+    // Points are also limited to the viewport or scissor rectangle captured in the state
+    sw_raster_t clipped = *r;
+    clipped.xMin = sw_maxi(r->xMin, r->state->clipMin[0]);
+    clipped.yMin = sw_maxi(r->yMin, r->state->clipMin[1]);
+    clipped.xMax = sw_mini(r->xMax, r->state->clipMax[0]);
+    clipped.yMax = sw_mini(r->yMax, r->state->clipMax[1]);
+
+    if (r->state->pointRadius >= 1.0f)
+    {
+        if (r->state->fragmentProc != NULL) sw_point_thick_raster_PROGRAM(&clipped, v);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_point_thick_raster_DEPTH_BLEND(&clipped, v);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) sw_point_thick_raster_BLEND(&clipped, v);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) sw_point_thick_raster_DEPTH(&clipped, v);
+        else sw_point_thick_raster(&clipped, v);
+    }
+    else
+    {
+        if (r->state->fragmentProc != NULL) sw_point_raster_PROGRAM(&clipped, v->screen[0], v->screen[1], v->homogeneous[2], v->color);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_point_raster_DEPTH_BLEND(&clipped, v->screen[0], v->screen[1], v->homogeneous[2], v->color);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) sw_point_raster_BLEND(&clipped, v->screen[0], v->screen[1], v->homogeneous[2], v->color);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) sw_point_raster_DEPTH(&clipped, v->screen[0], v->screen[1], v->homogeneous[2], v->color);
+        else sw_point_raster(&clipped, v->screen[0], v->screen[1], v->homogeneous[2], v->color);
+    }
+
+    float margin = r->state->pointRadius + 1.0f;
+    sw_depth_tiles_widen(&clipped, v->screen[0] - margin, v->screen[1] - margin, v->screen[0] + margin, v->screen[1] + margin,
+        v->homogeneous[2], v->homogeneous[2], SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST));
+}
+
+static inline void sw_point_render(sw_vertex_t *v)
+{
+    SW_STATS_ADD(primitives, 1);
+
+    if (!sw_point_clip_and_project(v)) { SW_STATS_ADD(primitivesClipped, 1); return; }
+
+    sw_raster_submit(SW_RASTER_POINT, sw_raster_get_flags(), v, 1);
+}
+//-------------------------------------------------------------------------------------------
+
+// Raster commands execution and binning logic
+//-------------------------------------------------------------------------------------------
+static inline void sw_raster_clear(const sw_raster_t *r, uint32_t bitmask)
+{
+    sw_raster_t clipped = *r;
+    clipped.xMin = sw_maxi(r->xMin, r->state->clipMin[0]);
+    clipped.yMin = sw_maxi(r->yMin, r->state->clipMin[1]);
+    clipped.xMax = sw_mini(r->xMax, r->state->clipMax[0]);
+    clipped.yMax = sw_mini(r->yMax, r->state->clipMax[1]);
+
+    if ((clipped.xMin >= clipped.xMax) || (clipped.yMin >= clipped.yMax)) return;
+
+    const sw_pixel_t *value = &r->state->clearValue;
+    bool clearColor = (bitmask & SW_COLOR_BUFFER_BIT);
+    bool clearDepth = (bitmask & SW_DEPTH_BUFFER_BIT);
+
+    for (int ty = clipped.yMin/SW_DEPTH_TILE_SIZE; ty <= (clipped.yMax - 1)/SW_DEPTH_TILE_SIZE; ty++)
+    {
+        for (int tx = clipped.xMin/SW_DEPTH_TILE_SIZE; tx <= (clipped.xMax - 1)/SW_DEPTH_TILE_SIZE; tx++)
+        {
+            sw_depth_tile_t *tile = &r->depthTiles[ty*r->depthTilesX + tx];
+
+            // Tile rectangle in the raster region, and its cleared part
+            int txMin = sw_maxi(tx*SW_DEPTH_TILE_SIZE, r->xMin);
+            int tyMin = sw_maxi(ty*SW_DEPTH_TILE_SIZE, r->yMin);
+            int txMax = sw_mini((tx + 1)*SW_DEPTH_TILE_SIZE, r->xMax);
+            int tyMax = sw_mini((ty + 1)*SW_DEPTH_TILE_SIZE, r->yMax);
+
+            sw_raster_t rect = clipped;
+            rect.xMin = sw_maxi(txMin, clipped.xMin);
+            rect.yMin = sw_maxi(tyMin, clipped.yMin);
+            rect.xMax = sw_mini(txMax, clipped.xMax);
+            rect.yMax = sw_mini(tyMax, clipped.yMax);
+
+            bool covered = (rect.xMin == txMin) && (rect.yMin == tyMin) && (rect.xMax == txMax) && (rect.yMax == tyMax);
+
+            if (covered)
+            {
+                // Whole tile cleared, deferred unless it already holds the clear value
+                if (clearColor && !((tile->clearState & SW_TILE_COLOR_CLEAN) && (memcmp(&tile->clearColor, &value->color, sizeof(sw_color_t)) == 0)))
+                {
+                    tile->clearColor = value->color;
+                    tile->clearState |= SW_TILE_COLOR_CLEAN | SW_TILE_COLOR_PENDING | SW_TILE_DIRTY;
+                }
+
+                if (clearDepth && !((tile->clearState & SW_TILE_DEPTH_CLEAN) && (memcmp(&tile->clearDepth, &value->depth, sizeof(sw_depth_t)) == 0)))
+                {
+                    tile->clearDepth = value->depth;
+                    tile->clearState |= SW_TILE_DEPTH_CLEAN | SW_TILE_DEPTH_PENDING | SW_TILE_DIRTY;
+                }
+            }
+            else
+            {
+                // Partially cleared tile, written now
+                sw_depth_tile_resolve(r, tile, tx, ty);
+
+                if (clearColor) sw_framebuffer_fill_color(&rect, value->color);
+                if (clearDepth) sw_framebuffer_fill_depth(&rect, value->depth);
+
+                tile->clearState &= ~((clearColor? SW_TILE_COLOR_CLEAN : 0) | (clearDepth? SW_TILE_DEPTH_CLEAN : 0));
+                tile->clearState |= SW_TILE_DIRTY;
+            }
+        }
+    }
+
+    if (bitmask & SW_DEPTH_BUFFER_BIT)
+    {
+        float depth = sw_framebuffer_read_depth(&r->state->clearValue.depth);
+        sw_depth_tiles_update_rect(r, clipped.xMin, clipped.yMin, clipped.xMax, clipped.yMax, depth, depth, true);
+    }
+}
+
+// Writes the deferred clears of the tiles a primitive can draw, and marks them as drawn
+static inline void sw_raster_touch_tiles(const sw_raster_t *r, sw_raster_type_t type, const sw_vertex_t *vertices, int count)
+{
+    float xMin = vertices[0].screen[0], xMax = xMin;
+    float yMin = vertices[0].screen[1], yMax = yMin;
+
+    for (int i = 1; i < count; i++)
+    {
+        xMin = fminf(xMin, vertices[i].screen[0]);
+        yMin = fminf(yMin, vertices[i].screen[1]);
+        xMax = fmaxf(xMax, vertices[i].screen[0]);
+        yMax = fmaxf(yMax, vertices[i].screen[1]);
+    }
+
+    // Same margins as the depth tiles updates
+    float margin = 0.0f;
+    if (type == SW_RASTER_LINE) margin = 0.5f*r->state->lineWidth + 1.0f;
+    else if (type == SW_RASTER_POINT) margin = r->state->pointRadius + 1.0f;
+    else
+    {
+        // Polygons can exceed the clip rectangle inside the guard band
+        xMin = fmaxf(xMin, (float)r->state->clipMin[0]);
+        yMin = fmaxf(yMin, (float)r->state->clipMin[1]);
+        xMax = fminf(xMax, (float)r->state->clipMax[0]);
+        yMax = fminf(yMax, (float)r->state->clipMax[1]);
+    }
+
+    int tMin[2], tMax[2];
+    if (!sw_depth_tiles_get_range(r, xMin - margin, yMin - margin, xMax + margin, yMax + margin, tMin, tMax)) return;
+
+    for (int ty = tMin[1]; ty <= tMax[1]; ty++)
+    {
+        sw_depth_tile_t *tile = &r->depthTiles[ty*r->depthTilesX + tMin[0]];
+
+        for (int tx = tMin[0]; tx <= tMax[0]; tx++, tile++)
+        {
+            sw_depth_tile_resolve(r, tile, tx, ty);
+            tile->clearState = SW_TILE_DIRTY;
+        }
+    }
+}
+
+#if SW_ENABLE_STATS
+// Current time of the statistics timers, in milliseconds
+static inline double sw_stats_get_time(void)
+{
+#if defined(_WIN32)
+    static int64_t frequency = 0;   // NOTE: Same value written by every thread
+    int64_t counter = 0;
+
+    if (frequency == 0) QueryPerformanceFrequency((union _LARGE_INTEGER *)&frequency);
+    QueryPerformanceCounter((union _LARGE_INTEGER *)&counter);
+
+    return (double)counter*1000.0/(double)frequency;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec*1000.0 + (double)ts.tv_nsec*1e-6;
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+    // NOTE: Wall clock time, affected by system time adjustments
+    struct timespec ts = { 0 };
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec*1000.0 + (double)ts.tv_nsec*1e-6;
+#else
+    // NOTE: Processor time, POSIX timers require _POSIX_C_SOURCE with C99
+    return (double)clock()*1000.0/CLOCKS_PER_SEC;
+#endif
+}
+
+static inline void sw_stats_accumulate(SWstats *dst, const SWstats *src)
+{
+    dst->drawCalls += src->drawCalls;
+    dst->vertices += src->vertices;
+    dst->primitives += src->primitives;
+    dst->primitivesCulled += src->primitivesCulled;
+    dst->primitivesClipped += src->primitivesClipped;
+    dst->primitivesAffine += src->primitivesAffine;
+    dst->pixelsShaded += src->pixelsShaded;
+    dst->pixelsDepthRejected += src->pixelsDepthRejected;
+    dst->texelsFetched += src->texelsFetched;
+    dst->clearTime += src->clearTime;
+    dst->rasterTime += src->rasterTime;
+    dst->copyTime += src->copyTime;
+}
+#endif
+
+static inline void sw_raster_execute(const sw_raster_t *r, sw_raster_type_t type, uint32_t flags, const sw_vertex_t *vertices, int count)
+{
+#if SW_ENABLE_STATS
+    double startTime = sw_stats_get_time();
+#endif
+
+    if (type != SW_RASTER_CLEAR) sw_raster_touch_tiles(r, type, vertices, count);
+
+    switch (type)
+    {
+        case SW_RASTER_POLYGON: sw_raster_polygon(r, flags, vertices, count); break;
+        case SW_RASTER_QUAD_AXIS_ALIGNED: sw_raster_quad(r, flags, vertices); break;
+        case SW_RASTER_QUAD_AFFINE: sw_raster_quad_affine(r, flags, vertices); break;
+        case SW_RASTER_LINE: sw_raster_line(r, flags, &vertices[0], &vertices[1]); break;
+        case SW_RASTER_POINT: sw_raster_point(r, flags, &vertices[0]); break;
+        case SW_RASTER_CLEAR: sw_raster_clear(r, flags); break;
+        default: break;
+    }
+
+#if SW_ENABLE_STATS
+    double elapsed = sw_stats_get_time() - startTime;
+    if (type == SW_RASTER_CLEAR) r->stats->clearTime += elapsed;
+    else r->stats->rasterTime += elapsed;
+#endif
+}
+
+#if (SW_MAX_THREADS > 1)
+#if defined(_MSC_VER)
+static inline void sw_mutex_init(sw_mutex_t *mutex) { mtx_init(mutex, mtx_plain); }
+static inline void sw_mutex_destroy(sw_mutex_t *mutex) { mtx_destroy(mutex); }
+static inline void sw_mutex_lock(sw_mutex_t *mutex) { mtx_lock(mutex); }
+static inline void sw_mutex_unlock(sw_mutex_t *mutex) { mtx_unlock(mutex); }
+static inline void sw_cond_init(sw_cond_t *cond) { cnd_init(cond); }
+static inline void sw_cond_destroy(sw_cond_t *cond) { cnd_destroy(cond); }
+static inline void sw_cond_wait(sw_cond_t *cond, sw_mutex_t *mutex) { cnd_wait(cond, mutex); }
+static inline void sw_cond_signal(sw_cond_t *cond) { cnd_signal(cond); }
+static inline void sw_cond_broadcast(sw_cond_t *cond) { cnd_broadcast(cond); }
+#else
+static inline void sw_mutex_init(sw_mutex_t *mutex) { pthread_mutex_init(mutex, NULL); }
+static inline void sw_mutex_destroy(sw_mutex_t *mutex) { pthread_mutex_destroy(mutex); }
+static inline void sw_mutex_lock(sw_mutex_t *mutex) { pthread_mutex_lock(mutex); }
+static inline void sw_mutex_unlock(sw_mutex_t *mutex) { pthread_mutex_unlock(mutex); }
+static inline void sw_cond_init(sw_cond_t *cond) { pthread_cond_init(cond, NULL); }
+static inline void sw_cond_destroy(sw_cond_t *cond) { pthread_cond_destroy(cond); }
+static inline void sw_cond_wait(sw_cond_t *cond, sw_mutex_t *mutex) { pthread_cond_wait(cond, mutex); }
+static inline void sw_cond_signal(sw_cond_t *cond) { pthread_cond_signal(cond); }
+static inline void sw_cond_broadcast(sw_cond_t *cond) { pthread_cond_broadcast(cond); }
+#endif
+
+// Rasterize all the commands binned in a tile, in submission order
+static void sw_binner_rasterize_tile(sw_context_t *ctx, int tile)
+{
+    sw_binner_t *binner = &ctx->binner;
+    const sw_bin_t *bin = &binner->bins[tile];
+
+    if (bin->count == 0) return;
+
+    int tx = tile%binner->tilesX;
+    int ty = tile/binner->tilesX;
+
+    sw_raster_t r;
+    sw_framebuffer_get_raster(&ctx->framebuffer, &r);
+    r.xMin = tx*SW_BIN_TILE_SIZE;
+    r.yMin = ty*SW_BIN_TILE_SIZE;
+    r.xMax = sw_mini(r.xMin + SW_BIN_TILE_SIZE, ctx->framebuffer.width);
+    r.yMax = sw_mini(r.yMin + SW_BIN_TILE_SIZE, ctx->framebuffer.height);
+
+#if SW_ENABLE_STATS
+    SWstats stats = { 0 };
+    r.stats = &stats;
+#endif
+
+    for (int i = 0; i < bin->count; i++)
+    {
+        const sw_command_t *cmd = &binner->commands[bin->commands[i]];
+        r.state = &binner->states[cmd->stateIndex];
+        sw_raster_execute(&r, (sw_raster_type_t)cmd->type, cmd->flags, &binner->vertices[cmd->vertexOffset], cmd->vertexCount);
+    }
+
+#if SW_ENABLE_STATS
+    sw_mutex_lock(&binner->mutex);
+    sw_stats_accumulate(&ctx->stats, &stats);
+    sw_mutex_unlock(&binner->mutex);
+#endif
+}
+
+// Grab and rasterize tiles until there are none left in the current flush
+static void sw_binner_work(sw_context_t *ctx)
+{
+    sw_binner_t *binner = &ctx->binner;
+    int tileCount = binner->tilesX*binner->tilesY;
+
+    while (true)
+    {
+        sw_mutex_lock(&binner->mutex);
+        int tile = binner->nextTile++;
+        sw_mutex_unlock(&binner->mutex);
+
+        if (tile >= tileCount) break;
+
+        sw_binner_rasterize_tile(ctx, tile);
+    }
+}
+
+#if defined(_MSC_VER)
+static int sw_binner_thread_proc(void *arg)
+#else
+static void *sw_binner_thread_proc(void *arg)
+#endif
+{
+    sw_context_t *ctx = (sw_context_t *)arg;
+    sw_binner_t *binner = &ctx->binner;
+
+    // NOTE: Workers are created before the first flush, a flush may start before they get here
+    uint32_t generation = 0;
+
+    sw_mutex_lock(&binner->mutex);
+
+    while (true)
+    {
+        while (!binner->shutdown && (binner->generation == generation)) sw_cond_wait(&binner->wakeCond, &binner->mutex);
+        if (binner->shutdown) break;
+
+        generation = binner->generation;
+        sw_mutex_unlock(&binner->mutex);
+
+        sw_binner_work(ctx);
+
+        sw_mutex_lock(&binner->mutex);
+        if (--binner->pendingWorkers == 0) sw_cond_signal(&binner->doneCond);
+    }
+
+    sw_mutex_unlock(&binner->mutex);
+
+#if defined(_MSC_VER)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+static bool sw_binner_resize(sw_context_t *ctx, int w, int h)
+{
+    sw_binner_t *binner = &ctx->binner;
+
+    int tilesX = (w + SW_BIN_TILE_SIZE - 1)/SW_BIN_TILE_SIZE;
+    int tilesY = (h + SW_BIN_TILE_SIZE - 1)/SW_BIN_TILE_SIZE;
+    int tileCount = tilesX*tilesY;
+
+    if (tileCount > binner->binCapacity)
+    {
+        sw_bin_t *newBins = (sw_bin_t *)SW_REALLOC(binner->bins, tileCount*sizeof(sw_bin_t));
+        if (newBins == NULL) return false;
+
+        for (int i = binner->binCapacity; i < tileCount; i++) newBins[i] = SW_CURLY_INIT(sw_bin_t) { 0 };
+
+        binner->bins = newBins;
+        binner->binCapacity = tileCount;
+    }
+
+    binner->tilesX = tilesX;
+    binner->tilesY = tilesY;
+
+    return true;
+}
+
+static void sw_binner_close(sw_context_t *ctx)
+{
+    sw_binner_t *binner = &ctx->binner;
+
+    if (!binner->initialized) return;
+
+    sw_mutex_lock(&binner->mutex);
+    binner->shutdown = true;
+    sw_cond_broadcast(&binner->wakeCond);
+    sw_mutex_unlock(&binner->mutex);
+
+    for (int i = 0; i < binner->threadCount; i++)
+    {
+#if defined(_MSC_VER)
+        thrd_join(binner->threads[i], NULL);
+#else
+        pthread_join(binner->threads[i], NULL);
+#endif
+    }
+
+    sw_cond_destroy(&binner->doneCond);
+    sw_cond_destroy(&binner->wakeCond);
+    sw_mutex_destroy(&binner->mutex);
+
+    for (int i = 0; i < binner->binCapacity; i++) SW_FREE(binner->bins[i].commands);
+
+    SW_FREE(binner->bins);
+    SW_FREE(binner->states);
+    SW_FREE(binner->vertices);
+    SW_FREE(binner->commands);
+
+    *binner = SW_CURLY_INIT(sw_binner_t) { 0 };
+}
+
+static bool sw_binner_init(sw_context_t *ctx, int w, int h)
+{
+    sw_binner_t *binner = &ctx->binner;
+
+    *binner = SW_CURLY_INIT(sw_binner_t) { 0 };
+
+    sw_mutex_init(&binner->mutex);
+    sw_cond_init(&binner->wakeCond);
+    sw_cond_init(&binner->doneCond);
+    binner->initialized = true;
+
+    binner->vertices = (sw_vertex_t *)SW_MALLOC(SW_BIN_MAX_VERTICES*sizeof(sw_vertex_t));
+    if (binner->vertices == NULL) { sw_binner_close(ctx); return false; }
+    binner->vertexCapacity = SW_BIN_MAX_VERTICES;
+
+    if (!sw_binner_resize(ctx, w, h)) { sw_binner_close(ctx); return false; }
+
+    for (int i = 0; i < SW_MAX_THREADS - 1; i++)
+    {
+#if defined(_MSC_VER)
+        if (thrd_create(&binner->threads[i], sw_binner_thread_proc, ctx) != thrd_success) break;
+#else
+        if (pthread_create(&binner->threads[i], NULL, sw_binner_thread_proc, ctx) != 0) break;
+#endif
+        binner->threadCount++;
+    }
+
+    if (binner->threadCount < SW_MAX_THREADS - 1)
+    {
+        SW_LOG("WARNING: RLSW: Only %i rasterization worker threads could be created\n", binner->threadCount);
+    }
+
+    return true;
+}
+
+// Rasterize all the binned commands and reset the bins
+static void sw_binner_flush(sw_context_t *ctx)
+{
+    sw_binner_t *binner = &ctx->binner;
+
+    if (binner->commandCount == 0) return;
+
+    sw_mutex_lock(&binner->mutex);
+    binner->nextTile = 0;
+    binner->pendingWorkers = binner->threadCount;
+    binner->generation++;
+    sw_cond_broadcast(&binner->wakeCond);
+    sw_mutex_unlock(&binner->mutex);
+
+    // The calling thread rasterizes tiles too, then waits for the workers
+    sw_binner_work(ctx);
+
+    sw_mutex_lock(&binner->mutex);
+    while (binner->pendingWorkers > 0) sw_cond_wait(&binner->doneCond, &binner->mutex);
+    sw_mutex_unlock(&binner->mutex);
+
+    for (int i = 0; i < binner->tilesX*binner->tilesY; i++) binner->bins[i].count = 0;
+
+    binner->commandCount = 0;
+    binner->vertexCount = 0;
+    binner->stateCount = 0;
+}
+
+// Store a command and add it to the bins of the tiles overlapped by its bounding box
+static bool sw_binner_push(sw_context_t *ctx, sw_raster_type_t type, uint32_t flags, const sw_vertex_t *vertices, int count, const sw_raster_state_t *state)
+{
+    sw_binner_t *binner = &ctx->binner;
+
+    // Compute the screen bounding box, enlarged to be conservative with the raster rules
+    int xMin = 0, yMin = 0;
+    int xMax = ctx->framebuffer.width;
+    int yMax = ctx->framebuffer.height;
+
+    if (type == SW_RASTER_CLEAR)
+    {
+        xMin = state->clipMin[0];
+        yMin = state->clipMin[1];
+        xMax = state->clipMax[0];
+        yMax = state->clipMax[1];
+    }
+    else
+    {
+        float bbMin[2] = { vertices[0].screen[0], vertices[0].screen[1] };
+        float bbMax[2] = { vertices[0].screen[0], vertices[0].screen[1] };
+
+        for (int i = 1; i < count; i++)
+        {
+            bbMin[0] = fminf(bbMin[0], vertices[i].screen[0]);
+            bbMin[1] = fminf(bbMin[1], vertices[i].screen[1]);
+            bbMax[0] = fmaxf(bbMax[0], vertices[i].screen[0]);
+            bbMax[1] = fmaxf(bbMax[1], vertices[i].screen[1]);
+        }
+
+        float margin = 1.0f;
+        if (type == SW_RASTER_LINE) margin += state->lineWidth;
+        else if (type == SW_RASTER_POINT) margin += state->pointRadius;
+
+        xMin = (int)floorf(bbMin[0] - margin);
+        yMin = (int)floorf(bbMin[1] - margin);
+        xMax = (int)ceilf(bbMax[0] + margin) + 1;
+        yMax = (int)ceilf(bbMax[1] + margin) + 1;
+
+        if ((type == SW_RASTER_POLYGON) || (type == SW_RASTER_QUAD_AXIS_ALIGNED) || (type == SW_RASTER_QUAD_AFFINE))
+        {
+            xMin = sw_maxi(xMin, state->clipMin[0]);
+            yMin = sw_maxi(yMin, state->clipMin[1]);
+            xMax = sw_mini(xMax, state->clipMax[0]);
+            yMax = sw_mini(yMax, state->clipMax[1]);
+        }
+    }
+
+    xMin = sw_maxi(xMin, 0);
+    yMin = sw_maxi(yMin, 0);
+    xMax = sw_mini(xMax, ctx->framebuffer.width);
+    yMax = sw_mini(yMax, ctx->framebuffer.height);
+
+    if ((xMin >= xMax) || (yMin >= yMax)) return true;
+
+    // Make room for the command, its vertices and its state
+    if (binner->vertexCount + count > binner->vertexCapacity) sw_binner_flush(ctx);
+
+    if (binner->commandCount == binner->commandCapacity)
+    {
+        int newCapacity = (binner->commandCapacity > 0)? 2*binner->commandCapacity : 1024;
+        sw_command_t *newCommands = (sw_command_t *)SW_REALLOC(binner->commands, newCapacity*sizeof(sw_command_t));
+        if (newCommands == NULL) return false;
+
+        binner->commands = newCommands;
+        binner->commandCapacity = newCapacity;
+    }
+
+    bool newState = (binner->stateCount == 0) || (memcmp(&binner->states[binner->stateCount - 1], state, sizeof(sw_raster_state_t)) != 0);
+
+    if (newState && (binner->stateCount == binner->stateCapacity))
+    {
+        int newCapacity = (binner->stateCapacity > 0)? 2*binner->stateCapacity : 64;
+        sw_raster_state_t *newStates = (sw_raster_state_t *)SW_REALLOC(binner->states, newCapacity*sizeof(sw_raster_state_t));
+        if (newStates == NULL) return false;
+
+        binner->states = newStates;
+        binner->stateCapacity = newCapacity;
+    }
+
+    // Add the command to the overlapped tiles bins
+    int txMin = xMin/SW_BIN_TILE_SIZE, txMax = (xMax - 1)/SW_BIN_TILE_SIZE;
+    int tyMin = yMin/SW_BIN_TILE_SIZE, tyMax = (yMax - 1)/SW_BIN_TILE_SIZE;
+
+    for (int ty = tyMin; ty <= tyMax; ty++)
+    {
+        for (int tx = txMin; tx <= txMax; tx++)
+        {
+            sw_bin_t *bin = &binner->bins[ty*binner->tilesX + tx];
+
+            if (bin->count == bin->capacity)
+            {
+                int newCapacity = (bin->capacity > 0)? 2*bin->capacity : 64;
+                uint32_t *newCommands = (uint32_t *)SW_REALLOC(bin->commands, newCapacity*sizeof(uint32_t));
+                if (newCommands == NULL)
+                {
+                    // Drop the command from the bins already updated
+                    for (int i = (ty*binner->tilesX + tx) - 1; i >= tyMin*binner->tilesX + txMin; i--)
+                    {
+                        int itx = i%binner->tilesX;
+                        if ((itx >= txMin) && (itx <= txMax) && (binner->bins[i].count > 0) &&
+                            (binner->bins[i].commands[binner->bins[i].count - 1] == (uint32_t)binner->commandCount)) binner->bins[i].count--;
+                    }
+                    return false;
+                }
+
+                bin->commands = newCommands;
+                bin->capacity = newCapacity;
+            }
+
+            bin->commands[bin->count++] = binner->commandCount;
+        }
+    }
+
+    if (newState) binner->states[binner->stateCount++] = *state;
+
+    sw_command_t *cmd = &binner->commands[binner->commandCount++];
+    cmd->type = (uint8_t)type;
+    cmd->flags = (uint16_t)flags;
+    cmd->vertexCount = (uint16_t)count;
+    cmd->vertexOffset = binner->vertexCount;
+    cmd->stateIndex = binner->stateCount - 1;
+
+    for (int i = 0; i < count; i++) binner->vertices[binner->vertexCount++] = vertices[i];
+
+    return true;
+}
+#endif // SW_MAX_THREADS > 1
+
+static inline void sw_raster_submit(sw_raster_type_t type, uint32_t flags, const sw_vertex_t *vertices, int count)
+{
+    sw_raster_state_t state;
+#if (SW_MAX_THREADS > 1)
+    memset(&state, 0, sizeof(sw_raster_state_t)); // NOTE: Padding is cleared too, binned states are compared with memcmp()
+#endif
+    sw_raster_get_state(&state, type);
+
+#if (SW_MAX_THREADS > 1)
+    if (sw_binner_push(&RLSW, type, flags, vertices, count, &state)) return;
+
+    // Binning failed (out of memory), rasterize the pending commands and this one directly
+    sw_binner_flush(&RLSW);
+#endif
+
+    sw_raster_t r;
+    sw_framebuffer_get_raster(&RLSW.framebuffer, &r);
+    r.state = &state;
+#if SW_ENABLE_STATS
+    r.stats = &RLSW.stats;
+#endif
+
+    sw_raster_execute(&r, type, flags, vertices, count);
+}
+
+// Complete all the pending rasterization
+static inline void sw_raster_finish(void)
+{
+#if (SW_MAX_THREADS > 1)
+    sw_binner_flush(&RLSW);
+#endif
+}
+//-------------------------------------------------------------------------------------------
+
+// Polygon modes rendering logic
+//-------------------------------------------------------------------------------------------
+static inline void sw_poly_point_render(void)
+{
+    for (int i = 0; i < RLSW.vertexCounter; i++) sw_point_render(&RLSW.vertexBuffer[i]);
+}
+
+static inline void sw_poly_line_render(void)
+{
+    const sw_vertex_t *vertices = RLSW.vertexBuffer;
+    int cm1 = RLSW.vertexCounter - 1;
+
+    for (int i = 0; i < cm1; i++)
+    {
+        sw_vertex_t verts[2] = { vertices[i], vertices[i + 1] };
+        sw_line_render(verts);
+    }
+
+    sw_vertex_t verts[2] = { vertices[cm1], vertices[0] };
+    sw_line_render(verts);
+}
+
+static inline void sw_poly_fill_render(void)
+{
+    switch (RLSW.drawMode)
+    {
+        case SW_POINTS: sw_point_render(&RLSW.vertexBuffer[0]); break;
+        case SW_LINES: sw_line_render(RLSW.vertexBuffer); break;
+        case SW_TRIANGLES: sw_triangle_render(); break;
+        case SW_QUADS: sw_quad_render(); break;
+    }
+}
+
+// Renders the primitive stored in the vertex buffer with the current polygon mode
+static inline void sw_poly_render(void)
+{
+    switch (RLSW.polyMode)
+    {
+        case SW_FILL: sw_poly_fill_render(); break;
+        case SW_LINE: sw_poly_line_render(); break;
+        case SW_POINT: sw_poly_point_render(); break;
+        default: break;
+    }
 
-DEFINE_POINT_RASTER(sw_point_raster_CHECK, 0, 0, 1)
-DEFINE_POINT_RASTER(sw_point_raster_DEPTH_CHECK, 1, 0, 1)
-DEFINE_POINT_RASTER(sw_point_raster_BLEND_CHECK, 0, 1, 1)
-DEFINE_POINT_RASTER(sw_point_raster_DEPTH_BLEND_CHECK, 1, 1, 1)
+    RLSW.vertexCounter = 0;
+}
+//-------------------------------------------------------------------------------------------
 
-DEFINE_POINT_RASTER(sw_point_raster_CHECK_SCISSOR, 0, 0, SW_SCISSOR_TEST)
-DEFINE_POINT_RASTER(sw_point_raster_DEPTH_CHECK_SCISSOR, 1, 0, SW_SCISSOR_TEST)
-DEFINE_POINT_RASTER(sw_point_raster_BLEND_CHECK_SCISSOR, 0, 1, SW_SCISSOR_TEST)
-DEFINE_POINT_RASTER(sw_point_raster_DEPTH_BLEND_CHECK_SCISSOR, 1, 1, SW_SCISSOR_TEST)
+// Vertex arrays processing logic
+//-------------------------------------------------------------------------------------------
+// Vertex arrays state, constant during a draw call
+typedef struct {
+    const float *positions;     // Positions array (xyz)
+    const float *texcoords;     // Texcoords array (uv), NULL to use the current texcoord
+    const uint8_t *colors;      // Colors array (rgba), NULL to use the current color
+    const float *texMatrix;     // Texture matrix, NULL if identity
+    float texcoord[2];          // Current texcoord, already transformed
+    float color[4];             // Current color, modulated by the colors array
+    SWvertexproc vertexProc;    // Vertex program, NULL for the fixed function
+    const void *uniforms;       // Programs uniforms block
+} sw_array_fetch_t;
 
-DEFINE_POINT_THICK_RASTER(sw_point_thick_raster, sw_point_raster_CHECK)
-DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_DEPTH, sw_point_raster_DEPTH_CHECK)
-DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_BLEND, sw_point_raster_BLEND_CHECK)
-DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_DEPTH_BLEND, sw_point_raster_DEPTH_BLEND_CHECK)
+static inline void sw_array_fetch_init(sw_array_fetch_t *fetch)
+{
+    const float *texMatrix = RLSW.stackTexture[RLSW.stackTextureCounter - 1];
 
-DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_SCISSOR, sw_point_raster_CHECK_SCISSOR)
-DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_DEPTH_SCISSOR, sw_point_raster_DEPTH_CHECK_SCISSOR)
-DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_BLEND_SCISSOR, sw_point_raster_BLEND_CHECK_SCISSOR)
-DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_DEPTH_BLEND_SCISSOR, sw_point_raster_DEPTH_BLEND_CHECK_SCISSOR)
+    bool texIdentity = true;
+    for (int i = 0; i < 16; i++) texIdentity = texIdentity && (texMatrix[i] == (((i%5) == 0)? 1.0f : 0.0f));
 
-static inline void sw_point_render(sw_vertex_t *v)
+    fetch->positions = RLSW.array.positions;
+    fetch->texcoords = RLSW.array.texcoords;
+    fetch->colors = RLSW.array.colors;
+    fetch->texMatrix = texIdentity? NULL : texMatrix;
+
+    float u = RLSW.current.texcoord[0];
+    float v = RLSW.current.texcoord[1];
+    fetch->texcoord[0] = texMatrix[0]*u + texMatrix[4]*v + texMatrix[12];
+    fetch->texcoord[1] = texMatrix[1]*u + texMatrix[5]*v + texMatrix[13];
+
+    for (int i = 0; i < 4; i++) fetch->color[i] = RLSW.current.color[i];
+
+    fetch->vertexProc = RLSW.vertexProc;
+    fetch->uniforms = RLSW.programUniforms;
+}
+
+// Fetches the attributes of a vertex from the arrays, the position is kept in object space
+static inline void sw_array_fetch_attributes(sw_vertex_t *SW_RESTRICT out, const sw_array_fetch_t *SW_RESTRICT fetch, uint32_t index)
 {
-    if (!sw_point_clip_and_project(v)) return;
+    const float *position = &fetch->positions[3*index];
+
+    out->position[0] = position[0];
+    out->position[1] = position[1];
+    out->position[2] = position[2];
+    out->position[3] = 1.0f;
 
-    if (RLSW.pointRadius >= 1.0f)
+    if (fetch->texcoords != NULL)
     {
-        if (SW_STATE_CHECK(SW_STATE_SCISSOR_TEST))
+        float u = fetch->texcoords[2*index];
+        float v = fetch->texcoords[2*index + 1];
+
+        if (fetch->texMatrix != NULL)
         {
-            if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_point_thick_raster_DEPTH_BLEND_SCISSOR(v);
-            else if (SW_STATE_CHECK(SW_STATE_BLEND)) sw_point_thick_raster_BLEND_SCISSOR(v);
-            else if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST)) sw_point_thick_raster_DEPTH_SCISSOR(v);
-            else sw_point_thick_raster_SCISSOR(v);
+            const float *m = fetch->texMatrix;
+            out->texcoord[0] = m[0]*u + m[4]*v + m[12];
+            out->texcoord[1] = m[1]*u + m[5]*v + m[13];
         }
         else
         {
-            if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_point_thick_raster_DEPTH_BLEND(v);
-            else if (SW_STATE_CHECK(SW_STATE_BLEND)) sw_point_thick_raster_BLEND(v);
-            else if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST)) sw_point_thick_raster_DEPTH(v);
-            else sw_point_thick_raster(v);
+            out->texcoord[0] = u;
+            out->texcoord[1] = v;
         }
     }
     else
     {
-        if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_point_raster_DEPTH_BLEND(v->screen[0], v->screen[1], v->homogeneous[2], v->color);
-        else if (SW_STATE_CHECK(SW_STATE_BLEND)) sw_point_raster_BLEND(v->screen[0], v->screen[1], v->homogeneous[2], v->color);
-        else if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST)) sw_point_raster_DEPTH(v->screen[0], v->screen[1], v->homogeneous[2], v->color);
-        else sw_point_raster(v->screen[0], v->screen[1], v->homogeneous[2], v->color);
+        out->texcoord[0] = fetch->texcoord[0];
+        out->texcoord[1] = fetch->texcoord[1];
+    }
+
+    if (fetch->colors != NULL)
+    {
+        float color[4];
+        sw_float_from_unorm8_simd(color, &fetch->colors[4*index]);
+
+        out->color[0] = fetch->color[0]*color[0];
+        out->color[1] = fetch->color[1]*color[1];
+        out->color[2] = fetch->color[2]*color[2];
+        out->color[3] = fetch->color[3]*color[3];
+    }
+    else
+    {
+        out->color[0] = fetch->color[0];
+        out->color[1] = fetch->color[1];
+        out->color[2] = fetch->color[2];
+        out->color[3] = fetch->color[3];
     }
+
+    if (fetch->vertexProc != NULL) fetch->vertexProc(out->position, out->texcoord, out->color, fetch->uniforms);
 }
-//-------------------------------------------------------------------------------------------
 
-// Polygon modes rendering logic
-//-------------------------------------------------------------------------------------------
-static inline void sw_poly_point_render(void)
+// Fetches a vertex from the arrays and computes its homogeneous coordinates
+static inline void sw_array_fetch_vertex(sw_vertex_t *SW_RESTRICT out, const sw_array_fetch_t *SW_RESTRICT fetch, uint32_t index)
 {
-    for (int i = 0; i < RLSW.vertexCounter; i++) sw_point_render(&RLSW.vertexBuffer[i]);
+    sw_array_fetch_attributes(out, fetch, index);
+    SW_STATS_ADD(vertices, 1);
+
+    // NOTE: The vertex program can change the position w
+    if (fetch->vertexProc == NULL) sw_vec4_transform_point_simd(out->homogeneous, RLSW.matMVP, out->position);
+    else sw_vec4_transform(out->homogeneous, RLSW.matMVP, out->position);
 }
 
-static inline void sw_poly_line_render(void)
+// Fetches the vertices shared by the instances of a draw, attributes only
+static inline sw_vertex_t *sw_array_fetch_instance_vertices(const sw_array_fetch_t *fetch, uint32_t first, int count)
 {
-    const sw_vertex_t *vertices = RLSW.vertexBuffer;
-    int cm1 = RLSW.vertexCounter - 1;
-
-    for (int i = 0; i < cm1; i++)
+    if (count > RLSW.instanceVertexCapacity)
     {
-        sw_vertex_t verts[2] = { vertices[i], vertices[i + 1] };
-        sw_line_render(verts);
+        sw_vertex_t *newVertices = (sw_vertex_t *)SW_REALLOC(RLSW.instanceVertices, count*sizeof(sw_vertex_t));
+        if (newVertices == NULL) return NULL;
+
+        RLSW.instanceVertices = newVertices;
+        RLSW.instanceVertexCapacity = count;
     }
 
-    sw_vertex_t verts[2] = { vertices[cm1], vertices[0] };
-    sw_line_render(verts);
+    for (int i = 0; i < count; i++) sw_array_fetch_attributes(&RLSW.instanceVertices[i], fetch, first + i);
+
+    return RLSW.instanceVertices;
 }
 
-static inline void sw_poly_fill_render(void)
+// Copies a vertex shared by the instances and computes its homogeneous coordinates for an instance
+static inline void sw_array_instance_vertex(sw_vertex_t *SW_RESTRICT out, const sw_vertex_t *SW_RESTRICT in, const sw_matrix_t mvp)
 {
-    switch (RLSW.drawMode)
+    *out = *in;
+    sw_vec4_transform(out->homogeneous, mvp, in->position);
+    SW_STATS_ADD(vertices, 1);
+}
+
+// Assembles and renders the primitives of consecutive transformed vertices
+static inline void sw_array_render(const sw_vertex_t *vertices, int count)
+{
+    int reqVertices = RLSW.reqVertices;
+
+    for (int i = 0; i + reqVertices <= count; i += reqVertices)
     {
-        case SW_POINTS: sw_point_render(&RLSW.vertexBuffer[0]); break;
-        case SW_LINES: sw_line_render(RLSW.vertexBuffer); break;
-        case SW_TRIANGLES: sw_triangle_render(); break;
-        case SW_QUADS: sw_quad_render(); break;
+        for (int j = 0; j < reqVertices; j++) RLSW.vertexBuffer[j] = vertices[i + j];
+
+        RLSW.vertexCounter = reqVertices;
+        sw_poly_render();
     }
 }
 //-------------------------------------------------------------------------------------------
@@ -3412,26 +7035,14 @@ void sw_immediate_push_vertex(const float position[4], const float color[4], con
         vertex->color[i] = color[i];
     }
 
+    if (RLSW.vertexProc != NULL) RLSW.vertexProc(vertex->position, vertex->texcoord, vertex->color, RLSW.programUniforms);
+
     // Calculate homogeneous coordinates
-    const float *m = RLSW.matMVP, *v = vertex->position;
-    vertex->homogeneous[0] = m[0]*v[0] + m[4]*v[1] + m[8]*v[2] + m[12]*v[3];
-    vertex->homogeneous[1] = m[1]*v[0] + m[5]*v[1] + m[9]*v[2] + m[13]*v[3];
-    vertex->homogeneous[2] = m[2]*v[0] + m[6]*v[1] + m[10]*v[2] + m[14]*v[3];
-    vertex->homogeneous[3] = m[3]*v[0] + m[7]*v[1] + m[11]*v[2] + m[15]*v[3];
+    sw_vec4_transform(vertex->homogeneous, RLSW.matMVP, vertex->position);
+    SW_STATS_ADD(vertices, 1);
 
     // Immediate rendering of the primitive if the required number is reached
-    if (RLSW.vertexCounter == RLSW.reqVertices)
-    {
-        switch (RLSW.polyMode)
-        {
-            case SW_FILL: sw_poly_fill_render(); break;
-            case SW_LINE: sw_poly_line_render(); break;
-            case SW_POINT: sw_poly_point_render(); break;
-            default: break;
-        }
-
-        RLSW.vertexCounter = 0;
-    }
+    if (RLSW.vertexCounter == RLSW.reqVertices) sw_poly_render();
 }
 
 //-------------------------------------------------------------------------------------------
@@ -3444,9 +7055,9 @@ static inline bool sw_is_texture_valid(uint32_t id)
 
     if (id == 0) valid = false;
     else if (id >= SW_MAX_TEXTURES) valid = false;
-    else if (RLSW.loadedTextures[id].pixels == NULL) valid = false;
+    else if (RLSW.loadedTextures[id].levels[0].pixels == NULL) valid = false;
 
-    return true;
+    return valid;
 }
 
 static inline bool sw_is_texture_filter_valid(int filter)
@@ -3454,11 +7065,41 @@ static inline bool sw_is_texture_filter_valid(int filter)
     return ((filter == SW_NEAREST) || (filter == SW_LINEAR));
 }
 
+static inline bool sw_is_texture_min_filter_valid(int filter)
+{
+    return (sw_is_texture_filter_valid(filter) ||
+        (filter == SW_NEAREST_MIPMAP_NEAREST) || (filter == SW_LINEAR_MIPMAP_NEAREST) ||
+        (filter == SW_NEAREST_MIPMAP_LINEAR) || (filter == SW_LINEAR_MIPMAP_LINEAR));
+}
+
+static inline void sw_texture_free_levels(sw_texture_t *texture, int firstLevel)
+{
+    for (int i = firstLevel; i < texture->levelCount; i++)
+    {
+        // NOTE: Generated textures share the default texture pixels until specified
+        if (texture->levels[i].pixels != RLSW.loadedTextures[0].levels[0].pixels) SW_FREE(texture->levels[i].pixels);
+        texture->levels[i] = SW_CURLY_INIT(sw_texture_level_t) { 0 };
+    }
+
+    if (texture->levelCount > firstLevel) texture->levelCount = firstLevel;
+}
+
 static inline bool sw_is_texture_wrap_valid(int wrap)
 {
     return ((wrap == SW_REPEAT) || (wrap == SW_CLAMP));
 }
 
+static inline bool sw_is_framebuffer_valid(uint32_t id)
+{
+    bool valid = true;
+
+    if (id == 0) valid = false;
+    else if (id >= (uint32_t)RLSW.loadedFramebufferCount) valid = false;
+    else if (!RLSW.loadedFramebuffers[id].used) valid = false;
+
+    return valid;
+}
+
 static inline bool sw_is_draw_mode_valid(int mode)
 {
     bool result = false;
@@ -3541,12 +7182,220 @@ static inline bool sw_is_blend_dst_factor_valid(int blend)
 }
 //-------------------------------------------------------------------------------------------
 
+// Framebuffer objects management functions
+//-------------------------------------------------------------------------------------------
+// Copies the framebuffer object pixels to an attached texture base level
+// NOTE: Rows are flipped to match the OpenGL texture layout, where the first row is
+// the bottom of the framebuffer, color attachments are stored as RGBA32 and depth
+// attachments as grayscale
+static void sw_fbo_resolve_texture(uint32_t id)
+{
+    sw_texture_t *texture = &RLSW.loadedTextures[id];
+
+    uint32_t fboId = texture->resolveFramebuffer;
+    texture->resolveFramebuffer = 0;
+
+    const sw_fbo_t *fbo = &RLSW.loadedFramebuffers[fboId];
+    const sw_framebuffer_t *fb = (fboId == RLSW.currentFramebuffer)? &RLSW.framebuffer : &fbo->storage;
+
+    if (fb->colors == NULL) return;
+
+    sw_raster_finish(); // Pending primitives may still target the framebuffer or sample the texture
+    sw_framebuffer_resolve_clears((sw_framebuffer_t *)fb);
+
+    sw_texture_level_t *level = &texture->levels[0];
+
+    bool isDepth = (fbo->colorTexture != id);
+    sw_pixelformat_t format = isDepth? SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE : SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+
+    if ((level->width != fb->width) || (level->height != fb->height) || (texture->format != format) ||
+        (level->pixels == RLSW.loadedTextures[0].levels[0].pixels))
+    {
+        sw_texture_free_levels(texture, 0);
+        sw_texture_set_format(texture, format);
+
+        if (!sw_texture_level_alloc(level, fb->width, fb->height, format))
+        {
+            RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory...
+            *level = RLSW.loadedTextures[0].levels[0];
+            texture->levelCount = 1;
+            sw_texture_set_format(texture, RLSW.loadedTextures[0].format);
+            return;
+        }
+
+        texture->levelCount = 1;
+    }
+
+    for (int y = 0; y < fb->height; y++)
+    {
+        int row = fb->height - 1 - y;
+
+        if (isDepth)
+        {
+            const sw_depth_t *src = &fb->depths[row*fb->width];
+            for (int x = 0; x < fb->width; x++)
+            {
+                level->pixels[sw_texture_texel_index(level, x, y)] = (uint8_t)(sw_saturate(sw_framebuffer_read_depth(&src[x]))*255.0f + 0.5f);
+            }
+        }
+        else
+        {
+            const sw_color_t *src = &fb->colors[row*fb->colorStride];
+            for (int x = 0; x < fb->width; x++)
+            {
+                sw_framebuffer_read_color8(&level->pixels[4*sw_texture_texel_index(level, x, y)], &src[x]);
+            }
+        }
+    }
+}
+
+// Copies an attached texture base level to the bound framebuffer object, so rendering
+// happens on top of the texture contents like with an OpenGL framebuffer object
+static void sw_fbo_load_texture(uint32_t id, bool isDepth)
+{
+    const sw_texture_t *texture = &RLSW.loadedTextures[id];
+    const sw_texture_level_t *level = &texture->levels[0];
+    sw_framebuffer_t *fb = &RLSW.framebuffer;
+
+    int w = sw_mini(level->width, fb->width);
+    int h = sw_mini(level->height, fb->height);
+
+    sw_framebuffer_touch_tiles(fb);
+
+    for (int y = 0; y < h; y++)
+    {
+        int row = fb->height - 1 - y;
+        sw_color_t *dstColor = &fb->colors[row*fb->colorStride];
+        sw_depth_t *dstDepth = &fb->depths[row*fb->width];
+
+        for (int x = 0; x < w; x++)
+        {
+            uint8_t src[4];
+            sw_get_pixel(src, level->pixels, sw_texture_texel_index(level, x, y), texture->format);
+
+            if (isDepth) sw_framebuffer_write_depth(&dstDepth[x], src[0]*SW_INV_255);
+            else
+            {
+                float color[4] = { src[0]*SW_INV_255, src[1]*SW_INV_255, src[2]*SW_INV_255, src[3]*SW_INV_255 };
+                sw_framebuffer_write_color(&dstColor[x], color);
+            }
+        }
+    }
+    // NOTE: The loaded depth values are not tracked, the bounds cover the whole depth range
+    if (isDepth) sw_framebuffer_set_depth_tiles(fb, 0.0f, 1.0f);
+}
+//-------------------------------------------------------------------------------------------
+
+// Framebuffer copy functions
+//-------------------------------------------------------------------------------------------
+// Copies a region of the current framebuffer to user memory, pending rasterization and clears must be resolved
+static void sw_framebuffer_copy(int x, int y, int w, int h, SWformat format, SWtype type, void *pixels)
+{
+    sw_pixelformat_t pFormat = (sw_pixelformat_t)sw_get_pixel_format(format, type);
+
+    if (w <= 0) { RLSW.errCode = SW_INVALID_VALUE; return; }
+    if (h <= 0) { RLSW.errCode = SW_INVALID_VALUE; return; }
+
+    // Region is clipped to the framebuffer bounds
+    x = sw_clampi(x, 0, RLSW.framebuffer.width);
+    y = sw_clampi(y, 0, RLSW.framebuffer.height);
+
+    if (w > (RLSW.framebuffer.width - x)) w = RLSW.framebuffer.width - x;
+    if (h > (RLSW.framebuffer.height - y)) h = RLSW.framebuffer.height - y;
+
+    if ((w <= 0) || (h <= 0)) return;
+
+    // NOTE: Multisampled framebuffers are resolved by the generic copies
+    if ((x == 0) && (y == 0) && (w == RLSW.framebuffer.width) && (h == RLSW.framebuffer.height) && (RLSW.framebuffer.sampleColors == NULL))
+    {
+        #if SW_COLOR_BUFFER_BITS == 32
+            if (pFormat == SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+            {
+                sw_framebuffer_copy_fast(pixels);
+                return;
+            }
+        #elif SW_COLOR_BUFFER_BITS == 16
+            if (pFormat == SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5)
+            {
+                sw_framebuffer_copy_fast(pixels);
+                return;
+            }
+        #endif
+    }
+
+    switch (pFormat)
+    {
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE: sw_framebuffer_copy_to_GRAYALPHA(x, y, w, h, (uint8_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA: sw_framebuffer_copy_to_GRAYALPHA(x, y, w, h, (uint8_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5: sw_framebuffer_copy_to_R5G6B5(x, y, w, h, (uint16_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8: sw_framebuffer_copy_to_R8G8B8(x, y, w, h, (uint8_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R5G5B5A1: sw_framebuffer_copy_to_R5G5B5A1(x, y, w, h, (uint16_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R4G4B4A4: sw_framebuffer_copy_to_R4G4B4A4(x, y, w, h, (uint16_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: sw_framebuffer_copy_to_R8G8B8A8(x, y, w, h, (uint8_t *)pixels); break;
+        // Below: not implemented
+        case SW_PIXELFORMAT_UNCOMPRESSED_R32:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32A32:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R16:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16A16:
+        default: RLSW.errCode = SW_INVALID_ENUM; break;
+    }
+}
+
+// Copies a region of the current framebuffer to user memory with scaling, pending rasterization and clears must be resolved
+static void sw_framebuffer_blit(int xDst, int yDst, int wDst, int hDst, int xSrc, int ySrc, int wSrc, int hSrc, SWformat format, SWtype type, void *pixels)
+{
+    sw_pixelformat_t pFormat = (sw_pixelformat_t)sw_get_pixel_format(format, type);
+
+    if (wSrc <= 0) { RLSW.errCode = SW_INVALID_VALUE; return; }
+    if (hSrc <= 0) { RLSW.errCode = SW_INVALID_VALUE; return; }
+
+    if (wSrc > RLSW.framebuffer.width) wSrc = RLSW.framebuffer.width;
+    if (hSrc > RLSW.framebuffer.height) hSrc = RLSW.framebuffer.height;
+
+    xSrc = sw_clampi(xSrc, 0, wSrc);
+    ySrc = sw_clampi(ySrc, 0, hSrc);
+
+    // Check if the sizes are identical after clamping the source to avoid unexpected issues
+    // TODO: REVIEW: This repeats the operations if true, so a copy function can be made without these checks
+    if (xDst == xSrc && yDst == ySrc && wDst == wSrc && hDst == hSrc)
+    {
+        sw_framebuffer_copy(xSrc, ySrc, wSrc, hSrc, format, type, pixels);
+    }
+
+    switch (pFormat)
+    {
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE: sw_framebuffer_blit_to_GRAYALPHA(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint8_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA: sw_framebuffer_blit_to_GRAYALPHA(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint8_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5: sw_framebuffer_blit_to_R5G6B5(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint16_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8: sw_framebuffer_blit_to_R8G8B8(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint8_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R5G5B5A1: sw_framebuffer_blit_to_R5G5B5A1(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint16_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R4G4B4A4: sw_framebuffer_blit_to_R4G4B4A4(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint16_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: sw_framebuffer_blit_to_R8G8B8A8(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint8_t *)pixels); break;
+        // Below: not implemented
+        case SW_PIXELFORMAT_UNCOMPRESSED_R32:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32A32:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R16:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16A16:
+        default:
+            RLSW.errCode = SW_INVALID_ENUM;
+            break;
+    }
+}
+//-------------------------------------------------------------------------------------------
+
 //----------------------------------------------------------------------------------
 // Module Functions Definition
 //----------------------------------------------------------------------------------
 bool swInit(int w, int h)
 {
-    if (!sw_framebuffer_load(w, h)) { swClose(); return false; }
+    if (!sw_framebuffer_load(&RLSW.framebuffer, w, h)) { swClose(); return false; }
+#if (SW_MAX_THREADS > 1)
+    if (!sw_binner_init(&RLSW, w, h)) { swClose(); return false; }
+#endif
 
     swViewport(0, 0, w, h);
     swScissor(0, 0, w, h);
@@ -3557,9 +7406,15 @@ bool swInit(int w, int h)
     RLSW.freeTextureIds = (uint32_t *)SW_MALLOC(SW_MAX_TEXTURES*sizeof(uint32_t));
     if (RLSW.loadedTextures == NULL) { swClose(); return false; }
 
+    RLSW.loadedFramebuffers = (sw_fbo_t *)SW_MALLOC(SW_MAX_FRAMEBUFFERS*sizeof(sw_fbo_t));
+    if (RLSW.loadedFramebuffers == NULL) { swClose(); return false; }
+
+    RLSW.freeFramebufferIds = (uint32_t *)SW_MALLOC(SW_MAX_FRAMEBUFFERS*sizeof(uint32_t));
+    if (RLSW.freeFramebufferIds == NULL) { swClose(); return false; }
+
     const float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
-    sw_framebuffer_write_color(&RLSW.clearValue, clearColor);
-    sw_framebuffer_write_depth(&RLSW.clearValue, 1.0f);
+    sw_framebuffer_write_color(&RLSW.clearValue.color, clearColor);
+    sw_framebuffer_write_depth(&RLSW.clearValue.depth, 1.0f);
 
     RLSW.currentMatrixMode = SW_MODELVIEW;
     RLSW.currentMatrix = &RLSW.stackModelview[0];
@@ -3587,6 +7442,7 @@ bool swInit(int w, int h)
 
     RLSW.srcFactorFunc = sw_factor_src_alpha;
     RLSW.dstFactorFunc = sw_factor_one_minus_src_alpha;
+    RLSW.blendMode = SW_BLEND_ALPHA;
 
     RLSW.polyMode = SW_FILL;
     RLSW.cullFace = SW_BACK;
@@ -3598,20 +7454,27 @@ bool swInit(int w, int h)
         0xFFFFFFFF
     };
 
-    RLSW.loadedTextures[0].pixels = (uint8_t*)defaultTex;
-    RLSW.loadedTextures[0].width = 2;
-    RLSW.loadedTextures[0].height = 2;
-    RLSW.loadedTextures[0].wMinus1 = 1;
-    RLSW.loadedTextures[0].hMinus1 = 1;
+    RLSW.loadedTextures[0] = SW_CURLY_INIT(sw_texture_t) { 0 };
+    RLSW.loadedTextures[0].levels[0].pixels = (uint8_t*)defaultTex;
+    RLSW.loadedTextures[0].levels[0].width = 2;
+    RLSW.loadedTextures[0].levels[0].height = 2;
+    RLSW.loadedTextures[0].levels[0].wMinus1 = 1;
+    RLSW.loadedTextures[0].levels[0].hMinus1 = 1;
+    RLSW.loadedTextures[0].levels[0].tx = 0.5f;
+    RLSW.loadedTextures[0].levels[0].ty = 0.5f;
+    RLSW.loadedTextures[0].levelCount = 1;
+    sw_texture_set_format(&RLSW.loadedTextures[0], SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
     RLSW.loadedTextures[0].minFilter = SW_NEAREST;
     RLSW.loadedTextures[0].magFilter = SW_NEAREST;
     RLSW.loadedTextures[0].sWrap = SW_REPEAT;
     RLSW.loadedTextures[0].tWrap = SW_REPEAT;
-    RLSW.loadedTextures[0].tx = 0.5f;
-    RLSW.loadedTextures[0].ty = 0.5f;
 
     RLSW.loadedTextureCount = 1;
 
+    // NOTE: Framebuffer object 0 is the main framebuffer
+    RLSW.loadedFramebuffers[0] = SW_CURLY_INIT(sw_fbo_t) { 0 };
+    RLSW.loadedFramebufferCount = 1;
+
     SW_LOG("INFO: RLSW: Software renderer initialized successfully\n");
 #if defined(SW_HAS_FMA_AVX) && defined(SW_HAS_FMA_AVX2)
     SW_LOG("INFO: RLSW: Using SIMD instructions: FMA AVX\n");
@@ -3632,121 +7495,259 @@ bool swInit(int w, int h)
     return true;
 }
 
-void swClose(void)
+void swClose(void)
+{
+#if (SW_MAX_THREADS > 1)
+    sw_binner_close(&RLSW); // NOTE: Pending primitives are discarded
+#endif
+
+    // NOTE: Starts at texture 1, texture 0 does not have to be freed
+    for (int i = 1; i < RLSW.loadedTextureCount; i++)
+    {
+        if (sw_is_texture_valid(i)) sw_texture_free_levels(&RLSW.loadedTextures[i], 0);
+    }
+
+    // Restore the main framebuffer, the bound framebuffer object storage is freed with the others
+    if (RLSW.currentFramebuffer != 0)
+    {
+        RLSW.loadedFramebuffers[RLSW.currentFramebuffer].storage = RLSW.framebuffer;
+        RLSW.framebuffer = RLSW.mainFramebuffer;
+    }
+
+    for (int i = 1; i < RLSW.loadedFramebufferCount; i++)
+    {
+        if (sw_is_framebuffer_valid(i)) sw_framebuffer_unload(&RLSW.loadedFramebuffers[i].storage);
+    }
+
+    sw_framebuffer_unload(&RLSW.framebuffer);
+    SW_FREE(RLSW.loadedTextures);
+    SW_FREE(RLSW.freeTextureIds);
+    SW_FREE(RLSW.loadedFramebuffers);
+    SW_FREE(RLSW.freeFramebufferIds);
+    SW_FREE(RLSW.instanceVertices);
+
+    RLSW = SW_CURLY_INIT(sw_context_t) { 0 };
+}
+
+// Create a new context, with its own framebuffer, textures and state
+// NOTE: The calling thread current context is not changed
+SWcontext *swCreateContext(int w, int h)
+{
+    sw_context_t *ctx = (sw_context_t *)SW_MALLOC(sizeof(sw_context_t));
+    if (ctx == NULL) return NULL;
+
+    *ctx = SW_CURLY_INIT(sw_context_t) { 0 };
+
+    sw_context_t *current = swCurrentContext;
+    swCurrentContext = ctx;
+    bool initialized = swInit(w, h);
+    swCurrentContext = current;
+
+    if (!initialized)
+    {
+        SW_FREE(ctx);
+        return NULL;
+    }
+
+    return ctx;
+}
+
+// Destroy a context created with swCreateContext()
+// NOTE: The context must not be current on other threads, the calling thread
+// falls back to the default context if it was its current one
+void swDestroyContext(SWcontext *ctx)
+{
+    if ((ctx == NULL) || (ctx == &swDefaultContext)) return;
+
+    sw_context_t *current = swCurrentContext;
+    swCurrentContext = ctx;
+    swClose();
+    swCurrentContext = (current == ctx)? &swDefaultContext : current;
+
+    SW_FREE(ctx);
+}
+
+// Set the calling thread current context, NULL for the default context
+// NOTE: A context must be current on a single thread at a time
+void swMakeContextCurrent(SWcontext *ctx)
 {
-    // NOTE: Starts at texture 1, texture 0 does not have to be freed
-    for (int i = 1; i < RLSW.loadedTextureCount; i++)
-    {
-        if (sw_is_texture_valid(i))
-        {
-            SW_FREE(RLSW.loadedTextures[i].pixels);
-        }
-    }
-
-    SW_FREE(RLSW.framebuffer.pixels);
-    SW_FREE(RLSW.loadedTextures);
-    SW_FREE(RLSW.freeTextureIds);
+    swCurrentContext = (ctx != NULL)? ctx : &swDefaultContext;
+}
 
-    RLSW = SW_CURLY_INIT(sw_context_t) { 0 };
+// Get the calling thread current context
+SWcontext *swGetCurrentContext(void)
+{
+    return swCurrentContext;
 }
 
 bool swResizeFramebuffer(int w, int h)
 {
-    return sw_framebuffer_resize(w, h);
+    sw_raster_finish();
+
+    // NOTE: Always resizes the main framebuffer, even while a framebuffer object is bound
+    if (RLSW.currentFramebuffer != 0) return sw_framebuffer_resize(&RLSW.mainFramebuffer, w, h);
+
+#if (SW_MAX_THREADS > 1)
+    if (!sw_binner_resize(&RLSW, w, h)) return false;
+#endif
+
+    return sw_framebuffer_resize(&RLSW.framebuffer, w, h);
 }
 
-void swCopyFramebuffer(int x, int y, int w, int h, SWformat format, SWtype type, void *pixels)
+// Set user memory as the main framebuffer color plane, rendering happens directly into it
+// NOTE: Stride is in bytes, the supported formats depend on SW_COLOR_BUFFER_BITS:
+// 32 bits: SW_RGBA/SW_BGRA with SW_UNSIGNED_BYTE, 16 bits: SW_RGB with SW_UNSIGNED_SHORT_5_6_5
+// Passing NULL pixels restores an internal color plane, previous contents are not kept
+bool swSetFramebufferMemory(void *pixels, int w, int h, int stride, SWformat format, SWtype type)
 {
-    sw_pixelformat_t pFormat = (sw_pixelformat_t)sw_get_pixel_format(format, type);
+    sw_raster_finish();
 
-    if (w <= 0) { RLSW.errCode = SW_INVALID_VALUE; return; }
-    if (h <= 0) { RLSW.errCode = SW_INVALID_VALUE; return; }
+    // NOTE: Always sets the main framebuffer, even while a framebuffer object is bound
+    sw_framebuffer_t *fb = (RLSW.currentFramebuffer != 0)? &RLSW.mainFramebuffer : &RLSW.framebuffer;
+    bool bgra = false;
 
-    if (w > RLSW.framebuffer.width) w = RLSW.framebuffer.width;
-    if (h > RLSW.framebuffer.height) h = RLSW.framebuffer.height;
+    if (pixels != NULL)
+    {
+        const int pixelSize = (int)sizeof(sw_color_t);
 
-    x = sw_clampi(x, 0, w);
-    y = sw_clampi(y, 0, h);
+        if ((w <= 0) || (h <= 0) || (stride < w*pixelSize)) { RLSW.errCode = SW_INVALID_VALUE; return false; }
+        if (((uintptr_t)pixels%pixelSize != 0) || (stride%pixelSize != 0)) { RLSW.errCode = SW_INVALID_VALUE; return false; }
 
-    if ((x >= w) || (y >= h)) return;
+#if SW_COLOR_BUFFER_BITS == 32
+        if ((type != SW_UNSIGNED_BYTE) || ((format != SW_RGBA) && (format != SW_BGRA))) { RLSW.errCode = SW_INVALID_ENUM; return false; }
+        bgra = (format == SW_BGRA);
+#elif SW_COLOR_BUFFER_BITS == 16
+        if ((type != SW_UNSIGNED_SHORT_5_6_5) || (format != SW_RGB)) { RLSW.errCode = SW_INVALID_ENUM; return false; }
+#else
+        (void)format; (void)type;
+        RLSW.errCode = SW_INVALID_OPERATION; // No user format matches 8 bit color buffers
+        return false;
+#endif
 
-    if ((x == 0) && (y == 0) && (w == RLSW.framebuffer.width) && (h == RLSW.framebuffer.height))
-    {
-        #if SW_COLOR_BUFFER_BITS == 32
-            if (pFormat == SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
-            {
-                sw_framebuffer_copy_fast(pixels);
-                return;
-            }
-        #elif SW_COLOR_BUFFER_BITS == 16
-            if (pFormat == SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5)
-            {
-                sw_framebuffer_copy_fast(pixels);
-                return;
-            }
-        #endif
+        // NOTE: Multisampled framebuffers keep their owned color plane
+        if (fb->sampleColors != NULL) { RLSW.errCode = SW_INVALID_OPERATION; return false; }
+
+#if (SW_MAX_THREADS > 1)
+        if ((fb == &RLSW.framebuffer) && !sw_binner_resize(&RLSW, w, h)) { RLSW.errCode = SW_STACK_OVERFLOW; return false; }
+#endif
     }
 
-    switch (pFormat)
+    if (!sw_framebuffer_set_colors(fb, pixels, w, h, stride/(int)sizeof(sw_color_t), bgra))
     {
-        case SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE: sw_framebuffer_copy_to_GRAYALPHA(x, y, w, h, (uint8_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA: sw_framebuffer_copy_to_GRAYALPHA(x, y, w, h, (uint8_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5: sw_framebuffer_copy_to_R5G6B5(x, y, w, h, (uint16_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8: sw_framebuffer_copy_to_R8G8B8(x, y, w, h, (uint8_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R5G5B5A1: sw_framebuffer_copy_to_R5G5B5A1(x, y, w, h, (uint16_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R4G4B4A4: sw_framebuffer_copy_to_R4G4B4A4(x, y, w, h, (uint16_t *)pixels); break;
-        //case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: sw_framebuffer_copy_to_R8G8B8A8(x, y, w, h, (uint8_t *)pixels); break;
-        // Below: not implemented
-        case SW_PIXELFORMAT_UNCOMPRESSED_R32:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32A32:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R16:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16A16:
-        default: RLSW.errCode = SW_INVALID_ENUM; break;
+        RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory...
+        return false;
     }
+
+    return true;
 }
 
-void swBlitFramebuffer(int xDst, int yDst, int wDst, int hDst, int xSrc, int ySrc, int wSrc, int hSrc, SWformat format, SWtype type, void *pixels)
+// Get the user memory set as the main framebuffer color plane (NULL if internal)
+// NOTE: Pending primitives and clears are written first, so the memory contents are up to date
+void *swGetFramebufferMemory(void)
 {
-    sw_pixelformat_t pFormat = (sw_pixelformat_t)sw_get_pixel_format(format, type);
+    sw_raster_finish();
 
-    if (wSrc <= 0) { RLSW.errCode = SW_INVALID_VALUE; return; }
-    if (hSrc <= 0) { RLSW.errCode = SW_INVALID_VALUE; return; }
+    sw_framebuffer_t *fb = (RLSW.currentFramebuffer != 0)? &RLSW.mainFramebuffer : &RLSW.framebuffer;
+    if (!fb->userColors) return NULL;
 
-    if (wSrc > RLSW.framebuffer.width) wSrc = RLSW.framebuffer.width;
-    if (hSrc > RLSW.framebuffer.height) hSrc = RLSW.framebuffer.height;
+    sw_framebuffer_resolve_clears(fb);
 
-    xSrc = sw_clampi(xSrc, 0, wSrc);
-    ySrc = sw_clampi(ySrc, 0, hSrc);
+    return fb->colors;
+}
 
-    // Check if the sizes are identical after clamping the source to avoid unexpected issues
-    // TODO: REVIEW: This repeats the operations if true, so a copy function can be made without these checks
-    if (xDst == xSrc && yDst == ySrc && wDst == wSrc && hDst == hSrc)
+// Get the current framebuffer region changed since the last reset, with the tiles granularity
+// NOTE: Clears of whole tiles already holding the clear values do not change them
+bool swGetDirtyRect(int *x, int *y, int *w, int *h, bool reset)
+{
+    sw_raster_finish();
+
+    sw_framebuffer_t *fb = &RLSW.framebuffer;
+    int tMin[2] = { fb->depthTilesX, fb->depthTilesY };
+    int tMax[2] = { -1, -1 };
+
+    for (int ty = 0; ty < fb->depthTilesY; ty++)
     {
-        swCopyFramebuffer(xSrc, ySrc, wSrc, hSrc, format, type, pixels);
+        sw_depth_tile_t *tile = &fb->depthTiles[ty*fb->depthTilesX];
+
+        for (int tx = 0; tx < fb->depthTilesX; tx++, tile++)
+        {
+            if (!(tile->clearState & SW_TILE_DIRTY)) continue;
+
+            tMin[0] = sw_mini(tMin[0], tx);
+            tMin[1] = sw_mini(tMin[1], ty);
+            tMax[0] = sw_maxi(tMax[0], tx);
+            tMax[1] = sw_maxi(tMax[1], ty);
+
+            if (reset) tile->clearState &= ~SW_TILE_DIRTY;
+        }
     }
 
-    switch (pFormat)
+    if (tMax[0] < 0)
     {
-        case SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE: sw_framebuffer_blit_to_GRAYALPHA(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint8_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA: sw_framebuffer_blit_to_GRAYALPHA(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint8_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5: sw_framebuffer_blit_to_R5G6B5(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint16_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8: sw_framebuffer_blit_to_R8G8B8(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint8_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R5G5B5A1: sw_framebuffer_blit_to_R5G5B5A1(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint16_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R4G4B4A4: sw_framebuffer_blit_to_R4G4B4A4(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint16_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: sw_framebuffer_blit_to_R8G8B8A8(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint8_t *)pixels); break;
-        // Below: not implemented
-        case SW_PIXELFORMAT_UNCOMPRESSED_R32:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32A32:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R16:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16A16:
-        default:
-            RLSW.errCode = SW_INVALID_ENUM;
-            break;
+        *x = *y = *w = *h = 0;
+        return false;
     }
+
+    *x = tMin[0]*SW_DEPTH_TILE_SIZE;
+    *y = tMin[1]*SW_DEPTH_TILE_SIZE;
+    *w = sw_mini((tMax[0] + 1)*SW_DEPTH_TILE_SIZE, fb->width) - *x;
+    *h = sw_mini((tMax[1] + 1)*SW_DEPTH_TILE_SIZE, fb->height) - *y;
+
+    return true;
+}
+
+bool swGetStats(SWstats *stats, bool reset)
+{
+#if SW_ENABLE_STATS
+    sw_raster_finish();
+
+    *stats = RLSW.stats;
+    if (reset) RLSW.stats = SW_CURLY_INIT(SWstats) { 0 };
+
+    return true;
+#else
+    *stats = SW_CURLY_INIT(SWstats) { 0 };
+    (void)reset;
+
+    return false;
+#endif
+}
+
+void swFinish(void)
+{
+    sw_raster_finish();
+}
+
+void swCopyFramebuffer(int x, int y, int w, int h, SWformat format, SWtype type, void *pixels)
+{
+    sw_raster_finish();
+    sw_framebuffer_resolve_clears(&RLSW.framebuffer);
+
+#if SW_ENABLE_STATS
+    double startTime = sw_stats_get_time();
+#endif
+
+    sw_framebuffer_copy(x, y, w, h, format, type, pixels);
+
+#if SW_ENABLE_STATS
+    RLSW.stats.copyTime += sw_stats_get_time() - startTime;
+#endif
+}
+
+void swBlitFramebuffer(int xDst, int yDst, int wDst, int hDst, int xSrc, int ySrc, int wSrc, int hSrc, SWformat format, SWtype type, void *pixels)
+{
+    sw_raster_finish();
+    sw_framebuffer_resolve_clears(&RLSW.framebuffer);
+
+#if SW_ENABLE_STATS
+    double startTime = sw_stats_get_time();
+#endif
+
+    sw_framebuffer_blit(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, format, type, pixels);
+
+#if SW_ENABLE_STATS
+    RLSW.stats.copyTime += sw_stats_get_time() - startTime;
+#endif
 }
 
 void swEnable(SWstate state)
@@ -3758,6 +7759,26 @@ void swEnable(SWstate state)
         case SW_DEPTH_TEST: RLSW.stateFlags |= SW_STATE_DEPTH_TEST; break;
         case SW_CULL_FACE: RLSW.stateFlags |= SW_STATE_CULL_FACE; break;
         case SW_BLEND: RLSW.stateFlags |= SW_STATE_BLEND; break;
+        case SW_MULTISAMPLE:
+        {
+            // NOTE: Only the main framebuffer is multisampled, its samples are allocated once enabled
+            sw_framebuffer_t *fb = (RLSW.currentFramebuffer != 0)? &RLSW.mainFramebuffer : &RLSW.framebuffer;
+
+            if (fb->userColors) { RLSW.errCode = SW_INVALID_OPERATION; break; }
+
+            if (fb->sampleColors == NULL)
+            {
+                sw_raster_finish();
+
+                if (!sw_framebuffer_load_samples(fb))
+                {
+                    RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory...
+                    break;
+                }
+            }
+
+            RLSW.stateFlags |= SW_STATE_MULTISAMPLE;
+        } break;
         default: RLSW.errCode = SW_INVALID_ENUM; break;
     }
 }
@@ -3771,6 +7792,7 @@ void swDisable(SWstate state)
         case SW_DEPTH_TEST: RLSW.stateFlags &= ~SW_STATE_DEPTH_TEST; break;
         case SW_CULL_FACE: RLSW.stateFlags &= ~SW_STATE_CULL_FACE; break;
         case SW_BLEND: RLSW.stateFlags &= ~SW_STATE_BLEND; break;
+        case SW_MULTISAMPLE: RLSW.stateFlags &= ~SW_STATE_MULTISAMPLE; break;
         default: RLSW.errCode = SW_INVALID_ENUM; break;
     }
 }
@@ -3792,11 +7814,11 @@ void swGetFloatv(SWget name, float *v)
     {
         case SW_COLOR_CLEAR_VALUE:
         {
-            sw_framebuffer_read_color(v, &RLSW.clearValue);
+            sw_framebuffer_read_color(v, &RLSW.clearValue.color);
         } break;
         case SW_DEPTH_CLEAR_VALUE:
         {
-            v[0] = sw_framebuffer_read_depth(&RLSW.clearValue);
+            v[0] = sw_framebuffer_read_depth(&RLSW.clearValue.depth);
         } break;
         case SW_CURRENT_COLOR:
         {
@@ -3896,39 +7918,32 @@ void swScissor(int x, int y, int width, int height)
     RLSW.scMax[0] = sw_clampi(x + width, 0, RLSW.framebuffer.width - 1);
     RLSW.scMax[1] = sw_clampi(y + height, 0, RLSW.framebuffer.height - 1);
 
-    RLSW.scClipMin[0] = (2.0f*(float)RLSW.scMin[0]/(float)RLSW.vpSize[0]) - 1.0f;
-    RLSW.scClipMax[0] = (2.0f*(float)RLSW.scMax[0]/(float)RLSW.vpSize[0]) - 1.0f;
-    RLSW.scClipMax[1] = 1.0f - (2.0f*(float)RLSW.scMin[1]/(float)RLSW.vpSize[1]);
-    RLSW.scClipMin[1] = 1.0f - (2.0f*(float)RLSW.scMax[1]/(float)RLSW.vpSize[1]);
+    // NOTE: Clip space is relative to the viewport, the scissor rectangle is not
+    float vpX = RLSW.vpCenter[0] - RLSW.vpHalf[0];
+    float vpY = RLSW.vpCenter[1] - RLSW.vpHalf[1];
+
+    RLSW.scClipMin[0] = (2.0f*((float)RLSW.scMin[0] - vpX)/(float)RLSW.vpSize[0]) - 1.0f;
+    RLSW.scClipMax[0] = (2.0f*((float)RLSW.scMax[0] - vpX)/(float)RLSW.vpSize[0]) - 1.0f;
+    RLSW.scClipMax[1] = 1.0f - (2.0f*((float)RLSW.scMin[1] - vpY)/(float)RLSW.vpSize[1]);
+    RLSW.scClipMin[1] = 1.0f - (2.0f*((float)RLSW.scMax[1] - vpY)/(float)RLSW.vpSize[1]);
 }
 
 void swClearColor(float r, float g, float b, float a)
 {
     float v[4] = { r, g, b, a };
-    sw_framebuffer_write_color(&RLSW.clearValue, v);
+    sw_framebuffer_write_color(&RLSW.clearValue.color, v);
 }
 
 void swClearDepth(float depth)
 {
-    sw_framebuffer_write_depth(&RLSW.clearValue, depth);
+    sw_framebuffer_write_depth(&RLSW.clearValue.depth, depth);
 }
 
 void swClear(uint32_t bitmask)
 {
-    int size = RLSW.framebuffer.width*RLSW.framebuffer.height;
+    if (!(bitmask & (SW_COLOR_BUFFER_BIT | SW_DEPTH_BUFFER_BIT))) return;
 
-    if ((bitmask & (SW_COLOR_BUFFER_BIT | SW_DEPTH_BUFFER_BIT)) == (SW_COLOR_BUFFER_BIT | SW_DEPTH_BUFFER_BIT))
-    {
-        sw_framebuffer_fill(RLSW.framebuffer.pixels, size, RLSW.clearValue);
-    }
-    else if (bitmask & (SW_COLOR_BUFFER_BIT))
-    {
-        sw_framebuffer_fill_color(RLSW.framebuffer.pixels, size, RLSW.clearValue.color);
-    }
-    else if (bitmask & SW_DEPTH_BUFFER_BIT)
-    {
-        sw_framebuffer_fill_depth(RLSW.framebuffer.pixels, size, RLSW.clearValue.depth);
-    }
+    sw_raster_submit(SW_RASTER_CLEAR, bitmask, NULL, 0);
 }
 
 void swBlendFunc(SWfactor sfactor, SWfactor dfactor)
@@ -3974,6 +7989,13 @@ void swBlendFunc(SWfactor sfactor, SWfactor dfactor)
         case SW_SRC_ALPHA_SATURATE: break;
         default: break;
     }
+
+    RLSW.blendMode = SW_BLEND_GENERIC;
+    if ((sfactor == SW_SRC_ALPHA) && (dfactor == SW_ONE_MINUS_SRC_ALPHA)) RLSW.blendMode = SW_BLEND_ALPHA;
+    else if ((sfactor == SW_SRC_ALPHA) && (dfactor == SW_ONE)) RLSW.blendMode = SW_BLEND_ADDITIVE;
+    else if ((sfactor == SW_DST_COLOR) && (dfactor == SW_ONE_MINUS_SRC_ALPHA)) RLSW.blendMode = SW_BLEND_MULTIPLIED;
+    else if ((sfactor == SW_ONE) && (dfactor == SW_ONE)) RLSW.blendMode = SW_BLEND_ADD_COLORS;
+    else if ((sfactor == SW_ONE) && (dfactor == SW_ONE_MINUS_SRC_ALPHA)) RLSW.blendMode = SW_BLEND_ALPHA_PREMULTIPLY;
 }
 
 void swPolygonMode(SWpoly mode)
@@ -4008,6 +8030,29 @@ void swLineWidth(float width)
     RLSW.lineWidth = roundf(width);
 }
 
+// Set the vertex and fragment programs replacing the fixed function stages, NULL to restore them
+// NOTE: Programs are called from the rasterization threads when SW_MAX_THREADS > 1,
+// they must not write the uniforms nor any shared state
+void swUseProgram(SWvertexproc vertexProc, SWfragmentproc fragmentProc)
+{
+    RLSW.vertexProc = vertexProc;
+    RLSW.fragmentProc = fragmentProc;
+}
+
+// Set the uniforms block passed to the programs, copied up to SW_MAX_PROGRAM_UNIFORMS bytes
+void swProgramUniforms(const void *data, int size)
+{
+    if ((size < 0) || (size > SW_MAX_PROGRAM_UNIFORMS) || ((data == NULL) && (size > 0)))
+    {
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
+
+    sw_raster_finish(); // Pending primitives may still read the uniforms
+
+    if (size > 0) memcpy(RLSW.programUniforms, data, size);
+}
+
 void swMatrixMode(SWmatrix mode)
 {
     switch (mode)
@@ -4284,6 +8329,8 @@ void swBegin(SWdraw mode)
         return;
     }
 
+    SW_STATS_ADD(drawCalls, 1);
+
     // Recalculate the MVP if this is needed
     if (RLSW.isDirtyMVP)
     {
@@ -4479,72 +8526,187 @@ void swDrawArrays(SWdraw mode, int offset, int count)
 {
     if (RLSW.array.positions == 0)
     {
-        RLSW.errCode = SW_INVALID_OPERATION;
+        RLSW.errCode = SW_INVALID_OPERATION;
+        return;
+    }
+
+    if (!sw_is_draw_mode_valid(mode))
+    {
+        RLSW.errCode = SW_INVALID_ENUM;
+        return;
+    }
+
+    swBegin(mode);
+    {
+        sw_array_fetch_t fetch;
+        sw_array_fetch_init(&fetch);
+
+        // Vertices are transformed by batches holding whole primitives
+        int batchSize = SW_VERTEX_CACHE_SIZE - SW_VERTEX_CACHE_SIZE%RLSW.reqVertices;
+        int end = offset + count - count%RLSW.reqVertices;
+
+        for (int first = offset; first < end; first += batchSize)
+        {
+            int batchCount = sw_mini(batchSize, end - first);
+
+            for (int i = 0; i < batchCount; i++)
+            {
+                sw_array_fetch_vertex(&RLSW.vertexCache[i], &fetch, first + i);
+            }
+
+            sw_array_render(RLSW.vertexCache, batchCount);
+        }
+    }
+    swEnd();
+}
+
+void swDrawElements(SWdraw mode, int count, int type, const void *indices)
+{
+    if (RLSW.array.positions == 0)
+    {
+        RLSW.errCode = SW_INVALID_OPERATION;
+        return;
+    }
+
+    if (count < 0)
+    {
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
+
+    const uint8_t *indicesUb = NULL;
+    const uint16_t *indicesUs = NULL;
+    const uint32_t *indicesUi = NULL;
+
+    switch (type)
+    {
+        case SW_UNSIGNED_BYTE:
+            indicesUb = (const uint8_t *)indices;
+            break;
+        case SW_UNSIGNED_SHORT:
+            indicesUs = (const uint16_t *)indices;
+            break;
+        case SW_UNSIGNED_INT:
+            indicesUi = (const uint32_t *)indices;
+            break;
+        default:
+            RLSW.errCode = SW_INVALID_ENUM;
+            return;
+    }
+
+    if (!sw_is_draw_mode_valid(mode))
+    {
+        RLSW.errCode = SW_INVALID_ENUM;
+        return;
+    }
+
+    // Cache entries stored by previous draw calls are invalidated
+    if (++RLSW.vertexCacheDrawCounter == 0)
+    {
+        memset(RLSW.vertexCacheDraw, 0, sizeof(RLSW.vertexCacheDraw));
+        RLSW.vertexCacheDrawCounter = 1;
+    }
+
+    swBegin(mode);
+    {
+        sw_array_fetch_t fetch;
+        sw_array_fetch_init(&fetch);
+
+        uint32_t drawCounter = RLSW.vertexCacheDrawCounter;
+        int reqVertices = RLSW.reqVertices;
+
+        for (int i = 0; i + reqVertices <= count; i += reqVertices)
+        {
+            for (int j = 0; j < reqVertices; j++)
+            {
+                uint32_t index = indicesUb? indicesUb[i + j] :
+                                (indicesUs? indicesUs[i + j] : indicesUi[i + j]);
+
+                // Shared vertices are transformed once, the cache is direct-mapped
+                uint32_t slot = index & (SW_VERTEX_CACHE_SIZE - 1);
+
+                if ((RLSW.vertexCacheIndex[slot] != index) || (RLSW.vertexCacheDraw[slot] != drawCounter))
+                {
+                    sw_array_fetch_vertex(&RLSW.vertexCache[slot], &fetch, index);
+                    RLSW.vertexCacheIndex[slot] = index;
+                    RLSW.vertexCacheDraw[slot] = drawCounter;
+                }
+
+                RLSW.vertexBuffer[j] = RLSW.vertexCache[slot];
+            }
+
+            RLSW.vertexCounter = reqVertices;
+            sw_poly_render();
+        }
+    }
+    swEnd();
+}
+
+// Draws the arrays once per instance, each instance matrix is applied before the modelview matrix
+// NOTE: Matrices are column-major, 16 floats per instance, vertices are fetched once for all the instances
+void swDrawArraysInstanced(SWdraw mode, int offset, int count, int instances, const float *matrices)
+{
+    if (RLSW.array.positions == 0)
+    {
+        RLSW.errCode = SW_INVALID_OPERATION;
+        return;
+    }
+
+    if ((offset < 0) || (count < 0) || (instances < 0) || ((matrices == NULL) && (instances > 0)))
+    {
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
+
+    if (!sw_is_draw_mode_valid(mode))
+    {
+        RLSW.errCode = SW_INVALID_ENUM;
         return;
     }
 
     swBegin(mode);
     {
-        const float *texMatrix = RLSW.stackTexture[RLSW.stackTextureCounter - 1];
-        const float *defaultTexcoord = RLSW.current.texcoord;
-        const float *defaultColor = RLSW.current.color;
+        sw_array_fetch_t fetch;
+        sw_array_fetch_init(&fetch);
 
-        const float *positions = RLSW.array.positions;
-        const float *texcoords = RLSW.array.texcoords;
-        const uint8_t *colors = RLSW.array.colors;
+        int end = count - count%RLSW.reqVertices;
 
-        int end = offset + count;
-
-        for (int i = offset; i < end; i++)
+        const sw_vertex_t *vertices = sw_array_fetch_instance_vertices(&fetch, offset, end);
+        if ((vertices == NULL) && (end > 0))
         {
-            float u, v;
-            if (texcoords)
-            {
-                int idx = 2*i;
-                u = texcoords[idx];
-                v = texcoords[idx + 1];
-            }
-            else
-            {
-                u = defaultTexcoord[0];
-                v = defaultTexcoord[1];
-            }
+            RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory, not really stack overflow
+            swEnd();
+            return;
+        }
 
-            float texcoord[2];
-            texcoord[0] = texMatrix[0]*u + texMatrix[4]*v + texMatrix[12];
-            texcoord[1] = texMatrix[1]*u + texMatrix[5]*v + texMatrix[13];
+        // Vertices are transformed by batches holding whole primitives
+        int batchSize = SW_VERTEX_CACHE_SIZE - SW_VERTEX_CACHE_SIZE%RLSW.reqVertices;
 
-            float color[4] = {
-                defaultColor[0],
-                defaultColor[1],
-                defaultColor[2],
-                defaultColor[3]
-            };
+        for (int instance = 0; instance < instances; instance++)
+        {
+            sw_matrix_t mvp;
+            sw_matrix_mul_rst(mvp, &matrices[16*instance], RLSW.matMVP);
 
-            if (colors)
+            for (int first = 0; first < end; first += batchSize)
             {
-                int idx = 4*i;
-                color[0] *= (float)colors[idx]*SW_INV_255;
-                color[1] *= (float)colors[idx + 1]*SW_INV_255;
-                color[2] *= (float)colors[idx + 2]*SW_INV_255;
-                color[3] *= (float)colors[idx + 3]*SW_INV_255;
-            }
+                int batchCount = sw_mini(batchSize, end - first);
 
-            int idx = 3*i;
-            float position[4] = {
-                positions[idx],
-                positions[idx + 1],
-                positions[idx + 2],
-                1.0f
-            };
+                for (int i = 0; i < batchCount; i++)
+                {
+                    sw_array_instance_vertex(&RLSW.vertexCache[i], &vertices[first + i], mvp);
+                }
 
-            sw_immediate_push_vertex(position, color, texcoord);
+                sw_array_render(RLSW.vertexCache, batchCount);
+            }
         }
     }
     swEnd();
 }
 
-void swDrawElements(SWdraw mode, int count, int type, const void *indices)
+// Draws the elements once per instance, each instance matrix is applied before the modelview matrix
+// NOTE: Matrices are column-major, 16 floats per instance, the vertices in the indices range
+// are fetched once for all the instances, then transformed once per instance
+void swDrawElementsInstanced(SWdraw mode, int count, int type, const void *indices, int instances, const float *matrices)
 {
     if (RLSW.array.positions == 0)
     {
@@ -4552,7 +8714,7 @@ void swDrawElements(SWdraw mode, int count, int type, const void *indices)
         return;
     }
 
-    if (count < 0)
+    if ((count < 0) || (instances < 0) || ((matrices == NULL) && (instances > 0)))
     {
         RLSW.errCode = SW_INVALID_VALUE;
         return;
@@ -4578,63 +8740,75 @@ void swDrawElements(SWdraw mode, int count, int type, const void *indices)
             return;
     }
 
+    if (!sw_is_draw_mode_valid(mode))
+    {
+        RLSW.errCode = SW_INVALID_ENUM;
+        return;
+    }
+
     swBegin(mode);
     {
-        const float *texMatrix = RLSW.stackTexture[RLSW.stackTextureCounter - 1];
-        const float *defaultTexcoord = RLSW.current.texcoord;
-        const float *defaultColor = RLSW.current.color;
+        sw_array_fetch_t fetch;
+        sw_array_fetch_init(&fetch);
 
-        const float *positions = RLSW.array.positions;
-        const float *texcoords = RLSW.array.texcoords;
-        const uint8_t *colors = RLSW.array.colors;
+        int reqVertices = RLSW.reqVertices;
+        int end = count - count%reqVertices;
 
-        for (int i = 0; i < count; i++)
+        // Range of the vertices referenced by the indices
+        uint32_t minIndex = UINT32_MAX, maxIndex = 0;
+        for (int i = 0; i < end; i++)
         {
-            int index = indicesUb? indicesUb[i] :
-                       (indicesUs? indicesUs[i] : indicesUi[i]);
-
-            float u, v;
-            if (texcoords)
-            {
-                int idx = 2*index;
-                u = texcoords[idx];
-                v = texcoords[idx + 1];
-            }
-            else
-            {
-                u = defaultTexcoord[0];
-                v = defaultTexcoord[1];
-            }
+            uint32_t index = indicesUb? indicesUb[i] : (indicesUs? indicesUs[i] : indicesUi[i]);
+            if (index < minIndex) minIndex = index;
+            if (index > maxIndex) maxIndex = index;
+        }
 
-            float texcoord[2];
-            texcoord[0] = texMatrix[0]*u + texMatrix[4]*v + texMatrix[12];
-            texcoord[1] = texMatrix[1]*u + texMatrix[5]*v + texMatrix[13];
+        const sw_vertex_t *vertices = NULL;
+        if (end > 0) vertices = sw_array_fetch_instance_vertices(&fetch, minIndex, (int)(maxIndex - minIndex + 1));
+        if (vertices == NULL)
+        {
+            if (end > 0) RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory, not really stack overflow
+            swEnd();
+            return;
+        }
 
-            float color[4] = {
-                defaultColor[0],
-                defaultColor[1],
-                defaultColor[2],
-                defaultColor[3]
-            };
+        for (int instance = 0; instance < instances; instance++)
+        {
+            sw_matrix_t mvp;
+            sw_matrix_mul_rst(mvp, &matrices[16*instance], RLSW.matMVP);
 
-            if (colors)
+            // Cache entries stored by previous draw calls or instances are invalidated
+            if (++RLSW.vertexCacheDrawCounter == 0)
             {
-                int idx = 4*index;
-                color[0] *= (float)colors[idx]*SW_INV_255;
-                color[1] *= (float)colors[idx + 1]*SW_INV_255;
-                color[2] *= (float)colors[idx + 2]*SW_INV_255;
-                color[3] *= (float)colors[idx + 3]*SW_INV_255;
+                memset(RLSW.vertexCacheDraw, 0, sizeof(RLSW.vertexCacheDraw));
+                RLSW.vertexCacheDrawCounter = 1;
             }
 
-            int idx = 3*index;
-            float position[4] = {
-                positions[idx],
-                positions[idx + 1],
-                positions[idx + 2],
-                1.0f
-            };
+            uint32_t drawCounter = RLSW.vertexCacheDrawCounter;
 
-            sw_immediate_push_vertex(position, color, texcoord);
+            for (int i = 0; i < end; i += reqVertices)
+            {
+                for (int j = 0; j < reqVertices; j++)
+                {
+                    uint32_t index = indicesUb? indicesUb[i + j] :
+                                    (indicesUs? indicesUs[i + j] : indicesUi[i + j]);
+
+                    // Shared vertices are transformed once per instance, the cache is direct-mapped
+                    uint32_t slot = index & (SW_VERTEX_CACHE_SIZE - 1);
+
+                    if ((RLSW.vertexCacheIndex[slot] != index) || (RLSW.vertexCacheDraw[slot] != drawCounter))
+                    {
+                        sw_array_instance_vertex(&RLSW.vertexCache[slot], &vertices[index - minIndex], mvp);
+                        RLSW.vertexCacheIndex[slot] = index;
+                        RLSW.vertexCacheDraw[slot] = drawCounter;
+                    }
+
+                    RLSW.vertexBuffer[j] = RLSW.vertexCache[slot];
+                }
+
+                RLSW.vertexCounter = reqVertices;
+                sw_poly_render();
+            }
         }
     }
     swEnd();
@@ -4665,6 +8839,8 @@ void swDeleteTextures(int count, uint32_t *textures)
 {
     if ((count == 0) || (textures == NULL)) return;
 
+    sw_raster_finish(); // Pending primitives may still sample the textures
+
     for (int i = 0; i < count; i++)
     {
         if (!sw_is_texture_valid(textures[i]))
@@ -4673,15 +8849,25 @@ void swDeleteTextures(int count, uint32_t *textures)
             continue;
         }
 
-        SW_FREE(RLSW.loadedTextures[textures[i]].pixels);
+        sw_texture_free_levels(&RLSW.loadedTextures[textures[i]], 0);
+        RLSW.loadedTextures[textures[i]].resolveFramebuffer = 0;
+
+        // Deleted textures are detached from the framebuffer objects
+        for (int j = 1; j < RLSW.loadedFramebufferCount; j++)
+        {
+            sw_fbo_t *fbo = &RLSW.loadedFramebuffers[j];
+            if (fbo->colorTexture == textures[i]) fbo->colorTexture = 0;
+            if (fbo->depthTexture == textures[i]) fbo->depthTexture = 0;
+        }
 
-        RLSW.loadedTextures[textures[i]].pixels = NULL;
         RLSW.freeTextureIds[RLSW.freeTextureIdCount++] = textures[i];
     }
 }
 
-void swTexImage2D(int width, int height, SWformat format, SWtype type, const void *data)
+void swTexImage2D(int level, int width, int height, SWformat format, SWtype type, const void *data)
 {
+    sw_raster_finish(); // Pending primitives may still sample the bound texture
+
     uint32_t id = RLSW.currentTexture;
 
     if (!sw_is_texture_valid(id))
@@ -4700,31 +8886,58 @@ void swTexImage2D(int width, int height, SWformat format, SWtype type, const voi
 
     sw_texture_t *texture = &RLSW.loadedTextures[id];
 
-    int size = width*height;
-    texture->pixels = SW_MALLOC(4*size);
+    // NOTE: Levels must be specified in order, each one with half the size of the previous one
+    if ((level < 0) || (level >= SW_MAX_TEXTURE_LEVELS) || (level > texture->levelCount) ||
+        ((level > 0) && ((width != sw_maxi(texture->levels[level - 1].width/2, 1)) ||
+                         (height != sw_maxi(texture->levels[level - 1].height/2, 1)))))
+    {
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
 
-    if (texture->pixels == NULL)
+    // Specifying a level replaces it and invalidates the following ones
+    sw_texture_free_levels(texture, level);
+    if (level == 0) texture->resolveFramebuffer = 0;
+
+    sw_texture_level_t *dstLevel = &texture->levels[level];
+
+    // The base level selects the storage format, the other levels are converted to it
+    sw_pixelformat_t storageFormat = (level == 0)? sw_get_texture_storage_format((sw_pixelformat_t)pixelFormat) : texture->format;
+    int pixelSize = sw_get_texture_pixel_size(storageFormat);
+
+    if (!sw_texture_level_alloc(dstLevel, width, height, storageFormat))
     {
+        *dstLevel = SW_CURLY_INIT(sw_texture_level_t) { 0 };
         RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory...
         return;
     }
 
-    for (int i = 0; i < size; i++)
+    // NOTE: Without data the level contents are undefined in OpenGL, zeroed here
+    if (data == NULL) memset(dstLevel->pixels, 0, pixelSize*sw_texture_level_size(dstLevel));
+    else if ((pixelFormat == (int)storageFormat) && (dstLevel->tilesX == 0)) memcpy(dstLevel->pixels, data, pixelSize*width*height);
+    else
     {
-        uint32_t *dst = &((uint32_t*)texture->pixels)[i];
-        sw_get_pixel((uint8_t*)dst, data, i, pixelFormat);
+        // Data rows are converted to the storage format and layout
+        for (int y = 0, i = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++, i++)
+            {
+                uint8_t color[4];
+                sw_get_pixel(color, data, i, pixelFormat);
+                sw_set_texture_pixel(dstLevel->pixels, sw_texture_texel_index(dstLevel, x, y), color, storageFormat);
+            }
+        }
     }
 
-    texture->width = width;
-    texture->height = height;
-    texture->wMinus1 = width - 1;
-    texture->hMinus1 = height - 1;
-    texture->tx = 1.0f/width;
-    texture->ty = 1.0f/height;
+    if (level == 0) sw_texture_set_format(texture, storageFormat);
+
+    texture->levelCount = level + 1;
 }
 
 void swTexParameteri(int param, int value)
 {
+    sw_raster_finish(); // Pending primitives may still sample the bound texture
+
     uint32_t id = RLSW.currentTexture;
 
     if (!sw_is_texture_valid(id))
@@ -4739,7 +8952,7 @@ void swTexParameteri(int param, int value)
     {
         case SW_TEXTURE_MIN_FILTER:
         {
-            if (!sw_is_texture_filter_valid(value))
+            if (!sw_is_texture_min_filter_valid(value))
             {
                 RLSW.errCode = SW_INVALID_ENUM;
                 return;
@@ -4781,6 +8994,29 @@ void swTexParameteri(int param, int value)
     }
 }
 
+void swGetTexParameteriv(int param, int *value)
+{
+    uint32_t id = RLSW.currentTexture;
+
+    if (!sw_is_texture_valid(id) || (value == NULL))
+    {
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
+
+    const sw_texture_t *texture = &RLSW.loadedTextures[id];
+
+    switch (param)
+    {
+        case SW_TEXTURE_MIN_FILTER: *value = texture->minFilter; break;
+        case SW_TEXTURE_MAG_FILTER: *value = texture->magFilter; break;
+        case SW_TEXTURE_WRAP_S: *value = texture->sWrap; break;
+        case SW_TEXTURE_WRAP_T: *value = texture->tWrap; break;
+        case SW_TEXTURE_MAX_LEVEL: *value = texture->levelCount - 1; break;
+        default: RLSW.errCode = SW_INVALID_ENUM; break;
+    }
+}
+
 void swBindTexture(uint32_t id)
 {
     if (id >= SW_MAX_TEXTURES)
@@ -4789,13 +9025,347 @@ void swBindTexture(uint32_t id)
         return;
     }
 
-    if (RLSW.loadedTextures[id].pixels == NULL)
+    if (RLSW.loadedTextures[id].levels[0].pixels == NULL)
     {
         RLSW.errCode = SW_INVALID_OPERATION;
         return;
     }
 
+    // Textures rendered to since their last use receive the framebuffer object pixels
+    if (RLSW.loadedTextures[id].resolveFramebuffer != 0) sw_fbo_resolve_texture(id);
+
     RLSW.currentTexture = id;
 }
 
+// Copies a level of the bound texture to user memory, converted to the requested format
+// NOTE: Rows are tightly packed, textures attached to framebuffer objects receive their
+// rendered pixels first, float and half float formats are not supported
+void swGetTexImage(int level, SWformat format, SWtype type, void *pixels)
+{
+    uint32_t id = RLSW.currentTexture;
+
+    if (!sw_is_texture_valid(id) || (pixels == NULL))
+    {
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
+
+    // Textures rendered to since their last use receive the framebuffer object pixels
+    if (RLSW.loadedTextures[id].resolveFramebuffer != 0) sw_fbo_resolve_texture(id);
+    else sw_raster_finish();
+
+    const sw_texture_t *texture = &RLSW.loadedTextures[id];
+
+    if ((level < 0) || (level >= texture->levelCount))
+    {
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
+
+    sw_pixelformat_t pixelFormat = (sw_pixelformat_t)sw_get_pixel_format(format, type);
+
+    switch (pixelFormat)
+    {
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE:
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R5G5B5A1:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R4G4B4A4:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: break;
+        default: RLSW.errCode = SW_INVALID_ENUM; return;
+    }
+
+    const sw_texture_level_t *src = &texture->levels[level];
+
+    if ((pixelFormat == texture->format) && (src->tilesX == 0))
+    {
+        memcpy(pixels, src->pixels, sw_get_texture_pixel_size(texture->format)*src->width*src->height);
+        return;
+    }
+
+    // Texels are converted from the storage format and layout to the requested rows
+    for (int y = 0, i = 0; y < src->height; y++)
+    {
+        for (int x = 0; x < src->width; x++, i++)
+        {
+            uint8_t color[4];
+            sw_get_pixel(color, src->pixels, sw_texture_texel_index(src, x, y), texture->format);
+            sw_set_texture_pixel(pixels, i, color, pixelFormat);
+        }
+    }
+}
+
+void swGenerateMipmap(void)
+{
+    sw_raster_finish(); // Pending primitives may still sample the bound texture
+
+    uint32_t id = RLSW.currentTexture;
+
+    if (!sw_is_texture_valid(id))
+    {
+        RLSW.errCode = SW_INVALID_OPERATION;
+        return;
+    }
+
+    sw_texture_t *texture = &RLSW.loadedTextures[id];
+
+    sw_texture_free_levels(texture, 1);
+
+    // Each level is a 2x2 box filter of the previous one, odd dimensions reuse the last texel
+    while (texture->levelCount < SW_MAX_TEXTURE_LEVELS)
+    {
+        const sw_texture_level_t *src = &texture->levels[texture->levelCount - 1];
+        if ((src->width == 1) && (src->height == 1)) break;
+
+        sw_texture_level_t *dst = &texture->levels[texture->levelCount];
+
+        if (!sw_texture_level_alloc(dst, sw_maxi(src->width/2, 1), sw_maxi(src->height/2, 1), texture->format))
+        {
+            *dst = SW_CURLY_INIT(sw_texture_level_t) { 0 };
+            RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory...
+            return;
+        }
+
+        for (int y = 0; y < dst->height; y++)
+        {
+            int y0 = sw_mini(2*y, src->hMinus1);
+            int y1 = sw_mini(2*y + 1, src->hMinus1);
+
+            for (int x = 0; x < dst->width; x++)
+            {
+                int x0 = sw_mini(2*x, src->wMinus1);
+                int x1 = sw_mini(2*x + 1, src->wMinus1);
+
+                uint8_t p00[4], p10[4], p01[4], p11[4], out[4];
+                sw_get_pixel(p00, src->pixels, sw_texture_texel_index(src, x0, y0), texture->format);
+                sw_get_pixel(p10, src->pixels, sw_texture_texel_index(src, x1, y0), texture->format);
+                sw_get_pixel(p01, src->pixels, sw_texture_texel_index(src, x0, y1), texture->format);
+                sw_get_pixel(p11, src->pixels, sw_texture_texel_index(src, x1, y1), texture->format);
+
+                for (int i = 0; i < 4; i++) out[i] = (uint8_t)((p00[i] + p10[i] + p01[i] + p11[i] + 2) >> 2);
+
+                sw_set_texture_pixel(dst->pixels, sw_texture_texel_index(dst, x, y), out, texture->format);
+            }
+        }
+
+        texture->levelCount++;
+    }
+}
+
+void swGenFramebuffers(int count, uint32_t *framebuffers)
+{
+    if ((count == 0) || (framebuffers == NULL)) return;
+
+    for (int i = 0; i < count; i++)
+    {
+        uint32_t id = 0;
+        if (RLSW.freeFramebufferIdCount > 0) id = RLSW.freeFramebufferIds[--RLSW.freeFramebufferIdCount];
+        else if (RLSW.loadedFramebufferCount < SW_MAX_FRAMEBUFFERS) id = RLSW.loadedFramebufferCount++;
+        else
+        {
+            RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory, not really stack overflow
+            return;
+        }
+
+        RLSW.loadedFramebuffers[id] = SW_CURLY_INIT(sw_fbo_t) { 0 };
+        RLSW.loadedFramebuffers[id].used = true;
+        framebuffers[i] = id;
+    }
+}
+
+void swDeleteFramebuffers(int count, uint32_t *framebuffers)
+{
+    if ((count == 0) || (framebuffers == NULL)) return;
+
+    for (int i = 0; i < count; i++)
+    {
+        uint32_t id = framebuffers[i];
+
+        if (!sw_is_framebuffer_valid(id))
+        {
+            RLSW.errCode = SW_INVALID_VALUE;
+            continue;
+        }
+
+        // Deleting the bound framebuffer object binds the main framebuffer
+        if (id == RLSW.currentFramebuffer) swBindFramebuffer(0);
+
+        // The attached textures keep the last rendered pixels
+        sw_fbo_t *fbo = &RLSW.loadedFramebuffers[id];
+        if ((fbo->colorTexture != 0) && (RLSW.loadedTextures[fbo->colorTexture].resolveFramebuffer == id)) sw_fbo_resolve_texture(fbo->colorTexture);
+        if ((fbo->depthTexture != 0) && (RLSW.loadedTextures[fbo->depthTexture].resolveFramebuffer == id)) sw_fbo_resolve_texture(fbo->depthTexture);
+
+        sw_framebuffer_unload(&fbo->storage);
+        *fbo = SW_CURLY_INIT(sw_fbo_t) { 0 };
+
+        RLSW.freeFramebufferIds[RLSW.freeFramebufferIdCount++] = id;
+    }
+}
+
+void swBindFramebuffer(uint32_t id)
+{
+    if (id == RLSW.currentFramebuffer) return;
+
+    if ((id != 0) && !sw_is_framebuffer_valid(id))
+    {
+        RLSW.errCode = SW_INVALID_OPERATION;
+        return;
+    }
+
+    sw_raster_finish(); // Pending primitives target the current framebuffer
+
+    // Store the current framebuffer, the attached textures are resolved when bound again
+    if (RLSW.currentFramebuffer == 0) RLSW.mainFramebuffer = RLSW.framebuffer;
+    else
+    {
+        sw_fbo_t *fbo = &RLSW.loadedFramebuffers[RLSW.currentFramebuffer];
+        fbo->storage = RLSW.framebuffer;
+
+        if (fbo->colorTexture != 0) RLSW.loadedTextures[fbo->colorTexture].resolveFramebuffer = RLSW.currentFramebuffer;
+        if (fbo->depthTexture != 0) RLSW.loadedTextures[fbo->depthTexture].resolveFramebuffer = RLSW.currentFramebuffer;
+    }
+
+    uint32_t prevFramebuffer = RLSW.currentFramebuffer;
+
+    RLSW.framebuffer = (id == 0)? RLSW.mainFramebuffer : RLSW.loadedFramebuffers[id].storage;
+    RLSW.currentFramebuffer = id;
+
+#if (SW_MAX_THREADS > 1)
+    // NOTE: Bins capacity only grows, it can't fail for a smaller framebuffer
+    if (!sw_binner_resize(&RLSW, RLSW.framebuffer.width, RLSW.framebuffer.height)) RLSW.errCode = SW_STACK_OVERFLOW;
+#endif
+
+    // The bound texture may be sampled without being bound again
+    if ((prevFramebuffer != 0) && (RLSW.loadedTextures[RLSW.currentTexture].resolveFramebuffer == prevFramebuffer))
+    {
+        sw_fbo_resolve_texture(RLSW.currentTexture);
+    }
+}
+
+void swFramebufferTexture2D(SWattachment attachment, uint32_t texture)
+{
+    uint32_t id = RLSW.currentFramebuffer;
+
+    if (id == 0)
+    {
+        RLSW.errCode = SW_INVALID_OPERATION;
+        return;
+    }
+
+    if ((attachment != SW_COLOR_ATTACHMENT0) && (attachment != SW_DEPTH_ATTACHMENT))
+    {
+        RLSW.errCode = SW_INVALID_ENUM;
+        return;
+    }
+
+    if ((texture >= SW_MAX_TEXTURES) || ((texture != 0) && (RLSW.loadedTextures[texture].levels[0].pixels == NULL)))
+    {
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
+
+    sw_raster_finish(); // Pending primitives target the current storage
+
+    sw_fbo_t *fbo = &RLSW.loadedFramebuffers[id];
+    bool isDepth = (attachment == SW_DEPTH_ATTACHMENT);
+    uint32_t *slot = isDepth? &fbo->depthTexture : &fbo->colorTexture;
+
+    // The replaced texture keeps the pixels rendered so far
+    if ((*slot != 0) && (RLSW.loadedTextures[*slot].resolveFramebuffer == id)) sw_fbo_resolve_texture(*slot);
+
+    *slot = texture;
+
+    if (texture == 0) return;
+
+    // The storage takes the color attachment dimensions, or the depth attachment ones without color
+    const sw_texture_level_t *base = &RLSW.loadedTextures[(fbo->colorTexture != 0)? fbo->colorTexture : fbo->depthTexture].levels[0];
+
+    if ((RLSW.framebuffer.colors == NULL) || (RLSW.framebuffer.width != base->width) || (RLSW.framebuffer.height != base->height))
+    {
+        int w = base->width, h = base->height;
+
+        bool loaded = (RLSW.framebuffer.colors == NULL)?
+            sw_framebuffer_load(&RLSW.framebuffer, w, h) : sw_framebuffer_resize(&RLSW.framebuffer, w, h);
+
+#if (SW_MAX_THREADS > 1)
+        if (loaded) loaded = sw_binner_resize(&RLSW, w, h);
+#endif
+        if (!loaded)
+        {
+            RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory...
+            return;
+        }
+
+        // Attachments not specified yet are cleared to the default values
+        sw_pixel_t clearValue = { 0 };
+        const float clearColor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        sw_framebuffer_write_color(&clearValue.color, clearColor);
+        sw_framebuffer_write_depth(&clearValue.depth, 1.0f);
+
+        for (int i = 0; i < w*h; i++)
+        {
+            RLSW.framebuffer.colors[i] = clearValue.color;
+            RLSW.framebuffer.depths[i] = clearValue.depth;
+        }
+        sw_framebuffer_set_depth_tiles(&RLSW.framebuffer, 1.0f, 1.0f);
+
+        // Attachments specified before keep their contents
+        uint32_t other = isDepth? fbo->colorTexture : fbo->depthTexture;
+        if (other != 0) sw_fbo_load_texture(other, !isDepth);
+    }
+
+    // The texture may hold pixels rendered by another framebuffer object
+    if (RLSW.loadedTextures[texture].resolveFramebuffer != 0) sw_fbo_resolve_texture(texture);
+
+    sw_fbo_load_texture(texture, isDepth);
+}
+
+SWfbstatus swCheckFramebufferStatus(void)
+{
+    if (RLSW.currentFramebuffer == 0) return SW_FRAMEBUFFER_COMPLETE;
+
+    const sw_fbo_t *fbo = &RLSW.loadedFramebuffers[RLSW.currentFramebuffer];
+    SWfbstatus status = SW_FRAMEBUFFER_COMPLETE;
+
+    if ((fbo->colorTexture == 0) && (fbo->depthTexture == 0)) status = SW_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT;
+    else if (RLSW.framebuffer.colors == NULL) status = SW_FRAMEBUFFER_UNSUPPORTED;
+    else if ((fbo->colorTexture != 0) && (fbo->depthTexture != 0))
+    {
+        // NOTE: Attachments must share the same dimensions, as in OpenGL ES 2.0
+        const sw_texture_level_t *color = &RLSW.loadedTextures[fbo->colorTexture].levels[0];
+        const sw_texture_level_t *depth = &RLSW.loadedTextures[fbo->depthTexture].levels[0];
+
+        if ((color->width != depth->width) || (color->height != depth->height)) status = SW_FRAMEBUFFER_INCOMPLETE_ATTACHMENT;
+    }
+
+    return status;
+}
+
+void swGetFramebufferAttachmentParameteriv(SWattachment attachment, SWattachget pname, int *v)
+{
+    if ((RLSW.currentFramebuffer == 0) || (v == NULL))
+    {
+        RLSW.errCode = SW_INVALID_OPERATION;
+        return;
+    }
+
+    const sw_fbo_t *fbo = &RLSW.loadedFramebuffers[RLSW.currentFramebuffer];
+    uint32_t texture = 0;
+
+    switch (attachment)
+    {
+        case SW_COLOR_ATTACHMENT0: texture = fbo->colorTexture; break;
+        case SW_DEPTH_ATTACHMENT: texture = fbo->depthTexture; break;
+        default: RLSW.errCode = SW_INVALID_ENUM; return;
+    }
+
+    switch (pname)
+    {
+        case SW_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE: *v = (texture != 0)? GL_TEXTURE : GL_NONE; break;
+        case SW_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME: *v = (int)texture; break;
+        default: RLSW.errCode = SW_INVALID_ENUM; break;
+    }
+}
+
 #endif // RLSW_IMPLEMENTATION
@@ -3,7 +3,7 @@
 *   rcore_memory - Functions to manage window, graphics device and inputs
 *
 *   PLATFORM: MEMORY (No OS)
-*       - Memory framebuffer output (no os)
+*       - Memory framebuffer output (no os), rendered directly into memory when possible
 *
 *   LIMITATIONS:
 *       - Software renderer (rlsw)
@@ -57,13 +57,14 @@
 //----------------------------------------------------------------------------------
 // Platform-specific required data for timming (Win32)
 #if defined(_WIN32)
-typedef struct _LARGE_INTEGER { int64_t QuadPart; } LARGE_INTEGER;
+typedef union _LARGE_INTEGER { int64_t QuadPart; } LARGE_INTEGER;   // NOTE: Same tag as windows.h, also declared by rlsw
 __declspec(dllimport) int __stdcall QueryPerformanceCounter(LARGE_INTEGER *lpPerformanceCount);
 __declspec(dllimport) int __stdcall QueryPerformanceFrequency(LARGE_INTEGER *lpFrequency);
 #endif
 
 typedef struct {
     unsigned int *pixels;   // Pointer to pixel data buffer (RGBA8888 format)
+    bool pixelsBindTried;   // Pixel data buffer binding as renderer framebuffer memory was tried
 #if defined(_WIN32)
     LARGE_INTEGER timerFrequency;
 #endif
@@ -351,8 +352,35 @@ void DisableCursor(void)
 // Swap back buffer with front buffer (screen drawing)
 void SwapScreenBuffer(void)
 {
-    // Update framebuffer
-    rlCopyFramebuffer(0, 0, CORE.Window.render.width, CORE.Window.render.height, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, platform.pixels);
+    // Get region changed since last frame, available to the user with GetScreenDirtyRec()
+    int x = 0, y = 0, width = 0, height = 0;
+    rlGetFramebufferDirtyRect(&x, &y, &width, &height, true);
+    CORE.Window.dirtyRec = (Rectangle){ (float)x, (float)y, (float)width, (float)height };
+
+    // Framebuffer memory is already up to date when rendering directly into it
+    if (rlGetFramebufferMemory() != NULL) return;
+
+    // Update framebuffer changed region
+    // NOTE: Pixel data buffer rows are contiguous only when the region covers the full width
+    int stride = CORE.Window.render.width;
+    if (width == stride) rlCopyFramebuffer(0, y, width, height, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, platform.pixels + y*stride);
+    else
+    {
+        for (int row = y; row < (y + height); row++)
+        {
+            rlCopyFramebuffer(x, row, width, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, platform.pixels + row*stride + x);
+        }
+    }
+
+    // Render next frames directly into the pixel data buffer, avoiding the copy
+    // NOTE: Only tried once, it fails (logging an info) if renderer color buffer format does not match,
+    // user can still provide its own memory with rlSetFramebufferMemory()
+    if (!platform.pixelsBindTried)
+    {
+        rlSetFramebufferMemory(platform.pixels, CORE.Window.render.width, CORE.Window.render.height,
+            CORE.Window.render.width*sizeof(unsigned int), PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        platform.pixelsBindTried = true;
+    }
 }
 
 //----------------------------------------------------------------------------------
@@ -315,6 +315,7 @@ typedef struct CoreData {
         Size screenMin;                     // Screen minimum width and height (for resizable window)
         Size screenMax;                     // Screen maximum width and height (for resizable window)
         Matrix screenScale;                 // Matrix to scale screen (framebuffer rendering)
+        Rectangle dirtyRec;                 // Screen framebuffer region changed by last frame (PLATFORM_MEMORY)
 
         char **dropFilepaths;               // Store dropped files paths pointers (provided by GLFW)
         unsigned int dropFileCount;         // Count dropped files strings
@@ -709,6 +710,9 @@ void InitWindow(int width, int height, const char *title)
     // NOTE: Current fbo size stored as globals in rlgl for convenience
     rlglInit(CORE.Window.render.width, CORE.Window.render.height);
 
+    // Software renderer has no multisampled window framebuffer, MSAA is enabled in the renderer itself
+    if (FLAG_IS_SET(CORE.Window.flags, FLAG_MSAA_4X_HINT) && (rlGetVersion() == RL_OPENGL_11_SOFTWARE)) rlEnableMultisample();
+
     // Setup default viewport
     SetupViewport(CORE.Window.render.width, CORE.Window.render.height);
 
@@ -851,6 +855,19 @@ int GetRenderHeight(void)
     return height;
 }
 
+// Get screen region changed by last frame, in screen framebuffer (render size) coordinates
+// NOTE: Only tracked by the software renderer on PLATFORM_MEMORY, full screen returned otherwise
+Rectangle GetScreenDirtyRec(void)
+{
+    Rectangle rec = { 0.0f, 0.0f, (float)CORE.Window.render.width, (float)CORE.Window.render.height };
+
+#if defined(PLATFORM_MEMORY)
+    rec = CORE.Window.dirtyRec;
+#endif
+
+    return rec;
+}
+
 // Enable waiting for events on EndDrawing(), no automatic event polling
 void EnableEventWaiting(void)
 {
@@ -43,11 +43,31 @@
 *       #define RLGL_ENABLE_OPENGL_DEBUG_CONTEXT
 *           Enable debug context (only available on OpenGL 4.3)
 *
+*       #define RLGL_RENDER_BATCH_INTERLEAVED
+*           Use a compact interleaved vertex layout for the render batch (position, texcoords, color),
+*           stored in a single vertex buffer and uploaded once per batch draw (24 bytes per vertex instead of 36)
+*
+*       #define RLGL_RENDER_BATCH_NORMALS
+*           Keep normals (packed to 8-bit) in the interleaved render batch vertex layout,
+*           only required by custom shaders using vertex normals on rlBegin()/rlEnd() drawing
+*
+*       #define RLGL_RENDER_BATCH_THREADS
+*           Support render batch contexts (rlLoadBatchContext()), filled by worker threads in parallel
+*           and drawn by the main thread, rlgl state is accessed through a thread-local pointer;
+*           blending mode, shader and scissor set from a context thread are recorded with its data,
+*           other GL state functions fail with an error log (GL context is only current on main thread)
+*
+*       #define RLGL_RENDER_BATCH_STREAMING
+*           Stream render batch vertex data through a ring of RL_DEFAULT_BATCH_STREAM_BUFFERS vertex buffers,
+*           persistently mapped and fenced if supported (GL_ARB_buffer_storage) or orphaned on every upload,
+*           so CPU writes never wait for the GPU to finish reading the previous batch
+*
 *       rlgl capabilities could be customized just defining some internal
 *       values before library inclusion (default values listed):
 *
 *       #define RL_DEFAULT_BATCH_BUFFER_ELEMENTS   8192    // Default internal render batch elements limits
 *       #define RL_DEFAULT_BATCH_BUFFERS              1    // Default number of batch buffers (multi-buffering)
+*       #define RL_DEFAULT_BATCH_STREAM_BUFFERS       3    // Default number of batch buffers on streaming mode (ring buffering)
 *       #define RL_DEFAULT_BATCH_DRAWCALLS          256    // Default number of batch draw calls (by state changes: mode, texture)
 *       #define RL_DEFAULT_BATCH_MAX_TEXTURE_UNITS    4    // Maximum number of textures units that can be activated on batch drawing (SetShaderValueTexture())
 *
@@ -213,6 +233,9 @@
 #ifndef RL_DEFAULT_BATCH_BUFFERS
     #define RL_DEFAULT_BATCH_BUFFERS                 1      // Default number of batch buffers (multi-buffering)
 #endif
+#ifndef RL_DEFAULT_BATCH_STREAM_BUFFERS
+    #define RL_DEFAULT_BATCH_STREAM_BUFFERS          3      // Default number of batch buffers on streaming mode (ring buffering)
+#endif
 #ifndef RL_DEFAULT_BATCH_DRAWCALLS
     #define RL_DEFAULT_BATCH_DRAWCALLS             256      // Default number of batch draw calls (by state changes: mode, texture)
 #endif
@@ -378,10 +401,22 @@ typedef struct Matrix {
 #define RL_MATRIX_TYPE
 #endif
 
+// Render batch vertex, interleaved layout (24 bytes, 28 bytes with normals)
+// NOTE: Only used with RLGL_RENDER_BATCH_INTERLEAVED, texture coordinates keep full float range (repeat wrapping)
+typedef struct rlBatchVertex {
+    float position[3];          // Vertex position (XYZ) (shader-location = 0)
+    float texcoord[2];          // Vertex texture coordinates (UV) (shader-location = 1)
+    unsigned char color[4];     // Vertex color (RGBA) (shader-location = 3)
+#if defined(RLGL_RENDER_BATCH_NORMALS)
+    signed char normal[4];      // Vertex normal, normalized (XYZ, W unused) (shader-location = 2)
+#endif
+} rlBatchVertex;
+
 // Dynamic vertex buffers (position + texcoords + colors + indices arrays)
 typedef struct rlVertexBuffer {
     int elementCount;           // Number of elements in the buffer (QUADS)
 
+    // NOTE: Separate vertex arrays are NULL with RLGL_RENDER_BATCH_INTERLEAVED, vertex data is in data array
     float *vertices;            // Vertex position (XYZ - 3 components per vertex) (shader-location = 0)
     float *texcoords;           // Vertex texture coordinates (UV - 2 components per vertex) (shader-location = 1)
     float *normals;             // Vertex normal (XYZ - 3 components per vertex) (shader-location = 2)
@@ -394,6 +429,9 @@ typedef struct rlVertexBuffer {
 #endif
     unsigned int vaoId;         // OpenGL Vertex Array Object id
     unsigned int vboId[5];      // OpenGL Vertex Buffer Objects id (5 types of vertex data)
+    void *mapped[4];            // Vertex buffers persistently mapped memory (NULL if not mapped) (RLGL_RENDER_BATCH_STREAMING only)
+    void *fence;                // Fence sync object, signaled when GPU completes the last draw using the buffers (RLGL_RENDER_BATCH_STREAMING only)
+    rlBatchVertex *data;        // Vertex data, all attributes interleaved (4 vertex per element) (RLGL_RENDER_BATCH_INTERLEAVED only)
 } rlVertexBuffer;
 
 // Draw call type
@@ -412,6 +450,11 @@ typedef struct rlDrawCall {
     //Matrix modelview;         // Modelview matrix for this draw -> Using RLGL.modelview by default
 } rlDrawCall;
 
+// Opaque structs declaration
+// NOTE: Actual structs are defined internally in rlgl module
+typedef struct rlBatchSortData rlBatchSortData;
+typedef struct rlDrawState rlDrawState;
+
 // rlRenderBatch type
 typedef struct rlRenderBatch {
     int bufferCount;            // Number of vertex buffers (multi-buffering support)
@@ -421,8 +464,69 @@ typedef struct rlRenderBatch {
     rlDrawCall *draws;          // Draw calls array, depends on textureId
     int drawCounter;            // Draw calls counter
     float currentDepth;         // Current depth value for next draw
+
+    rlBatchSortData *sortData;  // Draws sorting scratch data (internal, allocated on first sort)
 } rlRenderBatch;
 
+// Command buffer type, draws recorded once and replayed many times
+// NOTE: On OpenGL 3.3/ES2 vertex data is uploaded to static buffers and CPU arrays are released,
+// on OpenGL 1.1 (and software renderer) vertex data is kept on CPU, already transformed
+typedef struct rlCommandBuffer {
+    int vertexCount;            // Number of vertex recorded
+    float *vertices;            // Vertex position (XYZ - 3 components per vertex)
+    float *texcoords;           // Vertex texture coordinates (UV - 2 components per vertex)
+    unsigned char *colors;      // Vertex colors (RGBA - 4 components per vertex)
+
+    rlDrawCall *draws;          // Draw calls array, one per mode, texture and state change
+    rlDrawState *states;        // Draw calls state: blending, shader, scissor (internal, one per draw)
+    int drawCount;              // Draw calls counter
+
+    unsigned int vaoId;         // OpenGL Vertex Array Object id
+    unsigned int vboId[3];      // OpenGL Vertex Buffer Objects id (position, texcoord, color)
+} rlCommandBuffer;
+
+typedef struct rlBatchContextState rlBatchContextState;
+
+// Render batch context, a render batch filled from a worker thread
+// NOTE: Vertex data is recorded with rlgl functions by the thread owning the context (rlBeginBatchContext()),
+// the main thread draws it in the required order (rlDrawBatchContext()), with current matrices and the
+// blending mode, shader and scissor set by the context thread
+typedef struct rlBatchContext {
+    rlRenderBatch batch;            // Render batch filled by the context
+    rlBatchContextState *state;     // Context rlgl state (internal)
+} rlBatchContext;
+
+// Software renderer CPU programs, replacing the shaders stages (software backend only)
+// NOTE: Vertex program gets the object space position (xyzw), fragment program gets the vertex color to
+// replace, the texel sampled at texcoord and the fragment coordinates, colors are RGBA normalized
+typedef void (*rlVertexProcCallback)(float *position, float *texcoord, float *color, const void *uniforms);
+typedef void (*rlFragmentProcCallback)(float *color, const float *texColor, const float *texcoord, int x, int y, const void *uniforms);
+
+// Software renderer statistics, accumulated since the last reset (software backend only)
+// NOTE: Requires the software renderer compiled with SW_ENABLE_STATS, times in milliseconds
+typedef struct rlSoftwareStats {
+    unsigned long long drawCalls;           // Draw calls (vertex arrays draws and immediate mode batches)
+    unsigned long long vertices;            // Vertices transformed
+    unsigned long long primitives;          // Primitives assembled (points, lines, triangles, quads)
+    unsigned long long primitivesCulled;    // Primitives discarded by face culling
+    unsigned long long primitivesClipped;   // Primitives discarded by clipping
+    unsigned long long primitivesAffine;    // Triangles and quads rasterized without perspective division (2D draws)
+    unsigned long long pixelsShaded;        // Fragments written to the color buffer
+    unsigned long long pixelsDepthRejected; // Fragments failing the depth test
+    unsigned long long texelsFetched;       // Texels read by texture sampling
+    double clearTime;                       // Time spent clearing
+    double rasterTime;                      // Time spent rasterizing (summed over the rasterization threads)
+    double copyTime;                        // Time spent copying the framebuffer
+} rlSoftwareStats;
+
+// Render batch upload statistics, accumulated since the last reset (OpenGL 3.3 and ES2 only)
+typedef struct rlRenderBatchStats {
+    unsigned long long uploads;             // Vertex buffer uploads (one per vertex buffer updated)
+    unsigned long long uploadBytes;         // Vertex data bytes uploaded (or copied to mapped buffers)
+    unsigned long long orphans;             // Vertex buffer storage orphaned before an upload (streaming mode)
+    unsigned long long fenceWaits;          // Waits for the GPU to release a ring buffer (streaming mode, stalls)
+} rlRenderBatchStats;
+
 // OpenGL version
 typedef enum {
     RL_OPENGL_11_SOFTWARE = 0,  // Software rendering
@@ -691,6 +795,8 @@ RLAPI void rlSetLineWidth(float width);                 // Set the line drawing
 RLAPI float rlGetLineWidth(void);                       // Get the line drawing width
 RLAPI void rlEnableSmoothLines(void);                   // Enable line aliasing
 RLAPI void rlDisableSmoothLines(void);                  // Disable line aliasing
+RLAPI void rlEnableMultisample(void);                   // Enable multisample anti-aliasing (MSAA)
+RLAPI void rlDisableMultisample(void);                  // Disable multisample anti-aliasing (MSAA)
 RLAPI void rlEnableStereoRender(void);                  // Enable stereo rendering
 RLAPI void rlDisableStereoRender(void);                 // Disable stereo rendering
 RLAPI bool rlIsStereoRenderEnabled(void);               // Check if stereo render is enabled
@@ -711,6 +817,8 @@ RLAPI void rlglClose(void);                             // De-initialize rlgl (b
 RLAPI void rlLoadExtensions(void *loader);              // Load OpenGL extensions (loader function required)
 RLAPI void *rlGetProcAddress(const char *procName);     // Get OpenGL procedure address
 RLAPI int rlGetVersion(void);                           // Get current OpenGL version
+RLAPI bool rlGetSoftwareStats(rlSoftwareStats *stats, bool reset); // Get software renderer statistics since last reset, false if not available
+RLAPI bool rlGetRenderBatchStats(rlRenderBatchStats *stats, bool reset); // Get render batch upload statistics since last reset, false if not available
 RLAPI void rlSetFramebufferWidth(int width);            // Set current framebuffer width
 RLAPI int rlGetFramebufferWidth(void);                  // Get default framebuffer width
 RLAPI void rlSetFramebufferHeight(int height);          // Set current framebuffer height
@@ -729,6 +837,17 @@ RLAPI void rlDrawRenderBatch(rlRenderBatch *batch);     // Draw render batch dat
 RLAPI void rlSetRenderBatchActive(rlRenderBatch *batch); // Set the active render batch for rlgl (NULL for default internal)
 RLAPI void rlDrawRenderBatchActive(void);               // Update and draw internal render batch
 RLAPI bool rlCheckRenderBatchLimit(int vCount);         // Check internal buffer overflow for a given number of vertex
+RLAPI void rlEnableRenderBatchSort(void);               // Enable render batch draws sorting by texture (orthographic 2D only, non-overlapping draws are reordered)
+RLAPI void rlDisableRenderBatchSort(void);              // Disable render batch draws sorting, draws submitted in order
+RLAPI void rlBeginCommandBuffer(void);                  // Begin recording draws into a command buffer (draws are not rendered)
+RLAPI rlCommandBuffer rlEndCommandBuffer(void);         // End recording draws, returns recorded command buffer
+RLAPI void rlDrawCommandBuffer(rlCommandBuffer buffer, Matrix transform, const float *tint); // Draw command buffer with a transform and a tint (RGBA normalized, NULL for none)
+RLAPI void rlUnloadCommandBuffer(rlCommandBuffer buffer); // Unload command buffer data (CPU and GPU)
+RLAPI rlBatchContext rlLoadBatchContext(int bufferElements); // Load a render batch context, to be filled by a worker thread
+RLAPI void rlUnloadBatchContext(rlBatchContext context); // Unload render batch context
+RLAPI void rlBeginBatchContext(rlBatchContext *context); // Begin filling render batch context from calling thread (rlgl vertex functions, blending, shader and scissor are recorded)
+RLAPI void rlEndBatchContext(void);                     // End filling render batch context from calling thread
+RLAPI void rlDrawBatchContext(rlBatchContext *context); // Draw render batch context data (main thread), context is reset
 
 RLAPI void rlSetTexture(unsigned int id);               // Set current texture for render batch and check buffers limits
 
@@ -749,6 +868,7 @@ RLAPI void rlDrawVertexArray(int offset, int count);    // Draw vertex array (cu
 RLAPI void rlDrawVertexArrayElements(int offset, int count, const void *buffer); // Draw vertex array elements
 RLAPI void rlDrawVertexArrayInstanced(int offset, int count, int instances); // Draw vertex array (currently active vao) with instancing
 RLAPI void rlDrawVertexArrayElementsInstanced(int offset, int count, const void *buffer, int instances); // Draw vertex array elements with instancing
+RLAPI void rlDrawVertexArrayTransformsInstanced(int offset, int count, const void *buffer, const float *transforms, int instances); // Draw vertex array (elements if buffer provided) once per instance transform (OpenGL 1.1 only)
 
 // Textures management
 RLAPI unsigned int rlLoadTexture(const void *data, int width, int height, int format, int mipmapCount); // Load texture data
@@ -770,6 +890,9 @@ RLAPI void rlUnloadFramebuffer(unsigned int id);                          // Del
 // WARNING: Copy and resize framebuffer functionality only defined for software backend
 RLAPI void rlCopyFramebuffer(int x, int y, int width, int height, int format, void *pixels); // Copy framebuffer pixel data to internal buffer
 RLAPI void rlResizeFramebuffer(int width, int height);                    // Resize internal framebuffer
+RLAPI bool rlSetFramebufferMemory(void *pixels, int width, int height, int stride, int format); // Set user memory as framebuffer color buffer, rendering directly into it (NULL restores internal)
+RLAPI bool rlGetFramebufferDirtyRect(int *x, int *y, int *width, int *height, bool reset); // Get framebuffer region changed since last reset, false if none
+RLAPI void *rlGetFramebufferMemory(void);                                 // Get user memory set as framebuffer color buffer, rendering finished (NULL if internal)
 
 // Shaders management
 RLAPI unsigned int rlLoadShaderCode(const char *vsCode, const char *fsCode);    // Load shader from code strings
@@ -783,6 +906,9 @@ RLAPI void rlSetUniformMatrix(int locIndex, Matrix mat);
 RLAPI void rlSetUniformMatrices(int locIndex, const Matrix *mat, int count);    // Set shader value matrices
 RLAPI void rlSetUniformSampler(int locIndex, unsigned int textureId);           // Set shader value sampler
 RLAPI void rlSetShader(unsigned int id, int *locs);                             // Set shader currently active (id and locations)
+// WARNING: CPU programs functionality only defined for software backend
+RLAPI void rlSetSoftwareProgram(rlVertexProcCallback vertexProc, rlFragmentProcCallback fragmentProc); // Set CPU vertex/fragment programs (NULL for fixed function)
+RLAPI void rlSetSoftwareProgramUniforms(const void *data, int size);           // Set CPU programs uniforms block (copied)
 
 // Compute shader management
 RLAPI unsigned int rlLoadComputeShaderProgram(unsigned int shaderId);           // Load compute shader program
@@ -903,6 +1029,7 @@ RLAPI void rlLoadDrawQuad(void);     // Load and draw a quad
 
 #include <stdlib.h>                     // Required for: calloc(), free()
 #include <string.h>                     // Required for: strcmp(), strlen() [Used in rlglInit(), on extensions loading]
+#include <stddef.h>                     // Required for: offsetof() [Used in rlLoadRenderBatch(), interleaved layout]
 #include <math.h>                       // Required for: sqrtf(), sinf(), cosf(), floor(), log()
 
 //----------------------------------------------------------------------------------
@@ -1050,9 +1177,33 @@ RLAPI void rlLoadDrawQuad(void);     // Load and draw a quad
     #define RL_DEFAULT_SHADER_SAMPLER2D_NAME_TEXTURE2  "texture2"          // texture2 (texture slot active 2)
 #endif
 
+#if defined(RLGL_RENDER_BATCH_THREADS)
+    #if defined(_MSC_VER)
+        #define RL_THREAD_LOCAL __declspec(thread)
+    #else
+        #define RL_THREAD_LOCAL __thread
+    #endif
+#endif
+
+// Bounds kept by render batch sorting, one per run of touching primitives of every draw
+// NOTE: Bounds are joined when exceeded, sorting is still correct but merges less draws
+#define RL_BATCH_SORT_MAX_BOUNDS    (RL_DEFAULT_BATCH_DRAWCALLS*4)
+
 //----------------------------------------------------------------------------------
 // Module Types and Structures Definition
 //----------------------------------------------------------------------------------
+// Draw state, recorded with command buffer draws and render batch context chunks, applied when they are drawn
+// NOTE: Compared with memcmp(), states are cleared before being filled
+struct rlDrawState {
+    int blendMode;                      // Blending mode
+    int blendFactors[3];                // Custom blending factors and equation (rlSetBlendFactors())
+    int blendFactorsSeparate[6];        // Custom blending separate factors and equations (rlSetBlendFactorsSeparate())
+    unsigned int shaderId;              // Shader program id
+    int *shaderLocs;                    // Shader locations pointer
+    bool scissorEnabled;                // Scissor test enabled
+    int scissor[4];                     // Scissor rectangle (x, y, width, height)
+};
+
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
 
 typedef void *(*rlglLoadProc)(const char *name);   // OpenGL extension functions loader signature (same as GLADloadproc)
@@ -1068,6 +1219,9 @@ typedef struct rlglData {
         float texcoordx, texcoordy;         // Current active texture coordinate (added on glVertex*())
         float normalx, normaly, normalz;    // Current active normal (added on glVertex*())
         unsigned char colorr, colorg, colorb, colora;   // Current active color (added on glVertex*())
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+        signed char normalPacked[3];        // Current active normal, normalized (interleaved batch layout)
+#endif
 
         int currentMatrixMode;              // Current matrix mode
         Matrix *currentMatrix;              // Current matrix pointer
@@ -1088,6 +1242,7 @@ typedef struct rlglData {
         unsigned int currentShaderId;       // Current shader id to be used on rendering (by default, defaultShaderId)
         int *currentShaderLocs;             // Current shader locations pointer to be used on rendering (by default, defaultShaderLocs)
 
+        bool batchSortEnabled;              // Render batch draws sorting flag (merging draws by texture)
         bool stereoRender;                  // Stereo rendering flag
         Matrix projectionStereo[2];         // VR stereo rendering eyes projection matrices
         Matrix viewOffsetStereo[2];         // VR stereo rendering eyes view offset matrices
@@ -1105,6 +1260,10 @@ typedef struct rlglData {
         int glBlendEquationAlpha;           // Blending equation for alpha
         bool glCustomBlendModeModified;     // Custom blending factor and equation modification status
 
+        // Scissor variables
+        bool scissorEnabled;                // Scissor test enabled
+        int scissor[4];                     // Scissor rectangle (x, y, width, height)
+
         int framebufferWidth;               // Current framebuffer width
         int framebufferHeight;              // Current framebuffer height
 
@@ -1126,6 +1285,7 @@ typedef struct rlglData {
         bool texAnisoFilter;                // Anisotropic texture filtering support (GL_EXT_texture_filter_anisotropic)
         bool computeShader;                 // Compute shaders support (GL_ARB_compute_shader)
         bool ssbo;                          // Shader storage buffer object support (GL_ARB_shader_storage_buffer_object)
+        bool bufferStorage;                 // Immutable buffer storage support, persistent mapping (GL_ARB_buffer_storage)
 
         float maxAnisotropyLevel;           // Maximum anisotropy level supported (minimum is 2.0f)
         int maxDepthBits;                   // Maximum bits for depth component
@@ -1133,8 +1293,87 @@ typedef struct rlglData {
     } ExtSupported;     // Extensions supported flags
 } rlglData;
 
+#if defined(RLGL_RENDER_BATCH_STREAMING)
+// Render batch streaming GL functions, vertex buffers storage, updates and synchronization
+// NOTE: Set from the loaded GL functions by rlLoadRenderBatch(), entries already set are kept,
+// so a mock GL layer can replace them (headless tests including the implementation)
+typedef struct rlStreamingProcs {
+    PFNGLBUFFERDATAPROC bufferData;                 // glBufferData(), storage allocation and orphaning
+    PFNGLBUFFERSUBDATAPROC bufferSubData;           // glBufferSubData(), orphaned buffers updates
+#if defined(GRAPHICS_API_OPENGL_33) && !defined(GRAPHICS_API_OPENGL_21)
+    PFNGLBUFFERSTORAGEPROC bufferStorage;           // glBufferStorage(), immutable storage (GL_ARB_buffer_storage)
+    PFNGLMAPBUFFERRANGEPROC mapBufferRange;         // glMapBufferRange(), persistent mapping
+    PFNGLFENCESYNCPROC fenceSync;                   // glFenceSync()
+    PFNGLCLIENTWAITSYNCPROC clientWaitSync;         // glClientWaitSync()
+    PFNGLDELETESYNCPROC deleteSync;                 // glDeleteSync()
+#endif
+} rlStreamingProcs;
+#endif
+
+// Render batch draws sorting data, allocated once per batch
+// NOTE: Sorted vertex data is written to the scratch arrays, swapped with the batch buffer arrays
+struct rlBatchSortData {
+    rlVertexBuffer buffer;                                  // Scratch vertex arrays (same size as batch buffers)
+    int drawGroup[RL_DEFAULT_BATCH_DRAWCALLS];              // Group of every draw (-1 if empty)
+    int drawOffset[RL_DEFAULT_BATCH_DRAWCALLS];             // First vertex of every draw
+    int drawFirstBounds[RL_DEFAULT_BATCH_DRAWCALLS];        // First bounds of every draw (-1 if empty)
+    int groupOffset[RL_DEFAULT_BATCH_DRAWCALLS];            // First draw of every group, then first vertex
+    int groupCount[RL_DEFAULT_BATCH_DRAWCALLS];             // Vertex count of every group
+    float groupBounds[RL_DEFAULT_BATCH_DRAWCALLS*4];        // Bounds of every group, on XY plane (all group draws)
+    int groupFirstBounds[RL_DEFAULT_BATCH_DRAWCALLS];       // First draw bounds of every group
+    int groupLastBounds[RL_DEFAULT_BATCH_DRAWCALLS];        // Last draw bounds of every group
+    rlDrawCall groupDraws[RL_DEFAULT_BATCH_DRAWCALLS];      // Draw of every group
+
+    // Bounds of the draws merged into every group, kept across the sorts of a batch until it is drawn
+    float bounds[RL_BATCH_SORT_MAX_BOUNDS*4];               // Primitives bounds, on XY plane
+    float sortedBounds[RL_BATCH_SORT_MAX_BOUNDS*4];         // Primitives bounds, rearranged by groups
+    int boundsDraw[RL_BATCH_SORT_MAX_BOUNDS];               // Draw of every bounds
+    int boundsNext[RL_BATCH_SORT_MAX_BOUNDS];               // Next bounds of same draw or group (-1 if last)
+    int boundsCount;                                        // Draws bounds count
+    int drawBoundedCount[RL_DEFAULT_BATCH_DRAWCALLS];       // Vertex covered by bounds of every draw
+    int boundedDraws;                                       // Draws with bounds (groups of previous sort)
+};
+
+#if defined(RLGL_RENDER_BATCH_THREADS)
+// Render batch data filled by a context thread, pending to be drawn
+// NOTE: Vertex arrays are swapped with the batch when full, no copy required
+typedef struct rlBatchChunk {
+    rlVertexBuffer buffer;              // Vertex buffer CPU arrays
+    rlDrawCall *draws;                  // Draw calls array
+    int drawCounter;                    // Draw calls counter
+    int vertexCounter;                  // Vertex counter
+    rlDrawState state;                  // Draw state the chunk data was filled with
+} rlBatchChunk;
+
+// Render batch context state
+struct rlBatchContextState {
+    rlglData rlgl;                      // rlgl state used by the context thread
+    rlBatchChunk *chunks;               // Filled batches, drawn before current batch data
+    int chunkCount;                     // Filled batches counter
+    int chunkCapacity;                  // Allocated chunks, the ones after filled batches keep drawn arrays for reuse
+    rlDrawState state;                  // Draw state of the context batch data, set by rlEndBatchContext()
+};
+#endif
+
 #endif  // GRAPHICS_API_OPENGL_33 || GRAPHICS_API_OPENGL_ES2
 
+// Command buffer recording state
+typedef struct rlCommandRecorder {
+    bool active;                        // Recording draws, they are not rendered
+    rlCommandBuffer buffer;             // Command buffer being recorded
+    int vertexCapacity;                 // Vertex arrays capacity (number of vertex)
+    int drawCapacity;                   // Draws array capacity
+    bool failed;                        // Arrays allocation failed, next draws are discarded
+#if defined(GRAPHICS_API_OPENGL_11)
+    float texcoord[2];                  // Current vertex texture coordinates
+    unsigned char color[4];             // Current vertex color
+    unsigned int textureId;             // Current texture id, 0 for no texture
+    Matrix modelviewInverse;            // Inverse of modelview matrix when recording started
+    Matrix transform;                   // Modelview matrix relative to recording start
+    bool transformRequired;             // Relative transform is not identity
+#endif
+} rlCommandRecorder;
+
 //----------------------------------------------------------------------------------
 // Global Variables Definition
 //----------------------------------------------------------------------------------
@@ -1142,8 +1381,37 @@ static double rlCullDistanceNear = RL_CULL_DISTANCE_NEAR;
 static double rlCullDistanceFar = RL_CULL_DISTANCE_FAR;
 
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+#if defined(RLGL_RENDER_BATCH_THREADS)
+// NOTE: rlgl state is accessed through a thread-local pointer, threads filling
+// a render batch context use the context state instead of the main one
+static rlglData rlglMain = { 0 };
+static RL_THREAD_LOCAL rlglData *rlglCurrent = &rlglMain;
+static RL_THREAD_LOCAL rlBatchContextState *rlThreadContext = NULL;
+#define RLGL (*rlglCurrent)
+
+// GL state functions fail on a render batch context thread, GL context is current on main thread only
+// NOTE: Blending mode, shader and scissor are not set but recorded with the context data
+#define RLGL_THREAD_CONTEXT_ACTIVE (rlThreadContext != NULL)
+#define RLGL_CHECK_THREAD_CONTEXT() if (RLGL_THREAD_CONTEXT_ACTIVE) { TRACELOG(RL_LOG_ERROR, "RLGL: %s() failed, GL not available from render batch context thread", __func__); return; }
+#else
 static rlglData RLGL = { 0 };
+#endif
 #endif  // GRAPHICS_API_OPENGL_33 || GRAPHICS_API_OPENGL_ES2
+#if !defined(RLGL_CHECK_THREAD_CONTEXT)
+    #define RLGL_THREAD_CONTEXT_ACTIVE false
+    #define RLGL_CHECK_THREAD_CONTEXT()
+#endif
+static rlCommandRecorder rlRecorder = { 0 };
+#if defined(GRAPHICS_API_OPENGL_11)
+static bool rlScissorEnabled = false;   // Scissor test enabled, no rlgl state on OpenGL 1.1
+static int rlScissorRect[4] = { 0 };    // Scissor rectangle (x, y, width, height)
+#endif
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+static rlRenderBatchStats rlBatchStats = { 0 };
+#if defined(RLGL_RENDER_BATCH_STREAMING)
+static rlStreamingProcs rlStreamGL = { 0 };     // Render batch streaming GL functions (replaceable by a mock GL layer)
+#endif
+#endif
 static bool isGpuReady = false;
 
 #if defined(GRAPHICS_API_OPENGL_ES2) && !defined(GRAPHICS_API_OPENGL_ES3)
@@ -1164,6 +1432,22 @@ static PFNGLVERTEXATTRIBDIVISOREXTPROC glVertexAttribDivisor = NULL;
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
 static void rlLoadShaderDefault(void);      // Load default shader
 static void rlUnloadShaderDefault(void);    // Unload default shader
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+static void rlSetRenderBatchVertexAttribs(void); // Setup render batch interleaved vertex attributes (bound array buffer)
+#endif
+static bool rlSortRenderBatch(rlRenderBatch *batch, int maxDraws); // Sort render batch draws, merging them by mode and texture
+static void rlRecordRenderBatch(rlRenderBatch *batch); // Record render batch draws into current command buffer
+static void rlLoadRenderBatchBuffer(rlVertexBuffer *buffer, int index, int size, const void *data); // Allocate render batch vertex buffer storage (bound array buffer)
+static void rlUpdateRenderBatchBuffer(rlVertexBuffer *buffer, int index, int vertexSize, const void *data); // Update render batch vertex buffer data (bound array buffer)
+#if defined(RLGL_RENDER_BATCH_STREAMING)
+static void rlLoadStreamingProcs(void);                       // Set render batch streaming GL functions not already set
+static void rlWaitRenderBatchBuffer(rlVertexBuffer *buffer);  // Wait for the GPU to complete draws using render batch vertex buffers
+static void rlFenceRenderBatchBuffer(rlVertexBuffer *buffer); // Insert a fence after draws using render batch vertex buffers
+#endif
+#if defined(RLGL_RENDER_BATCH_THREADS)
+static void rlStoreRenderBatch(rlRenderBatch *batch);  // Store render batch data as a chunk of current thread context
+static void rlSwapBatchChunk(rlRenderBatch *batch, rlBatchChunk *chunk); // Swap render batch data with chunk data
+#endif
 #if defined(RLGL_SHOW_GL_DETAILS_INFO)
 static const char *rlGetCompressedFormatName(int format); // Get compressed format official GL identifier name
 #endif  // RLGL_SHOW_GL_DETAILS_INFO
@@ -1171,16 +1455,21 @@ static const char *rlGetCompressedFormatName(int format); // Get compressed form
 
 static int rlGetPixelDataSize(int width, int height, int format);   // Get pixel data size in bytes (image or texture)
 
+static void rlRecordDraw(int mode, unsigned int textureId); // Record a new draw into current command buffer (merged if same mode, texture and state)
+static void rlRecordVertex(const float *position, const float *texcoord, const unsigned char *color); // Record one vertex into current command buffer draw
+static void rlGetDrawState(rlDrawState *state);            // Get current draw state (blending, shader, scissor)
+static void rlApplyDrawState(const rlDrawState *state);     // Set draw state as current (blending, shader, scissor)
+
 static Matrix rlMatrixIdentity(void);                       // Get identity matrix
-#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
 // Auxiliar matrix math functions
 typedef struct rl_float16 { float v[16]; } rl_float16;
 static rl_float16 rlMatrixToFloatV(Matrix mat);             // Get float array of matrix data
 #define rlMatrixToFloat(mat) (rlMatrixToFloatV(mat).v)      // Get float vector for Matrix
 static Matrix rlMatrixMultiply(Matrix left, Matrix right);  // Multiply two matrices
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
 static Matrix rlMatrixTranspose(Matrix mat);                // Transposes provided matrix
-static Matrix rlMatrixInvert(Matrix mat);                   // Invert provided matrix
 #endif
+static Matrix rlMatrixInvert(Matrix mat);                   // Invert provided matrix
 
 //----------------------------------------------------------------------------------
 // Module Functions Definition - Matrix operations
@@ -1420,6 +1709,7 @@ void rlOrtho(double left, double right, double bottom, double top, double znear,
 // Set the viewport area (transformation from normalized device coordinates to window coordinates)
 void rlViewport(int x, int y, int width, int height)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
     glViewport(x, y, width, height);
 }
 
@@ -1448,8 +1738,21 @@ double rlGetCullDistanceFar(void)
 #if defined(GRAPHICS_API_OPENGL_11)
 // Fallback to OpenGL 1.1 function calls
 //---------------------------------------
+// NOTE: When recording a command buffer, vertex data is recorded instead,
+// transformed by the modelview changes since recording started
 void rlBegin(int mode)
 {
+    if (rlRecorder.active)
+    {
+        Matrix transform = rlMatrixMultiply(rlGetMatrixModelview(), rlRecorder.modelviewInverse);
+        Matrix identity = rlMatrixIdentity();
+
+        rlRecorder.transform = transform;
+        rlRecorder.transformRequired = (memcmp(&transform, &identity, sizeof(Matrix)) != 0);
+        rlRecordDraw(mode, rlRecorder.textureId);
+        return;
+    }
+
     switch (mode)
     {
         case RL_LINES: glBegin(GL_LINES); break;
@@ -1459,15 +1762,48 @@ void rlBegin(int mode)
     }
 }
 
-void rlEnd(void) { glEnd(); }
-void rlVertex2i(int x, int y) { glVertex2i(x, y); }
-void rlVertex2f(float x, float y) { glVertex2f(x, y); }
-void rlVertex3f(float x, float y, float z) { glVertex3f(x, y, z); }
-void rlTexCoord2f(float x, float y) { glTexCoord2f(x, y); }
-void rlNormal3f(float x, float y, float z) { glNormal3f(x, y, z); }
-void rlColor4ub(unsigned char r, unsigned char g, unsigned char b, unsigned char a) { glColor4ub(r, g, b, a); }
-void rlColor3f(float x, float y, float z) { glColor3f(x, y, z); }
-void rlColor4f(float x, float y, float z, float w) { glColor4f(x, y, z, w); }
+void rlEnd(void) { if (!rlRecorder.active) glEnd(); }
+void rlVertex2i(int x, int y) { if (rlRecorder.active) rlVertex3f((float)x, (float)y, 0.0f); else glVertex2i(x, y); }
+void rlVertex2f(float x, float y) { if (rlRecorder.active) rlVertex3f(x, y, 0.0f); else glVertex2f(x, y); }
+void rlVertex3f(float x, float y, float z)
+{
+    if (rlRecorder.active)
+    {
+        float position[3] = { x, y, z };
+
+        if (rlRecorder.transformRequired)
+        {
+            Matrix mat = rlRecorder.transform;
+            position[0] = mat.m0*x + mat.m4*y + mat.m8*z + mat.m12;
+            position[1] = mat.m1*x + mat.m5*y + mat.m9*z + mat.m13;
+            position[2] = mat.m2*x + mat.m6*y + mat.m10*z + mat.m14;
+        }
+
+        rlRecordVertex(position, rlRecorder.texcoord, rlRecorder.color);
+    }
+    else glVertex3f(x, y, z);
+}
+void rlTexCoord2f(float x, float y)
+{
+    if (rlRecorder.active) { rlRecorder.texcoord[0] = x; rlRecorder.texcoord[1] = y; }
+    else glTexCoord2f(x, y);
+}
+void rlNormal3f(float x, float y, float z) { if (!rlRecorder.active) glNormal3f(x, y, z); }
+void rlColor4ub(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+    if (rlRecorder.active) { rlRecorder.color[0] = r; rlRecorder.color[1] = g; rlRecorder.color[2] = b; rlRecorder.color[3] = a; }
+    else glColor4ub(r, g, b, a);
+}
+void rlColor3f(float x, float y, float z)
+{
+    if (rlRecorder.active) rlColor4ub((unsigned char)(x*255), (unsigned char)(y*255), (unsigned char)(z*255), 255);
+    else glColor3f(x, y, z);
+}
+void rlColor4f(float x, float y, float z, float w)
+{
+    if (rlRecorder.active) rlColor4ub((unsigned char)(x*255), (unsigned char)(y*255), (unsigned char)(z*255), (unsigned char)(w*255));
+    else glColor4f(x, y, z, w);
+}
 #endif
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
 // Initialize drawing mode (how to organize vertex)
@@ -1495,7 +1831,9 @@ void rlBegin(int mode)
             }
         }
 
-        if (RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS) rlDrawRenderBatch(RLGL.currentBatch);
+        // NOTE: On sorted batches, draws are merged first, the batch is only drawn if not enough draws are merged
+        if ((RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS) &&
+            (!RLGL.State.batchSortEnabled || !rlSortRenderBatch(RLGL.currentBatch, RL_DEFAULT_BATCH_DRAWCALLS*3/4))) rlDrawRenderBatch(RLGL.currentBatch);
 
         RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].mode = mode;
         RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].textureId = RLGL.State.currentTextureId;
@@ -1553,6 +1891,26 @@ void rlVertex3f(float x, float y, float z)
         }
     }
 
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+    // Add vertex with current texcoord, color and normal, all written through the same pointer
+    rlBatchVertex *vertex = &RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].data[RLGL.State.vertexCounter];
+
+    vertex->position[0] = tx;
+    vertex->position[1] = ty;
+    vertex->position[2] = tz;
+    vertex->texcoord[0] = RLGL.State.texcoordx;
+    vertex->texcoord[1] = RLGL.State.texcoordy;
+    vertex->color[0] = RLGL.State.colorr;
+    vertex->color[1] = RLGL.State.colorg;
+    vertex->color[2] = RLGL.State.colorb;
+    vertex->color[3] = RLGL.State.colora;
+#if defined(RLGL_RENDER_BATCH_NORMALS)
+    vertex->normal[0] = RLGL.State.normalPacked[0];
+    vertex->normal[1] = RLGL.State.normalPacked[1];
+    vertex->normal[2] = RLGL.State.normalPacked[2];
+    vertex->normal[3] = 0;
+#endif
+#else
     // Add vertices
     RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].vertices[3*RLGL.State.vertexCounter] = tx;
     RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].vertices[3*RLGL.State.vertexCounter + 1] = ty;
@@ -1572,6 +1930,7 @@ void rlVertex3f(float x, float y, float z)
     RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].colors[4*RLGL.State.vertexCounter + 1] = RLGL.State.colorg;
     RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].colors[4*RLGL.State.vertexCounter + 2] = RLGL.State.colorb;
     RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].colors[4*RLGL.State.vertexCounter + 3] = RLGL.State.colora;
+#endif
 
     RLGL.State.vertexCounter++;
     RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].vertexCount++;
@@ -1621,6 +1980,12 @@ void rlNormal3f(float x, float y, float z)
     RLGL.State.normalx = normalx;
     RLGL.State.normaly = normaly;
     RLGL.State.normalz = normalz;
+
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+    RLGL.State.normalPacked[0] = (signed char)(normalx*127.0f);
+    RLGL.State.normalPacked[1] = (signed char)(normaly*127.0f);
+    RLGL.State.normalPacked[2] = (signed char)(normalz*127.0f);
+#endif
 }
 
 // Define one vertex (color)
@@ -1656,7 +2021,8 @@ void rlSetTexture(unsigned int id)
     if (id == 0)
     {
 #if defined(GRAPHICS_API_OPENGL_11)
-        rlDisableTexture();
+        if (rlRecorder.active) rlRecorder.textureId = 0;
+        else rlDisableTexture();
 #else
         // NOTE: If quads batch limit is reached, force a draw call and next batch starts
         if (RLGL.State.vertexCounter >=
@@ -1670,7 +2036,8 @@ void rlSetTexture(unsigned int id)
     else
     {
 #if defined(GRAPHICS_API_OPENGL_11)
-        rlEnableTexture(id);
+        if (rlRecorder.active) rlRecorder.textureId = id;
+        else rlEnableTexture(id);
 #else
         RLGL.State.currentTextureId = id;
         if (RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].textureId != id)
@@ -1697,7 +2064,9 @@ void rlSetTexture(unsigned int id)
                 }
             }
 
-            if (RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS) rlDrawRenderBatch(RLGL.currentBatch);
+            // NOTE: On sorted batches, draws are merged first, the batch is only drawn if not enough draws are merged
+            if ((RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS) &&
+                (!RLGL.State.batchSortEnabled || !rlSortRenderBatch(RLGL.currentBatch, RL_DEFAULT_BATCH_DRAWCALLS*3/4))) rlDrawRenderBatch(RLGL.currentBatch);
 
             RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].textureId = id;
             RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].vertexCount = 0;
@@ -1709,6 +2078,7 @@ void rlSetTexture(unsigned int id)
 // Select and active a texture slot
 void rlActiveTextureSlot(int slot)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     glActiveTexture(GL_TEXTURE0 + slot);
 #endif
@@ -1717,6 +2087,7 @@ void rlActiveTextureSlot(int slot)
 // Enable texture
 void rlEnableTexture(unsigned int id)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if defined(GRAPHICS_API_OPENGL_11)
     glEnable(GL_TEXTURE_2D);
 #endif
@@ -1726,6 +2097,7 @@ void rlEnableTexture(unsigned int id)
 // Disable texture
 void rlDisableTexture(void)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if defined(GRAPHICS_API_OPENGL_11)
     glDisable(GL_TEXTURE_2D);
 #endif
@@ -1735,6 +2107,7 @@ void rlDisableTexture(void)
 // Enable texture cubemap
 void rlEnableTextureCubemap(unsigned int id)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     glBindTexture(GL_TEXTURE_CUBE_MAP, id);
 #endif
@@ -1743,6 +2116,7 @@ void rlEnableTextureCubemap(unsigned int id)
 // Disable texture cubemap
 void rlDisableTextureCubemap(void)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
 #endif
@@ -1751,6 +2125,7 @@ void rlDisableTextureCubemap(void)
 // Set texture parameters (wrap mode/filter mode)
 void rlTextureParameters(unsigned int id, int param, int value)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
     glBindTexture(GL_TEXTURE_2D, id);
 
     switch (param)
@@ -1796,6 +2171,7 @@ void rlTextureParameters(unsigned int id, int param, int value)
 // Set cubemap parameters (wrap mode/filter mode)
 void rlCubemapParameters(unsigned int id, int param, int value)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if !defined(GRAPHICS_API_OPENGL_11)
     glBindTexture(GL_TEXTURE_CUBE_MAP, id);
 
@@ -1839,6 +2215,7 @@ void rlCubemapParameters(unsigned int id, int param, int value)
 // Enable shader program
 void rlEnableShader(unsigned int id)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2))
     glUseProgram(id);
 #endif
@@ -1847,6 +2224,7 @@ void rlEnableShader(unsigned int id)
 // Disable shader program
 void rlDisableShader(void)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2))
     glUseProgram(0);
 #endif
@@ -1855,7 +2233,8 @@ void rlDisableShader(void)
 // Enable rendering to texture (fbo)
 void rlEnableFramebuffer(unsigned int id)
 {
-#if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2))
+    RLGL_CHECK_THREAD_CONTEXT();
+#if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE))
     glBindFramebuffer(GL_FRAMEBUFFER, id);
 #endif
 }
@@ -1873,7 +2252,8 @@ unsigned int rlGetActiveFramebuffer(void)
 // Disable rendering to texture
 void rlDisableFramebuffer(void)
 {
-#if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2))
+    RLGL_CHECK_THREAD_CONTEXT();
+#if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE))
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 #endif
 }
@@ -1881,6 +2261,7 @@ void rlDisableFramebuffer(void)
 // Blit active framebuffer to main framebuffer
 void rlBlitFramebuffer(int srcX, int srcY, int srcWidth, int srcHeight, int dstX, int dstY, int dstWidth, int dstHeight, int bufferMask)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES3))
     glBlitFramebuffer(srcX, srcY, srcWidth, srcHeight, dstX, dstY, dstWidth, dstHeight, bufferMask, GL_NEAREST);
 #endif
@@ -1889,7 +2270,8 @@ void rlBlitFramebuffer(int srcX, int srcY, int srcWidth, int srcHeight, int dstX
 // Bind framebuffer object (fbo)
 void rlBindFramebuffer(unsigned int target, unsigned int framebuffer)
 {
-#if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2))
+    RLGL_CHECK_THREAD_CONTEXT();
+#if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE))
     glBindFramebuffer(target, framebuffer);
 #endif
 }
@@ -1898,6 +2280,7 @@ void rlBindFramebuffer(unsigned int target, unsigned int framebuffer)
 // NOTE: One color buffer is always active by default
 void rlActiveDrawBuffers(int count)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES3))
     // NOTE: Maximum number of draw buffers supported is implementation dependant,
     // it can be queried with glGet*() but it must be at least 8
@@ -1932,35 +2315,36 @@ void rlActiveDrawBuffers(int count)
 //----------------------------------------------------------------------------------
 
 // Enable color blending
-void rlEnableColorBlend(void) { glEnable(GL_BLEND); }
+void rlEnableColorBlend(void) { RLGL_CHECK_THREAD_CONTEXT(); glEnable(GL_BLEND); }
 
 // Disable color blending
-void rlDisableColorBlend(void) { glDisable(GL_BLEND); }
+void rlDisableColorBlend(void) { RLGL_CHECK_THREAD_CONTEXT(); glDisable(GL_BLEND); }
 
 // Enable depth test
-void rlEnableDepthTest(void) { glEnable(GL_DEPTH_TEST); }
+void rlEnableDepthTest(void) { RLGL_CHECK_THREAD_CONTEXT(); glEnable(GL_DEPTH_TEST); }
 
 // Disable depth test
-void rlDisableDepthTest(void) { glDisable(GL_DEPTH_TEST); }
+void rlDisableDepthTest(void) { RLGL_CHECK_THREAD_CONTEXT(); glDisable(GL_DEPTH_TEST); }
 
 // Enable depth write
-void rlEnableDepthMask(void) { glDepthMask(GL_TRUE); }
+void rlEnableDepthMask(void) { RLGL_CHECK_THREAD_CONTEXT(); glDepthMask(GL_TRUE); }
 
 // Disable depth write
-void rlDisableDepthMask(void) { glDepthMask(GL_FALSE); }
+void rlDisableDepthMask(void) { RLGL_CHECK_THREAD_CONTEXT(); glDepthMask(GL_FALSE); }
 
 // Enable backface culling
-void rlEnableBackfaceCulling(void) { glEnable(GL_CULL_FACE); }
+void rlEnableBackfaceCulling(void) { RLGL_CHECK_THREAD_CONTEXT(); glEnable(GL_CULL_FACE); }
 
 // Disable backface culling
-void rlDisableBackfaceCulling(void) { glDisable(GL_CULL_FACE); }
+void rlDisableBackfaceCulling(void) { RLGL_CHECK_THREAD_CONTEXT(); glDisable(GL_CULL_FACE); }
 
 // Set color mask active for screen read/draw
-void rlColorMask(bool r, bool g, bool b, bool a) { glColorMask(r, g, b, a); }
+void rlColorMask(bool r, bool g, bool b, bool a) { RLGL_CHECK_THREAD_CONTEXT(); glColorMask(r, g, b, a); }
 
 // Set face culling mode
 void rlSetCullFace(int mode)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
     switch (mode)
     {
         case RL_CULL_FACE_BACK: glCullFace(GL_BACK); break;
@@ -1970,17 +2354,51 @@ void rlSetCullFace(int mode)
 }
 
 // Enable scissor test
-void rlEnableScissorTest(void) { glEnable(GL_SCISSOR_TEST); }
+// NOTE: Scissor state is tracked to be recorded with command buffer draws and render batch context data,
+// on changes batch is drawn first, draws are recorded with the state they were submitted with
+void rlEnableScissorTest(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if (!RLGL.State.scissorEnabled) rlDrawRenderBatch(RLGL.currentBatch);
+    RLGL.State.scissorEnabled = true;
+#else
+    rlScissorEnabled = true;
+#endif
+    if (!RLGL_THREAD_CONTEXT_ACTIVE) glEnable(GL_SCISSOR_TEST);
+}
 
 // Disable scissor test
-void rlDisableScissorTest(void) { glDisable(GL_SCISSOR_TEST); }
+void rlDisableScissorTest(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if (RLGL.State.scissorEnabled) rlDrawRenderBatch(RLGL.currentBatch);
+    RLGL.State.scissorEnabled = false;
+#else
+    rlScissorEnabled = false;
+#endif
+    if (!RLGL_THREAD_CONTEXT_ACTIVE) glDisable(GL_SCISSOR_TEST);
+}
 
 // Scissor test
-void rlScissor(int x, int y, int width, int height) { glScissor(x, y, width, height); }
+void rlScissor(int x, int y, int width, int height)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    int *scissor = RLGL.State.scissor;
+    if ((scissor[0] != x) || (scissor[1] != y) || (scissor[2] != width) || (scissor[3] != height)) rlDrawRenderBatch(RLGL.currentBatch);
+#else
+    int *scissor = rlScissorRect;
+#endif
+    scissor[0] = x;
+    scissor[1] = y;
+    scissor[2] = width;
+    scissor[3] = height;
+    if (!RLGL_THREAD_CONTEXT_ACTIVE) glScissor(x, y, width, height);
+}
 
 // Enable wire mode
 void rlEnableWireMode(void)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if defined(GRAPHICS_API_OPENGL_11) || defined(GRAPHICS_API_OPENGL_33)
     // NOTE: glPolygonMode() not available on OpenGL ES
     glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
@@ -1990,6 +2408,7 @@ void rlEnableWireMode(void)
 // Disable wire mode
 void rlDisableWireMode(void)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if defined(GRAPHICS_API_OPENGL_11) || defined(GRAPHICS_API_OPENGL_33)
     // NOTE: glPolygonMode() not available on OpenGL ES
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
@@ -1999,6 +2418,7 @@ void rlDisableWireMode(void)
 // Enable point mode
 void rlEnablePointMode(void)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if defined(GRAPHICS_API_OPENGL_11) || defined(GRAPHICS_API_OPENGL_33)
     // NOTE: glPolygonMode() not available on OpenGL ES
     glPolygonMode(GL_FRONT_AND_BACK, GL_POINT);
@@ -2009,6 +2429,7 @@ void rlEnablePointMode(void)
 // Disable point mode
 void rlDisablePointMode(void)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if defined(GRAPHICS_API_OPENGL_11) || defined(GRAPHICS_API_OPENGL_33)
     // NOTE: glPolygonMode() not available on OpenGL ES
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
@@ -2016,7 +2437,7 @@ void rlDisablePointMode(void)
 }
 
 // Set the line drawing width
-void rlSetLineWidth(float width) { glLineWidth(width); }
+void rlSetLineWidth(float width) { RLGL_CHECK_THREAD_CONTEXT(); glLineWidth(width); }
 
 // Get the line drawing width
 float rlGetLineWidth(void)
@@ -2029,6 +2450,7 @@ float rlGetLineWidth(void)
 // Set the point drawing size
 void rlSetPointSize(float size)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if defined(GRAPHICS_API_OPENGL_11)
     glPointSize(size);
 #endif
@@ -2048,6 +2470,7 @@ float rlGetPointSize(void)
 // Enable line aliasing
 void rlEnableSmoothLines(void)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_11)
     glEnable(GL_LINE_SMOOTH);
 #endif
@@ -2056,11 +2479,32 @@ void rlEnableSmoothLines(void)
 // Disable line aliasing
 void rlDisableSmoothLines(void)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_11)
     glDisable(GL_LINE_SMOOTH);
 #endif
 }
 
+// Enable multisample anti-aliasing (MSAA)
+// NOTE: Hardware multisampling also requires a multisampled framebuffer (FLAG_MSAA_4X_HINT),
+// the software renderer allocates the samples of its main framebuffer when enabled
+void rlEnableMultisample(void)
+{
+    RLGL_CHECK_THREAD_CONTEXT();
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    glEnable(GL_MULTISAMPLE);
+#endif
+}
+
+// Disable multisample anti-aliasing (MSAA)
+void rlDisableMultisample(void)
+{
+    RLGL_CHECK_THREAD_CONTEXT();
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    glDisable(GL_MULTISAMPLE);
+#endif
+}
+
 // Enable stereo rendering
 void rlEnableStereoRender(void)
 {
@@ -2090,6 +2534,7 @@ bool rlIsStereoRenderEnabled(void)
 // Clear color buffer with color
 void rlClearColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
     // Color values clamp to 0.0f(0) and 1.0f(255)
     float cr = (float)r/255;
     float cg = (float)g/255;
@@ -2102,6 +2547,7 @@ void rlClearColor(unsigned char r, unsigned char g, unsigned char b, unsigned ch
 // Clear used screen buffers (color and depth)
 void rlClearScreenBuffers(void)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);     // Clear used buffers: Color and Depth (Depth is used for 3D)
     //glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);     // Stencil buffer not used...
 }
@@ -2131,6 +2577,7 @@ void rlCheckErrors(void)
 }
 
 // Set blend mode
+// NOTE: On a render batch context thread blending mode is not set, it is recorded with the context data
 void rlSetBlendMode(int mode)
 {
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
@@ -2138,26 +2585,29 @@ void rlSetBlendMode(int mode)
     {
         rlDrawRenderBatch(RLGL.currentBatch);
 
-        switch (mode)
+        if (!RLGL_THREAD_CONTEXT_ACTIVE)
         {
-            case RL_BLEND_ALPHA: glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); glBlendEquation(GL_FUNC_ADD); break;
-            case RL_BLEND_ADDITIVE: glBlendFunc(GL_SRC_ALPHA, GL_ONE); glBlendEquation(GL_FUNC_ADD); break;
-            case RL_BLEND_MULTIPLIED: glBlendFunc(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA); glBlendEquation(GL_FUNC_ADD); break;
-            case RL_BLEND_ADD_COLORS: glBlendFunc(GL_ONE, GL_ONE); glBlendEquation(GL_FUNC_ADD); break;
-            case RL_BLEND_SUBTRACT_COLORS: glBlendFunc(GL_ONE, GL_ONE); glBlendEquation(GL_FUNC_SUBTRACT); break;
-            case RL_BLEND_ALPHA_PREMULTIPLY: glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); glBlendEquation(GL_FUNC_ADD); break;
-            case RL_BLEND_CUSTOM:
+            switch (mode)
             {
-                // NOTE: Using GL blend src/dst factors and GL equation configured with rlSetBlendFactors()
-                glBlendFunc(RLGL.State.glBlendSrcFactor, RLGL.State.glBlendDstFactor); glBlendEquation(RLGL.State.glBlendEquation);
-            } break;
-            case RL_BLEND_CUSTOM_SEPARATE:
-            {
-                // NOTE: Using GL blend src/dst factors and GL equation configured with rlSetBlendFactorsSeparate()
-                glBlendFuncSeparate(RLGL.State.glBlendSrcFactorRGB, RLGL.State.glBlendDestFactorRGB, RLGL.State.glBlendSrcFactorAlpha, RLGL.State.glBlendDestFactorAlpha);
-                glBlendEquationSeparate(RLGL.State.glBlendEquationRGB, RLGL.State.glBlendEquationAlpha);
-            } break;
-            default: break;
+                case RL_BLEND_ALPHA: glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); glBlendEquation(GL_FUNC_ADD); break;
+                case RL_BLEND_ADDITIVE: glBlendFunc(GL_SRC_ALPHA, GL_ONE); glBlendEquation(GL_FUNC_ADD); break;
+                case RL_BLEND_MULTIPLIED: glBlendFunc(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA); glBlendEquation(GL_FUNC_ADD); break;
+                case RL_BLEND_ADD_COLORS: glBlendFunc(GL_ONE, GL_ONE); glBlendEquation(GL_FUNC_ADD); break;
+                case RL_BLEND_SUBTRACT_COLORS: glBlendFunc(GL_ONE, GL_ONE); glBlendEquation(GL_FUNC_SUBTRACT); break;
+                case RL_BLEND_ALPHA_PREMULTIPLY: glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); glBlendEquation(GL_FUNC_ADD); break;
+                case RL_BLEND_CUSTOM:
+                {
+                    // NOTE: Using GL blend src/dst factors and GL equation configured with rlSetBlendFactors()
+                    glBlendFunc(RLGL.State.glBlendSrcFactor, RLGL.State.glBlendDstFactor); glBlendEquation(RLGL.State.glBlendEquation);
+                } break;
+                case RL_BLEND_CUSTOM_SEPARATE:
+                {
+                    // NOTE: Using GL blend src/dst factors and GL equation configured with rlSetBlendFactorsSeparate()
+                    glBlendFuncSeparate(RLGL.State.glBlendSrcFactorRGB, RLGL.State.glBlendDestFactorRGB, RLGL.State.glBlendSrcFactorAlpha, RLGL.State.glBlendDestFactorAlpha);
+                    glBlendEquationSeparate(RLGL.State.glBlendEquationRGB, RLGL.State.glBlendEquationAlpha);
+                } break;
+                default: break;
+            }
         }
 
         RLGL.State.currentBlendMode = mode;
@@ -2308,7 +2758,13 @@ void rlglInit(int width, int height)
     // Init default vertex arrays buffers
     // Simulate that the default shader has the location RL_SHADER_LOC_VERTEX_NORMAL to bind the normal buffer for the default render batch
     RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_NORMAL] = RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL;
+#if defined(RLGL_RENDER_BATCH_STREAMING)
+    RLGL.defaultBatch = rlLoadRenderBatch(RL_DEFAULT_BATCH_STREAM_BUFFERS, RL_DEFAULT_BATCH_BUFFER_ELEMENTS);
+    TRACELOG(RL_LOG_INFO, "RLGL: Render batch streaming mode: %i ring buffers (%s)", RL_DEFAULT_BATCH_STREAM_BUFFERS,
+        (RLGL.defaultBatch.vertexBuffer[0].mapped[0] != NULL)? "persistent mapped" : "orphaned");
+#else
     RLGL.defaultBatch = rlLoadRenderBatch(RL_DEFAULT_BATCH_BUFFERS, RL_DEFAULT_BATCH_BUFFER_ELEMENTS);
+#endif
     RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_NORMAL] = -1;
     RLGL.currentBatch = &RLGL.defaultBatch;
 
@@ -2445,6 +2901,9 @@ void rlLoadExtensions(void *loader)
     RLGL.ExtSupported.computeShader = GLAD_GL_ARB_compute_shader;
     RLGL.ExtSupported.ssbo = GLAD_GL_ARB_shader_storage_buffer_object;
     #endif
+    #if !defined(GRAPHICS_API_OPENGL_21)
+    RLGL.ExtSupported.bufferStorage = GLAD_GL_ARB_buffer_storage;         // Persistent mapped buffers
+    #endif
 
 #endif  // GRAPHICS_API_OPENGL_33
 
@@ -2719,6 +3178,58 @@ int rlGetVersion(void)
     return glVersion;
 }
 
+// Get software renderer statistics, accumulated since the last reset
+// NOTE: Statistics are only available with the software backend compiled with SW_ENABLE_STATS,
+// resetting them every frame gives per-frame values
+bool rlGetSoftwareStats(rlSoftwareStats *stats, bool reset)
+{
+    bool result = false;
+    rlSoftwareStats emptyStats = { 0 };
+    *stats = emptyStats;
+
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    SWstats swStats = { 0 };
+    result = swGetStats(&swStats, reset);
+
+    stats->drawCalls = swStats.drawCalls;
+    stats->vertices = swStats.vertices;
+    stats->primitives = swStats.primitives;
+    stats->primitivesCulled = swStats.primitivesCulled;
+    stats->primitivesClipped = swStats.primitivesClipped;
+    stats->primitivesAffine = swStats.primitivesAffine;
+    stats->pixelsShaded = swStats.pixelsShaded;
+    stats->pixelsDepthRejected = swStats.pixelsDepthRejected;
+    stats->texelsFetched = swStats.texelsFetched;
+    stats->clearTime = swStats.clearTime;
+    stats->rasterTime = swStats.rasterTime;
+    stats->copyTime = swStats.copyTime;
+#else
+    (void)reset;
+#endif
+
+    return result;
+}
+
+// Get render batch upload statistics, accumulated since the last reset
+// NOTE: Resetting them every frame gives per-frame values, compare uploadBytes against fenceWaits
+// and orphans to check whether streaming mode (RLGL_RENDER_BATCH_STREAMING) avoids stalls
+bool rlGetRenderBatchStats(rlRenderBatchStats *stats, bool reset)
+{
+    bool result = false;
+    rlRenderBatchStats emptyStats = { 0 };
+    *stats = emptyStats;
+
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    *stats = rlBatchStats;
+    if (reset) rlBatchStats = emptyStats;
+    result = true;
+#else
+    (void)reset;
+#endif
+
+    return result;
+}
+
 // Set current framebuffer width
 void rlSetFramebufferWidth(int width)
 {
@@ -2795,6 +3306,10 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
     if (!isGpuReady) { TRACELOG(RL_LOG_WARNING, "GL: GPU is not ready to load data, trying to load before InitWindow()?"); return batch; }
 
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+#if defined(RLGL_RENDER_BATCH_STREAMING)
+    rlLoadStreamingProcs();
+#endif
+
     // Initialize CPU (RAM) vertex buffers (position, texcoord, color data and indexes)
     //--------------------------------------------------------------------------------------------
     batch.vertexBuffer = (rlVertexBuffer *)RL_CALLOC(numBuffers, sizeof(rlVertexBuffer));
@@ -2803,10 +3318,14 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
     {
         batch.vertexBuffer[i].elementCount = bufferElements;
 
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+        batch.vertexBuffer[i].data = (rlBatchVertex *)RL_CALLOC(bufferElements*4, sizeof(rlBatchVertex));  // 4 vertex by quad
+#else
         batch.vertexBuffer[i].vertices = (float *)RL_CALLOC(bufferElements*3*4, sizeof(float));     // 3 float by vertex, 4 vertex by quad
         batch.vertexBuffer[i].texcoords = (float *)RL_CALLOC(bufferElements*2*4, sizeof(float));    // 2 float by texcoord, 4 texcoord by quad
         batch.vertexBuffer[i].normals = (float *)RL_CALLOC(bufferElements*3*4, sizeof(float));      // 3 float by vertex, 4 vertex by quad
         batch.vertexBuffer[i].colors = (unsigned char *)RL_CALLOC(bufferElements*4*4, sizeof(unsigned char));   // 4 float by color, 4 colors by quad
+#endif
 #if defined(GRAPHICS_API_OPENGL_33)
         batch.vertexBuffer[i].indices = (unsigned int *)RL_CALLOC(bufferElements*6, sizeof(unsigned int));      // 6 int by quad (indices)
 #endif
@@ -2814,10 +3333,12 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
         batch.vertexBuffer[i].indices = (unsigned short *)RL_CALLOC(bufferElements*6, sizeof(unsigned short));  // 6 int by quad (indices)
 #endif
 
+#if !defined(RLGL_RENDER_BATCH_INTERLEAVED)
         for (int j = 0; j < (3*4*bufferElements); j++) batch.vertexBuffer[i].vertices[j] = 0.0f;
         for (int j = 0; j < (2*4*bufferElements); j++) batch.vertexBuffer[i].texcoords[j] = 0.0f;
         for (int j = 0; j < (3*4*bufferElements); j++) batch.vertexBuffer[i].normals[j] = 0.0f;
         for (int j = 0; j < (4*4*bufferElements); j++) batch.vertexBuffer[i].colors[j] = 0;
+#endif
 
         int k = 0;
 
@@ -2851,34 +3372,43 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
             glBindVertexArray(batch.vertexBuffer[i].vaoId);
         }
 
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+        // Quads - Interleaved vertex buffer binding and attributes enable
+        // NOTE: Only one vertex buffer is used (vboId[0]), besides the index buffer (vboId[4])
+        glGenBuffers(1, &batch.vertexBuffer[i].vboId[0]);
+        glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[0]);
+        rlLoadRenderBatchBuffer(&batch.vertexBuffer[i], 0, bufferElements*4*sizeof(rlBatchVertex), batch.vertexBuffer[i].data);
+        rlSetRenderBatchVertexAttribs();
+#else
         // Quads - Vertex buffers binding and attributes enable
         // Vertex position buffer (shader-location = 0)
         glGenBuffers(1, &batch.vertexBuffer[i].vboId[0]);
         glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[0]);
-        glBufferData(GL_ARRAY_BUFFER, bufferElements*3*4*sizeof(float), batch.vertexBuffer[i].vertices, GL_DYNAMIC_DRAW);
+        rlLoadRenderBatchBuffer(&batch.vertexBuffer[i], 0, bufferElements*3*4*sizeof(float), batch.vertexBuffer[i].vertices);
         glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION]);
         glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION], 3, GL_FLOAT, 0, 0, 0);
 
         // Vertex texcoord buffer (shader-location = 1)
         glGenBuffers(1, &batch.vertexBuffer[i].vboId[1]);
         glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[1]);
-        glBufferData(GL_ARRAY_BUFFER, bufferElements*2*4*sizeof(float), batch.vertexBuffer[i].texcoords, GL_DYNAMIC_DRAW);
+        rlLoadRenderBatchBuffer(&batch.vertexBuffer[i], 1, bufferElements*2*4*sizeof(float), batch.vertexBuffer[i].texcoords);
         glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01]);
         glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01], 2, GL_FLOAT, 0, 0, 0);
 
         // Vertex normal buffer (shader-location = 2)
         glGenBuffers(1, &batch.vertexBuffer[i].vboId[2]);
         glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[2]);
-        glBufferData(GL_ARRAY_BUFFER, bufferElements*3*4*sizeof(float), batch.vertexBuffer[i].normals, GL_DYNAMIC_DRAW);
+        rlLoadRenderBatchBuffer(&batch.vertexBuffer[i], 2, bufferElements*3*4*sizeof(float), batch.vertexBuffer[i].normals);
         glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_NORMAL]);
         glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_NORMAL], 3, GL_FLOAT, 0, 0, 0);
 
         // Vertex color buffer (shader-location = 3)
         glGenBuffers(1, &batch.vertexBuffer[i].vboId[3]);
         glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[3]);
-        glBufferData(GL_ARRAY_BUFFER, bufferElements*4*4*sizeof(unsigned char), batch.vertexBuffer[i].colors, GL_DYNAMIC_DRAW);
+        rlLoadRenderBatchBuffer(&batch.vertexBuffer[i], 3, bufferElements*4*4*sizeof(unsigned char), batch.vertexBuffer[i].colors);
         glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_COLOR]);
         glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_COLOR], 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, 0);
+#endif
 
         // Fill index buffer
         glGenBuffers(1, &batch.vertexBuffer[i].vboId[4]);
@@ -2950,18 +3480,37 @@ void rlUnloadRenderBatch(rlRenderBatch batch)
         glDeleteBuffers(1, &batch.vertexBuffer[i].vboId[2]);
         glDeleteBuffers(1, &batch.vertexBuffer[i].vboId[3]);
         glDeleteBuffers(1, &batch.vertexBuffer[i].vboId[4]);
+#if defined(RLGL_RENDER_BATCH_STREAMING) && defined(GRAPHICS_API_OPENGL_33) && !defined(GRAPHICS_API_OPENGL_21)
+        // NOTE: Deleting buffers unmaps them, only pending fence must be deleted
+        if (batch.vertexBuffer[i].fence != NULL) rlStreamGL.deleteSync((GLsync)batch.vertexBuffer[i].fence);
+#endif
 
         // Delete VAOs from GPU (VRAM)
         if (RLGL.ExtSupported.vao) glDeleteVertexArrays(1, &batch.vertexBuffer[i].vaoId);
 
         // Free vertex arrays memory from CPU (RAM)
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+        RL_FREE(batch.vertexBuffer[i].data);
+#else
         RL_FREE(batch.vertexBuffer[i].vertices);
         RL_FREE(batch.vertexBuffer[i].texcoords);
         RL_FREE(batch.vertexBuffer[i].normals);
         RL_FREE(batch.vertexBuffer[i].colors);
+#endif
         RL_FREE(batch.vertexBuffer[i].indices);
     }
 
+    // Unload draws sorting data
+    if (batch.sortData != NULL)
+    {
+        RL_FREE(batch.sortData->buffer.data);
+        RL_FREE(batch.sortData->buffer.vertices);
+        RL_FREE(batch.sortData->buffer.texcoords);
+        RL_FREE(batch.sortData->buffer.normals);
+        RL_FREE(batch.sortData->buffer.colors);
+        RL_FREE(batch.sortData);
+    }
+
     // Unload arrays
     RL_FREE(batch.vertexBuffer);
     RL_FREE(batch.draws);
@@ -2973,10 +3522,29 @@ void rlUnloadRenderBatch(rlRenderBatch batch)
 void rlDrawRenderBatch(rlRenderBatch *batch)
 {
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    // Merge batch draws by texture before uploading vertex data, if any draw can be merged
+    if (RLGL.State.batchSortEnabled) rlSortRenderBatch(batch, batch->drawCounter - 1);
+
+    bool recording = false;
+#if defined(RLGL_RENDER_BATCH_THREADS)
+    // Filling a render batch context, no GL access from this thread, data is kept until drawn from main thread
+    if (rlThreadContext != NULL)
+    {
+        rlStoreRenderBatch(batch);
+        recording = true;
+    }
+#endif
+    // Recording a command buffer, batch draws are recorded instead of drawn
+    if (!recording && rlRecorder.active)
+    {
+        rlRecordRenderBatch(batch);
+        recording = true;
+    }
+
     // Update batch vertex buffers
     //------------------------------------------------------------------------------------------------------------
     // NOTE: If there is not vertex data, buffers doesn't need to be updated (vertexCount > 0)
-    if (RLGL.State.vertexCounter > 0)
+    if ((RLGL.State.vertexCounter > 0) && !recording)
     {
         // Activate elements VAO
         if (RLGL.ExtSupported.vao) glBindVertexArray(batch->vertexBuffer[batch->currentBuffer].vaoId);
@@ -2984,25 +3552,36 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
         // TODO: If no data changed on the CPU arrays there is no need to re-upload data to GPU,
         // a flag can be used to detect changes but it would imply keeping a copy buffer and memcmp() both, does it worth it?
 
+#if defined(RLGL_RENDER_BATCH_STREAMING)
+        // Wait for the GPU to release the ring buffer, only if it was not done since buffers were last drawn
+        rlWaitRenderBatchBuffer(&batch->vertexBuffer[batch->currentBuffer]);
+#endif
+
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+        // Interleaved vertex buffer, all attributes uploaded at once
+        glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[0]);
+        rlUpdateRenderBatchBuffer(&batch->vertexBuffer[batch->currentBuffer], 0, sizeof(rlBatchVertex), batch->vertexBuffer[batch->currentBuffer].data);
+#else
         // Vertex positions buffer
         glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[0]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*3*sizeof(float), batch->vertexBuffer[batch->currentBuffer].vertices);
+        rlUpdateRenderBatchBuffer(&batch->vertexBuffer[batch->currentBuffer], 0, 3*sizeof(float), batch->vertexBuffer[batch->currentBuffer].vertices);
         //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*3*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].vertices, GL_DYNAMIC_DRAW);  // Update all buffer
 
         // Texture coordinates buffer
         glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[1]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*2*sizeof(float), batch->vertexBuffer[batch->currentBuffer].texcoords);
+        rlUpdateRenderBatchBuffer(&batch->vertexBuffer[batch->currentBuffer], 1, 2*sizeof(float), batch->vertexBuffer[batch->currentBuffer].texcoords);
         //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*2*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].texcoords, GL_DYNAMIC_DRAW); // Update all buffer
 
         // Normals buffer
         glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[2]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*3*sizeof(float), batch->vertexBuffer[batch->currentBuffer].normals);
+        rlUpdateRenderBatchBuffer(&batch->vertexBuffer[batch->currentBuffer], 2, 3*sizeof(float), batch->vertexBuffer[batch->currentBuffer].normals);
         //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*3*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].normals, GL_DYNAMIC_DRAW); // Update all buffer
 
         // Colors buffer
         glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[3]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*4*sizeof(unsigned char), batch->vertexBuffer[batch->currentBuffer].colors);
+        rlUpdateRenderBatchBuffer(&batch->vertexBuffer[batch->currentBuffer], 3, 4*sizeof(unsigned char), batch->vertexBuffer[batch->currentBuffer].colors);
         //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*4*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].colors, GL_DYNAMIC_DRAW);    // Update all buffer
+#endif
 
         // NOTE: glMapBuffer() causes sync issue
         // If GPU is working with this buffer, glMapBuffer() will wait(stall) until GPU to finish its job
@@ -3030,6 +3609,7 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
 
     int eyeCount = 1;
     if (RLGL.State.stereoRender) eyeCount = 2;
+    if (recording) eyeCount = 0;    // Batch data recorded, nothing to draw
 
     for (int eye = 0; eye < eyeCount; eye++)
     {
@@ -3080,6 +3660,11 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
             if (RLGL.ExtSupported.vao) glBindVertexArray(batch->vertexBuffer[batch->currentBuffer].vaoId);
             else
             {
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+                // Bind vertex attribs: position, texcoord, normal and color (interleaved buffer)
+                glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[0]);
+                rlSetRenderBatchVertexAttribs();
+#else
                 // Bind vertex attrib: position (shader-location = 0)
                 glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[0]);
                 glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION], 3, GL_FLOAT, 0, 0, 0);
@@ -3099,6 +3684,7 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
                 glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[3]);
                 glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_COLOR], 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, 0);
                 glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_COLOR]);
+#endif
 
                 glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[4]);
             }
@@ -3158,6 +3744,11 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
         glUseProgram(0);    // Unbind shader program
     }
 
+#if defined(RLGL_RENDER_BATCH_STREAMING)
+    // Fence buffers draws, next upload to these buffers (after a ring cycle) waits on it
+    if ((RLGL.State.vertexCounter > 0) && !recording) rlFenceRenderBatchBuffer(&batch->vertexBuffer[batch->currentBuffer]);
+#endif
+
     // Restore viewport to default measures
     if (eyeCount == 2) rlViewport(0, 0, RLGL.State.framebufferWidth, RLGL.State.framebufferHeight);
     //------------------------------------------------------------------------------------------------------------
@@ -3187,6 +3778,13 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
 
     // Reset draws counter to one draw for the batch
     batch->drawCounter = 1;
+
+    // Reset draws bounds kept by sorting
+    if (batch->sortData != NULL)
+    {
+        batch->sortData->boundsCount = 0;
+        batch->sortData->boundedDraws = 0;
+    }
     //------------------------------------------------------------------------------------------------------------
 
     // Change to next buffer in the list (in case of multi-buffering)
@@ -3199,6 +3797,14 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
 void rlSetRenderBatchActive(rlRenderBatch *batch)
 {
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+#if defined(RLGL_RENDER_BATCH_THREADS)
+    // Render batch context thread fills the context batch only, default batch belongs to main thread
+    if (RLGL_THREAD_CONTEXT_ACTIVE && (batch != RLGL.currentBatch))
+    {
+        TRACELOG(RL_LOG_ERROR, "RLGL: %s() failed, only context batch can be active on render batch context thread", __func__);
+        return;
+    }
+#endif
     rlDrawRenderBatch(RLGL.currentBatch);
 
     if (batch != NULL) RLGL.currentBatch = batch;
@@ -3214,96 +3820,522 @@ void rlDrawRenderBatchActive(void)
 #endif
 }
 
-// Check internal buffer overflow for a given number of vertex
-// and force a rlRenderBatch draw call if required
-bool rlCheckRenderBatchLimit(int vCount)
+// Enable render batch draws sorting
+// NOTE: Draws are merged by texture and mode, reordering them only when they do not overlap previous
+// draws, meant for 2D drawing (draws bounds are checked on XY), batches drawn with a projection or
+// modelview depending on depth (BeginMode3D()) are not sorted, current batch is drawn before change
+void rlEnableRenderBatchSort(void)
 {
-    bool overflow = false;
-
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
-    if ((RLGL.State.vertexCounter + vCount) >=
-        (RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].elementCount*4))
-    {
-        overflow = true;
-
-        // Store current primitive drawing mode and texture id
-        int currentMode = RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].mode;
-        int currentTexture = RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].textureId;
+    if (!RLGL.State.batchSortEnabled) rlDrawRenderBatch(RLGL.currentBatch);
+    RLGL.State.batchSortEnabled = true;
+#endif
+}
 
-        rlDrawRenderBatch(RLGL.currentBatch);    // NOTE: Stereo rendering is checked inside
+// Disable render batch draws sorting
+void rlDisableRenderBatchSort(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if (RLGL.State.batchSortEnabled) rlDrawRenderBatch(RLGL.currentBatch);
+    RLGL.State.batchSortEnabled = false;
+#endif
+}
 
-        // Restore state of last batch so new vertices can be added
-        RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].mode = currentMode;
-        RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].textureId = currentTexture;
+// Begin recording draws into a command buffer
+// NOTE: Vertex data, draw modes, textures, blending mode, shader and scissor are recorded, other state
+// changes (matrices not applied to vertex) are not; current batch is drawn first, nested recording is not supported
+void rlBeginCommandBuffer(void)
+{
+    if (rlRecorder.active)
+    {
+        TRACELOG(RL_LOG_WARNING, "RLGL: Command buffer already recording");
+        return;
     }
+
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    rlDrawRenderBatch(RLGL.currentBatch);
 #endif
 
-    return overflow;
+    memset(&rlRecorder, 0, sizeof(rlCommandRecorder));
+#if defined(GRAPHICS_API_OPENGL_11)
+    // Recorded vertex are relative to modelview matrix when recording starts
+    rlRecorder.modelviewInverse = rlMatrixInvert(rlGetMatrixModelview());
+    rlRecorder.color[0] = 255;
+    rlRecorder.color[1] = 255;
+    rlRecorder.color[2] = 255;
+    rlRecorder.color[3] = 255;
+#endif
+    rlRecorder.active = true;
 }
 
-// Textures data management
-//-----------------------------------------------------------------------------------------
-// Convert image data to OpenGL texture (returns OpenGL valid Id)
-unsigned int rlLoadTexture(const void *data, int width, int height, int format, int mipmapCount)
+// End recording draws, returns recorded command buffer
+// NOTE: On OpenGL 3.3/ES2 vertex data is uploaded to GPU static buffers and released from CPU
+rlCommandBuffer rlEndCommandBuffer(void)
 {
-    unsigned int id = 0;
-    if (!isGpuReady) { TRACELOG(RL_LOG_WARNING, "GL: GPU is not ready to load data, trying to load before InitWindow()?"); return id; }
-
-    glBindTexture(GL_TEXTURE_2D, 0);    // Free any old binding
+    rlCommandBuffer buffer = { 0 };
 
-    // Check texture format support by OpenGL 1.1 (compressed textures not supported)
-#if defined(GRAPHICS_API_OPENGL_11)
-    if (format >= RL_PIXELFORMAT_COMPRESSED_DXT1_RGB)
-    {
-        TRACELOG(RL_LOG_WARNING, "GL: OpenGL 1.1 does not support GPU compressed texture formats");
-        return id;
-    }
-#else
-    if ((!RLGL.ExtSupported.texCompDXT) && ((format == RL_PIXELFORMAT_COMPRESSED_DXT1_RGB) || (format == RL_PIXELFORMAT_COMPRESSED_DXT1_RGBA) ||
-        (format == RL_PIXELFORMAT_COMPRESSED_DXT3_RGBA) || (format == RL_PIXELFORMAT_COMPRESSED_DXT5_RGBA)))
+    if (!rlRecorder.active)
     {
-        TRACELOG(RL_LOG_WARNING, "GL: DXT compressed texture format not supported");
-        return id;
+        TRACELOG(RL_LOG_WARNING, "RLGL: Command buffer not recording");
+        return buffer;
     }
+
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
-    if ((!RLGL.ExtSupported.texCompETC1) && (format == RL_PIXELFORMAT_COMPRESSED_ETC1_RGB))
-    {
-        TRACELOG(RL_LOG_WARNING, "GL: ETC1 compressed texture format not supported");
-        return id;
-    }
+    rlDrawRenderBatch(RLGL.currentBatch);   // Record pending batch draws
+#endif
+    rlRecorder.active = false;
 
-    if ((!RLGL.ExtSupported.texCompETC2) && ((format == RL_PIXELFORMAT_COMPRESSED_ETC2_RGB) || (format == RL_PIXELFORMAT_COMPRESSED_ETC2_EAC_RGBA)))
-    {
-        TRACELOG(RL_LOG_WARNING, "GL: ETC2 compressed texture format not supported");
-        return id;
-    }
+    buffer = rlRecorder.buffer;
+    if ((buffer.drawCount > 0) && (buffer.draws[buffer.drawCount - 1].vertexCount == 0)) buffer.drawCount--;
 
-    if ((!RLGL.ExtSupported.texCompPVRT) && ((format == RL_PIXELFORMAT_COMPRESSED_PVRT_RGB) || (format == RL_PIXELFORMAT_COMPRESSED_PVRT_RGBA)))
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if (buffer.vertexCount > 0)
     {
-        TRACELOG(RL_LOG_WARNING, "GL: PVRT compressed texture format not supported");
-        return id;
-    }
+        if (RLGL.ExtSupported.vao)
+        {
+            glGenVertexArrays(1, &buffer.vaoId);
+            glBindVertexArray(buffer.vaoId);
+        }
 
-    if ((!RLGL.ExtSupported.texCompASTC) && ((format == RL_PIXELFORMAT_COMPRESSED_ASTC_4x4_RGBA) || (format == RL_PIXELFORMAT_COMPRESSED_ASTC_8x8_RGBA)))
-    {
-        TRACELOG(RL_LOG_WARNING, "GL: ASTC compressed texture format not supported");
-        return id;
+        // Vertex position buffer (shader-location = 0)
+        glGenBuffers(1, &buffer.vboId[0]);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer.vboId[0]);
+        glBufferData(GL_ARRAY_BUFFER, buffer.vertexCount*3*sizeof(float), buffer.vertices, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION);
+        glVertexAttribPointer(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 3, GL_FLOAT, 0, 0, 0);
+
+        // Vertex texcoord buffer (shader-location = 1)
+        glGenBuffers(1, &buffer.vboId[1]);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer.vboId[1]);
+        glBufferData(GL_ARRAY_BUFFER, buffer.vertexCount*2*sizeof(float), buffer.texcoords, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD);
+        glVertexAttribPointer(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, 2, GL_FLOAT, 0, 0, 0);
+
+        // Vertex color buffer (shader-location = 3)
+        glGenBuffers(1, &buffer.vboId[2]);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer.vboId[2]);
+        glBufferData(GL_ARRAY_BUFFER, buffer.vertexCount*4*sizeof(unsigned char), buffer.colors, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR);
+        glVertexAttribPointer(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, 0);
+
+        if (RLGL.ExtSupported.vao) glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
+
+    // Vertex data is kept on GPU only
+    RL_FREE(buffer.vertices);
+    RL_FREE(buffer.texcoords);
+    RL_FREE(buffer.colors);
+    buffer.vertices = NULL;
+    buffer.texcoords = NULL;
+    buffer.colors = NULL;
 #endif
-#endif  // GRAPHICS_API_OPENGL_11
 
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    memset(&rlRecorder, 0, sizeof(rlCommandRecorder));
 
-    glGenTextures(1, &id);              // Generate texture id
+    TRACELOG(RL_LOG_INFO, "RLGL: Command buffer recorded successfully (%i vertex, %i draws)", buffer.vertexCount, buffer.drawCount);
 
-    glBindTexture(GL_TEXTURE_2D, id);
+    return buffer;
+}
 
-    int mipWidth = width;
-    int mipHeight = height;
-    int mipOffset = 0;          // Mipmap data offset, only used for tracelog
-    (void)mipOffset;            // Used to avoid gcc warnings about unused variable
+// Draw command buffer with a transform and a tint (RGBA normalized, NULL for none)
+// NOTE: Transform is applied before current matrices, draws use the blending mode, shader and scissor
+// they were recorded with (current ones are restored after drawing), stereo rendering is not considered
+// and command buffers can not be drawn while recording
+void rlDrawCommandBuffer(rlCommandBuffer buffer, Matrix transform, const float *tint)
+{
+    if ((buffer.vertexCount == 0) || (buffer.drawCount == 0)) return;
+    if (rlRecorder.active)
+    {
+        TRACELOG(RL_LOG_WARNING, "RLGL: Command buffer can not be drawn while recording");
+        return;
+    }
 
-    // NOTE: Added pointer math separately from function to avoid UBSAN complaining
+    const float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    if (tint == NULL) tint = white;
+
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    rlDrawRenderBatch(RLGL.currentBatch);   // Previous draws are drawn first
+
+    // Draws are drawn with the state they were recorded with, current state is restored at the end
+    rlDrawState previous = { 0 };
+    rlGetDrawState(&previous);
+
+    // Create modelview-projection matrix, including command buffer transform
+    Matrix matModel = transform;
+    if (RLGL.State.transformRequired) matModel = rlMatrixMultiply(transform, RLGL.State.transform);
+    Matrix matMVP = rlMatrixMultiply(rlMatrixMultiply(matModel, RLGL.State.modelview), RLGL.State.projection);
+
+    for (int i = 0, vertexOffset = 0; i < buffer.drawCount; vertexOffset += buffer.draws[i].vertexCount, i++)
+    {
+        // NOTE: Applying a state draws the (empty) batch, unbinding shader program and vertex array,
+        // they are bound again with the state shader
+        if ((i == 0) || (memcmp(&buffer.states[i], &buffer.states[i - 1], sizeof(rlDrawState)) != 0))
+        {
+            rlApplyDrawState(&buffer.states[i]);
+
+            const int *locs = RLGL.State.currentShaderLocs;
+            glUseProgram(RLGL.State.currentShaderId);
+            glUniformMatrix4fv(locs[RL_SHADER_LOC_MATRIX_MVP], 1, false, rlMatrixToFloat(matMVP));
+
+            // Upload the same matrices as rlDrawRenderBatch(), model matrix including command buffer transform
+            if (locs[RL_SHADER_LOC_MATRIX_PROJECTION] != -1) glUniformMatrix4fv(locs[RL_SHADER_LOC_MATRIX_PROJECTION], 1, false, rlMatrixToFloat(RLGL.State.projection));
+            if (locs[RL_SHADER_LOC_MATRIX_VIEW] != -1) glUniformMatrix4fv(locs[RL_SHADER_LOC_MATRIX_VIEW], 1, false, rlMatrixToFloat(RLGL.State.modelview));
+            if (locs[RL_SHADER_LOC_MATRIX_MODEL] != -1) glUniformMatrix4fv(locs[RL_SHADER_LOC_MATRIX_MODEL], 1, false, rlMatrixToFloat(matModel));
+            if (locs[RL_SHADER_LOC_MATRIX_NORMAL] != -1) glUniformMatrix4fv(locs[RL_SHADER_LOC_MATRIX_NORMAL], 1, false, rlMatrixToFloat(rlMatrixTranspose(rlMatrixInvert(matModel))));
+
+            glUniform4f(locs[RL_SHADER_LOC_COLOR_DIFFUSE], tint[0], tint[1], tint[2], tint[3]);
+            glUniform1i(locs[RL_SHADER_LOC_MAP_DIFFUSE], 0);  // Active default sampler2D: texture0
+
+            if (RLGL.ExtSupported.vao) glBindVertexArray(buffer.vaoId);
+            else
+            {
+                // Bind vertex attrib: position (shader-location = 0)
+                glBindBuffer(GL_ARRAY_BUFFER, buffer.vboId[0]);
+                glVertexAttribPointer(locs[RL_SHADER_LOC_VERTEX_POSITION], 3, GL_FLOAT, 0, 0, 0);
+                glEnableVertexAttribArray(locs[RL_SHADER_LOC_VERTEX_POSITION]);
+
+                // Bind vertex attrib: texcoord (shader-location = 1)
+                glBindBuffer(GL_ARRAY_BUFFER, buffer.vboId[1]);
+                glVertexAttribPointer(locs[RL_SHADER_LOC_VERTEX_TEXCOORD01], 2, GL_FLOAT, 0, 0, 0);
+                glEnableVertexAttribArray(locs[RL_SHADER_LOC_VERTEX_TEXCOORD01]);
+
+                // Bind vertex attrib: color (shader-location = 3)
+                glBindBuffer(GL_ARRAY_BUFFER, buffer.vboId[2]);
+                glVertexAttribPointer(locs[RL_SHADER_LOC_VERTEX_COLOR], 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, 0);
+                glEnableVertexAttribArray(locs[RL_SHADER_LOC_VERTEX_COLOR]);
+            }
+
+            glActiveTexture(GL_TEXTURE0);
+        }
+
+        glBindTexture(GL_TEXTURE_2D, buffer.draws[i].textureId);
+        glDrawArrays(buffer.draws[i].mode, vertexOffset, buffer.draws[i].vertexCount);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    if (RLGL.ExtSupported.vao) glBindVertexArray(0);
+    else glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    rlApplyDrawState(&previous);
+    glUseProgram(0);
+#endif
+
+#if defined(GRAPHICS_API_OPENGL_11)
+    unsigned char *colors = buffer.colors;
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    // Software renderer modulates vertex array colors by current color
+    glColor4f(tint[0], tint[1], tint[2], tint[3]);
+#else
+    // Tint is applied to a copy of vertex colors, if required
+    if ((tint[0] != 1.0f) || (tint[1] != 1.0f) || (tint[2] != 1.0f) || (tint[3] != 1.0f))
+    {
+        colors = (unsigned char *)RL_MALLOC(buffer.vertexCount*4*sizeof(unsigned char));
+        for (int i = 0; i < buffer.vertexCount*4; i++) colors[i] = (unsigned char)(buffer.colors[i]*tint[i%4]);
+    }
+#endif
+
+    // Draws are drawn with the state they were recorded with, current state is restored at the end
+    rlDrawState previous = { 0 };
+    rlGetDrawState(&previous);
+
+    glPushMatrix();
+    glMultMatrixf(rlMatrixToFloat(transform));
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, buffer.vertices);
+    glTexCoordPointer(2, GL_FLOAT, 0, buffer.texcoords);
+    glColorPointer(4, GL_UNSIGNED_BYTE, 0, colors);
+
+    for (int i = 0, vertexOffset = 0; i < buffer.drawCount; vertexOffset += buffer.draws[i].vertexCount, i++)
+    {
+        if ((i == 0) || (memcmp(&buffer.states[i], &buffer.states[i - 1], sizeof(rlDrawState)) != 0)) rlApplyDrawState(&buffer.states[i]);
+
+        if (buffer.draws[i].textureId != 0) rlEnableTexture(buffer.draws[i].textureId);
+        else rlDisableTexture();
+
+        switch (buffer.draws[i].mode)
+        {
+            case RL_LINES: glDrawArrays(GL_LINES, vertexOffset, buffer.draws[i].vertexCount); break;
+            case RL_TRIANGLES: glDrawArrays(GL_TRIANGLES, vertexOffset, buffer.draws[i].vertexCount); break;
+            case RL_QUADS: glDrawArrays(GL_QUADS, vertexOffset, buffer.draws[i].vertexCount); break;
+            default: break;
+        }
+    }
+
+    rlDisableTexture();
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_COLOR_ARRAY);
+
+    glPopMatrix();
+    rlApplyDrawState(&previous);
+
+    if (colors != buffer.colors) RL_FREE(colors);
+#endif
+}
+
+// Unload command buffer data (CPU and GPU)
+void rlUnloadCommandBuffer(rlCommandBuffer buffer)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if (buffer.vertexCount > 0)
+    {
+        glDeleteBuffers(3, buffer.vboId);
+        if (RLGL.ExtSupported.vao) glDeleteVertexArrays(1, &buffer.vaoId);
+    }
+#endif
+    RL_FREE(buffer.vertices);
+    RL_FREE(buffer.texcoords);
+    RL_FREE(buffer.colors);
+    RL_FREE(buffer.draws);
+    RL_FREE(buffer.states);
+}
+
+// Load a render batch context, to be filled by a worker thread
+// NOTE: Context state is a copy of current rlgl state, it must be loaded from main thread,
+// context batch uses as many vertex buffers as default batch (drawn chunks go through all of them)
+rlBatchContext rlLoadBatchContext(int bufferElements)
+{
+    rlBatchContext context = { 0 };
+
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+#if defined(RLGL_RENDER_BATCH_THREADS)
+#if defined(RLGL_RENDER_BATCH_STREAMING)
+    context.batch = rlLoadRenderBatch(RL_DEFAULT_BATCH_STREAM_BUFFERS, bufferElements);
+#else
+    context.batch = rlLoadRenderBatch(RL_DEFAULT_BATCH_BUFFERS, bufferElements);
+#endif
+    context.state = (rlBatchContextState *)RL_CALLOC(1, sizeof(rlBatchContextState));
+    context.state->rlgl = RLGL;
+    memset(&context.state->rlgl.defaultBatch, 0, sizeof(rlRenderBatch));  // Default batch arrays belong to main thread
+    context.state->rlgl.State.vertexCounter = 0;
+    context.state->rlgl.State.stereoRender = false;     // Context thread never draws
+#else
+    (void)bufferElements;
+    TRACELOG(RL_LOG_WARNING, "RLGL: Render batch contexts require RLGL_RENDER_BATCH_THREADS");
+#endif
+#else
+    (void)bufferElements;
+#endif
+
+    return context;
+}
+
+// Unload render batch context
+void rlUnloadBatchContext(rlBatchContext context)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+#if defined(RLGL_RENDER_BATCH_THREADS)
+    if (context.state == NULL) return;
+
+    for (int i = 0; i < context.state->chunkCapacity; i++)
+    {
+        rlBatchChunk *chunk = &context.state->chunks[i];
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+        RL_FREE(chunk->buffer.data);
+#else
+        RL_FREE(chunk->buffer.vertices);
+        RL_FREE(chunk->buffer.texcoords);
+        RL_FREE(chunk->buffer.normals);
+        RL_FREE(chunk->buffer.colors);
+#endif
+        RL_FREE(chunk->draws);
+    }
+
+    RL_FREE(context.state->chunks);
+    RL_FREE(context.state);
+    rlUnloadRenderBatch(context.batch);
+#else
+    (void)context;
+#endif
+#else
+    (void)context;
+#endif
+}
+
+// Begin filling render batch context from calling thread
+// NOTE: rlgl vertex level and matrix functions on calling thread use context state until rlEndBatchContext(),
+// blending mode, shader and scissor changes are recorded with the context data, other GL functions must not
+// be called (rlgl GL state functions fail with an error log), only the context batch can be active,
+// vertex data is kept if the batch gets full, matrix stack starts empty
+void rlBeginBatchContext(rlBatchContext *context)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+#if defined(RLGL_RENDER_BATCH_THREADS)
+    if (context->state == NULL) return;
+
+    rlglData *state = &context->state->rlgl;
+    state->currentBatch = &context->batch;
+    state->State.modelview = rlMatrixIdentity();
+    state->State.transform = rlMatrixIdentity();
+    state->State.transformRequired = false;
+    state->State.currentMatrixMode = RL_MODELVIEW;
+    state->State.currentMatrix = &state->State.modelview;
+    state->State.stackCounter = 0;
+
+    rlThreadContext = context->state;
+    rlglCurrent = state;
+#else
+    (void)context;
+#endif
+#else
+    (void)context;
+#endif
+}
+
+// End filling render batch context from calling thread
+// NOTE: Draw state is kept to draw the context batch data
+void rlEndBatchContext(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+#if defined(RLGL_RENDER_BATCH_THREADS)
+    if (rlThreadContext == NULL) return;
+
+    rlGetDrawState(&rlThreadContext->state);
+    rlThreadContext = NULL;
+    rlglCurrent = &rlglMain;
+#endif
+#endif
+}
+
+// Draw render batch context data, batches filled previously are drawn first
+// NOTE: Must be called from main thread, context thread must have finished filling it,
+// data is drawn with the draw state it was filled with, current draw state is restored after
+void rlDrawBatchContext(rlBatchContext *context)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+#if defined(RLGL_RENDER_BATCH_THREADS)
+    if (context->state == NULL) return;
+
+    rlBatchContextState *state = context->state;
+    rlDrawRenderBatch(RLGL.currentBatch);   // Previous draws are drawn first
+
+    rlDrawState previous = { 0 };
+    rlGetDrawState(&previous);
+
+    for (int i = 0; i < state->chunkCount; i++)
+    {
+        rlBatchChunk *chunk = &state->chunks[i];
+
+        // Draw chunk data using context batch, context data is swapped back after
+        // NOTE: Draw state is applied first, it draws current batch (empty)
+        rlApplyDrawState(&chunk->state);
+        RLGL.State.vertexCounter = chunk->vertexCounter;
+        rlSwapBatchChunk(&context->batch, chunk);
+        rlDrawRenderBatch(&context->batch);
+        rlSwapBatchChunk(&context->batch, chunk);
+    }
+
+    // Drawn chunks arrays are kept, reused when the context batch gets full again
+    state->chunkCount = 0;
+
+    rlApplyDrawState(&state->state);
+    RLGL.State.vertexCounter = state->rlgl.State.vertexCounter;
+    rlDrawRenderBatch(&context->batch);
+    state->rlgl.State.vertexCounter = 0;
+
+    rlApplyDrawState(&previous);
+#else
+    (void)context;
+#endif
+#else
+    (void)context;
+#endif
+}
+
+// Check internal buffer overflow for a given number of vertex
+// and force a rlRenderBatch draw call if required
+bool rlCheckRenderBatchLimit(int vCount)
+{
+    bool overflow = false;
+
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if ((RLGL.State.vertexCounter + vCount) >=
+        (RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].elementCount*4))
+    {
+        overflow = true;
+
+        // Store current primitive drawing mode and texture id
+        int currentMode = RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].mode;
+        int currentTexture = RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].textureId;
+
+        rlDrawRenderBatch(RLGL.currentBatch);    // NOTE: Stereo rendering is checked inside
+
+        // Restore state of last batch so new vertices can be added
+        RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].mode = currentMode;
+        RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].textureId = currentTexture;
+    }
+#endif
+
+    return overflow;
+}
+
+// Textures data management
+//-----------------------------------------------------------------------------------------
+// Convert image data to OpenGL texture (returns OpenGL valid Id)
+unsigned int rlLoadTexture(const void *data, int width, int height, int format, int mipmapCount)
+{
+    unsigned int id = 0;
+    if (!isGpuReady) { TRACELOG(RL_LOG_WARNING, "GL: GPU is not ready to load data, trying to load before InitWindow()?"); return id; }
+
+    glBindTexture(GL_TEXTURE_2D, 0);    // Free any old binding
+
+    // Check texture format support by OpenGL 1.1 (compressed textures not supported)
+#if defined(GRAPHICS_API_OPENGL_11)
+    if (format >= RL_PIXELFORMAT_COMPRESSED_DXT1_RGB)
+    {
+        TRACELOG(RL_LOG_WARNING, "GL: OpenGL 1.1 does not support GPU compressed texture formats");
+        return id;
+    }
+#else
+    if ((!RLGL.ExtSupported.texCompDXT) && ((format == RL_PIXELFORMAT_COMPRESSED_DXT1_RGB) || (format == RL_PIXELFORMAT_COMPRESSED_DXT1_RGBA) ||
+        (format == RL_PIXELFORMAT_COMPRESSED_DXT3_RGBA) || (format == RL_PIXELFORMAT_COMPRESSED_DXT5_RGBA)))
+    {
+        TRACELOG(RL_LOG_WARNING, "GL: DXT compressed texture format not supported");
+        return id;
+    }
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if ((!RLGL.ExtSupported.texCompETC1) && (format == RL_PIXELFORMAT_COMPRESSED_ETC1_RGB))
+    {
+        TRACELOG(RL_LOG_WARNING, "GL: ETC1 compressed texture format not supported");
+        return id;
+    }
+
+    if ((!RLGL.ExtSupported.texCompETC2) && ((format == RL_PIXELFORMAT_COMPRESSED_ETC2_RGB) || (format == RL_PIXELFORMAT_COMPRESSED_ETC2_EAC_RGBA)))
+    {
+        TRACELOG(RL_LOG_WARNING, "GL: ETC2 compressed texture format not supported");
+        return id;
+    }
+
+    if ((!RLGL.ExtSupported.texCompPVRT) && ((format == RL_PIXELFORMAT_COMPRESSED_PVRT_RGB) || (format == RL_PIXELFORMAT_COMPRESSED_PVRT_RGBA)))
+    {
+        TRACELOG(RL_LOG_WARNING, "GL: PVRT compressed texture format not supported");
+        return id;
+    }
+
+    if ((!RLGL.ExtSupported.texCompASTC) && ((format == RL_PIXELFORMAT_COMPRESSED_ASTC_4x4_RGBA) || (format == RL_PIXELFORMAT_COMPRESSED_ASTC_8x8_RGBA)))
+    {
+        TRACELOG(RL_LOG_WARNING, "GL: ASTC compressed texture format not supported");
+        return id;
+    }
+#endif
+#endif  // GRAPHICS_API_OPENGL_11
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    glGenTextures(1, &id);              // Generate texture id
+
+    glBindTexture(GL_TEXTURE_2D, id);
+
+    int mipWidth = width;
+    int mipHeight = height;
+    int mipOffset = 0;          // Mipmap data offset, only used for tracelog
+    (void)mipOffset;            // Used to avoid gcc warnings about unused variable
+
+    // NOTE: Added pointer math separately from function to avoid UBSAN complaining
     unsigned char *dataPtr = NULL;
     if (data != NULL) dataPtr = (unsigned char *)data;
 
@@ -3467,6 +4499,19 @@ unsigned int rlLoadTextureDepth(int width, int height, bool useRenderBuffer)
 
         TRACELOG(RL_LOG_INFO, "TEXTURE: [ID %i] Depth renderbuffer loaded successfully (%i bits)", id, (RLGL.ExtSupported.maxDepthBits >= 24)? RLGL.ExtSupported.maxDepthBits : 16);
     }
+#elif defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    // NOTE: Software renderer keeps depth in the framebuffer object storage,
+    // the texture (also used as renderbuffer) receives it as grayscale when sampled
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D, id);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, NULL);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    TRACELOG(RL_LOG_INFO, "TEXTURE: [ID %i] Depth texture loaded successfully", id);
 #endif
 
     return id;
@@ -3692,6 +4737,26 @@ void rlGenTextureMipmaps(unsigned int id, int width, int height, int format, int
     else TRACELOG(RL_LOG_WARNING, "TEXTURE: [ID %i] Failed to generate mipmaps", id);
 
     glBindTexture(GL_TEXTURE_2D, 0);
+#elif defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    // NOTE: Software renderer supports NPOT mipmaps, the levels count is queried from the
+    // generated chain, generation fails for invalid textures and float formats
+    glGetError();   // Clear previous errors
+    glBindTexture(GL_TEXTURE_2D, id);
+    int result = glGetError();  // Invalid textures keep the previous one bound
+
+    int maxLevel = 0;
+    if (result == GL_NO_ERROR)
+    {
+        glGenerateMipmap(GL_TEXTURE_2D);
+        result = glGetError();
+        glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &maxLevel);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    *mipmaps = maxLevel + 1;
+
+    if (result == GL_NO_ERROR) TRACELOG(RL_LOG_INFO, "TEXTURE: [ID %i] Mipmaps generated by software renderer, total: %i", id, *mipmaps);
+    else TRACELOG(RL_LOG_WARNING, "TEXTURE: [ID %i] Failed to generate mipmaps", id);
 #else
     TRACELOG(RL_LOG_WARNING, "TEXTURE: [ID %i] GPU mipmap generation not supported", id);
 #endif
@@ -3779,6 +4844,70 @@ void rlResizeFramebuffer(int width, int height)
 #endif
 }
 
+// Set user memory as framebuffer color buffer, rendering directly into it
+// NOTE: Stride is in bytes, pixels are laid out like rlCopyFramebuffer() output,
+// so RL_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 is stored BGRA if SW_GL_FRAMEBUFFER_COPY_BGRA
+bool rlSetFramebufferMemory(void *pixels, int width, int height, int stride, int format)
+{
+    bool result = false;
+
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    unsigned int glInternalFormat = 0, glFormat = 0, glType = 0;
+    if (pixels != NULL) rlGetGlTextureFormats(format, &glInternalFormat, &glFormat, &glType); // Get OpenGL texture format
+    #if SW_GL_FRAMEBUFFER_COPY_BGRA
+    if (glFormat == GL_RGBA) glFormat = GL_BGRA;
+    #endif
+    result = swSetFramebufferMemory(pixels, width, height, stride, glFormat, glType);
+    if (!result)
+    {
+        // NOTE: Formats not matching the color buffer (or a multisampled one) are an expected
+        // configuration, callers keep copying the framebuffer with rlCopyFramebuffer()
+        SWerrcode error = swGetError();
+        if ((error == SW_INVALID_ENUM) || (error == SW_INVALID_OPERATION)) TRACELOG(RL_LOG_INFO, "FBO: Framebuffer memory format not supported by renderer color buffer");
+        else TRACELOG(RL_LOG_WARNING, "FBO: Failed to set framebuffer memory");
+    }
+#else
+    (void)pixels;
+    (void)width;
+    (void)height;
+    (void)stride;
+    (void)format;
+#endif
+
+    return result;
+}
+
+// Get framebuffer region changed since last reset, false if none
+// NOTE: Region is conservative, aligned to the software renderer tiles
+bool rlGetFramebufferDirtyRect(int *x, int *y, int *width, int *height, bool reset)
+{
+    bool result = false;
+
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    result = swGetDirtyRect(x, y, width, height, reset);
+#else
+    (void)reset;
+    *x = 0;
+    *y = 0;
+    *width = 0;
+    *height = 0;
+#endif
+
+    return result;
+}
+
+// Get user memory set as framebuffer color buffer (NULL if internal)
+void *rlGetFramebufferMemory(void)
+{
+    void *pixels = NULL;
+
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    pixels = swGetFramebufferMemory();
+#endif
+
+    return pixels;
+}
+
 // Read screen pixel data (color buffer)
 unsigned char *rlReadScreenPixels(int width, int height)
 {
@@ -3825,7 +4954,7 @@ unsigned int rlLoadFramebuffer(void)
     unsigned int fboId = 0;
     if (!isGpuReady) { TRACELOG(RL_LOG_WARNING, "GL: GPU is not ready to load data, trying to load before InitWindow()?"); return fboId; }
 
-#if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2))
+#if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE))
     glGenFramebuffers(1, &fboId);       // Create the framebuffer object
     glBindFramebuffer(GL_FRAMEBUFFER, 0);   // Unbind any framebuffer
 #endif
@@ -3868,6 +4997,22 @@ void rlFramebufferAttach(unsigned int fboId, unsigned int texId, int attachType,
         default: break;
     }
 
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+#elif defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    // NOTE: Software renderer supports one color attachment, depth renderbuffers are textures
+    glBindFramebuffer(GL_FRAMEBUFFER, fboId);
+
+    if (attachType == RL_ATTACHMENT_COLOR_CHANNEL0)
+    {
+        if (texType == RL_ATTACHMENT_TEXTURE2D) glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texId, mipLevel);
+        else TRACELOG(RL_LOG_WARNING, "FBO: [ID %i] Color attachment type not supported by software renderer", fboId);
+    }
+    else if (attachType == RL_ATTACHMENT_DEPTH)
+    {
+        if ((texType == RL_ATTACHMENT_TEXTURE2D) || (texType == RL_ATTACHMENT_RENDERBUFFER)) glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texId, mipLevel);
+    }
+    else TRACELOG(RL_LOG_WARNING, "FBO: [ID %i] Attachment not supported by software renderer", fboId);
+
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 #endif
 }
@@ -3877,7 +5022,7 @@ bool rlFramebufferComplete(unsigned int id)
 {
     bool result = false;
 
-#if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2))
+#if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE))
     glBindFramebuffer(GL_FRAMEBUFFER, id);
 
     GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
@@ -3930,6 +5075,19 @@ void rlUnloadFramebuffer(unsigned int id)
     glDeleteFramebuffers(1, &id);
 
     TRACELOG(RL_LOG_INFO, "FBO: [ID %i] Unloaded framebuffer from VRAM (GPU)", id);
+#elif defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    // Query depth attachment to automatically delete texture (renderbuffers are textures)
+    int depthId = 0;
+    glBindFramebuffer(GL_FRAMEBUFFER, id);
+    glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME, &depthId);
+
+    unsigned int depthIdU = (unsigned int)depthId;
+    if (depthIdU != 0) glDeleteTextures(1, &depthIdU);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &id);
+
+    TRACELOG(RL_LOG_INFO, "FBO: [ID %i] Unloaded framebuffer from RAM (software)", id);
 #endif
 }
 
@@ -4091,6 +5249,40 @@ void rlDrawVertexArrayElementsInstanced(int offset, int count, const void *buffe
 #endif
 }
 
+// Draw vertex array (elements if buffer provided) once per instance transform
+// NOTE: Transforms are column-major float16 arrays, each one multiplies the current matrix like rlMultMatrixf(),
+// the software renderer fetches the vertices once for all the instances
+void rlDrawVertexArrayTransformsInstanced(int offset, int count, const void *buffer, const float *transforms, int instances)
+{
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    if (buffer != NULL)
+    {
+        // NOTE: Added pointer math separately from function to avoid UBSAN complaining
+        unsigned short *bufferPtr = (unsigned short *)buffer;
+        if (offset > 0) bufferPtr += offset;
+
+        swDrawElementsInstanced(GL_TRIANGLES, count, GL_UNSIGNED_SHORT, (const unsigned short *)bufferPtr, instances, transforms);
+    }
+    else swDrawArraysInstanced(GL_TRIANGLES, offset, count, instances, transforms);
+#elif defined(GRAPHICS_API_OPENGL_11)
+    for (int i = 0; i < instances; i++)
+    {
+        rlPushMatrix();
+            rlMultMatrixf(&transforms[16*i]);
+            if (buffer != NULL) rlDrawVertexArrayElements(offset, count, buffer);
+            else rlDrawVertexArray(offset, count);
+        rlPopMatrix();
+    }
+#else
+    // NOTE: GPU backends draw instances with shaders (rlDrawVertexArrayInstanced())
+    (void)offset;
+    (void)count;
+    (void)buffer;
+    (void)transforms;
+    (void)instances;
+#endif
+}
+
 // Enable vertex state pointer
 void rlEnableStatePointer(int vertexAttribType, void *buffer)
 {
@@ -4428,6 +5620,7 @@ int rlGetLocationAttrib(unsigned int shaderId, const char *attribName)
 // Set shader value uniform
 void rlSetUniform(int locIndex, const void *value, int uniformType, int count)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     switch (uniformType)
     {
@@ -4454,6 +5647,7 @@ void rlSetUniform(int locIndex, const void *value, int uniformType, int count)
 // Set shader value attribute
 void rlSetVertexAttributeDefault(int locIndex, const void *value, int attribType, int count)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     switch (attribType)
     {
@@ -4469,6 +5663,7 @@ void rlSetVertexAttributeDefault(int locIndex, const void *value, int attribType
 // Set shader value uniform matrix
 void rlSetUniformMatrix(int locIndex, Matrix mat)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     glUniformMatrix4fv(locIndex, 1, false, rlMatrixToFloat(mat));
 #endif
@@ -4477,6 +5672,7 @@ void rlSetUniformMatrix(int locIndex, Matrix mat)
 // Set shader value uniform matrix
 void rlSetUniformMatrices(int locIndex, const Matrix *matrices, int count)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if defined(GRAPHICS_API_OPENGL_33)
     glUniformMatrix4fv(locIndex, count, true, (const float *)matrices);
 #elif defined(GRAPHICS_API_OPENGL_ES2)
@@ -4489,6 +5685,7 @@ void rlSetUniformMatrices(int locIndex, const Matrix *matrices, int count)
 // Set shader value uniform sampler
 void rlSetUniformSampler(int locIndex, unsigned int textureId)
 {
+    RLGL_CHECK_THREAD_CONTEXT();
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     // Check if texture is already active
     for (int i = 0; i < RL_DEFAULT_BATCH_MAX_TEXTURE_UNITS; i++)
@@ -4527,6 +5724,29 @@ void rlSetShader(unsigned int id, int *locs)
 #endif
 }
 
+// Set CPU vertex/fragment programs, used by the software renderer in place of shaders
+// NOTE: Any of them can be NULL to keep the fixed function stage, uniforms are shared by both
+void rlSetSoftwareProgram(rlVertexProcCallback vertexProc, rlFragmentProcCallback fragmentProc)
+{
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    swUseProgram(vertexProc, fragmentProc);
+#else
+    (void)vertexProc;
+    (void)fragmentProc;
+#endif
+}
+
+// Set CPU programs uniforms block, data is copied
+void rlSetSoftwareProgramUniforms(const void *data, int size)
+{
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    swProgramUniforms(data, size);
+#else
+    (void)data;
+    (void)size;
+#endif
+}
+
 // Load compute shader program
 unsigned int rlLoadComputeShaderProgram(unsigned int shaderId)
 {
@@ -5111,6 +6331,611 @@ static void rlUnloadShaderDefault(void)
     TRACELOG(RL_LOG_INFO, "SHADER: [ID %i] Default shader unloaded successfully", RLGL.State.defaultShaderId);
 }
 
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+// Setup render batch interleaved vertex attributes, using current shader locations
+// NOTE: Vertex buffer must be bound to GL_ARRAY_BUFFER, attributes are sourced from it
+static void rlSetRenderBatchVertexAttribs(void)
+{
+    const int *locs = RLGL.State.currentShaderLocs;
+
+    glVertexAttribPointer(locs[RL_SHADER_LOC_VERTEX_POSITION], 3, GL_FLOAT, GL_FALSE, sizeof(rlBatchVertex), (void *)offsetof(rlBatchVertex, position));
+    glEnableVertexAttribArray(locs[RL_SHADER_LOC_VERTEX_POSITION]);
+
+    glVertexAttribPointer(locs[RL_SHADER_LOC_VERTEX_TEXCOORD01], 2, GL_FLOAT, GL_FALSE, sizeof(rlBatchVertex), (void *)offsetof(rlBatchVertex, texcoord));
+    glEnableVertexAttribArray(locs[RL_SHADER_LOC_VERTEX_TEXCOORD01]);
+
+    glVertexAttribPointer(locs[RL_SHADER_LOC_VERTEX_COLOR], 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(rlBatchVertex), (void *)offsetof(rlBatchVertex, color));
+    glEnableVertexAttribArray(locs[RL_SHADER_LOC_VERTEX_COLOR]);
+
+    if (locs[RL_SHADER_LOC_VERTEX_NORMAL] != -1)
+    {
+#if defined(RLGL_RENDER_BATCH_NORMALS)
+        glVertexAttribPointer(locs[RL_SHADER_LOC_VERTEX_NORMAL], 3, GL_BYTE, GL_TRUE, sizeof(rlBatchVertex), (void *)offsetof(rlBatchVertex, normal));
+        glEnableVertexAttribArray(locs[RL_SHADER_LOC_VERTEX_NORMAL]);
+#else
+        // No normals stored, shaders get the constant attribute value
+        glDisableVertexAttribArray(locs[RL_SHADER_LOC_VERTEX_NORMAL]);
+#endif
+    }
+}
+#endif
+
+// Sort render batch draws, merging them by mode and texture
+// NOTE: Every draw is appended to the last group of same mode and texture if no draw of the groups after it
+// overlaps the draw bounds, so the result matches drawing in submission order; bounds are checked on XY plane,
+// draws are not sorted if screen position depends on depth (perspective projection, 3d camera) or on stereo;
+// lines are never moved because of their width, vertex data is rearranged by groups, a trailing empty draw
+// (already open) is kept last
+// Returns false if resulting groups exceed maxDraws, batch is not modified in that case
+static bool rlSortRenderBatch(rlRenderBatch *batch, int maxDraws)
+{
+    rlVertexBuffer *buffer = &batch->vertexBuffer[batch->currentBuffer];
+    int drawCount = batch->drawCounter;
+    bool openDraw = (batch->draws[drawCount - 1].vertexCount == 0);
+    if (openDraw) drawCount--;
+    if (drawCount < 2) return false;
+
+    // XY bounds are only screen bounds if screen x, y and w do not depend on z (orthographic 2D drawing)
+    Matrix matMVP = rlMatrixMultiply(RLGL.State.modelview, RLGL.State.projection);
+    if (RLGL.State.stereoRender || (matMVP.m8 != 0.0f) || (matMVP.m9 != 0.0f) ||
+        (matMVP.m3 != 0.0f) || (matMVP.m7 != 0.0f) || (matMVP.m11 != 0.0f)) return false;
+
+    // Scratch data is allocated on first sort, kept until the batch is unloaded
+    if (batch->sortData == NULL)
+    {
+        rlBatchSortData *sortData = (rlBatchSortData *)RL_CALLOC(1, sizeof(rlBatchSortData));
+        if (sortData == NULL) return false;
+
+        int bufferVertexCount = buffer->elementCount*4;
+        bool loaded = false;
+        sortData->buffer.elementCount = buffer->elementCount;
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+        sortData->buffer.data = (rlBatchVertex *)RL_MALLOC(bufferVertexCount*sizeof(rlBatchVertex));
+        loaded = (sortData->buffer.data != NULL);
+#else
+        sortData->buffer.vertices = (float *)RL_MALLOC(bufferVertexCount*3*sizeof(float));
+        sortData->buffer.texcoords = (float *)RL_MALLOC(bufferVertexCount*2*sizeof(float));
+        sortData->buffer.normals = (float *)RL_MALLOC(bufferVertexCount*3*sizeof(float));
+        sortData->buffer.colors = (unsigned char *)RL_MALLOC(bufferVertexCount*4*sizeof(unsigned char));
+        loaded = ((sortData->buffer.vertices != NULL) && (sortData->buffer.texcoords != NULL) &&
+                  (sortData->buffer.normals != NULL) && (sortData->buffer.colors != NULL));
+#endif
+        if (!loaded)
+        {
+            TRACELOG(RL_LOG_WARNING, "RLGL: Failed to allocate render batch sorting data, draws not sorted");
+            RL_FREE(sortData->buffer.data);
+            RL_FREE(sortData->buffer.vertices);
+            RL_FREE(sortData->buffer.texcoords);
+            RL_FREE(sortData->buffer.normals);
+            RL_FREE(sortData->buffer.colors);
+            RL_FREE(sortData);
+            return false;
+        }
+
+        batch->sortData = sortData;
+    }
+
+    rlBatchSortData *sortData = batch->sortData;
+    int *drawGroup = sortData->drawGroup;
+    int *drawOffset = sortData->drawOffset;
+    int *drawFirstBounds = sortData->drawFirstBounds;
+    int *groupOffset = sortData->groupOffset;
+    int *groupCount = sortData->groupCount;
+    float *groupBounds = sortData->groupBounds;
+    int *groupFirstBounds = sortData->groupFirstBounds;
+    int *groupLastBounds = sortData->groupLastBounds;
+    rlDrawCall *groupDraws = sortData->groupDraws;
+    float *bounds = sortData->bounds;
+    int *boundsDraw = sortData->boundsDraw;
+    int *boundsNext = sortData->boundsNext;
+    int boundsCount = sortData->boundsCount;
+    int groups = 0;
+
+    memset(groupCount, 0, drawCount*sizeof(int));
+
+    // Draws merged by previous sorts keep their bounds, if there are not enough bounds available for
+    // one per draw, bounds of every draw are joined (group bounds used as temporary storage)
+    if ((boundsCount + drawCount) > RL_BATCH_SORT_MAX_BOUNDS)
+    {
+        for (int i = 0; i < sortData->boundedDraws; i++)
+        {
+            groupBounds[4*i + 0] = 3.4e38f;
+            groupBounds[4*i + 1] = 3.4e38f;
+            groupBounds[4*i + 2] = -3.4e38f;
+            groupBounds[4*i + 3] = -3.4e38f;
+        }
+
+        for (int b = 0; b < boundsCount; b++)
+        {
+            float *db = &groupBounds[4*boundsDraw[b]];
+            if (bounds[4*b + 0] < db[0]) db[0] = bounds[4*b + 0];
+            if (bounds[4*b + 1] < db[1]) db[1] = bounds[4*b + 1];
+            if (bounds[4*b + 2] > db[2]) db[2] = bounds[4*b + 2];
+            if (bounds[4*b + 3] > db[3]) db[3] = bounds[4*b + 3];
+        }
+
+        boundsCount = 0;
+        for (int i = 0; i < sortData->boundedDraws; i++)
+        {
+            if (groupBounds[4*i] > groupBounds[4*i + 2]) continue;     // Draw without bounds
+
+            memcpy(&bounds[4*boundsCount], &groupBounds[4*i], 4*sizeof(float));
+            boundsDraw[boundsCount] = i;
+            boundsCount++;
+        }
+    }
+
+    // New vertex bounds, on XY plane, one bounds for every run of primitives touching each other
+    // NOTE: One bounds is reserved for every draw left, primitives are joined to last bounds if no more available
+    for (int i = 0, offset = 0; i < drawCount; offset += (batch->draws[i].vertexCount + batch->draws[i].vertexAlignment), i++)
+    {
+        const rlDrawCall *draw = &batch->draws[i];
+        int bounded = (i < sortData->boundedDraws)? sortData->drawBoundedCount[i] : 0;
+        int primitiveSize = (draw->mode == RL_QUADS)? 4 : ((draw->mode == RL_TRIANGLES)? 3 : 2);
+        float *b = NULL;
+
+        for (int v = offset + bounded; v < (offset + draw->vertexCount); v += primitiveSize)
+        {
+            float pb[4] = { 3.4e38f, 3.4e38f, -3.4e38f, -3.4e38f };
+            for (int k = v; (k < (v + primitiveSize)) && (k < (offset + draw->vertexCount)); k++)
+            {
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+                const float *position = buffer->data[k].position;
+#else
+                const float *position = &buffer->vertices[3*k];
+#endif
+                if (position[0] < pb[0]) pb[0] = position[0];
+                if (position[1] < pb[1]) pb[1] = position[1];
+                if (position[0] > pb[2]) pb[2] = position[0];
+                if (position[1] > pb[3]) pb[3] = position[1];
+            }
+
+            bool join = (b != NULL) && ((boundsCount >= (RL_BATCH_SORT_MAX_BOUNDS - (drawCount - 1 - i))) ||
+                ((pb[0] <= b[2]) && (b[0] <= pb[2]) && (pb[1] <= b[3]) && (b[1] <= pb[3])));
+
+            if (join)
+            {
+                if (pb[0] < b[0]) b[0] = pb[0];
+                if (pb[1] < b[1]) b[1] = pb[1];
+                if (pb[2] > b[2]) b[2] = pb[2];
+                if (pb[3] > b[3]) b[3] = pb[3];
+            }
+            else
+            {
+                b = &bounds[4*boundsCount];
+                memcpy(b, pb, 4*sizeof(float));
+                boundsDraw[boundsCount] = i;
+                boundsCount++;
+            }
+        }
+    }
+
+    // Bounds lists of every draw
+    for (int i = 0; i < drawCount; i++) drawFirstBounds[i] = -1;
+    for (int b = boundsCount - 1; b >= 0; b--)
+    {
+        boundsNext[b] = drawFirstBounds[boundsDraw[b]];
+        drawFirstBounds[boundsDraw[b]] = b;
+    }
+
+    // Group draws, looking back for the last group of same mode and texture
+    for (int i = 0, offset = 0; i < drawCount; offset += (batch->draws[i].vertexCount + batch->draws[i].vertexAlignment), i++)
+    {
+        const rlDrawCall *draw = &batch->draws[i];
+        drawOffset[i] = offset;
+        drawGroup[i] = -1;
+        if ((draw->vertexCount == 0) || (drawFirstBounds[i] == -1)) continue;
+
+        // Draw bounds joined, to skip groups far from the draw
+        float drawBounds[4] = { 3.4e38f, 3.4e38f, -3.4e38f, -3.4e38f };
+        int lastBounds = -1;
+        for (int b = drawFirstBounds[i]; b != -1; b = boundsNext[b])
+        {
+            if (bounds[4*b + 0] < drawBounds[0]) drawBounds[0] = bounds[4*b + 0];
+            if (bounds[4*b + 1] < drawBounds[1]) drawBounds[1] = bounds[4*b + 1];
+            if (bounds[4*b + 2] > drawBounds[2]) drawBounds[2] = bounds[4*b + 2];
+            if (bounds[4*b + 3] > drawBounds[3]) drawBounds[3] = bounds[4*b + 3];
+            lastBounds = b;
+        }
+
+        int group = -1;
+        for (int g = groups - 1; g >= 0; g--)
+        {
+            const rlDrawCall *first = &batch->draws[groupOffset[g]];    // Group first draw, mode and texture
+            if ((first->mode == draw->mode) && (first->textureId == draw->textureId)) { group = g; break; }
+
+            // Lines are not moved and can not be passed over, other draws can pass over groups not overlapping them,
+            // every draw bounds are checked against every draw bounds of the group
+            if ((draw->mode == RL_LINES) || (first->mode == RL_LINES)) break;
+
+            const float *gb = &groupBounds[4*g];
+            bool overlap = false;
+            if ((drawBounds[0] < gb[2]) && (gb[0] < drawBounds[2]) && (drawBounds[1] < gb[3]) && (gb[1] < drawBounds[3]))
+            {
+                for (int a = drawFirstBounds[i]; (a != -1) && !overlap; a = boundsNext[a])
+                {
+                    const float *ab = &bounds[4*a];
+                    for (int b = groupFirstBounds[g]; (b != -1) && !overlap; b = boundsNext[b])
+                    {
+                        const float *bb = &bounds[4*b];
+                        overlap = ((ab[0] < bb[2]) && (bb[0] < ab[2]) && (ab[1] < bb[3]) && (bb[1] < ab[3]));
+                    }
+                }
+            }
+
+            if (overlap) break;
+        }
+
+        if (group == -1)
+        {
+            group = groups++;
+            groupOffset[group] = i;     // NOTE: Temporarily used to store the group first draw
+            memcpy(&groupBounds[4*group], drawBounds, 4*sizeof(float));
+            groupFirstBounds[group] = drawFirstBounds[i];
+        }
+        else
+        {
+            float *gb = &groupBounds[4*group];
+            if (drawBounds[0] < gb[0]) gb[0] = drawBounds[0];
+            if (drawBounds[1] < gb[1]) gb[1] = drawBounds[1];
+            if (drawBounds[2] > gb[2]) gb[2] = drawBounds[2];
+            if (drawBounds[3] > gb[3]) gb[3] = drawBounds[3];
+            boundsNext[groupLastBounds[group]] = drawFirstBounds[i];
+        }
+
+        groupLastBounds[group] = lastBounds;
+        drawGroup[i] = group;
+        groupCount[group] += draw->vertexCount;
+    }
+
+    // Groups vertex offsets, each group aligned to 4 vertex (required by QUADS indexing)
+    int vertexCount = 0;
+    for (int g = 0; g < groups; g++)
+    {
+        groupDraws[g] = batch->draws[groupOffset[g]];
+        groupDraws[g].vertexCount = groupCount[g];
+        groupDraws[g].vertexAlignment = (4 - groupCount[g]%4)%4;
+        groupOffset[g] = vertexCount;
+        groupCount[g] = 0;
+        vertexCount += (groupDraws[g].vertexCount + groupDraws[g].vertexAlignment);
+    }
+
+    bool sorted = ((groups <= maxDraws) && (groups < drawCount) && (vertexCount <= buffer->elementCount*4));
+
+    if (sorted)
+    {
+        // Rearrange vertex data by groups into scratch arrays, in submission order inside every group
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+        rlBatchVertex *data = sortData->buffer.data;
+#else
+        float *vertices = sortData->buffer.vertices;
+        float *texcoords = sortData->buffer.texcoords;
+        float *normals = sortData->buffer.normals;
+        unsigned char *colors = sortData->buffer.colors;
+#endif
+        for (int i = 0; i < drawCount; i++)
+        {
+            int g = drawGroup[i];
+            if (g == -1) continue;
+
+            int src = drawOffset[i];
+            int dst = groupOffset[g] + groupCount[g];
+            int count = batch->draws[i].vertexCount;
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+            memcpy(data + dst, buffer->data + src, count*sizeof(rlBatchVertex));
+#else
+            memcpy(vertices + 3*dst, buffer->vertices + 3*src, count*3*sizeof(float));
+            memcpy(texcoords + 2*dst, buffer->texcoords + 2*src, count*2*sizeof(float));
+            memcpy(normals + 3*dst, buffer->normals + 3*src, count*3*sizeof(float));
+            memcpy(colors + 4*dst, buffer->colors + 4*src, count*4*sizeof(unsigned char));
+#endif
+            groupCount[g] += count;
+        }
+
+        // Alignment vertex are not drawn, just cleared
+        for (int g = 0; g < groups; g++)
+        {
+            int dst = groupOffset[g] + groupDraws[g].vertexCount;
+            int count = groupDraws[g].vertexAlignment;
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+            memset(data + dst, 0, count*sizeof(rlBatchVertex));
+#else
+            memset(vertices + 3*dst, 0, count*3*sizeof(float));
+            memset(texcoords + 2*dst, 0, count*2*sizeof(float));
+            memset(normals + 3*dst, 0, count*3*sizeof(float));
+            memset(colors + 4*dst, 0, count*4*sizeof(unsigned char));
+#endif
+        }
+
+        // Scratch arrays become the buffer arrays, previous ones are the next scratch arrays
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+        sortData->buffer.data = buffer->data;
+        buffer->data = data;
+#else
+        sortData->buffer.vertices = buffer->vertices;
+        sortData->buffer.texcoords = buffer->texcoords;
+        sortData->buffer.normals = buffer->normals;
+        sortData->buffer.colors = buffer->colors;
+        buffer->vertices = vertices;
+        buffer->texcoords = texcoords;
+        buffer->normals = normals;
+        buffer->colors = colors;
+#endif
+
+        // Draws bounds rearranged by groups, groups are the draws bounded for next sort
+        float *sortedBounds = sortData->sortedBounds;
+        int sortedCount = 0;
+        for (int g = 0; g < groups; g++)
+        {
+            for (int b = groupFirstBounds[g]; b != -1; b = boundsNext[b])
+            {
+                memcpy(&sortedBounds[4*sortedCount], &bounds[4*b], 4*sizeof(float));
+                boundsDraw[sortedCount] = g;    // NOTE: Written in place, only bounds and next bounds are read here
+                sortedCount++;
+            }
+
+            sortData->drawBoundedCount[g] = groupDraws[g].vertexCount;
+        }
+
+        memcpy(bounds, sortedBounds, 4*sortedCount*sizeof(float));
+        sortData->boundsCount = sortedCount;
+        sortData->boundedDraws = groups;
+
+        // Replace draws by groups, keeping the open draw (if any) at the end
+        rlDrawCall lastDraw = batch->draws[batch->drawCounter - 1];
+        for (int i = 0; i < batch->drawCounter; i++)
+        {
+            batch->draws[i].mode = RL_QUADS;
+            batch->draws[i].vertexCount = 0;
+            batch->draws[i].vertexAlignment = 0;
+            batch->draws[i].textureId = RLGL.State.defaultTextureId;
+        }
+        for (int g = 0; g < groups; g++) batch->draws[g] = groupDraws[g];
+
+        batch->drawCounter = groups;
+        if (openDraw)
+        {
+            batch->draws[groups] = lastDraw;
+            batch->draws[groups].vertexAlignment = 0;
+            batch->drawCounter++;
+        }
+
+        RLGL.State.vertexCounter = vertexCount;
+    }
+
+    return sorted;
+}
+
+// Record render batch draws into current command buffer
+// NOTE: QUADS are recorded as TRIANGLES, command buffers are drawn without indices
+static void rlRecordRenderBatch(rlRenderBatch *batch)
+{
+    const rlVertexBuffer *buffer = &batch->vertexBuffer[batch->currentBuffer];
+    static const int quadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+
+    for (int i = 0, offset = 0; i < batch->drawCounter; offset += (batch->draws[i].vertexCount + batch->draws[i].vertexAlignment), i++)
+    {
+        const rlDrawCall *draw = &batch->draws[i];
+        if (draw->vertexCount == 0) continue;
+
+        rlRecordDraw((draw->mode == RL_QUADS)? RL_TRIANGLES : draw->mode, draw->textureId);
+
+        int count = (draw->mode == RL_QUADS)? draw->vertexCount/4*6 : draw->vertexCount;
+        for (int k = 0; k < count; k++)
+        {
+            int v = offset + ((draw->mode == RL_QUADS)? (k/6*4 + quadIndices[k%6]) : k);
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+            rlRecordVertex(buffer->data[v].position, buffer->data[v].texcoord, buffer->data[v].color);
+#else
+            rlRecordVertex(&buffer->vertices[3*v], &buffer->texcoords[2*v], &buffer->colors[4*v]);
+#endif
+        }
+    }
+}
+
+#if defined(RLGL_RENDER_BATCH_THREADS)
+// Store render batch data as a chunk of current thread context, batch gets the chunk arrays
+// NOTE: Context thread can not draw the batch when full, chunks are drawn by rlDrawBatchContext(),
+// chunks arrays are allocated only when no drawn chunk is available for reuse
+static void rlStoreRenderBatch(rlRenderBatch *batch)
+{
+    rlBatchContextState *context = rlThreadContext;
+    if (RLGL.State.vertexCounter == 0) return;
+
+    if (context->chunkCount == context->chunkCapacity)
+    {
+        rlBatchChunk *chunks = (rlBatchChunk *)RL_REALLOC(context->chunks, (context->chunkCapacity + 1)*sizeof(rlBatchChunk));
+        if (chunks == NULL)
+        {
+            TRACELOG(RL_LOG_WARNING, "RLGL: Failed to allocate render batch context chunk, batch data discarded");
+            return;
+        }
+        context->chunks = chunks;
+
+        rlBatchChunk chunk = { 0 };
+        int vertexCount = batch->vertexBuffer[batch->currentBuffer].elementCount*4;
+        bool loaded = false;
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+        chunk.buffer.data = (rlBatchVertex *)RL_CALLOC(vertexCount, sizeof(rlBatchVertex));
+        loaded = (chunk.buffer.data != NULL);
+#else
+        chunk.buffer.vertices = (float *)RL_CALLOC(vertexCount*3, sizeof(float));
+        chunk.buffer.texcoords = (float *)RL_CALLOC(vertexCount*2, sizeof(float));
+        chunk.buffer.normals = (float *)RL_CALLOC(vertexCount*3, sizeof(float));
+        chunk.buffer.colors = (unsigned char *)RL_CALLOC(vertexCount*4, sizeof(unsigned char));
+        loaded = ((chunk.buffer.vertices != NULL) && (chunk.buffer.texcoords != NULL) &&
+                  (chunk.buffer.normals != NULL) && (chunk.buffer.colors != NULL));
+#endif
+        chunk.draws = (rlDrawCall *)RL_CALLOC(RL_DEFAULT_BATCH_DRAWCALLS, sizeof(rlDrawCall));
+
+        if (!loaded || (chunk.draws == NULL))
+        {
+            TRACELOG(RL_LOG_WARNING, "RLGL: Failed to allocate render batch context chunk, batch data discarded");
+            RL_FREE(chunk.buffer.data);
+            RL_FREE(chunk.buffer.vertices);
+            RL_FREE(chunk.buffer.texcoords);
+            RL_FREE(chunk.buffer.normals);
+            RL_FREE(chunk.buffer.colors);
+            RL_FREE(chunk.draws);
+            return;
+        }
+
+        context->chunks[context->chunkCapacity] = chunk;
+        context->chunkCapacity++;
+    }
+
+    // Filled arrays are moved to the chunk, batch gets the chunk free arrays
+    // NOTE: Draws are reset by rlDrawRenderBatch()
+    rlBatchChunk *chunk = &context->chunks[context->chunkCount];
+    rlSwapBatchChunk(batch, chunk);
+    chunk->vertexCounter = RLGL.State.vertexCounter;
+    rlGetDrawState(&chunk->state);
+    context->chunkCount++;
+}
+
+// Swap render batch data (vertex arrays and draws) with chunk data
+static void rlSwapBatchChunk(rlRenderBatch *batch, rlBatchChunk *chunk)
+{
+    rlVertexBuffer *buffer = &batch->vertexBuffer[batch->currentBuffer];
+    rlVertexBuffer bufferData = *buffer;
+    rlDrawCall *draws = batch->draws;
+    int drawCounter = batch->drawCounter;
+
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+    buffer->data = chunk->buffer.data;
+    chunk->buffer.data = bufferData.data;
+#else
+    buffer->vertices = chunk->buffer.vertices;
+    buffer->texcoords = chunk->buffer.texcoords;
+    buffer->normals = chunk->buffer.normals;
+    buffer->colors = chunk->buffer.colors;
+    chunk->buffer.vertices = bufferData.vertices;
+    chunk->buffer.texcoords = bufferData.texcoords;
+    chunk->buffer.normals = bufferData.normals;
+    chunk->buffer.colors = bufferData.colors;
+#endif
+    batch->draws = chunk->draws;
+    batch->drawCounter = chunk->drawCounter;
+    chunk->draws = draws;
+    chunk->drawCounter = drawCounter;
+}
+#endif
+
+// Allocate render batch vertex buffer storage, buffer must be bound to GL_ARRAY_BUFFER (vboId[index])
+// NOTE: On streaming mode, storage is persistently mapped if supported, it is never reallocated
+static void rlLoadRenderBatchBuffer(rlVertexBuffer *buffer, int index, int size, const void *data)
+{
+#if defined(RLGL_RENDER_BATCH_STREAMING)
+    buffer->mapped[index] = NULL;
+    buffer->fence = NULL;
+
+#if defined(GRAPHICS_API_OPENGL_33) && !defined(GRAPHICS_API_OPENGL_21)
+    if (RLGL.ExtSupported.bufferStorage)
+    {
+        // Coherent mapping, data copied to mapped memory is visible to the GPU without explicit flush
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        rlStreamGL.bufferStorage(GL_ARRAY_BUFFER, size, data, flags);
+        buffer->mapped[index] = rlStreamGL.mapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+        if (buffer->mapped[index] != NULL) return;
+
+        // NOTE: Immutable storage can not be reallocated (orphaned), buffer is replaced by a new one
+        TRACELOG(RL_LOG_WARNING, "RLGL: Failed to map render batch vertex buffer, using buffer orphaning");
+        glDeleteBuffers(1, &buffer->vboId[index]);
+        glGenBuffers(1, &buffer->vboId[index]);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer->vboId[index]);
+    }
+#endif
+    rlStreamGL.bufferData(GL_ARRAY_BUFFER, size, data, GL_STREAM_DRAW);
+#else
+    (void)buffer;
+    (void)index;
+    glBufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW);
+#endif
+}
+
+// Update render batch vertex buffer data from CPU array, buffer must be bound to GL_ARRAY_BUFFER
+// NOTE: On streaming mode, data is copied to mapped memory (GPU already released it, see rlWaitRenderBatchBuffer())
+// or buffer storage is orphaned first, so the driver does not need to wait for GPU reading previous data
+static void rlUpdateRenderBatchBuffer(rlVertexBuffer *buffer, int index, int vertexSize, const void *data)
+{
+    int dataSize = RLGL.State.vertexCounter*vertexSize;
+
+#if defined(RLGL_RENDER_BATCH_STREAMING)
+    if (buffer->mapped[index] != NULL) memcpy(buffer->mapped[index], data, dataSize);
+    else
+    {
+        rlStreamGL.bufferData(GL_ARRAY_BUFFER, buffer->elementCount*4*vertexSize, NULL, GL_STREAM_DRAW);
+        rlStreamGL.bufferSubData(GL_ARRAY_BUFFER, 0, dataSize, data);
+        rlBatchStats.orphans++;
+    }
+#else
+    (void)buffer;
+    (void)index;
+    glBufferSubData(GL_ARRAY_BUFFER, 0, dataSize, data);
+#endif
+
+    rlBatchStats.uploads++;
+    rlBatchStats.uploadBytes += dataSize;
+}
+
+#if defined(RLGL_RENDER_BATCH_STREAMING)
+// Set render batch streaming GL functions from the loaded GL functions
+// NOTE: Entries already set are kept, a mock GL layer sets them before loading render batches
+static void rlLoadStreamingProcs(void)
+{
+    if (rlStreamGL.bufferData == NULL) rlStreamGL.bufferData = glBufferData;
+    if (rlStreamGL.bufferSubData == NULL) rlStreamGL.bufferSubData = glBufferSubData;
+#if defined(GRAPHICS_API_OPENGL_33) && !defined(GRAPHICS_API_OPENGL_21)
+    if (rlStreamGL.bufferStorage == NULL) rlStreamGL.bufferStorage = glBufferStorage;
+    if (rlStreamGL.mapBufferRange == NULL) rlStreamGL.mapBufferRange = glMapBufferRange;
+    if (rlStreamGL.fenceSync == NULL) rlStreamGL.fenceSync = glFenceSync;
+    if (rlStreamGL.clientWaitSync == NULL) rlStreamGL.clientWaitSync = glClientWaitSync;
+    if (rlStreamGL.deleteSync == NULL) rlStreamGL.deleteSync = glDeleteSync;
+#endif
+}
+
+// Wait for the GPU to complete the draws using render batch vertex buffers (mapped buffers only)
+// NOTE: With enough ring buffers, the fence is already signaled and there is no stall
+static void rlWaitRenderBatchBuffer(rlVertexBuffer *buffer)
+{
+#if defined(GRAPHICS_API_OPENGL_33) && !defined(GRAPHICS_API_OPENGL_21)
+    if (buffer->fence == NULL) return;
+
+    GLsync fence = (GLsync)buffer->fence;
+    GLenum result = rlStreamGL.clientWaitSync(fence, 0, 0);
+
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+        // Flush commands on wait, in case the fence was not submitted yet
+        rlBatchStats.fenceWaits++;
+        do result = rlStreamGL.clientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        while (result == GL_TIMEOUT_EXPIRED);
+    }
+
+    if (result == GL_WAIT_FAILED) TRACELOG(RL_LOG_WARNING, "RLGL: Failed to wait for render batch vertex buffer fence");
+
+    rlStreamGL.deleteSync(fence);
+    buffer->fence = NULL;
+#else
+    (void)buffer;
+#endif
+}
+
+// Insert a fence after the draws using render batch vertex buffers (mapped buffers only)
+// NOTE: Orphaned buffers are synchronized by the driver, no fence required
+static void rlFenceRenderBatchBuffer(rlVertexBuffer *buffer)
+{
+#if defined(GRAPHICS_API_OPENGL_33) && !defined(GRAPHICS_API_OPENGL_21)
+    if (buffer->mapped[0] == NULL) return;
+
+    if (buffer->fence != NULL) rlStreamGL.deleteSync((GLsync)buffer->fence);
+    buffer->fence = (void *)rlStreamGL.fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#else
+    (void)buffer;
+#endif
+}
+#endif
+
 #if defined(RLGL_SHOW_GL_DETAILS_INFO)
 // Get compressed format official GL identifier name
 static const char *rlGetCompressedFormatName(int format)
@@ -5251,6 +7076,142 @@ static int rlGetPixelDataSize(int width, int height, int format)
     return dataSize;
 }
 
+// Record a new draw into current command buffer, with current draw state
+// NOTE: Draw is merged with previous one if mode, texture and state match, previous draw is reused if empty
+static void rlRecordDraw(int mode, unsigned int textureId)
+{
+    rlCommandBuffer *buffer = &rlRecorder.buffer;
+    if (rlRecorder.failed) return;
+
+    rlDrawState state = { 0 };
+    rlGetDrawState(&state);
+
+    if (buffer->drawCount > 0)
+    {
+        rlDrawCall *last = &buffer->draws[buffer->drawCount - 1];
+        if ((last->mode == mode) && (last->textureId == textureId) &&
+            (memcmp(&buffer->states[buffer->drawCount - 1], &state, sizeof(rlDrawState)) == 0)) return;
+        if (last->vertexCount == 0) buffer->drawCount--;
+    }
+
+    if (buffer->drawCount >= rlRecorder.drawCapacity)
+    {
+        int capacity = (rlRecorder.drawCapacity > 0)? rlRecorder.drawCapacity*2 : 32;
+
+        // NOTE: Arrays are updated as they grow, a failed grow keeps the previous array
+        rlDrawCall *draws = (rlDrawCall *)RL_REALLOC(buffer->draws, capacity*sizeof(rlDrawCall));
+        if (draws != NULL) buffer->draws = draws;
+        rlDrawState *states = (draws != NULL)? (rlDrawState *)RL_REALLOC(buffer->states, capacity*sizeof(rlDrawState)) : NULL;
+        if (states != NULL) buffer->states = states;
+
+        if ((draws == NULL) || (states == NULL))
+        {
+            TRACELOG(RL_LOG_WARNING, "RLGL: Failed to allocate command buffer draws, next draws discarded");
+            rlRecorder.failed = true;
+            return;
+        }
+
+        rlRecorder.drawCapacity = capacity;
+    }
+
+    rlDrawCall *draw = &buffer->draws[buffer->drawCount];
+    draw->mode = mode;
+    draw->vertexCount = 0;
+    draw->vertexAlignment = 0;
+    draw->textureId = textureId;
+    memcpy(&buffer->states[buffer->drawCount], &state, sizeof(rlDrawState));
+    buffer->drawCount++;
+}
+
+// Record one vertex into current command buffer draw
+// NOTE: Vertex data is discarded after an allocation failure, recorded data is kept consistent
+static void rlRecordVertex(const float *position, const float *texcoord, const unsigned char *color)
+{
+    rlCommandBuffer *buffer = &rlRecorder.buffer;
+
+    if (buffer->drawCount == 0) rlRecordDraw(RL_TRIANGLES, 0);
+    if (rlRecorder.failed) return;
+
+    if (buffer->vertexCount >= rlRecorder.vertexCapacity)
+    {
+        int capacity = (rlRecorder.vertexCapacity > 0)? rlRecorder.vertexCapacity*2 : 1024;
+
+        // NOTE: Arrays are updated as they grow, a failed grow keeps the previous array
+        float *vertices = (float *)RL_REALLOC(buffer->vertices, capacity*3*sizeof(float));
+        if (vertices != NULL) buffer->vertices = vertices;
+        float *texcoords = (vertices != NULL)? (float *)RL_REALLOC(buffer->texcoords, capacity*2*sizeof(float)) : NULL;
+        if (texcoords != NULL) buffer->texcoords = texcoords;
+        unsigned char *colors = (texcoords != NULL)? (unsigned char *)RL_REALLOC(buffer->colors, capacity*4*sizeof(unsigned char)) : NULL;
+        if (colors != NULL) buffer->colors = colors;
+
+        if ((vertices == NULL) || (texcoords == NULL) || (colors == NULL))
+        {
+            TRACELOG(RL_LOG_WARNING, "RLGL: Failed to allocate command buffer vertex data, next vertex discarded");
+            rlRecorder.failed = true;
+            return;
+        }
+
+        rlRecorder.vertexCapacity = capacity;
+    }
+
+    int v = buffer->vertexCount;
+    memcpy(&buffer->vertices[3*v], position, 3*sizeof(float));
+    memcpy(&buffer->texcoords[2*v], texcoord, 2*sizeof(float));
+    memcpy(&buffer->colors[4*v], color, 4*sizeof(unsigned char));
+
+    buffer->vertexCount++;
+    buffer->draws[buffer->drawCount - 1].vertexCount++;
+}
+
+// Get current draw state (blending, shader, scissor)
+// NOTE: State is cleared first, states can be compared with memcmp()
+static void rlGetDrawState(rlDrawState *state)
+{
+    memset(state, 0, sizeof(rlDrawState));
+
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    state->blendMode = RLGL.State.currentBlendMode;
+    state->blendFactors[0] = RLGL.State.glBlendSrcFactor;
+    state->blendFactors[1] = RLGL.State.glBlendDstFactor;
+    state->blendFactors[2] = RLGL.State.glBlendEquation;
+    state->blendFactorsSeparate[0] = RLGL.State.glBlendSrcFactorRGB;
+    state->blendFactorsSeparate[1] = RLGL.State.glBlendDestFactorRGB;
+    state->blendFactorsSeparate[2] = RLGL.State.glBlendSrcFactorAlpha;
+    state->blendFactorsSeparate[3] = RLGL.State.glBlendDestFactorAlpha;
+    state->blendFactorsSeparate[4] = RLGL.State.glBlendEquationRGB;
+    state->blendFactorsSeparate[5] = RLGL.State.glBlendEquationAlpha;
+    state->shaderId = RLGL.State.currentShaderId;
+    state->shaderLocs = RLGL.State.currentShaderLocs;
+    state->scissorEnabled = RLGL.State.scissorEnabled;
+    memcpy(state->scissor, RLGL.State.scissor, sizeof(state->scissor));
+#else
+    // NOTE: OpenGL 1.1 only tracks scissor state, no shaders and blending mode is not changed
+    state->scissorEnabled = rlScissorEnabled;
+    memcpy(state->scissor, rlScissorRect, sizeof(state->scissor));
+#endif
+}
+
+// Set draw state as current (blending, shader, scissor)
+// NOTE: Only changes are applied, current batch is drawn first on changes
+static void rlApplyDrawState(const rlDrawState *state)
+{
+    rlDrawState current = { 0 };
+    rlGetDrawState(&current);
+
+    rlSetBlendFactors(state->blendFactors[0], state->blendFactors[1], state->blendFactors[2]);
+    rlSetBlendFactorsSeparate(state->blendFactorsSeparate[0], state->blendFactorsSeparate[1], state->blendFactorsSeparate[2],
+        state->blendFactorsSeparate[3], state->blendFactorsSeparate[4], state->blendFactorsSeparate[5]);
+    rlSetBlendMode(state->blendMode);
+    rlSetShader(state->shaderId, state->shaderLocs);
+
+    if (state->scissorEnabled != current.scissorEnabled)
+    {
+        if (state->scissorEnabled) rlEnableScissorTest();
+        else rlDisableScissorTest();
+    }
+    if (memcmp(state->scissor, current.scissor, sizeof(state->scissor)) != 0) rlScissor(state->scissor[0], state->scissor[1], state->scissor[2], state->scissor[3]);
+}
+
 // Auxiliar math functions
 //-------------------------------------------------------------------------------
 // Get identity matrix
@@ -5264,7 +7225,7 @@ static Matrix rlMatrixIdentity(void)
 
     return matIdentity;
 }
-#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+
 // Get float array of matrix data
 // Explicit conversion to column-major memory layout
 static rl_float16 rlMatrixToFloatV(Matrix mat)
@@ -5317,6 +7278,7 @@ static Matrix rlMatrixMultiply(Matrix left, Matrix right)
     return result;
 }
 
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
 // Transposes provided matrix
 static Matrix rlMatrixTranspose(Matrix mat)
 {
@@ -5341,6 +7303,7 @@ static Matrix rlMatrixTranspose(Matrix mat)
 
     return result;
 }
+#endif
 
 // Invert provided matrix
 static Matrix rlMatrixInvert(Matrix mat)
@@ -5388,6 +7351,5 @@ static Matrix rlMatrixInvert(Matrix mat)
 
     return result;
 }
-#endif
 
 #endif  // RLGL_IMPLEMENTATION
\ No newline at end of file
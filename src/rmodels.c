@@ -1692,6 +1692,43 @@ void DrawMesh(Mesh mesh, Material material, Matrix transform)
 // Draw multiple mesh instances with material and different transforms
 void DrawMeshInstanced(Mesh mesh, Material material, const Matrix *transforms, int instances)
 {
+#if defined(GRAPHICS_API_OPENGL_11) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    // NOTE: Vertex arrays are set up like DrawMesh(), the instances transforms
+    // are applied on top of the current matrix, one draw for all of them
+    if (mesh.texcoords && material.maps[MATERIAL_MAP_DIFFUSE].texture.id > 0) rlEnableTexture(material.maps[MATERIAL_MAP_DIFFUSE].texture.id);
+
+    if (mesh.animVertices) rlEnableStatePointer(GL_VERTEX_ARRAY, mesh.animVertices);
+    else rlEnableStatePointer(GL_VERTEX_ARRAY, mesh.vertices);
+
+    if (mesh.texcoords) rlEnableStatePointer(GL_TEXTURE_COORD_ARRAY, mesh.texcoords);
+
+    if (mesh.animNormals) rlEnableStatePointer(GL_NORMAL_ARRAY, mesh.animNormals);
+    else if (mesh.normals) rlEnableStatePointer(GL_NORMAL_ARRAY, mesh.normals);
+
+    if (mesh.colors) rlEnableStatePointer(GL_COLOR_ARRAY, mesh.colors);
+
+    // Fill buffer with instances transformations as float16 arrays
+    float16 *instanceTransforms = (float16 *)RL_MALLOC(instances*sizeof(float16));
+    for (int i = 0; i < instances; i++) instanceTransforms[i] = MatrixToFloatV(transforms[i]);
+
+    rlColor4ub(material.maps[MATERIAL_MAP_DIFFUSE].color.r,
+               material.maps[MATERIAL_MAP_DIFFUSE].color.g,
+               material.maps[MATERIAL_MAP_DIFFUSE].color.b,
+               material.maps[MATERIAL_MAP_DIFFUSE].color.a);
+
+    if (mesh.indices != NULL) rlDrawVertexArrayTransformsInstanced(0, mesh.triangleCount*3, mesh.indices, (const float *)instanceTransforms, instances);
+    else rlDrawVertexArrayTransformsInstanced(0, mesh.vertexCount, NULL, (const float *)instanceTransforms, instances);
+
+    rlDisableStatePointer(GL_VERTEX_ARRAY);
+    rlDisableStatePointer(GL_TEXTURE_COORD_ARRAY);
+    rlDisableStatePointer(GL_NORMAL_ARRAY);
+    rlDisableStatePointer(GL_COLOR_ARRAY);
+
+    rlDisableTexture();
+
+    RL_FREE(instanceTransforms);
+#endif
+
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     // Instancing required variables
     float16 *instanceTransforms = NULL;
@@ -0,0 +1,318 @@
+/*******************************************************************************************
+*
+*   rlgl test - Render batch contexts (RLGL_RENDER_BATCH_THREADS)
+*
+*   Headless test, rlgl implementation is included with a mock OpenGL 3.3 layer:
+*   GL functions used by batch drawing are no-op stubs, draw calls are recorded with the
+*   texture, blending and scissor state they were issued with
+*
+*   Context is filled from the test thread, rlgl state is switched through the same
+*   thread-local pointer used by worker threads; draws are compared with the same
+*   quads drawn directly on a main thread batch of the same size
+*
+*   Checked, unsorted and sorted (rlEnableRenderBatchSort()):
+*     - Context filled past the batch size, data stored as chunks, chunks reused on next fill
+*     - Blending mode and scissor changed mid-fill, replayed by rlDrawBatchContext()
+*     - Draws count and textures order, main thread state restored after drawing
+*     - Default batch not reachable from context thread (rlSetRenderBatchActive(NULL) fails)
+*
+*   Test originally created with raylib 5.6-dev, last time updated with raylib 5.6-dev
+*
+*   Test licensed under an unmodified zlib/libpng license, which is an OSI-certified,
+*   BSD-like license that allows static linking with closed source software
+*
+*   Copyright (c) 2026 raylib contributors
+*
+********************************************************************************************/
+
+#define GRAPHICS_API_OPENGL_33
+#define RLGL_STANDALONE
+#define RLGL_RENDER_BATCH_THREADS
+#define RLGL_IMPLEMENTATION
+#include "rlgl.h"
+
+#include <stdio.h>          // Required for: printf()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define TEST_BATCH_ELEMENTS     16      // Render batch quads per vertex buffer, less than quads per fill
+#define TEST_SEGMENT_QUADS      10      // Quads filled between state changes
+#define TEST_SEGMENTS            3      // Segments: alpha, additive, alpha with scissor
+#define TEST_MAX_DRAWS         128      // Draw calls recorded by the mock
+
+#define TEST_TEXTURE_A           2      // Texture ids, default texture is 1
+#define TEST_TEXTURE_B           3
+
+#define CHECK(condition) do { if (!(condition)) { printf("    FAILED: %s (line %i)\n", #condition, __LINE__); failed++; } } while (0)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Mock draw call, with the GL state it was issued with
+typedef struct MockDraw {
+    int count;                  // Index count
+    int textureId;              // Texture bound
+    int blendDst;               // Blending destination factor
+    bool scissorEnabled;        // Scissor test enabled
+    int scissor[4];             // Scissor rectangle
+} MockDraw;
+
+// Mock GPU state
+typedef struct MockGL {
+    int boundTexture;           // Texture bound to GL_TEXTURE_2D
+    int blendDst;               // Blending destination factor
+    bool scissorEnabled;        // Scissor test enabled
+    int scissor[4];             // Scissor rectangle
+    int stateCalls;             // Blending and scissor GL calls
+
+    MockDraw draws[TEST_MAX_DRAWS];
+    int drawCount;
+} MockGL;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static MockGL mock = { 0 };
+
+//----------------------------------------------------------------------------------
+// Mock GL functions
+//----------------------------------------------------------------------------------
+static void GLAD_API_PTR MockGenObjects(GLsizei n, GLuint *ids) { static GLuint nextId = 1; for (int i = 0; i < n; i++) ids[i] = nextId++; }
+static void GLAD_API_PTR MockDeleteObjects(GLsizei n, const GLuint *ids) { }
+static void GLAD_API_PTR MockBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) { }
+static void GLAD_API_PTR MockBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) { }
+static void GLAD_API_PTR MockBindBuffer(GLenum target, GLuint id) { }
+static void GLAD_API_PTR MockBindObject(GLuint id) { }
+static void GLAD_API_PTR MockBindTexture(GLenum target, GLuint id) { mock.boundTexture = (int)id; }
+static void GLAD_API_PTR MockActiveTexture(GLenum texture) { }
+static void GLAD_API_PTR MockVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer) { }
+static void GLAD_API_PTR MockUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) { }
+static void GLAD_API_PTR MockUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) { }
+static void GLAD_API_PTR MockUniform1i(GLint location, GLint v0) { }
+static void GLAD_API_PTR MockBlendFunc(GLenum src, GLenum dst) { mock.blendDst = (int)dst; mock.stateCalls++; }
+static void GLAD_API_PTR MockBlendEquation(GLenum mode) { }
+static void GLAD_API_PTR MockEnable(GLenum cap) { if (cap == GL_SCISSOR_TEST) { mock.scissorEnabled = true; mock.stateCalls++; } }
+static void GLAD_API_PTR MockDisable(GLenum cap) { if (cap == GL_SCISSOR_TEST) { mock.scissorEnabled = false; mock.stateCalls++; } }
+static void GLAD_API_PTR MockScissor(GLint x, GLint y, GLsizei width, GLsizei height) { mock.scissor[0] = x; mock.scissor[1] = y; mock.scissor[2] = width; mock.scissor[3] = height; mock.stateCalls++; }
+static void GLAD_API_PTR MockDrawArrays(GLenum mode, GLint first, GLsizei count) { mock.drawCount++; }
+
+static void GLAD_API_PTR MockDrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices)
+{
+    if (mock.drawCount >= TEST_MAX_DRAWS) return;
+
+    MockDraw *draw = &mock.draws[mock.drawCount++];
+    draw->count = count;
+    draw->textureId = mock.boundTexture;
+    draw->blendDst = mock.blendDst;
+    draw->scissorEnabled = mock.scissorEnabled;
+    for (int i = 0; i < 4; i++) draw->scissor[i] = mock.scissor[i];
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+// Initialize mock GL layer and rlgl state required by render batch
+static void InitMockGL(void)
+{
+    static int shaderLocs[RL_MAX_SHADER_LOCATIONS] = { 0 };
+    for (int i = 0; i < RL_MAX_SHADER_LOCATIONS; i++) shaderLocs[i] = -1;
+
+    glad_glGenBuffers = MockGenObjects;
+    glad_glGenVertexArrays = MockGenObjects;
+    glad_glDeleteBuffers = MockDeleteObjects;
+    glad_glDeleteVertexArrays = MockDeleteObjects;
+    glad_glBindBuffer = MockBindBuffer;
+    glad_glBufferData = MockBufferData;
+    glad_glBufferSubData = MockBufferSubData;
+    glad_glBindVertexArray = MockBindObject;
+    glad_glUseProgram = MockBindObject;
+    glad_glEnableVertexAttribArray = MockBindObject;
+    glad_glDisableVertexAttribArray = MockBindObject;
+    glad_glBindTexture = MockBindTexture;
+    glad_glActiveTexture = MockActiveTexture;
+    glad_glVertexAttribPointer = MockVertexAttribPointer;
+    glad_glUniformMatrix4fv = MockUniformMatrix4fv;
+    glad_glUniform4f = MockUniform4f;
+    glad_glUniform1i = MockUniform1i;
+    glad_glBlendFunc = MockBlendFunc;
+    glad_glBlendEquation = MockBlendEquation;
+    glad_glEnable = MockEnable;
+    glad_glDisable = MockDisable;
+    glad_glScissor = MockScissor;
+    glad_glDrawArrays = MockDrawArrays;
+    glad_glDrawElements = MockDrawElements;
+
+    isGpuReady = true;
+    RLGL.ExtSupported.vao = true;
+    RLGL.State.defaultTextureId = 1;
+    RLGL.State.currentTextureId = 1;
+    RLGL.State.currentShaderId = 1;
+    RLGL.State.currentShaderLocs = shaderLocs;
+    RLGL.State.currentBlendMode = RL_BLEND_ALPHA;
+    RLGL.State.modelview = rlMatrixIdentity();
+    RLGL.State.projection = rlMatrixIdentity();
+    RLGL.State.transform = rlMatrixIdentity();
+    RLGL.State.currentMatrix = &RLGL.State.modelview;
+    rlOrtho(0.0, 200.0, 100.0, 0.0, 0.0, 1.0);
+
+    mock = (MockGL){ 0 };
+    mock.blendDst = GL_ONE_MINUS_SRC_ALPHA;
+}
+
+// Draw a textured quad
+static void DrawQuad(unsigned int textureId, float x, float y, float size)
+{
+    rlSetTexture(textureId);
+    rlBegin(RL_QUADS);
+        rlColor4ub(255, 255, 255, 255);
+        rlTexCoord2f(0.0f, 0.0f); rlVertex2f(x, y);
+        rlTexCoord2f(0.0f, 1.0f); rlVertex2f(x, y + size);
+        rlTexCoord2f(1.0f, 1.0f); rlVertex2f(x + size, y + size);
+        rlTexCoord2f(1.0f, 0.0f); rlVertex2f(x + size, y);
+    rlEnd();
+    rlSetTexture(0);
+}
+
+// Fill current batch with segments of quads alternating two textures (not overlapping),
+// blending mode and scissor changed between segments, state is reset at the end
+static void FillQuads(void)
+{
+    for (int s = 0; s < TEST_SEGMENTS; s++)
+    {
+        if (s == 1) rlSetBlendMode(RL_BLEND_ADDITIVE);
+        if (s == 2)
+        {
+            rlSetBlendMode(RL_BLEND_ALPHA);
+            rlEnableScissorTest();
+            rlScissor(1, 2, 3, 4);
+        }
+
+        for (int i = 0; i < TEST_SEGMENT_QUADS; i++) DrawQuad((i%2 == 0)? TEST_TEXTURE_A : TEST_TEXTURE_B, i*10.0f, s*10.0f, 10.0f);
+    }
+
+    rlDisableScissorTest();
+}
+
+// Check draws are the same as reference draws
+static int CheckDraws(const MockDraw *reference, int referenceCount)
+{
+    int failed = 0;
+
+    CHECK(mock.drawCount == referenceCount);
+    for (int i = 0; (i < mock.drawCount) && (i < referenceCount); i++)
+    {
+        const MockDraw *draw = &mock.draws[i];
+        CHECK(draw->count == reference[i].count);
+        CHECK(draw->textureId == reference[i].textureId);
+        CHECK(draw->blendDst == reference[i].blendDst);
+        CHECK(draw->scissorEnabled == reference[i].scissorEnabled);
+        if (draw->scissorEnabled) CHECK((draw->scissor[0] == 1) && (draw->scissor[1] == 2) && (draw->scissor[2] == 3) && (draw->scissor[3] == 4));
+    }
+
+    return failed;
+}
+
+// Fill a render batch context twice and draw it, draws must match the same quads drawn on main thread
+static int TestBatchContext(bool sort)
+{
+    int failed = 0;
+    printf("  fill past batch size, blending and scissor changes, %s\n", sort? "sorted" : "unsorted");
+
+    InitMockGL();
+
+    RLGL.defaultBatch = rlLoadRenderBatch(RL_DEFAULT_BATCH_BUFFERS, TEST_BATCH_ELEMENTS);
+    RLGL.currentBatch = &RLGL.defaultBatch;
+    if (sort) rlEnableRenderBatchSort();     // NOTE: Sorting flag is copied to context state on loading
+
+    // Reference draws, same quads drawn directly
+    FillQuads();
+    rlDrawRenderBatch(RLGL.currentBatch);
+
+    MockDraw reference[TEST_MAX_DRAWS] = { 0 };
+    int referenceCount = mock.drawCount;
+    for (int i = 0; i < referenceCount; i++) reference[i] = mock.draws[i];
+
+    int indexCount = 0;
+    for (int i = 0; i < referenceCount; i++) indexCount += reference[i].count;
+    CHECK(indexCount == TEST_SEGMENTS*TEST_SEGMENT_QUADS*6);
+    if (sort) CHECK(referenceCount < TEST_SEGMENTS*TEST_SEGMENT_QUADS);
+    else
+    {
+        // Unsorted, one draw per quad in submission order
+        CHECK(referenceCount == TEST_SEGMENTS*TEST_SEGMENT_QUADS);
+        for (int i = 0; i < referenceCount; i++)
+        {
+            CHECK(reference[i].textureId == ((i%2 == 0)? TEST_TEXTURE_A : TEST_TEXTURE_B));
+            CHECK(reference[i].blendDst == ((i/TEST_SEGMENT_QUADS == 1)? GL_ONE : GL_ONE_MINUS_SRC_ALPHA));
+            CHECK(reference[i].scissorEnabled == (i/TEST_SEGMENT_QUADS == 2));
+        }
+    }
+
+    rlBatchContext context = rlLoadBatchContext(TEST_BATCH_ELEMENTS);
+    CHECK(context.batch.bufferCount == RL_DEFAULT_BATCH_BUFFERS);
+
+    int chunkCapacity = 0;
+    for (int fill = 0; fill < 2; fill++)
+    {
+        // Main thread state, different from context one, restored after drawing
+        rlSetBlendMode(RL_BLEND_MULTIPLIED);
+        mock.drawCount = 0;
+        mock.stateCalls = 0;
+
+        rlBeginBatchContext(&context);
+            CHECK(RLGL.currentBatch == &context.batch);
+            rlSetRenderBatchActive(NULL);       // Fails, default batch belongs to main thread
+            CHECK(RLGL.currentBatch == &context.batch);
+            CHECK(RLGL.State.currentBlendMode == RL_BLEND_ALPHA);
+
+            FillQuads();
+            rlSetBlendMode(RL_BLEND_ALPHA);
+        rlEndBatchContext();
+
+        // Nothing drawn from context, data stored as chunks (reused on second fill), main batch not touched
+        CHECK(mock.drawCount == 0);
+        CHECK(mock.stateCalls == 0);
+        CHECK(context.state->chunkCount > 0);
+        CHECK(RLGL.State.vertexCounter == 0);
+        CHECK(RLGL.defaultBatch.drawCounter == 1);
+        if (fill == 0) chunkCapacity = context.state->chunkCapacity;
+        else CHECK(context.state->chunkCapacity == chunkCapacity);
+
+        rlDrawBatchContext(&context);
+
+        failed += CheckDraws(reference, referenceCount);
+        CHECK(context.state->chunkCount == 0);
+        CHECK(RLGL.State.currentBlendMode == RL_BLEND_MULTIPLIED);
+        CHECK(mock.blendDst == GL_ONE_MINUS_SRC_ALPHA);     // Multiplied: GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA
+        CHECK(!RLGL.State.scissorEnabled && !mock.scissorEnabled);
+
+        rlSetBlendMode(RL_BLEND_ALPHA);
+    }
+
+    rlUnloadBatchContext(context);
+
+    if (sort) rlDisableRenderBatchSort();
+    RLGL.currentBatch = NULL;
+    rlUnloadRenderBatch(RLGL.defaultBatch);
+
+    return failed;
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    int failed = 0;
+
+    printf("rlgl render batch contexts\n");
+
+    failed += TestBatchContext(false);
+    failed += TestBatchContext(true);
+
+    if (failed > 0) printf("%i checks FAILED\n", failed);
+    else printf("All checks passed\n");
+
+    return (failed > 0)? 1 : 0;
+}
@@ -0,0 +1,240 @@
+/*******************************************************************************************
+*
+*   rlgl test - Render batch draws sorting (rlEnableRenderBatchSort())
+*
+*   Headless test, rlgl implementation is included with a mock OpenGL 3.3 layer:
+*   GL functions used by batch loading and drawing are no-op stubs, draw calls are counted
+*
+*   Checked:
+*     - Non-overlapping draws are merged by texture, also across mid-batch sorts
+*     - Overlapping draws keep submission order
+*     - Draws are not sorted with a perspective projection (XY bounds are not screen bounds)
+*
+*   Test originally created with raylib 5.6-dev, last time updated with raylib 5.6-dev
+*
+*   Test licensed under an unmodified zlib/libpng license, which is an OSI-certified,
+*   BSD-like license that allows static linking with closed source software
+*
+*   Copyright (c) 2026 raylib contributors
+*
+********************************************************************************************/
+
+#define GRAPHICS_API_OPENGL_33
+#define RLGL_STANDALONE
+#define RLGL_IMPLEMENTATION
+#include "rlgl.h"
+
+#include <stdio.h>          // Required for: printf()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define TEST_BATCH_ELEMENTS   2048      // Render batch quads per vertex buffer
+#define TEST_GRID_COLUMNS       30      // Grid of quads, more draws than RL_DEFAULT_BATCH_DRAWCALLS
+#define TEST_GRID_ROWS          20
+
+#define TEST_TEXTURE_A           2      // Texture ids, default texture is 1
+#define TEST_TEXTURE_B           3
+
+#define CHECK(condition) do { if (!(condition)) { printf("    FAILED: %s (line %i)\n", #condition, __LINE__); failed++; } } while (0)
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static int drawCalls = 0;           // glDrawArrays() and glDrawElements() calls
+static int drawTextures[1024] = { 0 };  // Texture bound for every draw call
+static int boundTexture = 0;
+
+//----------------------------------------------------------------------------------
+// Mock GL functions
+//----------------------------------------------------------------------------------
+static void GLAD_API_PTR MockGenObjects(GLsizei n, GLuint *ids) { static GLuint nextId = 1; for (int i = 0; i < n; i++) ids[i] = nextId++; }
+static void GLAD_API_PTR MockDeleteObjects(GLsizei n, const GLuint *ids) { }
+static void GLAD_API_PTR MockBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) { }
+static void GLAD_API_PTR MockBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) { }
+static void GLAD_API_PTR MockBindBuffer(GLenum target, GLuint id) { }
+static void GLAD_API_PTR MockBindObject(GLuint id) { }
+static void GLAD_API_PTR MockBindTexture(GLenum target, GLuint id) { boundTexture = (int)id; }
+static void GLAD_API_PTR MockActiveTexture(GLenum texture) { }
+static void GLAD_API_PTR MockVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer) { }
+static void GLAD_API_PTR MockUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) { }
+static void GLAD_API_PTR MockUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) { }
+static void GLAD_API_PTR MockUniform1i(GLint location, GLint v0) { }
+
+static void GLAD_API_PTR MockDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    if (drawCalls < 1024) drawTextures[drawCalls] = boundTexture;
+    drawCalls++;
+}
+
+static void GLAD_API_PTR MockDrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices)
+{
+    if (drawCalls < 1024) drawTextures[drawCalls] = boundTexture;
+    drawCalls++;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+// Initialize mock GL layer and rlgl state required by render batch
+static void InitMockGL(void)
+{
+    static int shaderLocs[RL_MAX_SHADER_LOCATIONS] = { 0 };
+    for (int i = 0; i < RL_MAX_SHADER_LOCATIONS; i++) shaderLocs[i] = -1;
+
+    glad_glGenBuffers = MockGenObjects;
+    glad_glGenVertexArrays = MockGenObjects;
+    glad_glDeleteBuffers = MockDeleteObjects;
+    glad_glDeleteVertexArrays = MockDeleteObjects;
+    glad_glBindBuffer = MockBindBuffer;
+    glad_glBufferData = MockBufferData;
+    glad_glBufferSubData = MockBufferSubData;
+    glad_glBindVertexArray = MockBindObject;
+    glad_glUseProgram = MockBindObject;
+    glad_glEnableVertexAttribArray = MockBindObject;
+    glad_glDisableVertexAttribArray = MockBindObject;
+    glad_glBindTexture = MockBindTexture;
+    glad_glActiveTexture = MockActiveTexture;
+    glad_glVertexAttribPointer = MockVertexAttribPointer;
+    glad_glUniformMatrix4fv = MockUniformMatrix4fv;
+    glad_glUniform4f = MockUniform4f;
+    glad_glUniform1i = MockUniform1i;
+    glad_glDrawArrays = MockDrawArrays;
+    glad_glDrawElements = MockDrawElements;
+
+    isGpuReady = true;
+    RLGL.ExtSupported.vao = true;
+    RLGL.State.defaultTextureId = 1;
+    RLGL.State.currentTextureId = 1;
+    RLGL.State.currentShaderId = 1;
+    RLGL.State.currentShaderLocs = shaderLocs;
+    RLGL.State.modelview = rlMatrixIdentity();
+    RLGL.State.projection = rlMatrixIdentity();
+    RLGL.State.transform = rlMatrixIdentity();
+    RLGL.State.currentMatrix = &RLGL.State.modelview;
+}
+
+// Draw a textured quad
+static void DrawQuad(unsigned int textureId, float x, float y, float size)
+{
+    rlSetTexture(textureId);
+    rlBegin(RL_QUADS);
+        rlColor4ub(255, 255, 255, 255);
+        rlTexCoord2f(0.0f, 0.0f); rlVertex2f(x, y);
+        rlTexCoord2f(0.0f, 1.0f); rlVertex2f(x, y + size);
+        rlTexCoord2f(1.0f, 1.0f); rlVertex2f(x + size, y + size);
+        rlTexCoord2f(1.0f, 0.0f); rlVertex2f(x + size, y);
+    rlEnd();
+    rlSetTexture(0);
+}
+
+// Draw a checkerboard grid of quads alternating two textures, quads do not overlap
+// NOTE: Consecutive quads of same texture at row ends share a draw, draw bounds are not enough
+static int DrawGrid(rlRenderBatch *batch, bool sort)
+{
+    drawCalls = 0;
+
+    if (sort) rlEnableRenderBatchSort();
+    for (int y = 0; y < TEST_GRID_ROWS; y++)
+    {
+        for (int x = 0; x < TEST_GRID_COLUMNS; x++) DrawQuad(((x + y)%2 == 0)? TEST_TEXTURE_A : TEST_TEXTURE_B, x*10.0f, y*10.0f, 10.0f);
+    }
+    rlDrawRenderBatch(batch);
+    if (sort) rlDisableRenderBatchSort();
+
+    return drawCalls;
+}
+
+// Non-overlapping grid is merged into one draw per texture
+static int TestGrid(void)
+{
+    int failed = 0;
+    printf("  non-overlapping grid, orthographic\n");
+
+    InitMockGL();
+    rlOrtho(0.0, 300.0, 200.0, 0.0, 0.0, 1.0);
+
+    rlRenderBatch batch = rlLoadRenderBatch(1, TEST_BATCH_ELEMENTS);
+    RLGL.currentBatch = &batch;
+
+    CHECK(DrawGrid(&batch, true) == 2);
+
+    RLGL.currentBatch = NULL;
+    rlUnloadRenderBatch(batch);
+
+    return failed;
+}
+
+// Overlapping draws are never reordered
+static int TestOverlap(void)
+{
+    int failed = 0;
+    printf("  overlapping draws, orthographic\n");
+
+    InitMockGL();
+    rlOrtho(0.0, 300.0, 200.0, 0.0, 0.0, 1.0);
+
+    rlRenderBatch batch = rlLoadRenderBatch(1, TEST_BATCH_ELEMENTS);
+    RLGL.currentBatch = &batch;
+    drawCalls = 0;
+
+    rlEnableRenderBatchSort();
+    DrawQuad(TEST_TEXTURE_A, 0.0f, 0.0f, 10.0f);
+    DrawQuad(TEST_TEXTURE_B, 5.0f, 5.0f, 10.0f);        // Overlaps first A
+    DrawQuad(TEST_TEXTURE_A, 100.0f, 100.0f, 10.0f);    // Merged with first A, no overlap with B
+    DrawQuad(TEST_TEXTURE_B, 200.0f, 200.0f, 10.0f);    // Merged with B
+    DrawQuad(TEST_TEXTURE_A, 8.0f, 8.0f, 10.0f);        // Not merged, overlaps first B
+    rlDrawRenderBatch(&batch);
+    rlDisableRenderBatchSort();
+
+    CHECK(drawCalls == 3);
+    CHECK(drawTextures[0] == TEST_TEXTURE_A);
+    CHECK(drawTextures[1] == TEST_TEXTURE_B);
+    CHECK(drawTextures[2] == TEST_TEXTURE_A);
+
+    RLGL.currentBatch = NULL;
+    rlUnloadRenderBatch(batch);
+
+    return failed;
+}
+
+// With a perspective projection draws are kept in submission order, same draws as unsorted
+static int TestPerspective(void)
+{
+    int failed = 0;
+    printf("  non-overlapping grid, perspective\n");
+
+    InitMockGL();
+    rlFrustum(-1.0, 1.0, -1.0, 1.0, 1.0, 100.0);
+
+    rlRenderBatch batch = rlLoadRenderBatch(1, TEST_BATCH_ELEMENTS);
+    RLGL.currentBatch = &batch;
+
+    int unsortedCalls = DrawGrid(&batch, false);
+    CHECK(unsortedCalls > 2);
+    CHECK(DrawGrid(&batch, true) == unsortedCalls);
+
+    RLGL.currentBatch = NULL;
+    rlUnloadRenderBatch(batch);
+
+    return failed;
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    int failed = 0;
+
+    printf("rlgl render batch sorting\n");
+
+    failed += TestGrid();
+    failed += TestOverlap();
+    failed += TestPerspective();
+
+    if (failed > 0) printf("%i checks FAILED\n", failed);
+    else printf("All checks passed\n");
+
+    return (failed > 0)? 1 : 0;
+}
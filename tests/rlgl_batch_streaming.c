@@ -0,0 +1,326 @@
+/*******************************************************************************************
+*
+*   rlgl test - Render batch streaming (RLGL_RENDER_BATCH_STREAMING)
+*
+*   Headless test, rlgl implementation is included with a mock OpenGL 3.3 layer:
+*   render batch streaming GL functions are replaced through rlStreamGL table and
+*   the rest of GL functions used by batch loading and drawing are no-op stubs
+*
+*   Checked for both buffer storage (persistent mapping) and buffer orphaning paths:
+*     - Ring buffers rotation on every batch draw
+*     - Fence wait only when the ring wraps, stall counted only if GPU did not complete
+*     - Upload and orphan statistics
+*     - Mapping failure falls back to orphaning on new buffers (immutable storage can not be reallocated)
+*
+*   Test originally created with raylib 5.6-dev, last time updated with raylib 5.6-dev
+*
+*   Test licensed under an unmodified zlib/libpng license, which is an OSI-certified,
+*   BSD-like license that allows static linking with closed source software
+*
+*   Copyright (c) 2026 raylib contributors
+*
+********************************************************************************************/
+
+#define GRAPHICS_API_OPENGL_33
+#define RLGL_STANDALONE
+#define RLGL_RENDER_BATCH_STREAMING
+#define RLGL_IMPLEMENTATION
+#include "rlgl.h"
+
+#include <stdio.h>          // Required for: printf()
+#include <stdint.h>         // Required for: intptr_t
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define TEST_RING_BUFFERS        3      // Render batch vertex buffers (ring size)
+#define TEST_BATCH_ELEMENTS    256      // Render batch quads per vertex buffer
+#define TEST_FLUSHES            10      // Render batch draws per test case
+#define TEST_MAX_ALLOCS         32      // Mock mapped memory blocks
+#define TEST_MAX_FENCES         32      // Mock fences
+#define TEST_MAX_BUFFERS      1024      // Mock buffer ids
+
+#define CHECK(condition) do { if (!(condition)) { printf("    FAILED: %s (line %i)\n", #condition, __LINE__); failed++; } } while (0)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Mock GPU state
+typedef struct MockGL {
+    int gpuLatency;             // Batch draws required for the GPU to complete a fence
+    int flush;                  // Current batch draw index
+    bool mapFails;              // glMapBufferRange() returns NULL
+
+    unsigned int boundBuffer;   // Buffer bound to GL_ARRAY_BUFFER
+    bool immutable[TEST_MAX_BUFFERS];   // Buffers with immutable storage (glBufferStorage())
+    int invalidCalls;           // Calls failing with GL_INVALID_OPERATION (immutable storage reallocation or update)
+
+    int bufferDataCalls;        // glBufferData() calls
+    int orphanCalls;            // glBufferData() calls with no data (orphaning)
+    int bufferSubDataCalls;     // glBufferSubData() calls
+    int bufferStorageCalls;     // glBufferStorage() calls
+    int waitCalls;              // glClientWaitSync() calls
+    int fencesCreated;          // glFenceSync() calls
+    int fencesDeleted;          // glDeleteSync() calls
+
+    void *allocs[TEST_MAX_ALLOCS];      // Mapped memory blocks
+    int allocCount;
+    int fenceFlush[TEST_MAX_FENCES];    // Batch draw index every fence was inserted on
+} MockGL;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static MockGL mock = { 0 };
+
+//----------------------------------------------------------------------------------
+// Mock GL functions
+//----------------------------------------------------------------------------------
+// NOTE: Immutable storage can not be reallocated, neither updated without GL_DYNAMIC_STORAGE_BIT (not used by rlgl)
+static void GLAD_API_PTR MockBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage)
+{
+    if (mock.immutable[mock.boundBuffer]) { mock.invalidCalls++; return; }
+
+    mock.bufferDataCalls++;
+    if (data == NULL) mock.orphanCalls++;
+}
+
+static void GLAD_API_PTR MockBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data)
+{
+    if (mock.immutable[mock.boundBuffer]) { mock.invalidCalls++; return; }
+
+    mock.bufferSubDataCalls++;
+}
+
+static void GLAD_API_PTR MockBufferStorage(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags)
+{
+    if (mock.immutable[mock.boundBuffer]) { mock.invalidCalls++; return; }
+
+    mock.immutable[mock.boundBuffer] = true;
+    mock.bufferStorageCalls++;
+}
+
+static void *GLAD_API_PTR MockMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    if (mock.mapFails || (mock.allocCount >= TEST_MAX_ALLOCS)) return NULL;
+
+    void *memory = RL_CALLOC(1, length);
+    mock.allocs[mock.allocCount++] = memory;
+
+    return memory;
+}
+
+static GLsync GLAD_API_PTR MockFenceSync(GLenum condition, GLbitfield flags)
+{
+    if (mock.fencesCreated >= TEST_MAX_FENCES) return NULL;
+
+    mock.fenceFlush[mock.fencesCreated] = mock.flush;
+    mock.fencesCreated++;
+
+    return (GLsync)(intptr_t)mock.fencesCreated;   // Fence index + 1, never NULL
+}
+
+static GLenum GLAD_API_PTR MockClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+    mock.waitCalls++;
+
+    // GPU completes commands when flushed, otherwise only after the latency batch draws
+    if (flags & GL_SYNC_FLUSH_COMMANDS_BIT) return GL_CONDITION_SATISFIED;
+
+    int fence = (int)(intptr_t)sync - 1;
+    return ((mock.flush - mock.fenceFlush[fence]) >= mock.gpuLatency)? GL_ALREADY_SIGNALED : GL_TIMEOUT_EXPIRED;
+}
+
+static void GLAD_API_PTR MockDeleteSync(GLsync sync) { mock.fencesDeleted++; }
+
+// Rest of GL functions used by render batch, no GPU state required
+static void GLAD_API_PTR MockGenObjects(GLsizei n, GLuint *ids) { static GLuint nextId = 1; for (int i = 0; i < n; i++) ids[i] = (nextId++)%TEST_MAX_BUFFERS; }
+static void GLAD_API_PTR MockDeleteObjects(GLsizei n, const GLuint *ids) { }
+static void GLAD_API_PTR MockDeleteBuffers(GLsizei n, const GLuint *ids) { for (int i = 0; i < n; i++) mock.immutable[ids[i]] = false; }
+static void GLAD_API_PTR MockIndexBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) { }
+static void GLAD_API_PTR MockBindBuffer(GLenum target, GLuint id) { if (target == GL_ARRAY_BUFFER) mock.boundBuffer = id; }
+static void GLAD_API_PTR MockBindObject(GLuint id) { }
+static void GLAD_API_PTR MockBindTexture(GLenum target, GLuint id) { }
+static void GLAD_API_PTR MockActiveTexture(GLenum texture) { }
+static void GLAD_API_PTR MockVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer) { }
+static void GLAD_API_PTR MockUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) { }
+static void GLAD_API_PTR MockUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) { }
+static void GLAD_API_PTR MockUniform1i(GLint location, GLint v0) { }
+static void GLAD_API_PTR MockDrawArrays(GLenum mode, GLint first, GLsizei count) { }
+static void GLAD_API_PTR MockDrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices) { }
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+// Initialize mock GL layer and rlgl state required by render batch
+static void InitMockGL(bool bufferStorage, bool mapFails, int gpuLatency)
+{
+    static int shaderLocs[RL_MAX_SHADER_LOCATIONS] = { 0 };
+    for (int i = 0; i < RL_MAX_SHADER_LOCATIONS; i++) shaderLocs[i] = -1;
+
+    mock = (MockGL){ 0 };
+    mock.gpuLatency = gpuLatency;
+    mock.mapFails = mapFails;
+
+    glad_glGenBuffers = MockGenObjects;
+    glad_glGenVertexArrays = MockGenObjects;
+    glad_glDeleteBuffers = MockDeleteBuffers;
+    glad_glDeleteVertexArrays = MockDeleteObjects;
+    glad_glBindBuffer = MockBindBuffer;
+    glad_glBufferData = MockIndexBufferData;   // Index buffers, vertex buffers use rlStreamGL
+    glad_glBindVertexArray = MockBindObject;
+    glad_glUseProgram = MockBindObject;
+    glad_glEnableVertexAttribArray = MockBindObject;
+    glad_glDisableVertexAttribArray = MockBindObject;
+    glad_glBindTexture = MockBindTexture;
+    glad_glActiveTexture = MockActiveTexture;
+    glad_glVertexAttribPointer = MockVertexAttribPointer;
+    glad_glUniformMatrix4fv = MockUniformMatrix4fv;
+    glad_glUniform4f = MockUniform4f;
+    glad_glUniform1i = MockUniform1i;
+    glad_glDrawArrays = MockDrawArrays;
+    glad_glDrawElements = MockDrawElements;
+
+    rlStreamGL.bufferData = MockBufferData;
+    rlStreamGL.bufferSubData = MockBufferSubData;
+    rlStreamGL.bufferStorage = MockBufferStorage;
+    rlStreamGL.mapBufferRange = MockMapBufferRange;
+    rlStreamGL.fenceSync = MockFenceSync;
+    rlStreamGL.clientWaitSync = MockClientWaitSync;
+    rlStreamGL.deleteSync = MockDeleteSync;
+
+    isGpuReady = true;
+    RLGL.ExtSupported.vao = true;
+    RLGL.ExtSupported.bufferStorage = bufferStorage;
+    RLGL.State.defaultTextureId = 1;
+    RLGL.State.currentShaderId = 1;
+    RLGL.State.currentShaderLocs = shaderLocs;
+    RLGL.State.modelview = rlMatrixIdentity();
+    RLGL.State.projection = rlMatrixIdentity();
+    RLGL.State.transform = rlMatrixIdentity();
+    RLGL.State.currentMatrix = &RLGL.State.modelview;
+
+    rlRenderBatchStats stats = { 0 };
+    rlGetRenderBatchStats(&stats, true);
+}
+
+// Release mock GL layer mapped memory
+static void CloseMockGL(void)
+{
+    for (int i = 0; i < mock.allocCount; i++) RL_FREE(mock.allocs[i]);
+    mock.allocCount = 0;
+}
+
+// Draw a batch with one quad every time, checking ring rotation and fence waits
+static int TestStreaming(const char *name, bool bufferStorage, bool mapFails, int gpuLatency, int expectedStalls)
+{
+    int failed = 0;
+    printf("  %s\n", name);
+
+    InitMockGL(bufferStorage, mapFails, gpuLatency);
+    bool mapped = bufferStorage && !mapFails;
+
+    rlRenderBatch batch = rlLoadRenderBatch(TEST_RING_BUFFERS, TEST_BATCH_ELEMENTS);
+    RLGL.currentBatch = &batch;
+
+    CHECK(batch.bufferCount == TEST_RING_BUFFERS);
+    CHECK(batch.currentBuffer == 0);
+
+    // Every vertex buffer array is allocated (and mapped) once on load
+#if defined(RLGL_RENDER_BATCH_INTERLEAVED)
+    const int arrayCount = 1;
+    const int vertexSize = (int)sizeof(rlBatchVertex);
+#else
+    const int arrayCount = 4;
+    const int vertexSize = 3*sizeof(float) + 2*sizeof(float) + 3*sizeof(float) + 4*sizeof(unsigned char);
+#endif
+    CHECK(mock.bufferStorageCalls == (bufferStorage? TEST_RING_BUFFERS*arrayCount : 0));
+    if (mapped)
+    {
+        CHECK(mock.allocCount == TEST_RING_BUFFERS*arrayCount);
+        CHECK(mock.bufferDataCalls == 0);
+    }
+    else
+    {
+        // Buffers with immutable storage failing to map are replaced, new buffers storage allocated
+        CHECK(mock.allocCount == 0);
+        CHECK(mock.bufferDataCalls == TEST_RING_BUFFERS*arrayCount);
+    }
+    CHECK(mock.invalidCalls == 0);
+
+    int loadBufferDataCalls = mock.bufferDataCalls;
+
+    for (int i = 0; i < TEST_FLUSHES; i++)
+    {
+        mock.flush = i;
+        int waitCalls = mock.waitCalls;
+
+        rlBegin(RL_QUADS);
+            rlColor4ub(255, 255, 255, 255);
+            rlTexCoord2f(0.0f, 0.0f); rlVertex2f(0.0f, 0.0f);
+            rlTexCoord2f(0.0f, 1.0f); rlVertex2f(0.0f, 1.0f);
+            rlTexCoord2f(1.0f, 1.0f); rlVertex2f(1.0f, 1.0f);
+            rlTexCoord2f(1.0f, 0.0f); rlVertex2f(1.0f, 0.0f);
+        rlEnd();
+
+        rlDrawRenderBatch(&batch);
+
+        // Ring rotates on every draw, fence waited only on buffers already used (ring wrapped)
+        CHECK(batch.currentBuffer == (i + 1)%TEST_RING_BUFFERS);
+        if (mapped && (i >= TEST_RING_BUFFERS)) CHECK(mock.waitCalls > waitCalls);
+        else CHECK(mock.waitCalls == waitCalls);
+    }
+
+    rlRenderBatchStats stats = { 0 };
+    CHECK(rlGetRenderBatchStats(&stats, false));
+
+    CHECK(stats.uploads == (unsigned long long)TEST_FLUSHES*arrayCount);
+    CHECK(stats.uploadBytes == (unsigned long long)TEST_FLUSHES*4*vertexSize);
+    CHECK(stats.fenceWaits == (unsigned long long)expectedStalls);
+    CHECK(mock.invalidCalls == 0);
+
+    if (mapped)
+    {
+        CHECK(stats.orphans == 0);
+        CHECK(mock.bufferDataCalls == loadBufferDataCalls);
+        CHECK(mock.bufferSubDataCalls == 0);
+        CHECK(mock.fencesCreated == TEST_FLUSHES);
+    }
+    else
+    {
+        CHECK(stats.orphans == stats.uploads);
+        CHECK((unsigned long long)mock.orphanCalls == stats.orphans);
+        CHECK((unsigned long long)mock.bufferSubDataCalls == stats.uploads);
+        CHECK(mock.fencesCreated == 0);
+        CHECK(mock.waitCalls == 0);
+    }
+
+    // Pending fences are deleted on unload
+    RLGL.currentBatch = NULL;
+    rlUnloadRenderBatch(batch);
+    CHECK(mock.fencesDeleted == mock.fencesCreated);
+
+    CloseMockGL();
+
+    return failed;
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    int failed = 0;
+
+    printf("rlgl render batch streaming\n");
+
+    failed += TestStreaming("buffer storage, GPU completes before ring wraps", true, false, TEST_RING_BUFFERS - 1, 0);
+    failed += TestStreaming("buffer storage, GPU behind ring (stalls)", true, false, TEST_RING_BUFFERS + 1, TEST_FLUSHES - TEST_RING_BUFFERS);
+    failed += TestStreaming("buffer orphaning", false, false, TEST_RING_BUFFERS + 1, 0);
+    failed += TestStreaming("buffer storage, mapping failed (orphaning)", true, true, TEST_RING_BUFFERS + 1, 0);
+
+    if (failed > 0) printf("%i checks FAILED\n", failed);
+    else printf("All checks passed\n");
+
+    return (failed > 0)? 1 : 0;
+}
@@ -0,0 +1,282 @@
+/*******************************************************************************************
+*
+*   rlgl test - Command buffers recording and drawing (rlBeginCommandBuffer())
+*
+*   Headless test, rlgl implementation is included with a mock OpenGL 3.3 layer:
+*   GL functions used by batch and command buffer drawing are no-op stubs, draw calls
+*   are recorded with the texture, blending and scissor state they were issued with
+*
+*   Checked:
+*     - Quads are recorded as 6-vertex triangles, one draw per texture and draw state
+*     - Draws with same mode, texture and state are merged, trailing empty draw is dropped
+*     - Draws are replayed with the blending mode and scissor they were recorded with
+*     - Current blending mode and scissor are restored after drawing
+*
+*   Test originally created with raylib 5.6-dev, last time updated with raylib 5.6-dev
+*
+*   Test licensed under an unmodified zlib/libpng license, which is an OSI-certified,
+*   BSD-like license that allows static linking with closed source software
+*
+*   Copyright (c) 2026 raylib contributors
+*
+********************************************************************************************/
+
+#define GRAPHICS_API_OPENGL_33
+#define RLGL_STANDALONE
+#define RLGL_IMPLEMENTATION
+#include "rlgl.h"
+
+#include <stdio.h>          // Required for: printf()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define TEST_BATCH_ELEMENTS    256      // Render batch quads per vertex buffer
+#define TEST_MAX_DRAWS          16      // Draw calls recorded by the mock
+
+#define TEST_TEXTURE_A           2      // Texture ids, default texture is 1
+#define TEST_TEXTURE_B           3
+
+#define CHECK(condition) do { if (!(condition)) { printf("    FAILED: %s (line %i)\n", #condition, __LINE__); failed++; } } while (0)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Mock draw call, with the GL state it was issued with
+typedef struct MockDraw {
+    int mode;                   // Primitive mode
+    int first;                  // First vertex
+    int count;                  // Vertex count
+    int textureId;              // Texture bound
+    int blendDst;               // Blending destination factor
+    bool scissorEnabled;        // Scissor test enabled
+    int scissor[4];             // Scissor rectangle
+} MockDraw;
+
+// Mock GPU state
+typedef struct MockGL {
+    int boundTexture;           // Texture bound to GL_TEXTURE_2D
+    int blendSrc;               // Blending source factor
+    int blendDst;               // Blending destination factor
+    int blendCalls;             // glBlendFunc() calls
+    bool scissorEnabled;        // Scissor test enabled
+    int scissor[4];             // Scissor rectangle
+
+    MockDraw draws[TEST_MAX_DRAWS];
+    int drawCount;
+} MockGL;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static MockGL mock = { 0 };
+
+//----------------------------------------------------------------------------------
+// Mock GL functions
+//----------------------------------------------------------------------------------
+static void GLAD_API_PTR MockGenObjects(GLsizei n, GLuint *ids) { static GLuint nextId = 1; for (int i = 0; i < n; i++) ids[i] = nextId++; }
+static void GLAD_API_PTR MockDeleteObjects(GLsizei n, const GLuint *ids) { }
+static void GLAD_API_PTR MockBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) { }
+static void GLAD_API_PTR MockBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) { }
+static void GLAD_API_PTR MockBindBuffer(GLenum target, GLuint id) { }
+static void GLAD_API_PTR MockBindObject(GLuint id) { }
+static void GLAD_API_PTR MockBindTexture(GLenum target, GLuint id) { mock.boundTexture = (int)id; }
+static void GLAD_API_PTR MockActiveTexture(GLenum texture) { }
+static void GLAD_API_PTR MockVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer) { }
+static void GLAD_API_PTR MockUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) { }
+static void GLAD_API_PTR MockUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) { }
+static void GLAD_API_PTR MockUniform1i(GLint location, GLint v0) { }
+static void GLAD_API_PTR MockBlendFunc(GLenum src, GLenum dst) { mock.blendSrc = (int)src; mock.blendDst = (int)dst; mock.blendCalls++; }
+static void GLAD_API_PTR MockBlendEquation(GLenum mode) { }
+static void GLAD_API_PTR MockEnable(GLenum cap) { if (cap == GL_SCISSOR_TEST) mock.scissorEnabled = true; }
+static void GLAD_API_PTR MockDisable(GLenum cap) { if (cap == GL_SCISSOR_TEST) mock.scissorEnabled = false; }
+static void GLAD_API_PTR MockScissor(GLint x, GLint y, GLsizei width, GLsizei height) { mock.scissor[0] = x; mock.scissor[1] = y; mock.scissor[2] = width; mock.scissor[3] = height; }
+
+static void GLAD_API_PTR MockDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    if (mock.drawCount >= TEST_MAX_DRAWS) return;
+
+    MockDraw *draw = &mock.draws[mock.drawCount++];
+    draw->mode = (int)mode;
+    draw->first = first;
+    draw->count = count;
+    draw->textureId = mock.boundTexture;
+    draw->blendDst = mock.blendDst;
+    draw->scissorEnabled = mock.scissorEnabled;
+    for (int i = 0; i < 4; i++) draw->scissor[i] = mock.scissor[i];
+}
+
+static void GLAD_API_PTR MockDrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices) { mock.drawCount++; }
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+// Initialize mock GL layer and rlgl state required by render batch
+static void InitMockGL(void)
+{
+    static int shaderLocs[RL_MAX_SHADER_LOCATIONS] = { 0 };
+    for (int i = 0; i < RL_MAX_SHADER_LOCATIONS; i++) shaderLocs[i] = -1;
+
+    glad_glGenBuffers = MockGenObjects;
+    glad_glGenVertexArrays = MockGenObjects;
+    glad_glDeleteBuffers = MockDeleteObjects;
+    glad_glDeleteVertexArrays = MockDeleteObjects;
+    glad_glBindBuffer = MockBindBuffer;
+    glad_glBufferData = MockBufferData;
+    glad_glBufferSubData = MockBufferSubData;
+    glad_glBindVertexArray = MockBindObject;
+    glad_glUseProgram = MockBindObject;
+    glad_glEnableVertexAttribArray = MockBindObject;
+    glad_glDisableVertexAttribArray = MockBindObject;
+    glad_glBindTexture = MockBindTexture;
+    glad_glActiveTexture = MockActiveTexture;
+    glad_glVertexAttribPointer = MockVertexAttribPointer;
+    glad_glUniformMatrix4fv = MockUniformMatrix4fv;
+    glad_glUniform4f = MockUniform4f;
+    glad_glUniform1i = MockUniform1i;
+    glad_glBlendFunc = MockBlendFunc;
+    glad_glBlendEquation = MockBlendEquation;
+    glad_glEnable = MockEnable;
+    glad_glDisable = MockDisable;
+    glad_glScissor = MockScissor;
+    glad_glDrawArrays = MockDrawArrays;
+    glad_glDrawElements = MockDrawElements;
+
+    isGpuReady = true;
+    RLGL.ExtSupported.vao = true;
+    RLGL.State.defaultTextureId = 1;
+    RLGL.State.currentTextureId = 1;
+    RLGL.State.currentShaderId = 1;
+    RLGL.State.currentShaderLocs = shaderLocs;
+    RLGL.State.currentBlendMode = RL_BLEND_ALPHA;
+    RLGL.State.modelview = rlMatrixIdentity();
+    RLGL.State.projection = rlMatrixIdentity();
+    RLGL.State.transform = rlMatrixIdentity();
+    RLGL.State.currentMatrix = &RLGL.State.modelview;
+}
+
+// Draw a textured quad
+static void DrawQuad(unsigned int textureId, float x, float y, float size)
+{
+    rlSetTexture(textureId);
+    rlBegin(RL_QUADS);
+        rlColor4ub(255, 255, 255, 255);
+        rlTexCoord2f(0.0f, 0.0f); rlVertex2f(x, y);
+        rlTexCoord2f(0.0f, 1.0f); rlVertex2f(x, y + size);
+        rlTexCoord2f(1.0f, 1.0f); rlVertex2f(x + size, y + size);
+        rlTexCoord2f(1.0f, 0.0f); rlVertex2f(x + size, y);
+    rlEnd();
+    rlSetTexture(0);
+}
+
+// Record quads with two textures and blending mode and scissor changes, then draw them
+static int TestCommandBuffer(void)
+{
+    int failed = 0;
+    printf("  record and draw, blending and scissor changes\n");
+
+    InitMockGL();
+
+    rlRenderBatch batch = rlLoadRenderBatch(1, TEST_BATCH_ELEMENTS);
+    RLGL.currentBatch = &batch;
+
+    rlBeginCommandBuffer();
+        DrawQuad(TEST_TEXTURE_A, 0.0f, 0.0f, 10.0f);
+        DrawQuad(TEST_TEXTURE_A, 10.0f, 0.0f, 10.0f);       // Merged, same texture and state
+        DrawQuad(TEST_TEXTURE_B, 20.0f, 0.0f, 10.0f);
+        rlSetBlendMode(RL_BLEND_ADDITIVE);
+        DrawQuad(TEST_TEXTURE_B, 30.0f, 0.0f, 10.0f);       // Not merged, blending mode changed
+        rlSetBlendMode(RL_BLEND_ALPHA);
+        rlEnableScissorTest();
+        rlScissor(1, 2, 3, 4);
+        DrawQuad(TEST_TEXTURE_B, 40.0f, 0.0f, 10.0f);       // Not merged, scissor changed
+        DrawQuad(TEST_TEXTURE_B, 50.0f, 0.0f, 10.0f);       // Merged, same texture and state
+        rlDisableScissorTest();
+        rlRecordDraw(RL_LINES, TEST_TEXTURE_A);             // Draw with no vertex, as rlBegin() on OpenGL 1.1
+    rlCommandBuffer buffer = rlEndCommandBuffer();
+
+    // Recorded as triangles, 6 vertex per quad
+    CHECK(buffer.vertexCount == 6*6);
+    CHECK(buffer.drawCount == 4);
+    if (buffer.drawCount == 4)
+    {
+        const int textures[4] = { TEST_TEXTURE_A, TEST_TEXTURE_B, TEST_TEXTURE_B, TEST_TEXTURE_B };
+        const int counts[4] = { 12, 6, 6, 12 };
+        for (int i = 0; i < 4; i++)
+        {
+            CHECK(buffer.draws[i].mode == RL_TRIANGLES);
+            CHECK((int)buffer.draws[i].textureId == textures[i]);
+            CHECK(buffer.draws[i].vertexCount == counts[i]);
+        }
+
+        CHECK(buffer.states[1].blendMode == RL_BLEND_ALPHA);
+        CHECK(buffer.states[2].blendMode == RL_BLEND_ADDITIVE);
+        CHECK(!buffer.states[2].scissorEnabled);
+        CHECK(buffer.states[3].scissorEnabled);
+    }
+
+    // Current state, different from recorded one, restored after drawing
+    rlSetBlendMode(RL_BLEND_MULTIPLIED);
+    rlEnableScissorTest();
+    rlScissor(9, 9, 9, 9);
+
+    mock.drawCount = 0;
+    mock.blendCalls = 0;
+    rlDrawCommandBuffer(buffer, rlMatrixIdentity(), NULL);
+
+    CHECK(mock.drawCount == 4);
+    if (mock.drawCount == 4)
+    {
+        const int textures[4] = { TEST_TEXTURE_A, TEST_TEXTURE_B, TEST_TEXTURE_B, TEST_TEXTURE_B };
+        const int firsts[4] = { 0, 12, 18, 24 };
+        const int counts[4] = { 12, 6, 6, 12 };
+        for (int i = 0; i < 4; i++)
+        {
+            CHECK(mock.draws[i].mode == GL_TRIANGLES);
+            CHECK(mock.draws[i].textureId == textures[i]);
+            CHECK(mock.draws[i].first == firsts[i]);
+            CHECK(mock.draws[i].count == counts[i]);
+        }
+
+        CHECK(mock.draws[0].blendDst == GL_ONE_MINUS_SRC_ALPHA);
+        CHECK(mock.draws[2].blendDst == GL_ONE);
+        CHECK(mock.draws[3].blendDst == GL_ONE_MINUS_SRC_ALPHA);
+        CHECK(!mock.draws[0].scissorEnabled);
+        CHECK(!mock.draws[2].scissorEnabled);
+        CHECK(mock.draws[3].scissorEnabled);
+        CHECK((mock.draws[3].scissor[0] == 1) && (mock.draws[3].scissor[1] == 2) && (mock.draws[3].scissor[2] == 3) && (mock.draws[3].scissor[3] == 4));
+    }
+
+    // Blending set for draws 0 (alpha), 2 (additive), 3 (alpha) and restored (multiplied)
+    CHECK(mock.blendCalls == 4);
+    CHECK((mock.blendSrc == GL_DST_COLOR) && (mock.blendDst == GL_ONE_MINUS_SRC_ALPHA));
+    CHECK(RLGL.State.currentBlendMode == RL_BLEND_MULTIPLIED);
+    CHECK(mock.scissorEnabled && RLGL.State.scissorEnabled);
+    CHECK((mock.scissor[0] == 9) && (mock.scissor[1] == 9) && (mock.scissor[2] == 9) && (mock.scissor[3] == 9));
+
+    rlDisableScissorTest();
+    rlSetBlendMode(RL_BLEND_ALPHA);
+    rlUnloadCommandBuffer(buffer);
+
+    RLGL.currentBatch = NULL;
+    rlUnloadRenderBatch(batch);
+
+    return failed;
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    int failed = 0;
+
+    printf("rlgl command buffers\n");
+
+    failed += TestCommandBuffer();
+
+    if (failed > 0) printf("%i checks FAILED\n", failed);
+    else printf("All checks passed\n");
+
+    return (failed > 0)? 1 : 0;
+}